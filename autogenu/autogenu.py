@@ -1,4 +1,6 @@
+import io
 import linecache
+import re
 import subprocess
 import platform
 from enum import Enum, auto
@@ -12,6 +14,7 @@ class SolverType(Enum):
     ContinuationGMRES = auto()
     MultipleShootingCGMRES = auto()
     MSCGMRESWithInputSaturation = auto()
+    UncondensedMSCGMRES = auto()
 
 class AutoGenU(object):
     """ Automatic C++ code generator for the C/GMRES methods. 
@@ -28,6 +31,11 @@ class AutoGenU(object):
         assert dimx > 0, 'The second argument must be positive integer!'
         assert dimu > 0, 'The third argument must be positive integer!'
         self.__model_name = model_name
+        # The namespace of the model is the model name with the characters 
+        # that are not allowed in identifiers replaced.
+        self.__model_namespace = re.sub(r'\W', '_', model_name)
+        if self.__model_namespace[0].isdigit():
+            self.__model_namespace = '_' + self.__model_namespace
         self.__dimx = dimx        
         self.__dimu = dimu        
         self.__scalar_vars = []
@@ -39,6 +47,19 @@ class AutoGenU(object):
         self.__is_initialization_set = False
         self.__is_simulation_set = False
         self.__is_FB_epsilon_set = False
+        self.__use_fixed_size_gmres = False
+        self.__use_single_precision_basis = False
+        self.__num_threads = 1
+        self.__min_N_for_threads = 0
+        self.__use_riccati_recursion = False
+        self.__use_exact_jacobian_vector_product = False
+        self.__dense_jacobian_update_period = 0
+        self.__dense_jacobian_refresh_tolerance = 0
+        self.__krylov_recycle_dim = 0
+        self.__block_tridiagonal_lu_update_period = 0
+        self.__use_model_plugin = False
+        self.__use_runtime_parameters = False
+        self.__use_strength_reduction = False
 
     def define_t(self):
         """ Returns symbolic scalar variable 't'.
@@ -186,12 +207,20 @@ class AutoGenU(object):
             Args: 
                 solver_type: The solver type. Choose from 
                 SolverType.ContinuationGMRES, SolverType.MultipleShootingCGMRES, 
-                and SolverType.MSCGMRESWithInputSaturation.
+                SolverType.MSCGMRESWithInputSaturation, and 
+                SolverType.UncondensedMSCGMRES. UncondensedMSCGMRES does not 
+                condense the state and lambda in the linear problem, whose 
+                stages are then evaluated in parallel by set_num_threads(). 
+                Its GMRES method needs kmax of at least 
+                1.5*(dimu+dimc+dimh+2*dimx) unless set_block_tridiagonal_lu() 
+                is used, and it is slower than MultipleShootingCGMRES on a 
+                single core.
         """
         assert (
             solver_type == SolverType.ContinuationGMRES or 
             solver_type == SolverType.MultipleShootingCGMRES or
-            solver_type == SolverType.MSCGMRESWithInputSaturation
+            solver_type == SolverType.MSCGMRESWithInputSaturation or
+            solver_type == SolverType.UncondensedMSCGMRES
         )
         self.__solver_type = solver_type
         self.__is_solver_type_set = True
@@ -228,6 +257,186 @@ class AutoGenU(object):
         self.__kmax = kmax
         self.__is_solver_paramters_set = True
 
+    def set_fixed_size_gmres(self, use_fixed_size_gmres):
+        """ Sets whether the C/GMRES solver uses the storage whose 
+            dimensions are fixed at the code generation. 
+
+            Args: 
+                use_fixed_size_gmres: If True, main.cpp declares the solver 
+                    with N and kmax as the template arguments, e.g., 
+                    cgmres::MultipleShootingCGMRES<NMPCModel, N, kmax>. The 
+                    sequences over the horizon are then members of the 
+                    solver and the solver uses FixedSizeMatrixFreeGMRES, 
+                    whose vectors and matrices are not allocated on the heap. 
+                    Do not set True if N and kmax are so large that the 
+                    solver does not fit in the stack. The Givens rotations 
+                    and the back substitution are unrolled for each 
+                    dimension of the Krylov subspace. The default is False 
+                    because the benchmark fixed_size shows no speedup over 
+                    the dynamic workspace for the sample models. This cannot 
+                    be used together with set_single_precision_basis().
+        """
+        assert not (use_fixed_size_gmres and self.__use_single_precision_basis), "use_fixed_size_gmres and use_single_precision_basis cannot be used together!"
+        self.__use_fixed_size_gmres = use_fixed_size_gmres
+
+    def set_single_precision_basis(self, use_single_precision_basis):
+        """ Sets whether the GMRES method in the C/GMRES solver stores the 
+            basis of the Krylov subspace in single precision. 
+
+            Args: 
+                use_single_precision_basis: If True, 
+                    CGMRES_SINGLE_PRECISION_BASIS is defined in CMakeLists.txt 
+                    and the solver uses MixedPrecisionMatrixFreeGMRES, which 
+                    halves the memory of the Krylov basis. The residual of 
+                    the GMRES method is then limited to about 1e-7 relative 
+                    to the initial residual. The benchmark 
+                    benchmark/benchmark.py mixed_precision shows no speedup 
+                    on the sample models because their bases fit in the 
+                    cache, so use this only to save memory. This cannot be 
+                    used together with set_fixed_size_gmres(). The default 
+                    is False.
+        """
+        assert not (use_single_precision_basis and self.__use_fixed_size_gmres), "use_fixed_size_gmres and use_single_precision_basis cannot be used together!"
+        self.__use_single_precision_basis = use_single_precision_basis
+
+    def set_riccati_recursion(self, use_riccati_recursion):
+        """ Sets whether the linear problem of the C/GMRES method is solved 
+            directly by the Riccati recursion instead of the GMRES method. 
+
+            Args: 
+                use_riccati_recursion: If True, setRiccatiRecursion(true) of 
+                    the solver is called in main.cpp and the linear problem is 
+                    solved with the exact Jacobians of the stages in O(N) 
+                    operations independently of kmax. The linear problem is 
+                    the same as that of the GMRES method with the exact 
+                    Jacobian-vector products, and each update is usually 
+                    slower than the GMRES method with a small kmax; see the 
+                    benchmark riccati_recursion. This is supported only by 
+                    SolverType.MultipleShootingCGMRES and ignored by the other 
+                    solvers. The default is False.
+        """
+        self.__use_riccati_recursion = use_riccati_recursion
+
+    def set_exact_jacobian_vector_product(
+            self, use_exact_jacobian_vector_product
+        ):
+        """ Sets whether the Jacobian-vector products of the GMRES method 
+            are computed exactly instead of the forward difference 
+            approximation. 
+
+            Args: 
+                use_exact_jacobian_vector_product: If True, 
+                    setExactJacobianVectorProduct(true) of the solver is 
+                    called in main.cpp and the products are computed by the 
+                    functions of NMPCModel instantiated for the dual numbers, 
+                    which are the symbolic Jacobian-vector product kernels if 
+                    generate_source_files() is called with 
+                    use_symbolic_jvp=True. This is supported by 
+                    SolverType.ContinuationGMRES, 
+                    SolverType.MultipleShootingCGMRES, and 
+                    SolverType.MSCGMRESWithInputSaturation and ignored by 
+                    SolverType.UncondensedMSCGMRES. The benchmark 
+                    benchmark/benchmark.py exact_jvp shows that each update 
+                    is slower than with the forward difference on the sample 
+                    models because the products cost more than the 
+                    evaluations of the equations. The default is False.
+        """
+        self.__use_exact_jacobian_vector_product = (
+            use_exact_jacobian_vector_product
+        )
+
+    def set_dense_jacobian(self, update_period, refresh_tolerance=0):
+        """ Sets whether the linear problem of the C/GMRES method is solved by 
+            the LU factorization of the explicitly assembled Jacobian instead 
+            of the Krylov method. 
+
+            Args: 
+                update_period: If it is positive, setDenseJacobian() of the 
+                    solver is called in main.cpp and the Jacobian is 
+                    reassembled and refactorized every update_period updates. 
+                    Each refactorization costs as many directional 
+                    derivatives as the dimension of the linear problem, 
+                    e.g., about 1.2 ms for the cartpole with N = 50, and 
+                    main.cpp prints the number of the refactorizations. On 
+                    the sample models, this is slower than the Krylov 
+                    method; see the benchmark dense_jacobian. This is 
+                    supported only by SolverType.ContinuationGMRES and 
+                    SolverType.MultipleShootingCGMRES and ignored by the other 
+                    solvers. The default is 0, i.e., the Krylov method is 
+                    used.
+                refresh_tolerance: If it is positive, the solution under 
+                    the frozen factorization is improved by the iterative 
+                    refinement while its relative residual is larger than 
+                    this value, and the Jacobian is also refactorized if the 
+                    refinement stalls. The default is 0.
+        """
+        assert update_period >= 0
+        assert refresh_tolerance >= 0
+        self.__dense_jacobian_update_period = update_period
+        self.__dense_jacobian_refresh_tolerance = refresh_tolerance
+
+    def set_krylov_recycling(self, recycle_dim):
+        """ Sets whether the linear problem of the C/GMRES method is solved by 
+            the GCRO-DR method, which recycles a subspace of the Krylov 
+            subspace of the previous update, instead of the GMRES method. 
+
+            Args: 
+                recycle_dim: If it is positive, setKrylovRecycling() of the 
+                    solver is called in main.cpp and the recycled subspace is 
+                    spanned by the recycle_dim harmonic Ritz vectors of the 
+                    previous update. Its image is recomputed in each update 
+                    by recycle_dim of the kmax calls of AxFunc(). On the 
+                    sample models, this does not reduce the calls of AxFunc() 
+                    in the steady state and each update is slower than the 
+                    GMRES method; see the benchmark krylov_recycling. This is 
+                    supported only by SolverType.MultipleShootingCGMRES and 
+                    ignored by the other solvers. The default is 0, i.e., the 
+                    GMRES method is used.
+        """
+        assert recycle_dim >= 0
+        self.__krylov_recycle_dim = recycle_dim
+
+    def set_block_tridiagonal_lu(self, update_period):
+        """ Sets whether the linear problem of the C/GMRES method is solved by 
+            the block-tridiagonal LU factorization of the Jacobian instead of 
+            the Krylov method. 
+
+            Args: 
+                update_period: If it is positive, setBlockTridiagonalLU() of 
+                    the solver is called in main.cpp and the Jacobian is 
+                    assembled by the forward difference with a number of 
+                    evaluations independent of N and refactorized every 
+                    update_period updates. This is supported only by 
+                    SolverType.UncondensedMSCGMRES and ignored by the other 
+                    solvers. The default is 0, i.e., the Krylov method is 
+                    used.
+        """
+        assert update_period >= 0
+        self.__block_tridiagonal_lu_update_period = update_period
+
+    def set_num_threads(self, num_threads, min_N=50):
+        """ Sets the number of the threads that evaluate the stages of the 
+            horizon in parallel in the multiple-shooting based C/GMRES 
+            solvers. 
+
+            Args: 
+                num_threads: The number of the threads. If it is larger than 
+                    one, setNumThreads() of the solver is called in main.cpp. 
+                    The solver clamps it to the number of the hardware 
+                    threads. The speedup depends on the CPU. Measure it with 
+                    benchmark/benchmark.py num_threads before enabling this. 
+                    The default is one. This is ignored by 
+                    SolverType.ContinuationGMRES. 
+                min_N: The threads are used only if N is greater than or 
+                    equal to this value because the synchronization of the 
+                    threads does not pay for short horizons. The default is 
+                    50.
+        """
+        assert num_threads > 0
+        assert min_N >= 0
+        self.__num_threads = num_threads
+        self.__min_N_for_threads = min_N
+
     def set_initialization_parameters(
             self, solution_initial_guess, newton_residual_torelance, 
             max_newton_iteration, initial_Lagrange_multiplier=None
@@ -313,7 +522,12 @@ class AutoGenU(object):
             saturation = [index, u_min, u_max, dummy_weight, quadratic_weight]
             self.__saturation_list.append(saturation)
 
-    def generate_source_files(self, use_simplification=False, use_cse=False):
+    def generate_source_files(
+            self, use_simplification=False, use_cse=False, 
+            use_symbolic_jvp=False, use_fused_hamiltonian=False, 
+            use_model_plugin=False, use_runtime_parameters=False, 
+            use_strength_reduction=False, use_inline_functions=False
+        ):
         """ Generates the C++ source file in which the equations to solve the 
             optimal control problem are described. Before call this method, 
             set_functions() must be called.
@@ -323,35 +537,238 @@ class AutoGenU(object):
                     Symbolic functions are simplified. Default is False.
                 use_cse: The flag for common subexpression elimination. If True, 
                     common subexpressions are eliminated. Default is False.
+                use_symbolic_jvp: The flag for the symbolic Jacobian-vector 
+                    products. If True, the Jacobian-vector product functions 
+                    of the equations are generated symbolically with the 
+                    common subexpression elimination and used for the exact 
+                    Jacobian-vector products of the solvers instead of the 
+                    equations instantiated for the dual numbers. The kernels 
+                    are used only if set_exact_jacobian_vector_product(True) 
+                    is called. The benchmark benchmark/benchmark.py 
+                    exact_jvp shows that the kernels are slower than the dual 
+                    numbers on the sample models. Default is False.
+                use_fused_hamiltonian: The flag for the fused evaluation of the 
+                    state equation and the partial derivatives of the 
+                    Hamiltonian. If True, hamiltonianDerivativesFunc() that 
+                    computes them with the common subexpressions shared is 
+                    generated and used at each stage of the horizon in the 
+                    multiple-shooting optimal control problems and in the 
+                    backward sweep of the single-shooting one. Since the 
+                    solvers evaluate hxFunc() of a stage at a different grid 
+                    point from stateFunc() and huFunc(), the function takes 
+                    the time of dH/dx separately as t_hx, so that it gives 
+                    the same results as the separate evaluation also for the 
+                    equations that depend on t. Default is False.
+                use_model_plugin: The flag for the model plugin. If True, the 
+                    model is generated in the plugin directory together with 
+                    nmpc_model_plugin.cpp that exports the equations by the C 
+                    ABI of model_plugin_abi.hpp, and generate_cmake() builds 
+                    them as a shared library. nmpc_model.hpp and 
+                    nmpc_model.cpp of the solvers then forward the equations 
+                    to the plugin loaded by ModelPlugin at startup, so that 
+                    changes of the parameters and the equations only need 
+                    the plugin to be rebuilt as long as the dimensions are 
+                    unchanged. use_fused_hamiltonian is ignored. Default is 
+                    False.
+                use_runtime_parameters: The flag for the runtime parameters. 
+                    If True, the scalar and array variables are generated as 
+                    the members of NMPCModel::Parameters instead of the 
+                    compile-time constants, and can be changed at runtime by 
+                    setParameters() of the solvers, which forward them to 
+                    their NMPCModel objects. Each NMPCModel has its own 
+                    parameters and a second slot that setParameters() 
+                    writes and syncParameters() copies into the parameters 
+                    read by the equations. The solvers call 
+                    syncParameters() once per control update, so that the 
+                    equations read the plain members. Cannot be used with 
+                    use_model_plugin. Default is False.
+                use_strength_reduction: The flag for the strength reduction 
+                    of the generated code. If True, the integer powers up to 
+                    4 and the half-integer powers of symbols are written as 
+                    multiplications, sin and cos of the same argument are 
+                    computed at once by sincos(), and the subexpressions 
+                    that consist only of the parameters are computed once 
+                    in advance: in the constructor of NMPCModel, or in 
+                    setParameters() if use_runtime_parameters is True. 
+                    Without use_runtime_parameters, only the subexpressions 
+                    containing the array variables are hoisted because the 
+                    compiler folds those of the scalar variables. Default is 
+                    False.
+                use_inline_functions: The flag for the inline equations. If 
+                    True, the equations are defined as inline functions in 
+                    nmpc_model.hpp with the __restrict-qualified pointers 
+                    instead of in nmpc_model.cpp, so that the compiler can 
+                    inline them into the loops over the stages of the solvers 
+                    and vectorize them. Default is False.
         """
         assert self.__is_function_set, "Symbolic functions are not set!. Before call this method, call set_functions()"
         if self.__dimh > 0:
             assert self.__is_FB_epsilon_set, "FB epsilons are not set!"
             assert len(self.__FB_epsilon) == self.__dimh
+        assert not (use_model_plugin and use_runtime_parameters), "use_model_plugin and use_runtime_parameters cannot be used together!"
         self.__make_model_dir()
+        self.__use_model_plugin = use_model_plugin
+        self.__use_runtime_parameters = use_runtime_parameters
+        self.__use_strength_reduction = use_strength_reduction
+        model_dir = 'models/'+self.__model_name
+        model_namespace = self.__model_namespace
+        if use_model_plugin:
+            # The namespace of the model in the plugin differs from that of 
+            # the forwarding NMPCModel so that their symbols do not clash.
+            model_dir = model_dir+'/plugin'
+            model_namespace = model_namespace+'_plugin'
+            use_fused_hamiltonian = False
+            self.__make_model_dir('plugin')
         if use_simplification:
             symfunc.simplify(self.__f)
             symfunc.simplify(self.__hx)
             symfunc.simplify(self.__hu)
             symfunc.simplify(self.__phix)
-        f_model_h = open('models/'+str(self.__model_name)+'/nmpc_model.hpp', 'w')
+        if use_symbolic_jvp:
+            dimuc = self.__dimu + self.__dimc + self.__dimh
+            x = sympy.symbols('x[0:%d]' %(self.__dimx))
+            u = sympy.symbols('u[0:%d]' %(dimuc))
+            lmd = sympy.symbols('lmd[0:%d]' %(self.__dimx))
+            x_dir = sympy.symbols('x_dir[0:%d]' %(self.__dimx))
+            u_dir = sympy.symbols('u_dir[0:%d]' %(dimuc))
+            lmd_dir = sympy.symbols('lmd_dir[0:%d]' %(self.__dimx))
+            f_jvp = symfunc.directional_derivative(
+                self.__f, [x, u], [x_dir, u_dir]
+            )
+            phix_jvp = symfunc.directional_derivative(
+                self.__phix, [x], [x_dir]
+            )
+            hx_jvp = symfunc.directional_derivative(
+                self.__hx, [x, u, lmd], [x_dir, u_dir, lmd_dir]
+            )
+            hu_jvp = symfunc.directional_derivative(
+                self.__hu, [x, u, lmd], [x_dir, u_dir, lmd_dir]
+            )
+        f, phix, hx, hu = self.__f, self.__phix, self.__hx, self.__hu
+        constants = {}
+        if use_strength_reduction:
+            array_symbols = set(
+                var for array_var in self.__array_vars for var in array_var[0]
+            )
+            parameter_symbols = array_symbols | set(
+                scalar_var[0] for scalar_var in self.__scalar_vars
+            )
+            if use_runtime_parameters:
+                anchor_symbols = parameter_symbols
+                constant_name = 'constants'
+            else:
+                anchor_symbols = array_symbols
+                constant_name = 'constants_'
+            f, phix, hx, hu = [
+                symfunc.hoist_constant_subexpressions(
+                    func, parameter_symbols, anchor_symbols, constants, 
+                    constant_name
+                ) for func in [f, phix, hx, hu]
+            ]
+            if use_symbolic_jvp:
+                f_jvp, phix_jvp, hx_jvp, hu_jvp = [
+                    symfunc.hoist_constant_subexpressions(
+                        func, parameter_symbols, anchor_symbols, constants, 
+                        constant_name
+                    ) for func in [f_jvp, phix_jvp, hx_jvp, hu_jvp]
+                ]
+        # The include guard is named after the model so that the models of 
+        # different namespaces can be included in one translation unit.
+        include_guard = 'NMPC_MODEL_'+model_namespace.upper()+'_H'
+        f_model_h = open(model_dir+'/nmpc_model.hpp', 'w')
         f_model_h.writelines([
 """ 
-#ifndef NMPC_MODEL_H
-#define NMPC_MODEL_H
+#ifndef """+include_guard+"""
+#define """+include_guard+"""
 
 #define _USE_MATH_DEFINES
 
 #include <cmath>
+"""
+        ])
+        if use_runtime_parameters:
+            f_model_h.write('#include <atomic>\n')
+        if use_inline_functions:
+            f_model_h.write('\n#include "dual_number.hpp"\n')
+        f_model_h.writelines([
+"""
 
-
+// NMPCModel is declared in the namespace named after the model, 
+// cgmres::"""+model_namespace+""", and the solvers are templates on it, e.g., 
+// cgmres::MultipleShootingCGMRES<cgmres::"""+model_namespace+"""::NMPCModel>, so that 
+// the solvers of different models can share one binary. 
 namespace cgmres {
 
-// This class stores parameters of NMPC and equations of NMPC.
+"""
+        ])
+        if use_symbolic_jvp:
+            f_model_h.writelines([
+"""class Dual;
+
+"""
+            ])
+        f_model_h.writelines([
+"""namespace """+model_namespace+""" {
+
+"""
+        ])
+        if use_inline_functions:
+            location = 'this header'
+        else:
+            location = 'nmpc_model.cpp'
+        if use_symbolic_jvp:
+            f_model_h.writelines([
+"""// This class stores parameters of NMPC and equations of NMPC. The equations 
+// are templates with respect to the scalar type of the state, the control 
+// input, and the Lagrange multiplier. They are instantiated for double and 
+// specialized for Dual in """+location+""". The specialization for Dual 
+// computes the directional derivatives of the equations by the 
+// Jacobian-vector product functions, which are generated symbolically, for 
+// the exact Jacobian-vector products of the solvers.
+"""
+            ])
+        else:
+            f_model_h.writelines([
+"""// This class stores parameters of NMPC and equations of NMPC. The equations 
+// are templates with respect to the scalar type of the state, the control 
+// input, and the Lagrange multiplier. They are instantiated for double and 
+// Dual in """+location+""". The instantiation for Dual computes the 
+// directional derivatives of the equations for the exact Jacobian-vector 
+// products of the solvers.
+"""
+            ])
+        if use_runtime_parameters:
+            f_model_h.writelines([
+"""// The parameters of NMPC are the members of Parameters, which can be changed 
+// at runtime by setParameters() of each NMPCModel object and are copied into 
+// the parameters read by the equations by syncParameters().
 class NMPCModel {
+public:
+  // Parameters of NMPC that can be changed at runtime.
+  struct Parameters {
+"""
+            ])
+            f_model_h.writelines([
+                '    double '+scalar_var[1]+' = '+str(scalar_var[2])+';\n' 
+                for scalar_var in self.__scalar_vars
+            ])
+            f_model_h.writelines([
+                '    double '+array_var[1]+'['+str(len(array_var[0]))+'] = {'
+                +', '.join(str(value) for value in array_var[2])+'};\n' 
+                for array_var in self.__array_vars
+            ])
+            f_model_h.writelines([
+"""  };
+
 private:
 """
-        ])
+            ])
+        else:
+            f_model_h.writelines([
+"""class NMPCModel {
+private:
+"""
+            ])
         f_model_h.write(
             '  static constexpr int dim_state_ = '+str(self.__dimx)+';\n'
         )
@@ -364,18 +781,59 @@ private:
             +str(self.__dimc+self.__dimh)+';\n'
         )
         f_model_h.write('\n')
-        f_model_h.writelines([
-            '  static constexpr double '+scalar_var[1]+' = '
-            +str(scalar_var[2])+';\n' for scalar_var in self.__scalar_vars
-        ])
-        f_model_h.write('\n')
-        for array_var in self.__array_vars:
-            f_model_h.write(
-                '  double '+array_var[1]+'['+str(len(array_var[0]))+']'+' = {'
-            )
-            for i in range(len(array_var[0])-1):
-                f_model_h.write(str(array_var[2][i])+', ')
-            f_model_h.write(str(array_var[2][len(array_var[0])-1])+'};\n')
+        if use_runtime_parameters:
+            f_model_h.writelines([
+"""  // The parameters and the constant subexpressions of the equations 
+  // computed from them.
+  struct ParameterBlock {
+    Parameters parameters;
+"""
+            ])
+            if len(constants) > 0:
+                f_model_h.write(
+                    '    double constants['+str(len(constants))+'];\n'
+                )
+            f_model_h.writelines([
+"""  };
+
+  // The states of pending_parameters_. setParameters() takes the slot from 
+  // kParametersEmpty or kParametersReady, writes it in kParametersWriting, 
+  // and publishes it as kParametersReady. syncParameters() takes it from 
+  // kParametersReady, copies it in kParametersReading, and releases it as 
+  // kParametersEmpty.
+  enum {
+    kParametersEmpty, 
+    kParametersWriting, 
+    kParametersReady, 
+    kParametersReading
+  };
+
+  // The parameters read by the equations of this object.
+  ParameterBlock parameters_;
+
+  // The second slot, into which setParameters() writes the parameters and 
+  // from which syncParameters() copies them into parameters_, and its state.
+  ParameterBlock pending_parameters_;
+  std::atomic<int> pending_parameters_state_;
+
+  // Returns the parameter block of parameters.
+  static ParameterBlock makeParameterBlock(const Parameters& parameters);
+"""
+            ])
+        else:
+            f_model_h.writelines([
+                '  static constexpr double '+scalar_var[1]+' = '
+                +str(scalar_var[2])+';\n' for scalar_var in self.__scalar_vars
+            ])
+            f_model_h.write('\n')
+            for array_var in self.__array_vars:
+                f_model_h.write(
+                    '  double '+array_var[1]+'['+str(len(array_var[0]))+']'
+                    +' = {'
+                )
+                for i in range(len(array_var[0])-1):
+                    f_model_h.write(str(array_var[2][i])+', ')
+                f_model_h.write(str(array_var[2][len(array_var[0])-1])+'};\n')
         if self.__dimh > 0:
             f_model_h.write(
                 '  double fb_eps['+str(self.__dimh)+']'+' = {'
@@ -383,25 +841,48 @@ private:
             for i in range(self.__dimh-1):
                 f_model_h.write(str(self.__FB_epsilon[i])+', ')
             f_model_h.write(str(self.__FB_epsilon[self.__dimh-1])+'};\n')
+        if not use_runtime_parameters and len(constants) > 0:
+            f_model_h.writelines([
+                '\n'
+                '  // The constant subexpressions of the equations.\n'
+                '  double constants_['+str(len(constants))+'];\n'
+            ])
         f_model_h.writelines([
 """
 
 public:
-
+"""
+        ])
+        if use_runtime_parameters:
+            f_model_h.writelines([
+"""  // Sets the default values of Parameters.
+  NMPCModel();
+"""
+            ])
+        if not use_runtime_parameters and len(constants) > 0:
+            f_model_h.writelines([
+"""  // Computes the constant subexpressions of the equations.
+  NMPCModel();
+"""
+            ])
+        f_model_h.writelines([
+"""
   // Computes the state equation f(t, x, u).
   // t : time parameter
   // x : state vector
   // u : control input vector
   // f : the value of f(t, x, u)
-  void stateFunc(const double t, const double* x, const double* u, 
-                 double* dx) const;
+  template <typename Scalar>
+  void stateFunc(const double t, const Scalar* x, const Scalar* u, 
+                 Scalar* dx) const;
 
   // Computes the partial derivative of terminal cost with respect to state, 
   // i.e., dphi/dx(t, x).
   // t    : time parameter
   // x    : state vector
   // phix : the value of dphi/dx(t, x)
-  void phixFunc(const double t, const double* x, double* phix) const;
+  template <typename Scalar>
+  void phixFunc(const double t, const Scalar* x, Scalar* phix) const;
 
   // Computes the partial derivative of the Hamiltonian with respect to state, 
   // i.e., dH/dx(t, x, u, lmd).
@@ -410,8 +891,9 @@ public:
   // u   : control input vector
   // lmd : the Lagrange multiplier for the state equation
   // hx  : the value of dH/dx(t, x, u, lmd)
-  void hxFunc(const double t, const double* x, const double* u, 
-              const double* lmd, double* hx) const;
+  template <typename Scalar>
+  void hxFunc(const double t, const Scalar* x, const Scalar* u, 
+              const Scalar* lmd, Scalar* hx) const;
 
   // Computes the partial derivative of the Hamiltonian with respect to control 
   // input and the constraints, dH/du(t, x, u, lmd).
@@ -420,86 +902,517 @@ public:
   // u   : control input vector
   // lmd : the Lagrange multiplier for the state equation
   // hu  : the value of dH/du(t, x, u, lmd)
-  void huFunc(const double t, const double* x, const double* u, 
-              const double* lmd, double* hu) const;
+  template <typename Scalar>
+  void huFunc(const double t, const Scalar* x, const Scalar* u, 
+              const Scalar* lmd, Scalar* hu) const;
 
-  // Returns the dimension of the state.
-  int dim_state() const;
+"""
+        ])
+        if use_fused_hamiltonian:
+            f_model_h.writelines([
+"""  // Computes the state equation f(t, x, u) and the partial derivatives of 
+  // the Hamiltonian dH/dx(t_hx, x, u, lmd) and dH/du(t, x, u, lmd) at once. 
+  // The common subexpressions among them, e.g., the trigonometric functions 
+  // of the state, are computed only once.
+  // t    : time parameter of f and dH/du
+  // t_hx : time parameter of dH/dx
+  // x    : state vector
+  // u    : control input vector
+  // lmd  : the Lagrange multiplier for the state equation
+  // dx   : the value of f(t, x, u)
+  // hx   : the value of dH/dx(t_hx, x, u, lmd)
+  // hu   : the value of dH/du(t, x, u, lmd)
+  void hamiltonianDerivativesFunc(const double t, const double t_hx, 
+                                  const double* x, const double* u, 
+                                  const double* lmd, double* dx, double* hx, 
+                                  double* hu) const;
+
+"""
+            ])
+        if use_symbolic_jvp:
+            f_model_h.writelines([
+"""  // Computes the state equation f(t, x, u) and its directional derivative, 
+  // i.e., the Jacobian-vector product df/dx(t, x, u) * x_dir 
+  // + df/du(t, x, u) * u_dir. The common subexpressions of them are shared.
+  // t      : time parameter
+  // x      : state vector
+  // u      : control input vector
+  // x_dir  : direction of the state vector
+  // u_dir  : direction of the control input vector
+  // dx     : the value of f(t, x, u)
+  // dx_dir : the value of the directional derivative
+  void stateFuncJvp(const double t, const double* x, const double* u, 
+                    const double* x_dir, const double* u_dir, double* dx, 
+                    double* dx_dir) const;
+
+  // Computes dphi/dx(t, x) and its directional derivative 
+  // d^2phi/dx^2(t, x) * x_dir.
+  // t        : time parameter
+  // x        : state vector
+  // x_dir    : direction of the state vector
+  // phix     : the value of dphi/dx(t, x)
+  // phix_dir : the value of the directional derivative
+  void phixFuncJvp(const double t, const double* x, const double* x_dir, 
+                   double* phix, double* phix_dir) const;
+
+  // Computes dH/dx(t, x, u, lmd) and its directional derivative along 
+  // (x_dir, u_dir, lmd_dir).
+  // t       : time parameter
+  // x       : state vector
+  // u       : control input vector
+  // lmd     : the Lagrange multiplier for the state equation
+  // x_dir   : direction of the state vector
+  // u_dir   : direction of the control input vector
+  // lmd_dir : direction of the Lagrange multiplier
+  // hx      : the value of dH/dx(t, x, u, lmd)
+  // hx_dir  : the value of the directional derivative
+  void hxFuncJvp(const double t, const double* x, const double* u, 
+                 const double* lmd, const double* x_dir, 
+                 const double* u_dir, const double* lmd_dir, double* hx, 
+                 double* hx_dir) const;
+
+  // Computes dH/du(t, x, u, lmd) and its directional derivative along 
+  // (x_dir, u_dir, lmd_dir).
+  // t       : time parameter
+  // x       : state vector
+  // u       : control input vector
+  // lmd     : the Lagrange multiplier for the state equation
+  // x_dir   : direction of the state vector
+  // u_dir   : direction of the control input vector
+  // lmd_dir : direction of the Lagrange multiplier
+  // hu      : the value of dH/du(t, x, u, lmd)
+  // hu_dir  : the value of the directional derivative
+  void huFuncJvp(const double t, const double* x, const double* u, 
+                 const double* lmd, const double* x_dir, 
+                 const double* u_dir, const double* lmd_dir, double* hu, 
+                 double* hu_dir) const;
+
+"""
+            ])
+        if use_runtime_parameters:
+            f_model_h.writelines([
+"""  // Sets the parameters of this object. The equations use them after the 
+  // next call of syncParameters(). This can be called at any time and from 
+  // any thread, also while the equations are evaluated. If several calls 
+  // precede syncParameters(), the last one is used. This only waits while 
+  // syncParameters() copies the previous parameters.
+  void setParameters(const Parameters& parameters);
+
+  // Returns the parameters currently used by the equations of this object.
+  Parameters getParameters() const;
+
+  // Copies the parameters written by the latest setParameters() into the 
+  // parameters used by the equations if they have not been copied yet. The 
+  // solvers call this once at the beginning of each control update, and it 
+  // must not be called while the equations of this object are evaluated. 
+  // This never waits: parameters that setParameters() is still writing are 
+  // copied at the next call.
+  void syncParameters();
+
+"""
+            ])
+        f_model_h.writelines([
+"""  // Returns the dimension of the state. The dimensions are compile-time 
+  // constants so that the solvers compiled with this model can size the 
+  // loops and the work vectors of a stage statically.
+  static constexpr int dim_state() {
+    return dim_state_;
+  }
 
   // Returns the dimension of the contorl input.
-  int dim_control_input() const;
+  static constexpr int dim_control_input() {
+    return dim_control_input_;
+  }
 
   // Returns the dimension of the constraints.
-  int dim_constraints() const;
+  static constexpr int dim_constraints() {
+    return dim_constraints_;
+  }
 };
 
+"""
+        ])
+        if use_symbolic_jvp:
+            f_model_h.writelines([
+"""template <>
+void NMPCModel::stateFunc<Dual>(const double t, const Dual* x, const Dual* u, 
+                                Dual* dx) const;
+
+template <>
+void NMPCModel::phixFunc<Dual>(const double t, const Dual* x, 
+                               Dual* phix) const;
+
+template <>
+void NMPCModel::hxFunc<Dual>(const double t, const Dual* x, const Dual* u, 
+                             const Dual* lmd, Dual* hx) const;
+
+template <>
+void NMPCModel::huFunc<Dual>(const double t, const Dual* x, const Dual* u, 
+                             const Dual* lmd, Dual* hu) const;
+
+"""
+            ])
+        if not use_inline_functions:
+            f_model_h.writelines([
+"""} // namespace """+model_namespace+"""
+
 } // namespace cgmres
 
 
-#endif // NMPC_MODEL_H
+#endif // """+include_guard+"""
 """ 
-        ])
-        f_model_h.close()
-        f_model_c = open('models/'+self.__model_name+'/nmpc_model.cpp', 'w')
+            ])
+            f_model_h.close()
+        f_model_c = open(model_dir+'/nmpc_model.cpp', 'w')
+        f_model_c.write(' \n')
+        if use_runtime_parameters:
+            f_model_c.write('#include <thread>\n\n')
         f_model_c.writelines([
-""" 
-#include "nmpc_model.hpp"
+"""#include "nmpc_model.hpp"
+#include "dual_number.hpp"
 
 
 namespace cgmres {
+namespace """+model_namespace+""" {
+
+"""
+        ])
+        if use_runtime_parameters:
+            f_model_c.writelines([
+"""NMPCModel::NMPCModel() 
+  : parameters_(makeParameterBlock(Parameters())), 
+    pending_parameters_(parameters_), 
+    pending_parameters_state_(kParametersEmpty) {
+}
+
+NMPCModel::ParameterBlock NMPCModel::makeParameterBlock(
+    const Parameters& parameters) {
+  ParameterBlock parameter_block;
+  parameter_block.parameters = parameters;
+"""
+            ])
+            self.__write_constants(
+                f_model_c, constants, 'parameters.', 'parameter_block.'
+            )
+            f_model_c.writelines([
+"""  return parameter_block;
+}
+
+void NMPCModel::setParameters(const Parameters& parameters) {
+  const ParameterBlock parameter_block = makeParameterBlock(parameters);
+  int state = pending_parameters_state_.load(std::memory_order_relaxed);
+  while (true) {
+    if (state == kParametersWriting || state == kParametersReading) {
+      std::this_thread::yield();
+      state = pending_parameters_state_.load(std::memory_order_relaxed);
+    }
+    else if (pending_parameters_state_.compare_exchange_weak(
+                 state, kParametersWriting, std::memory_order_acquire, 
+                 std::memory_order_relaxed)) {
+      break;
+    }
+  }
+  pending_parameters_ = parameter_block;
+  pending_parameters_state_.store(kParametersReady, std::memory_order_release);
+}
+
+NMPCModel::Parameters NMPCModel::getParameters() const {
+  return parameters_.parameters;
+}
 
-void NMPCModel::stateFunc(const double t, const double* x, const double* u, 
-                          double* dx) const {
+void NMPCModel::syncParameters() {
+  int state = kParametersReady;
+  if (pending_parameters_state_.load(std::memory_order_relaxed) 
+          != kParametersReady 
+      || !pending_parameters_state_.compare_exchange_strong(
+             state, kParametersReading, std::memory_order_acquire, 
+             std::memory_order_relaxed)) {
+    return;
+  }
+  parameters_ = pending_parameters_;
+  pending_parameters_state_.store(kParametersEmpty, std::memory_order_release);
+}
+
+"""
+            ])
+        # The definitions of the equations are written into f_model_func, 
+        # which is moved to nmpc_model.hpp if use_inline_functions is True.
+        if use_inline_functions:
+            f_model_func = io.StringIO()
+        else:
+            f_model_func = f_model_c
+        if not use_runtime_parameters and len(constants) > 0:
+            f_model_func.write('NMPCModel::NMPCModel() {\n')
+            self.__write_constants(f_model_func, constants, '', '')
+            f_model_func.write('}\n\n')
+        f_model_func.writelines([
+"""template <typename Scalar>
+void NMPCModel::stateFunc(const double t, const Scalar* x, const Scalar* u, 
+                          Scalar* dx) const {
 """ 
         ])
-        self.__write_function(f_model_c, self.__f, 'dx', use_cse)
-        f_model_c.writelines([
+        self.__write_function(f_model_func, f, 'dx', use_cse)
+        f_model_func.writelines([
 """ 
 }
 
-void NMPCModel::phixFunc(const double t, const double* x, double* phix) const {
+template <typename Scalar>
+void NMPCModel::phixFunc(const double t, const Scalar* x, Scalar* phix) const {
 """
         ])
-        self.__write_function(f_model_c, self.__phix, 'phix', use_cse)
-        f_model_c.writelines([
+        self.__write_function(f_model_func, phix, 'phix', use_cse)
+        f_model_func.writelines([
 """ 
 }
 
-void NMPCModel::hxFunc(const double t, const double* x, const double* u, 
-                       const double* lmd, double* hx) const {
+template <typename Scalar>
+void NMPCModel::hxFunc(const double t, const Scalar* x, const Scalar* u, 
+                       const Scalar* lmd, Scalar* hx) const {
 """
         ])
-        self.__write_function(f_model_c, self.__hx, 'hx', use_cse)
-        f_model_c.writelines([
+        self.__write_function(f_model_func, hx, 'hx', use_cse)
+        f_model_func.writelines([
 """ 
 }
 
-void NMPCModel::huFunc(const double t, const double* x, const double* u, 
-                       const double* lmd, double* hu) const {
+template <typename Scalar>
+void NMPCModel::huFunc(const double t, const Scalar* x, const Scalar* u, 
+                       const Scalar* lmd, Scalar* hu) const {
 """
         ])
-        self.__write_function(f_model_c, self.__hu, 'hu', use_cse)
-        f_model_c.writelines([
+        self.__write_function(f_model_func, hu, 'hu', use_cse)
+        f_model_func.writelines([
+"""
+}
+
+"""
+        ])
+        if use_fused_hamiltonian:
+            f_model_func.writelines([
+"""void NMPCModel::hamiltonianDerivativesFunc(const double t, const double t_hx, 
+                                           const double* x, const double* u, 
+                                           const double* lmd, double* dx, 
+                                           double* hx, double* hu) const {
+"""
+            ])
+            # dH/dx is evaluated at its own time t_hx.
+            hx_fused = [
+                sympy.sympify(func).xreplace(
+                    {sympy.Symbol('t'): sympy.Symbol('t_hx')}
+                ) 
+                for func in hx
+            ]
+            self.__write_function(
+                f_model_func, [f, hx_fused, hu], 
+                ['dx', 'hx', 'hu'], True, 'double'
+            )
+            f_model_func.writelines([
+"""
+}
+
+"""
+            ])
+        if use_symbolic_jvp:
+            f_model_func.writelines([
+"""void NMPCModel::stateFuncJvp(const double t, const double* x, const double* u, 
+                             const double* x_dir, const double* u_dir, 
+                             double* dx, double* dx_dir) const {
+"""
+            ])
+            self.__write_function(
+                f_model_func, [f, f_jvp], ['dx', 'dx_dir'], True, 'double'
+            )
+            f_model_func.writelines([
+""" 
+}
+
+void NMPCModel::phixFuncJvp(const double t, const double* x, 
+                            const double* x_dir, double* phix, 
+                            double* phix_dir) const {
+"""
+            ])
+            self.__write_function(
+                f_model_func, [phix, phix_jvp], ['phix', 'phix_dir'], 
+                True, 'double'
+            )
+            f_model_func.writelines([
+""" 
+}
+
+void NMPCModel::hxFuncJvp(const double t, const double* x, const double* u, 
+                          const double* lmd, const double* x_dir, 
+                          const double* u_dir, const double* lmd_dir, 
+                          double* hx, double* hx_dir) const {
+"""
+            ])
+            self.__write_function(
+                f_model_func, [hx, hx_jvp], ['hx', 'hx_dir'], True, 
+                'double'
+            )
+            f_model_func.writelines([
+""" 
+}
+
+void NMPCModel::huFuncJvp(const double t, const double* x, const double* u, 
+                          const double* lmd, const double* x_dir, 
+                          const double* u_dir, const double* lmd_dir, 
+                          double* hu, double* hu_dir) const {
+"""
+            ])
+            self.__write_function(
+                f_model_func, [hu, hu_jvp], ['hu', 'hu_dir'], True, 
+                'double'
+            )
+            f_model_func.writelines([
+"""
+}
+
+"""
+            ])
+        # The templates defined in the header are instantiated implicitly.
+        if not use_inline_functions:
+            f_model_func.writelines([
+"""template void NMPCModel::stateFunc<double>(const double t, const double* x, 
+                                           const double* u, 
+                                           double* dx) const;
+template void NMPCModel::phixFunc<double>(const double t, const double* x, 
+                                          double* phix) const;
+template void NMPCModel::hxFunc<double>(const double t, const double* x, 
+                                        const double* u, const double* lmd, 
+                                        double* hx) const;
+template void NMPCModel::huFunc<double>(const double t, const double* x, 
+                                        const double* u, const double* lmd, 
+                                        double* hu) const;
+
 """
+            ])
+        if use_symbolic_jvp:
+            f_model_func.writelines([
+"""// The dual numbers are split into the values and the derivatives, and the 
+// equations and their derivatives are computed by the Jacobian-vector 
+// product functions.
+template <>
+void NMPCModel::stateFunc<Dual>(const double t, const Dual* x, const Dual* u, 
+                                Dual* dx) const {
+  constexpr int dim_u = dim_control_input_ + dim_constraints_;
+  double x_val[dim_state_], x_dir[dim_state_], u_val[dim_u], u_dir[dim_u], 
+      dx_val[dim_state_], dx_dir[dim_state_];
+  for (int i=0; i<dim_state_; ++i) {
+    x_val[i] = x[i].value();
+    x_dir[i] = x[i].derivative();
+  }
+  for (int i=0; i<dim_u; ++i) {
+    u_val[i] = u[i].value();
+    u_dir[i] = u[i].derivative();
+  }
+  stateFuncJvp(t, x_val, u_val, x_dir, u_dir, dx_val, dx_dir);
+  for (int i=0; i<dim_state_; ++i) {
+    dx[i] = Dual(dx_val[i], dx_dir[i]);
+  }
 }
 
-int NMPCModel::dim_state() const {
-  return dim_state_;
+template <>
+void NMPCModel::phixFunc<Dual>(const double t, const Dual* x, 
+                               Dual* phix) const {
+  double x_val[dim_state_], x_dir[dim_state_], phix_val[dim_state_], 
+      phix_dir[dim_state_];
+  for (int i=0; i<dim_state_; ++i) {
+    x_val[i] = x[i].value();
+    x_dir[i] = x[i].derivative();
+  }
+  phixFuncJvp(t, x_val, x_dir, phix_val, phix_dir);
+  for (int i=0; i<dim_state_; ++i) {
+    phix[i] = Dual(phix_val[i], phix_dir[i]);
+  }
 }
 
-int NMPCModel::dim_control_input() const {
-  return dim_control_input_;
+template <>
+void NMPCModel::hxFunc<Dual>(const double t, const Dual* x, const Dual* u, 
+                             const Dual* lmd, Dual* hx) const {
+  constexpr int dim_u = dim_control_input_ + dim_constraints_;
+  double x_val[dim_state_], x_dir[dim_state_], u_val[dim_u], u_dir[dim_u], 
+      lmd_val[dim_state_], lmd_dir[dim_state_], hx_val[dim_state_], 
+      hx_dir[dim_state_];
+  for (int i=0; i<dim_state_; ++i) {
+    x_val[i] = x[i].value();
+    x_dir[i] = x[i].derivative();
+    lmd_val[i] = lmd[i].value();
+    lmd_dir[i] = lmd[i].derivative();
+  }
+  for (int i=0; i<dim_u; ++i) {
+    u_val[i] = u[i].value();
+    u_dir[i] = u[i].derivative();
+  }
+  hxFuncJvp(t, x_val, u_val, lmd_val, x_dir, u_dir, lmd_dir, hx_val, 
+            hx_dir);
+  for (int i=0; i<dim_state_; ++i) {
+    hx[i] = Dual(hx_val[i], hx_dir[i]);
+  }
 }
 
-int NMPCModel::dim_constraints() const {
-  return dim_constraints_;
+template <>
+void NMPCModel::huFunc<Dual>(const double t, const Dual* x, const Dual* u, 
+                             const Dual* lmd, Dual* hu) const {
+  constexpr int dim_u = dim_control_input_ + dim_constraints_;
+  double x_val[dim_state_], x_dir[dim_state_], u_val[dim_u], u_dir[dim_u], 
+      lmd_val[dim_state_], lmd_dir[dim_state_], hu_val[dim_u], hu_dir[dim_u];
+  for (int i=0; i<dim_state_; ++i) {
+    x_val[i] = x[i].value();
+    x_dir[i] = x[i].derivative();
+    lmd_val[i] = lmd[i].value();
+    lmd_dir[i] = lmd[i].derivative();
+  }
+  for (int i=0; i<dim_u; ++i) {
+    u_val[i] = u[i].value();
+    u_dir[i] = u[i].derivative();
+  }
+  huFuncJvp(t, x_val, u_val, lmd_val, x_dir, u_dir, lmd_dir, hu_val, 
+            hu_dir);
+  for (int i=0; i<dim_u; ++i) {
+    hu[i] = Dual(hu_val[i], hu_dir[i]);
+  }
 }
 
+"""
+            ])
+        elif not use_inline_functions:
+            f_model_func.writelines([
+"""template void NMPCModel::stateFunc<Dual>(const double t, const Dual* x, 
+                                         const Dual* u, Dual* dx) const;
+template void NMPCModel::phixFunc<Dual>(const double t, const Dual* x, 
+                                        Dual* phix) const;
+template void NMPCModel::hxFunc<Dual>(const double t, const Dual* x, 
+                                      const Dual* u, const Dual* lmd, 
+                                      Dual* hx) const;
+template void NMPCModel::huFunc<Dual>(const double t, const Dual* x, 
+                                      const Dual* u, const Dual* lmd, 
+                                      Dual* hu) const;
+
+"""
+            ])
+        if use_inline_functions:
+            f_model_h.write(
+                self.__inline_definitions(f_model_func.getvalue())
+            )
+            f_model_h.writelines([
+"""} // namespace """+model_namespace+"""
+
+} // namespace cgmres
+
+
+#endif // """+include_guard+"""
+""" 
+            ])
+            f_model_h.close()
+        f_model_c.writelines([
+"""} // namespace """+model_namespace+"""
 } // namespace cgmres
 
 """ 
         ])
         f_model_c.close() 
+        if use_model_plugin:
+            self.__generate_model_plugin()
 
     def generate_main(self):
         """ Generates main.cpp that defines NMPC solver, set parameters for the 
@@ -512,8 +1425,20 @@ int NMPCModel::dim_constraints() const {
         assert self.__is_solver_paramters_set, "Solver parameters are not set! Before call this method, call set_solver_parameters()"
         assert self.__is_initialization_set, "Initialization parameters are not set! Before call this method, call set_initialization_parameters()"
         assert self.__is_simulation_set, "Simulation parameters are not set! Before call this method, call set_simulation_parameters()"
+        if (self.__solver_type == SolverType.UncondensedMSCGMRES
+            and self.__block_tridiagonal_lu_update_period == 0):
+            dim_stage = (self.__dimu + self.__dimc + self.__dimh 
+                         + 2 * self.__dimx)
+            min_kmax = (3 * dim_stage + 1) // 2
+            assert self.__kmax >= min_kmax, "kmax of UncondensedMSCGMRES must be at least "+str(min_kmax)+" = 1.5*(dimu+dimc+dimh+2*dimx) or the GMRES method diverges! Raise kmax in set_solver_parameters() or call set_block_tridiagonal_lu()"
         """ Makes a directory where the C++ source files are generated.
         """
+        use_dense_jacobian = (
+            (self.__solver_type == SolverType.ContinuationGMRES 
+             or self.__solver_type == SolverType.MultipleShootingCGMRES)
+            and self.__dense_jacobian_update_period > 0
+        )
+        model_type = 'cgmres::'+self.__model_namespace+'::NMPCModel'
         f_main = open('models/'+str(self.__model_name)+'/main.cpp', 'w')
         f_main.write('#include "nmpc_model.hpp"\n')
         if self.__solver_type == SolverType.ContinuationGMRES:
@@ -529,28 +1454,52 @@ int NMPCModel::dim_constraints() const {
                 '#include "input_saturation_set.hpp"\n'
                 '#include "ms_cgmres_with_input_saturation.hpp"\n'
             )
+        elif self.__solver_type == SolverType.UncondensedMSCGMRES:
+            f_main.write(
+                '#include "uncondensed_ms_cgmres.hpp"\n'
+            )
         f_main.write(
             '#include "cgmres_simulator.hpp"\n'
         )
+        if self.__use_model_plugin:
+            f_main.write('#include "model_plugin.hpp"\n')
         f_main.write('#include <string>\n')
+        if use_dense_jacobian:
+            f_main.write('#include <iostream>\n')
         f_main.write(
             '\n'
             'int main() {\n'
-            '  // Define the model in NMPC.\n'
-            '  cgmres::NMPCModel nmpc_model;\n'
-            '\n'
         )
+        if self.__use_model_plugin:
+            f_main.write(
+                '  // Load the equations of the model from the plugin.\n'
+                '  cgmres::ModelPlugin<'+model_type+'>::load('
+                'CGMRES_MODEL_PLUGIN_PATH);\n'
+                '\n'
+            )
+        else:
+            f_main.write(
+                '  // Define the model in NMPC.\n'
+                '  '+model_type+' nmpc_model;\n'
+                '\n'
+            )
         f_main.write('  // Define the solver.\n')
+        # The solver is sized by N and kmax at compile time if the fixed-size 
+        # storage is used.
+        solver_args = model_type
+        if self.__use_fixed_size_gmres:
+            solver_args += ', '+str(self.__N)+', '+str(self.__kmax)
         if self.__solver_type == SolverType.ContinuationGMRES:
             f_main.write(
-                '  cgmres::ContinuationGMRES nmpc_solver('+str(self.__T_f)+', '
+                '  cgmres::ContinuationGMRES<'+solver_args+'> nmpc_solver('
+                +str(self.__T_f)+', '
                 +str(self.__alpha)+', '+str(self.__N)+', '
                 +str(self.__finite_difference_increment)+', '+str(self.__zeta)
                 +', ' +str(self.__kmax)+');\n'
             )
         elif self.__solver_type == SolverType.MultipleShootingCGMRES:
             f_main.write(
-                '  cgmres::MultipleShootingCGMRES nmpc_solver('
+                '  cgmres::MultipleShootingCGMRES<'+solver_args+'> nmpc_solver('
                 +str(self.__T_f) +', '+str(self.__alpha)+', '+str(self.__N)+', '
                 +str(self.__finite_difference_increment)+', '+str(self.__zeta)
                 +', '+str(self.__kmax)+');\n'
@@ -568,12 +1517,19 @@ int NMPCModel::dim_constraints() const {
                     +str(self.__saturation_list[i][4])+');\n'
                 )
             f_main.write(
-                '  cgmres::MSCGMRESWithInputSaturation '
+                '  cgmres::MSCGMRESWithInputSaturation<'+solver_args+'> '
                 'nmpc_solver(input_saturation_set, '
                 +str(self.__T_f)+', '+str(self.__alpha)+', '+str(self.__N)+', '
                 +str(self.__finite_difference_increment)+', '+str(self.__zeta)
                 +', '+str(self.__kmax)+');\n'
             )
+        elif self.__solver_type == SolverType.UncondensedMSCGMRES:
+            f_main.write(
+                '  cgmres::UncondensedMSCGMRES<'+solver_args+'> nmpc_solver('
+                +str(self.__T_f) +', '+str(self.__alpha)+', '+str(self.__N)+', '
+                +str(self.__finite_difference_increment)+', '+str(self.__zeta)
+                +', '+str(self.__kmax)+');\n'
+            )
         f_main.write('\n\n')
         f_main.write('  // Set the initial state.\n')
         f_main.write(
@@ -604,6 +1560,54 @@ int NMPCModel::dim_constraints() const {
             +str(self.__max_newton_iteration)+');\n'
         )
         f_main.write('\n')
+        if (self.__solver_type == SolverType.MultipleShootingCGMRES
+            and self.__use_riccati_recursion):
+            f_main.write(
+                '  // Solve the linear problem by the Riccati recursion.\n'
+                '  nmpc_solver.setRiccatiRecursion(true);\n'
+                '\n'
+            )
+        if (self.__solver_type != SolverType.UncondensedMSCGMRES
+            and self.__use_exact_jacobian_vector_product):
+            f_main.write(
+                '  // Compute the Jacobian-vector products exactly.\n'
+                '  nmpc_solver.setExactJacobianVectorProduct(true);\n'
+                '\n'
+            )
+        if use_dense_jacobian:
+            f_main.write(
+                '  // Solve the linear problem by the LU factorization of the '
+                'Jacobian.\n'
+                '  nmpc_solver.setDenseJacobian('
+                +str(self.__dense_jacobian_update_period)+', '
+                +str(self.__dense_jacobian_refresh_tolerance)+');\n'
+                '\n'
+            )
+        if (self.__solver_type == SolverType.MultipleShootingCGMRES
+            and self.__krylov_recycle_dim > 0):
+            f_main.write(
+                '  // Solve the linear problem by the GCRO-DR method.\n'
+                '  nmpc_solver.setKrylovRecycling('
+                +str(self.__krylov_recycle_dim)+');\n'
+                '\n'
+            )
+        if (self.__solver_type == SolverType.UncondensedMSCGMRES
+            and self.__block_tridiagonal_lu_update_period > 0):
+            f_main.write(
+                '  // Solve the linear problem by the block-tridiagonal LU '
+                'factorization.\n'
+                '  nmpc_solver.setBlockTridiagonalLU('
+                +str(self.__block_tridiagonal_lu_update_period)+');\n'
+                '\n'
+            )
+        if (self.__solver_type != SolverType.ContinuationGMRES 
+            and self.__num_threads > 1):
+            f_main.write(
+                '  // Evaluate the stages of the horizon in parallel.\n'
+                '  nmpc_solver.setNumThreads('+str(self.__num_threads)+', '
+                +str(self.__min_N_for_threads)+');\n'
+                '\n'
+            )
         if (self.__solver_type == SolverType.MSCGMRESWithInputSaturation
             and self.__initial_Lagrange_multiplier is not None):
             f_main.write(
@@ -637,6 +1641,17 @@ int NMPCModel::dim_constraints() const {
             +self.__model_name
             +'");\n'
             '\n'
+        )
+        if use_dense_jacobian:
+            f_main.write(
+                '  // Print how often the frozen Jacobian is refactorized.\n'
+                '  std::cout << "Number of the factorizations of the Jacobian: "'
+                '\n'
+                '            << nmpc_solver.getNumDenseJacobianFactorizations() '
+                '<< std::endl;\n'
+                '\n'
+            )
+        f_main.write(
             '  return 0;\n'
             '}\n'
         )
@@ -655,6 +1670,16 @@ project(cgmres_simulator CXX)
 set(CMAKE_CXX_STANDARD 11)
 set(CMAKE_CXX_FLAGS "-O3")
 
+# The kernels of the GMRES method select AVX-512 or AVX2 at runtime. 
+# -march=native also vectorizes the other loops for the host. It is opt-in 
+# because the binary may not run on other CPUs.
+option(CGMRES_NATIVE_ARCH "Compile for the instruction sets of the host" OFF)
+include(CheckCXXCompilerFlag)
+check_cxx_compiler_flag("-march=native" CGMRES_HAS_MARCH_NATIVE)
+if(CGMRES_NATIVE_ARCH AND CGMRES_HAS_MARCH_NATIVE)
+  set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -march=native")
+endif()
+
 set(MODEL_DIR ${PROJECT_SOURCE_DIR})
 set(INCLUDE_DIR ${PROJECT_SOURCE_DIR}/../../include/cgmres)
 set(SIMULATOR_INCLUDE_DIR ${PROJECT_SOURCE_DIR}/../../include/cgmres/simulator)
@@ -666,23 +1691,63 @@ add_library(
     STATIC
     ${MODEL_DIR}/nmpc_model.cpp
 )
+target_include_directories(
+    nmpcmodel
+    PRIVATE
+    ${INCLUDE_DIR}
+)
 
 """
         ])
+        if self.__use_model_plugin:
+            f_cmake.writelines([
+"""target_sources(
+    nmpcmodel
+    PRIVATE
+    ${SRC_DIR}/model_plugin.cpp
+)
+target_include_directories(
+    nmpcmodel
+    PRIVATE
+    ${MODEL_DIR}
+)
+target_link_libraries(
+    nmpcmodel
+    PUBLIC
+    ${CMAKE_DL_LIBS}
+)
+
+add_library(
+    nmpc_model_plugin 
+    SHARED
+    ${MODEL_DIR}/plugin/nmpc_model.cpp
+    ${MODEL_DIR}/plugin/nmpc_model_plugin.cpp
+)
+target_include_directories(
+    nmpc_model_plugin
+    PRIVATE
+    ${MODEL_DIR}/plugin
+    ${INCLUDE_DIR}
+)
+set_target_properties(
+    nmpc_model_plugin
+    PROPERTIES
+    CXX_VISIBILITY_PRESET hidden
+)
+
+"""
+            ])
         if self.__solver_type == SolverType.ContinuationGMRES:
             f_cmake.writelines([
 """
 add_library(
     cgmres
     STATIC
-    ${SRC_DIR}/continuation_gmres.cpp
-    ${SRC_DIR}/single_shooting_continuation.cpp
-    ${SRC_DIR}/single_shooting_ocp.cpp
     ${SRC_DIR}/time_varying_smooth_horizon.cpp
-    ${SRC_DIR}/cgmres_initializer.cpp
-    ${SRC_DIR}/zero_horizon_ocp.cpp
-    ${SRC_DIR}/optimal_control_problem.cpp
     ${SRC_DIR}/linear_algebra.cpp
+    ${SRC_DIR}/aligned_matrix.cpp
+    ${SRC_DIR}/block_jacobi_preconditioner.cpp
+    ${SRC_DIR}/minimal_residual_smoothing.cpp
 )
 target_include_directories(
     cgmres
@@ -698,14 +1763,13 @@ target_include_directories(
 add_library(
     multiple_shooting_cgmres
     STATIC
-    ${SRC_DIR}/multiple_shooting_cgmres.cpp
-    ${SRC_DIR}/multiple_shooting_continuation.cpp
-    ${SRC_DIR}/multiple_shooting_ocp.cpp
+    ${SRC_DIR}/riccati_recursion.cpp
+    ${SRC_DIR}/stage_thread_pool.cpp
     ${SRC_DIR}/time_varying_smooth_horizon.cpp
-    ${SRC_DIR}/cgmres_initializer.cpp
-    ${SRC_DIR}/zero_horizon_ocp.cpp
-    ${SRC_DIR}/optimal_control_problem.cpp
     ${SRC_DIR}/linear_algebra.cpp
+    ${SRC_DIR}/aligned_matrix.cpp
+    ${SRC_DIR}/block_jacobi_preconditioner.cpp
+    ${SRC_DIR}/minimal_residual_smoothing.cpp
 )
 target_include_directories(
     multiple_shooting_cgmres
@@ -713,6 +1777,12 @@ target_include_directories(
     ${MODEL_DIR}
     ${INCLUDE_DIR}
 )
+find_package(Threads REQUIRED)
+target_link_libraries(
+    multiple_shooting_cgmres
+    PUBLIC
+    Threads::Threads
+)
 """
             ])
         elif self.__solver_type == SolverType.MSCGMRESWithInputSaturation:
@@ -721,17 +1791,15 @@ target_include_directories(
 add_library(
     ms_cgmres_with_input_saturation
     STATIC
-    ${SRC_DIR}/ms_cgmres_with_input_saturation.cpp
-    ${SRC_DIR}/ms_continuation_with_input_saturation.cpp
-    ${SRC_DIR}/ms_ocp_with_input_saturation.cpp
+    ${SRC_DIR}/stage_thread_pool.cpp
     ${SRC_DIR}/time_varying_smooth_horizon.cpp
-    ${SRC_DIR}/ms_cgmres_with_input_saturation_initializer.cpp
-    ${SRC_DIR}/zero_horizon_ocp_with_input_saturation.cpp
     ${SRC_DIR}/input_saturation_functions.cpp
     ${SRC_DIR}/input_saturation_set.cpp
     ${SRC_DIR}/input_saturation.cpp
-    ${SRC_DIR}/optimal_control_problem.cpp
     ${SRC_DIR}/linear_algebra.cpp
+    ${SRC_DIR}/aligned_matrix.cpp
+    ${SRC_DIR}/block_jacobi_preconditioner.cpp
+    ${SRC_DIR}/minimal_residual_smoothing.cpp
 )
 target_include_directories(
     ms_cgmres_with_input_saturation
@@ -739,8 +1807,67 @@ target_include_directories(
     ${MODEL_DIR}
     ${INCLUDE_DIR}
 )
+find_package(Threads REQUIRED)
+target_link_libraries(
+    ms_cgmres_with_input_saturation
+    PUBLIC
+    Threads::Threads
+)
+"""
+            ])
+        elif self.__solver_type == SolverType.UncondensedMSCGMRES:
+            f_cmake.writelines([
+"""
+add_library(
+    uncondensed_ms_cgmres
+    STATIC
+    ${SRC_DIR}/shooting_chain_preconditioner.cpp
+    ${SRC_DIR}/block_tridiagonal_lu.cpp
+    ${SRC_DIR}/riccati_recursion.cpp
+    ${SRC_DIR}/stage_thread_pool.cpp
+    ${SRC_DIR}/time_varying_smooth_horizon.cpp
+    ${SRC_DIR}/linear_algebra.cpp
+    ${SRC_DIR}/aligned_matrix.cpp
+    ${SRC_DIR}/block_jacobi_preconditioner.cpp
+    ${SRC_DIR}/minimal_residual_smoothing.cpp
+)
+target_include_directories(
+    uncondensed_ms_cgmres
+    PRIVATE
+    ${MODEL_DIR}
+    ${INCLUDE_DIR}
+)
+find_package(Threads REQUIRED)
+target_link_libraries(
+    uncondensed_ms_cgmres
+    PUBLIC
+    Threads::Threads
+)
 """
             ])
+        # The definitions select the GMRES method of the solvers and are 
+        # PUBLIC so that main.cpp sees the same solver types as the library 
+        # while other targets, e.g., the solvers of another model in the same 
+        # project, are not affected.
+        definitions = []
+        if self.__use_single_precision_basis:
+            definitions.append('CGMRES_SINGLE_PRECISION_BASIS')
+        if len(definitions) > 0:
+            solver_library = {
+                SolverType.ContinuationGMRES: 'cgmres',
+                SolverType.MultipleShootingCGMRES: 'multiple_shooting_cgmres',
+                SolverType.MSCGMRESWithInputSaturation: 
+                    'ms_cgmres_with_input_saturation',
+                SolverType.UncondensedMSCGMRES: 'uncondensed_ms_cgmres'
+            }[self.__solver_type]
+            f_cmake.write(
+                'target_compile_definitions(\n'
+                '    '+solver_library+'\n'
+                '    PUBLIC\n'
+            )
+            for definition in definitions:
+                f_cmake.write('    '+definition+'\n')
+            f_cmake.write(')\n')
         if platform.system() == 'Windows':
             f_cmake.writelines([
 """
@@ -748,7 +1875,6 @@ add_executable(
     main 
     ${MODEL_DIR}/main.cpp
     ${SIMULATOR_SRC_DIR}/save_simulation_data.cpp
-    ${SIMULATOR_SRC_DIR}/numerical_integrator.cpp
 )
 target_include_directories(
     main
@@ -774,6 +1900,10 @@ target_link_libraries(
                 f_cmake.write(
                     '    ms_cgmres_with_input_saturation'
                 )
+            elif self.__solver_type == SolverType.UncondensedMSCGMRES:
+                f_cmake.write(
+                    '    uncondensed_ms_cgmres'
+                )
             f_cmake.writelines([
 """
     nmpcmodel
@@ -792,7 +1922,6 @@ add_executable(
     a.out 
     ${MODEL_DIR}/main.cpp
     ${SIMULATOR_SRC_DIR}/save_simulation_data.cpp
-    ${SIMULATOR_SRC_DIR}/numerical_integrator.cpp
 )
 target_include_directories(
     a.out
@@ -818,6 +1947,10 @@ target_link_libraries(
                 f_cmake.write(
                     '    ms_cgmres_with_input_saturation'
                 )
+            elif self.__solver_type == SolverType.UncondensedMSCGMRES:
+                f_cmake.write(
+                    '    uncondensed_ms_cgmres'
+                )
             f_cmake.writelines([
 """
     nmpcmodel
@@ -827,6 +1960,20 @@ target_compile_options(
     PRIVATE
     -O3
 )
+"""
+            ])
+        if self.__use_model_plugin:
+            executable = 'main' if platform.system() == 'Windows' else 'a.out'
+            f_cmake.writelines([
+"""add_dependencies(
+    """+executable+"""
+    nmpc_model_plugin
+)
+target_compile_definitions(
+    """+executable+"""
+    PRIVATE
+    CGMRES_MODEL_PLUGIN_PATH="$<TARGET_FILE:nmpc_model_plugin>"
+)
 """
             ])
         f_cmake.close()
@@ -992,8 +2139,409 @@ target_compile_options(
                 print(line.rstrip().decode("utf8"))
 
 
+    def __generate_model_plugin(self):
+        """ Generates nmpc_model_plugin.cpp that exports the equations of the 
+            model in the plugin directory by the C ABI, and nmpc_model.hpp and 
+            nmpc_model.cpp of the solvers that forward the equations to the 
+            plugin loaded by ModelPlugin.
+        """
+        f_plugin = open(
+            'models/'+self.__model_name+'/plugin/nmpc_model_plugin.cpp', 'w'
+        )
+        f_plugin.writelines([
+""" 
+#include "nmpc_model.hpp"
+#include "dual_number.hpp"
+#include "model_plugin_abi.hpp"
+
+
+namespace {
+
+using NMPCModel = cgmres::"""+self.__model_namespace+"""_plugin::NMPCModel;
+
+// The model whose equations are exported.
+NMPCModel model;
+
+constexpr int dim_state = NMPCModel::dim_state();
+constexpr int dim_u = NMPCModel::dim_control_input() 
+                      + NMPCModel::dim_constraints();
+
+} // namespace
+
+
+extern "C" {
+
+int cgmres_model_plugin_abi_version() {
+  return CGMRES_MODEL_PLUGIN_ABI_VERSION;
+}
+
+int cgmres_model_dim_state() {
+  return NMPCModel::dim_state();
+}
+
+int cgmres_model_dim_control_input() {
+  return NMPCModel::dim_control_input();
+}
+
+int cgmres_model_dim_constraints() {
+  return NMPCModel::dim_constraints();
+}
+
+void cgmres_model_state_func(const double t, const double* x, const double* u, 
+                             double* dx) {
+  model.stateFunc(t, x, u, dx);
+}
+
+void cgmres_model_phix_func(const double t, const double* x, double* phix) {
+  model.phixFunc(t, x, phix);
+}
+
+void cgmres_model_hx_func(const double t, const double* x, const double* u, 
+                          const double* lmd, double* hx) {
+  model.hxFunc(t, x, u, lmd, hx);
+}
+
+void cgmres_model_hu_func(const double t, const double* x, const double* u, 
+                          const double* lmd, double* hu) {
+  model.huFunc(t, x, u, lmd, hu);
+}
+
+// The directional derivatives are computed by the equations for Dual.
+void cgmres_model_state_func_jvp(const double t, const double* x, 
+                                 const double* u, const double* x_dir, 
+                                 const double* u_dir, double* dx, 
+                                 double* dx_dir) {
+  cgmres::Dual x_dual[dim_state], u_dual[dim_u], dx_dual[dim_state];
+  for (int i=0; i<dim_state; ++i) {
+    x_dual[i] = cgmres::Dual(x[i], x_dir[i]);
+  }
+  for (int i=0; i<dim_u; ++i) {
+    u_dual[i] = cgmres::Dual(u[i], u_dir[i]);
+  }
+  model.stateFunc(t, x_dual, u_dual, dx_dual);
+  for (int i=0; i<dim_state; ++i) {
+    dx[i] = dx_dual[i].value();
+    dx_dir[i] = dx_dual[i].derivative();
+  }
+}
+
+void cgmres_model_phix_func_jvp(const double t, const double* x, 
+                                const double* x_dir, double* phix, 
+                                double* phix_dir) {
+  cgmres::Dual x_dual[dim_state], phix_dual[dim_state];
+  for (int i=0; i<dim_state; ++i) {
+    x_dual[i] = cgmres::Dual(x[i], x_dir[i]);
+  }
+  model.phixFunc(t, x_dual, phix_dual);
+  for (int i=0; i<dim_state; ++i) {
+    phix[i] = phix_dual[i].value();
+    phix_dir[i] = phix_dual[i].derivative();
+  }
+}
+
+void cgmres_model_hx_func_jvp(const double t, const double* x, 
+                              const double* u, const double* lmd, 
+                              const double* x_dir, const double* u_dir, 
+                              const double* lmd_dir, double* hx, 
+                              double* hx_dir) {
+  cgmres::Dual x_dual[dim_state], u_dual[dim_u], lmd_dual[dim_state], 
+      hx_dual[dim_state];
+  for (int i=0; i<dim_state; ++i) {
+    x_dual[i] = cgmres::Dual(x[i], x_dir[i]);
+    lmd_dual[i] = cgmres::Dual(lmd[i], lmd_dir[i]);
+  }
+  for (int i=0; i<dim_u; ++i) {
+    u_dual[i] = cgmres::Dual(u[i], u_dir[i]);
+  }
+  model.hxFunc(t, x_dual, u_dual, lmd_dual, hx_dual);
+  for (int i=0; i<dim_state; ++i) {
+    hx[i] = hx_dual[i].value();
+    hx_dir[i] = hx_dual[i].derivative();
+  }
+}
+
+void cgmres_model_hu_func_jvp(const double t, const double* x, 
+                              const double* u, const double* lmd, 
+                              const double* x_dir, const double* u_dir, 
+                              const double* lmd_dir, double* hu, 
+                              double* hu_dir) {
+  cgmres::Dual x_dual[dim_state], u_dual[dim_u], lmd_dual[dim_state], 
+      hu_dual[dim_u];
+  for (int i=0; i<dim_state; ++i) {
+    x_dual[i] = cgmres::Dual(x[i], x_dir[i]);
+    lmd_dual[i] = cgmres::Dual(lmd[i], lmd_dir[i]);
+  }
+  for (int i=0; i<dim_u; ++i) {
+    u_dual[i] = cgmres::Dual(u[i], u_dir[i]);
+  }
+  model.huFunc(t, x_dual, u_dual, lmd_dual, hu_dual);
+  for (int i=0; i<dim_u; ++i) {
+    hu[i] = hu_dual[i].value();
+    hu_dir[i] = hu_dual[i].derivative();
+  }
+}
+
+} // extern "C"
+
+"""
+        ])
+        f_plugin.close()
+        include_guard = 'NMPC_MODEL_'+self.__model_namespace.upper()+'_H'
+        f_model_h = open('models/'+self.__model_name+'/nmpc_model.hpp', 'w')
+        f_model_h.writelines([
+""" 
+#ifndef """+include_guard+"""
+#define """+include_guard+"""
+
+
+// NMPCModel is declared in the namespace named after the model, 
+// cgmres::"""+self.__model_namespace+""", and the solvers are templates on it, e.g., 
+// cgmres::MultipleShootingCGMRES<cgmres::"""+self.__model_namespace+"""::NMPCModel>, so that 
+// the solvers of different models can share one binary. 
+namespace cgmres {
+
+class Dual;
+
+namespace """+self.__model_namespace+""" {
+
+// This class forwards the equations of NMPC to the model plugin loaded by 
+// ModelPlugin, which is built from the plugin directory. The parameters and 
+// the equations are described in plugin/nmpc_model.hpp and 
+// plugin/nmpc_model.cpp. The dimensions are the compile-time constants of 
+// the solvers and must be equal to those of the plugin. The equations are 
+// specialized for double and Dual in nmpc_model.cpp.
+class NMPCModel {
+private:
+"""
+        ])
+        f_model_h.write(
+            '  static constexpr int dim_state_ = '+str(self.__dimx)+';\n'
+        )
+        f_model_h.write(
+            '  static constexpr int dim_control_input_ = '
+            +str(self.__dimu)+';\n'
+        )
+        f_model_h.write(
+            '  static constexpr int dim_constraints_ = '
+            +str(self.__dimc+self.__dimh)+';\n'
+        )
+        f_model_h.writelines([
+"""
+public:
+  // Computes the state equation f(t, x, u).
+  template <typename Scalar>
+  void stateFunc(const double t, const Scalar* x, const Scalar* u, 
+                 Scalar* dx) const;
+
+  // Computes the partial derivative of terminal cost with respect to state, 
+  // i.e., dphi/dx(t, x).
+  template <typename Scalar>
+  void phixFunc(const double t, const Scalar* x, Scalar* phix) const;
+
+  // Computes the partial derivative of the Hamiltonian with respect to state, 
+  // i.e., dH/dx(t, x, u, lmd).
+  template <typename Scalar>
+  void hxFunc(const double t, const Scalar* x, const Scalar* u, 
+              const Scalar* lmd, Scalar* hx) const;
+
+  // Computes the partial derivative of the Hamiltonian with respect to control 
+  // input and the constraints, dH/du(t, x, u, lmd).
+  template <typename Scalar>
+  void huFunc(const double t, const Scalar* x, const Scalar* u, 
+              const Scalar* lmd, Scalar* hu) const;
+
+  // Returns the dimension of the state.
+  static constexpr int dim_state() {
+    return dim_state_;
+  }
+
+  // Returns the dimension of the contorl input.
+  static constexpr int dim_control_input() {
+    return dim_control_input_;
+  }
+
+  // Returns the dimension of the constraints.
+  static constexpr int dim_constraints() {
+    return dim_constraints_;
+  }
+};
+
+template <>
+void NMPCModel::stateFunc<double>(const double t, const double* x, 
+                                  const double* u, double* dx) const;
+
+template <>
+void NMPCModel::phixFunc<double>(const double t, const double* x, 
+                                 double* phix) const;
+
+template <>
+void NMPCModel::hxFunc<double>(const double t, const double* x, 
+                               const double* u, const double* lmd, 
+                               double* hx) const;
+
+template <>
+void NMPCModel::huFunc<double>(const double t, const double* x, 
+                               const double* u, const double* lmd, 
+                               double* hu) const;
+
+template <>
+void NMPCModel::stateFunc<Dual>(const double t, const Dual* x, const Dual* u, 
+                                Dual* dx) const;
+
+template <>
+void NMPCModel::phixFunc<Dual>(const double t, const Dual* x, 
+                               Dual* phix) const;
+
+template <>
+void NMPCModel::hxFunc<Dual>(const double t, const Dual* x, const Dual* u, 
+                             const Dual* lmd, Dual* hx) const;
+
+template <>
+void NMPCModel::huFunc<Dual>(const double t, const Dual* x, const Dual* u, 
+                             const Dual* lmd, Dual* hu) const;
+
+} // namespace """+self.__model_namespace+"""
+
+} // namespace cgmres
+
+
+#endif // """+include_guard+"""
+"""
+        ])
+        f_model_h.close()
+        f_model_c = open('models/'+self.__model_name+'/nmpc_model.cpp', 'w')
+        f_model_c.writelines([
+""" 
+#include "nmpc_model.hpp"
+#include "dual_number.hpp"
+#include "model_plugin.hpp"
+
+
+namespace cgmres {
+namespace """+self.__model_namespace+""" {
+
+template <>
+void NMPCModel::stateFunc<double>(const double t, const double* x, 
+                                  const double* u, double* dx) const {
+  ModelPlugin<NMPCModel>::stateFunc(t, x, u, dx);
+}
+
+template <>
+void NMPCModel::phixFunc<double>(const double t, const double* x, 
+                                 double* phix) const {
+  ModelPlugin<NMPCModel>::phixFunc(t, x, phix);
+}
+
+template <>
+void NMPCModel::hxFunc<double>(const double t, const double* x, 
+                               const double* u, const double* lmd, 
+                               double* hx) const {
+  ModelPlugin<NMPCModel>::hxFunc(t, x, u, lmd, hx);
+}
+
+template <>
+void NMPCModel::huFunc<double>(const double t, const double* x, 
+                               const double* u, const double* lmd, 
+                               double* hu) const {
+  ModelPlugin<NMPCModel>::huFunc(t, x, u, lmd, hu);
+}
+
+// The dual numbers are split into the values and the derivatives, and the 
+// equations and their derivatives are computed by the Jacobian-vector 
+// product functions of the plugin.
+template <>
+void NMPCModel::stateFunc<Dual>(const double t, const Dual* x, const Dual* u, 
+                                Dual* dx) const {
+  constexpr int dim_u = dim_control_input_ + dim_constraints_;
+  double x_val[dim_state_], x_dir[dim_state_], u_val[dim_u], u_dir[dim_u], 
+      dx_val[dim_state_], dx_dir[dim_state_];
+  for (int i=0; i<dim_state_; ++i) {
+    x_val[i] = x[i].value();
+    x_dir[i] = x[i].derivative();
+  }
+  for (int i=0; i<dim_u; ++i) {
+    u_val[i] = u[i].value();
+    u_dir[i] = u[i].derivative();
+  }
+  ModelPlugin<NMPCModel>::stateFuncJvp(t, x_val, u_val, x_dir, u_dir, dx_val, 
+                                       dx_dir);
+  for (int i=0; i<dim_state_; ++i) {
+    dx[i] = Dual(dx_val[i], dx_dir[i]);
+  }
+}
+
+template <>
+void NMPCModel::phixFunc<Dual>(const double t, const Dual* x, 
+                               Dual* phix) const {
+  double x_val[dim_state_], x_dir[dim_state_], phix_val[dim_state_], 
+      phix_dir[dim_state_];
+  for (int i=0; i<dim_state_; ++i) {
+    x_val[i] = x[i].value();
+    x_dir[i] = x[i].derivative();
+  }
+  ModelPlugin<NMPCModel>::phixFuncJvp(t, x_val, x_dir, phix_val, phix_dir);
+  for (int i=0; i<dim_state_; ++i) {
+    phix[i] = Dual(phix_val[i], phix_dir[i]);
+  }
+}
+
+template <>
+void NMPCModel::hxFunc<Dual>(const double t, const Dual* x, const Dual* u, 
+                             const Dual* lmd, Dual* hx) const {
+  constexpr int dim_u = dim_control_input_ + dim_constraints_;
+  double x_val[dim_state_], x_dir[dim_state_], u_val[dim_u], u_dir[dim_u], 
+      lmd_val[dim_state_], lmd_dir[dim_state_], hx_val[dim_state_], 
+      hx_dir[dim_state_];
+  for (int i=0; i<dim_state_; ++i) {
+    x_val[i] = x[i].value();
+    x_dir[i] = x[i].derivative();
+    lmd_val[i] = lmd[i].value();
+    lmd_dir[i] = lmd[i].derivative();
+  }
+  for (int i=0; i<dim_u; ++i) {
+    u_val[i] = u[i].value();
+    u_dir[i] = u[i].derivative();
+  }
+  ModelPlugin<NMPCModel>::hxFuncJvp(t, x_val, u_val, lmd_val, x_dir, u_dir, 
+                                    lmd_dir, hx_val, hx_dir);
+  for (int i=0; i<dim_state_; ++i) {
+    hx[i] = Dual(hx_val[i], hx_dir[i]);
+  }
+}
+
+template <>
+void NMPCModel::huFunc<Dual>(const double t, const Dual* x, const Dual* u, 
+                             const Dual* lmd, Dual* hu) const {
+  constexpr int dim_u = dim_control_input_ + dim_constraints_;
+  double x_val[dim_state_], x_dir[dim_state_], u_val[dim_u], u_dir[dim_u], 
+      lmd_val[dim_state_], lmd_dir[dim_state_], hu_val[dim_u], hu_dir[dim_u];
+  for (int i=0; i<dim_state_; ++i) {
+    x_val[i] = x[i].value();
+    x_dir[i] = x[i].derivative();
+    lmd_val[i] = lmd[i].value();
+    lmd_dir[i] = lmd[i].derivative();
+  }
+  for (int i=0; i<dim_u; ++i) {
+    u_val[i] = u[i].value();
+    u_dir[i] = u[i].derivative();
+  }
+  ModelPlugin<NMPCModel>::huFuncJvp(t, x_val, u_val, lmd_val, x_dir, u_dir, 
+                                    lmd_dir, hu_val, hu_dir);
+  for (int i=0; i<dim_u; ++i) {
+    hu[i] = Dual(hu_val[i], hu_dir[i]);
+  }
+}
+
+} // namespace """+self.__model_namespace+"""
+} // namespace cgmres
+
+"""
+        ])
+        f_model_c.close()
+
     def __write_function(
-            self, writable_file, function, return_value_name, use_cse
+            self, writable_file, function, return_value_name, use_cse, 
+            scalar_type='Scalar'
         ):
         """ Write input symbolic function onto writable_file. The function's 
             return value name must be set. use_cse is optional.
@@ -1001,60 +2549,253 @@ target_compile_options(
             Args: 
                 writable_file: A writable file, i.e., a file streaming that is 
                     already opened as writing mode.
-                function: A symbolic function wrote onto the writable_file.
-                return_value_name: The name of the return value.
+                function: A symbolic function wrote onto the writable_file. If 
+                    this is a list of symbolic functions, they are wrote 
+                    together and the common subexpressions among them are 
+                    shared.
+                return_value_name: The name of the return value. If function 
+                    is a list of symbolic functions, the list of the names.
                 use_cse: If true, common subexpression elimination is used. If 
                     False, it is not used.
+                scalar_type: The type of the common subexpressions. Default is 
+                    'Scalar', the template parameter of the equations.
         """
-        if use_cse:
-            func_cse = sympy.cse(function)
-            for i in range(len(func_cse[0])):
-                cse_exp, cse_rhs = func_cse[0][i]
-                writable_file.write(
-                    '  double '+sympy.ccode(cse_exp)
-                    +' = '+sympy.ccode(cse_rhs)+';\n'
-                )
-            for i in range(len(func_cse[1])):
-                writable_file.write(
-                    '  '+return_value_name+'[%d] = '%i
-                    +sympy.ccode(func_cse[1][i])+';\n'
+        if isinstance(return_value_name, str):
+            function = [function]
+            return_value_name = [return_value_name]
+        if self.__use_runtime_parameters:
+            self.__write_runtime_parameters(writable_file, function)
+        outputs = [
+            (name+'[%d]'%i, func[i]) 
+            for func, name in zip(function, return_value_name) 
+            for i in range(len(func))
+        ]
+        if not self.__use_strength_reduction:
+            if use_cse:
+                func_cse = sympy.cse([output[1] for output in outputs])
+                for i in range(len(func_cse[0])):
+                    cse_exp, cse_rhs = func_cse[0][i]
+                    writable_file.write(
+                        '  '+scalar_type+' '+sympy.ccode(cse_exp)
+                        +' = '+sympy.ccode(cse_rhs)+';\n'
+                    )
+                for i in range(len(func_cse[1])):
+                    writable_file.write(
+                        '  '+outputs[i][0]+' = '
+                        +sympy.ccode(func_cse[1][i])+';\n'
+                    )
+            else:
+                writable_file.writelines(
+                    ['  '+output[0]+' = '+sympy.ccode(output[1])+';\n' 
+                    for output in outputs]
                 )
+            return
+        if use_cse:
+            replacements, reduced_exprs = sympy.cse(
+                [output[1] for output in outputs]
+            )
         else:
-            writable_file.writelines(
-                ['  '+return_value_name+'[%d] = '%i
-                +sympy.ccode(function[i])+';\n' for i in range(len(function))]
+            replacements = []
+            reduced_exprs = [output[1] for output in outputs]
+        # sin and cos of the same argument are computed at once by sincos() 
+        # just before the first statement that uses them.
+        sincos_args = symfunc.sincos_arguments(
+            [replacement[1] for replacement in replacements] + reduced_exprs
+        )
+        # The subexpressions that are exactly sin or cos of the arguments are 
+        # the outputs of sincos().
+        sincos_outputs = dict(
+            (cse_rhs, cse_exp) for cse_exp, cse_rhs in replacements 
+            if (isinstance(cse_rhs, (sympy.sin, sympy.cos)) 
+                and cse_rhs.args[0] in sincos_args)
+        )
+        sincos_symbols = {}
+        statements = [
+            ('  '+scalar_type+' '+sympy.ccode(cse_exp)+' = ', cse_rhs) 
+            for cse_exp, cse_rhs in replacements 
+            if cse_rhs not in sincos_outputs
+        ] + [
+            ('  '+output[0]+' = ', reduced_expr) 
+            for output, reduced_expr in zip(outputs, reduced_exprs)
+        ]
+        for lhs, rhs in statements:
+            for arg in sincos_args:
+                if arg in sincos_symbols:
+                    continue
+                uses = [sympy.sin(arg), sympy.cos(arg)]
+                uses += [
+                    sincos_outputs[use] for use in list(uses) 
+                    if use in sincos_outputs
+                ]
+                if rhs.has(*uses):
+                    sin_symbol = sincos_outputs.get(
+                        sympy.sin(arg), 
+                        sympy.Symbol('sin%d' %(len(sincos_symbols)))
+                    )
+                    cos_symbol = sincos_outputs.get(
+                        sympy.cos(arg), 
+                        sympy.Symbol('cos%d' %(len(sincos_symbols)))
+                    )
+                    sincos_symbols[arg] = (sin_symbol, cos_symbol)
+                    writable_file.write(
+                        '  '+scalar_type+' '+str(sin_symbol)+', '
+                        +str(cos_symbol)+';\n'
+                        '  sincos('+symfunc.reduced_ccode(arg)+', &'
+                        +str(sin_symbol)+', &'+str(cos_symbol)+');\n'
+                    )
+            rhs = rhs.xreplace(dict(
+                [(sympy.sin(arg), sincos_symbols[arg][0]) 
+                 for arg in sincos_symbols]
+                + [(sympy.cos(arg), sincos_symbols[arg][1]) 
+                   for arg in sincos_symbols]
+            ))
+            writable_file.write(lhs+symfunc.reduced_ccode(rhs)+';\n')
+
+    def __inline_definitions(self, definitions):
+        """ Makes the definitions of the member functions of NMPCModel inline 
+            and qualifies their pointer arguments with __restrict so that they 
+            can be written in the header.
+
+            Args: 
+                definitions: The definitions written in nmpc_model.cpp.
+
+            Returns: 
+                The inline definitions.
+        """
+        def inline_definition(match):
+            template, return_type, name, args, qualifier = match.groups()
+            args = [' '.join(arg.split()) for arg in args.split(',')]
+            args = [
+                re.sub(r'\* (\w+)$', r'* __restrict \1', arg) 
+                for arg in args if arg != ''
+            ]
+            head = 'inline '+(return_type or '')+name+'('
+            lines, line = [], head
+            for i in range(len(args)):
+                if i < len(args)-1:
+                    arg = args[i]+', '
+                else:
+                    arg = args[i]+')'+qualifier+' {'
+                if len(line+arg.rstrip()) >= 80 and line.strip() != head:
+                    lines.append(line)
+                    line = ' ' * len(head)
+                line += arg
+            if len(args) == 0:
+                line += ')'+qualifier+' {'
+            lines.append(line)
+            return (template or '')+'\n'.join(lines)
+
+        return re.sub(
+            r'^(template <[^>]*>\n)?(void )?(NMPCModel::\w+(?:<\w+>)?)'
+            r'\(([^)]*)\)((?: const)?) \{', 
+            inline_definition, definitions, flags=re.MULTILINE
+        )
+
+    def __write_runtime_parameters(self, writable_file, function):
+        """ Write the local constants of the runtime parameters used in the 
+            input symbolic functions onto writable_file.
+
+            Args: 
+                writable_file: A writable file, i.e., a file streaming that is 
+                    already opened as writing mode.
+                function: A list of symbolic functions.
+        """
+        symbol_names = set(
+            str(symbol) for func in function for i in range(len(func)) 
+            for symbol in sympy.sympify(func[i]).free_symbols
+        )
+        self.__write_parameter_locals(
+            writable_file, symbol_names, 'parameters_.parameters.'
+        )
+        if any(name.startswith('constants[') for name in symbol_names):
+            writable_file.write(
+                '  const double* constants = parameters_.constants;\n'
             )
 
-    def __make_model_dir(self):
+    def __write_constants(
+            self, writable_file, constants, parameters_name, block_name
+        ):
+        """ Write the computation of the constant subexpressions onto 
+            writable_file.
+
+            Args: 
+                writable_file: A writable file, i.e., a file streaming that is 
+                    already opened as writing mode.
+                constants: A dict from the constant subexpressions to their 
+                    symbols.
+                parameters_name: The prefix of the parameters, e.g., 
+                    'parameters.'. If empty, the parameters are the members 
+                    of NMPCModel and no local constants are written.
+                block_name: The prefix of the symbols of the constants.
+        """
+        if parameters_name != '':
+            self.__write_parameter_locals(
+                writable_file, 
+                set(str(symbol) for expr in constants 
+                    for symbol in expr.free_symbols), 
+                parameters_name
+            )
+        writable_file.writelines([
+            '  '+block_name+str(symbol)+' = '+symfunc.reduced_ccode(expr)
+            +';\n' for expr, symbol in constants.items()
+        ])
+
+    def __write_parameter_locals(
+            self, writable_file, symbol_names, parameters_name
+        ):
+        """ Write the local constants of the parameters whose symbols are in 
+            symbol_names onto writable_file.
+
+            Args: 
+                writable_file: A writable file, i.e., a file streaming that is 
+                    already opened as writing mode.
+                symbol_names: A set of the names of the used symbols.
+                parameters_name: The prefix of the parameters.
+        """
+        scalar_vars = [
+            scalar_var[1] for scalar_var in self.__scalar_vars 
+            if scalar_var[1] in symbol_names
+        ]
+        array_vars = [
+            array_var[1] for array_var in self.__array_vars 
+            if any(str(var) in symbol_names for var in array_var[0])
+        ]
+        writable_file.writelines([
+            '  const double '+name+' = '+parameters_name+name+';\n' 
+            for name in scalar_vars
+        ])
+        writable_file.writelines([
+            '  const double* '+name+' = '+parameters_name+name+';\n' 
+            for name in array_vars
+        ])
+
+    def __make_model_dir(self, sub_dir_name=None):
         """ Makes a directory where the C source files of OCP models are 
             generated.
+
+            Args: 
+                sub_dir_name: If it is not None, the directory having this 
+                    name is also made in the directory of the model.
         """
-        if platform.system() == 'Windows':
-            subprocess.run(
-                ['mkdir', 'models'], 
-                stdout=subprocess.PIPE, 
-                stderr=subprocess.PIPE, 
-                shell=True
-            )
-            subprocess.run(
-                ['mkdir', self.__model_name], 
-                cwd='models', 
-                stdout=subprocess.PIPE, 
-                stderr=subprocess.PIPE, 
-                shell=True
-            )
-        else:
-            subprocess.run(
-                ['mkdir', 'models'], 
-                stdout=subprocess.PIPE, 
-                stderr=subprocess.PIPE
-            )
-            subprocess.run(
-                ['mkdir', self.__model_name], 
-                cwd='models',
-                stdout=subprocess.PIPE, 
-                stderr=subprocess.PIPE
-            )
+        dir_names = [('models', '.'), (self.__model_name, 'models')]
+        if sub_dir_name is not None:
+            dir_names.append((sub_dir_name, 'models/'+self.__model_name))
+        for dir_name, cwd in dir_names:
+            if platform.system() == 'Windows':
+                subprocess.run(
+                    ['mkdir', dir_name], 
+                    cwd=cwd, 
+                    stdout=subprocess.PIPE, 
+                    stderr=subprocess.PIPE, 
+                    shell=True
+                )
+            else:
+                subprocess.run(
+                    ['mkdir', dir_name], 
+                    cwd=cwd,
+                    stdout=subprocess.PIPE, 
+                    stderr=subprocess.PIPE
+                )
 
     def __remove_build_dir(self):
         """ Removes a build directory. This function is mainly for Windows 
@@ -1,4 +1,5 @@
 import sympy
+from sympy.printing.c import C99CodePrinter
 
 
 def diff_scalar_func(scalar_func, var):
@@ -16,6 +17,31 @@ def diff_scalar_func(scalar_func, var):
     return [sympy.diff(scalar_func, var[i]) for i in range(len(var))]
 
 
+def directional_derivative(func, var_list, direction_list):
+    """ Calculate directional derivative of a vector-valued function, i.e., 
+        the product of the Jacobian and a direction vector. 
+
+        Args:
+            func: A symbolic vector-valued function.
+            var_list: A list of symbolic vectors with respect to which func is 
+                differentiated.
+            direction_list: A list of symbolic vectors that represent the 
+                direction. The i-th vector must have the same dimension as the 
+                i-th vector of var_list.
+
+        Returns: 
+            Directional derivative of func, i.e., the sum of the products of 
+            the Jacobians of func with respect to var_list and the 
+            corresponding vectors of direction_list.
+    """
+    return [
+        sympy.Add(*[sympy.diff(func_i, var[j]) * direction[j]
+                    for var, direction in zip(var_list, direction_list)
+                    for j in range(len(var))])
+        for func_i in func
+    ]
+
+
 def simplify(func):
     """ Simplifies a scalar-valued or vector-valued function.
 
@@ -26,4 +52,123 @@ def simplify(func):
         for i in range(len(func)):
             func[i] = sympy.simplify(sympy.nsimplify(func[i]))
     else:
-        func = sympy.simplify(sympy.nsimplify(func))
\ No newline at end of file
+        func = sympy.simplify(sympy.nsimplify(func))
+
+
+class _StrengthReducedCodePrinter(C99CodePrinter):
+    """ C code printer that writes the small integer and half-integer powers 
+        of symbols as multiplications instead of pow().
+    """
+    def _print_Pow(self, expr):
+        base, exp = expr.base, expr.exp
+        if base.is_Symbol and exp.is_Rational and exp.q in (1, 2):
+            num_mul = abs(exp.p) // exp.q
+            if 1 <= num_mul <= 4 and not (num_mul == 1 and exp.q == 1):
+                base_code = self._print(base)
+                factors = [base_code] * num_mul
+                if exp.q == 2:
+                    factors.append('sqrt('+base_code+')')
+                product = '*'.join(factors)
+                if exp.p < 0:
+                    return '(1.0/('+product+'))'
+                return '('+product+')'
+        return super()._print_Pow(expr)
+
+
+def reduced_ccode(expr):
+    """ Converts a symbolic expression into C code. The integer powers of 
+        symbols up to 4, and their half-integer powers, are written as 
+        multiplications and sqrt() instead of pow().
+
+        Args:
+            expr: A symbolic expression.
+
+        Returns: 
+            C code of expr.
+    """
+    return _StrengthReducedCodePrinter().doprint(expr)
+
+
+def sincos_arguments(exprs):
+    """ Finds the arguments whose sin and cos are both computed in exprs.
+
+        Args:
+            exprs: A list of symbolic expressions.
+
+        Returns: 
+            The list of the arguments in the order of their first appearances.
+    """
+    sin_args, cos_args, args = set(), set(), []
+    for expr in exprs:
+        for subexpr in sympy.preorder_traversal(expr):
+            if isinstance(subexpr, (sympy.sin, sympy.cos)):
+                arg = subexpr.args[0]
+                if isinstance(subexpr, sympy.sin):
+                    sin_args.add(arg)
+                else:
+                    cos_args.add(arg)
+                if arg not in args:
+                    args.append(arg)
+    return [arg for arg in args if arg in sin_args and arg in cos_args]
+
+
+def hoist_constant_subexpressions(
+        func, constant_symbols, anchor_symbols, constants, constant_name
+    ):
+    """ Replaces the subexpressions of a vector-valued function that consist 
+        only of constant symbols, e.g., the parameters, with new symbols so 
+        that they can be computed once in advance. The products and the sums 
+        of constant factors and terms are also replaced. Trivial 
+        subexpressions, i.e., a symbol and a number times a symbol, are not 
+        replaced.
+
+        Args:
+            func: A symbolic vector-valued function.
+            constant_symbols: A set of the constant symbols.
+            anchor_symbols: A set of the constant symbols at least one of 
+                which a subexpression must contain to be replaced.
+            constants: A dict from the replaced subexpressions to the new 
+                symbols. New entries are added to it.
+            constant_name: The name of the new symbols, whose i-th symbol is 
+                named constant_name[i].
+
+        Returns: 
+            func whose constant subexpressions are replaced.
+    """
+    def is_constant(expr):
+        return expr.free_symbols <= constant_symbols
+
+    def is_trivial(expr):
+        return (expr.is_Atom 
+                or (expr.is_Mul and len(expr.args) == 2 
+                    and expr.args[0].is_Number and expr.args[1].is_Symbol))
+
+    def constant_symbol(expr):
+        if expr not in constants:
+            constants[expr] = sympy.Symbol(
+                constant_name+'[%d]' %(len(constants))
+            )
+        return constants[expr]
+
+    def hoist(expr):
+        if expr.is_Atom:
+            return expr
+        if (is_constant(expr) and expr.free_symbols & anchor_symbols 
+            and not is_trivial(expr)):
+            return constant_symbol(expr)
+        if expr.is_Add or expr.is_Mul:
+            constant_args = [arg for arg in expr.args if is_constant(arg)]
+            other_args = [arg for arg in expr.args if not is_constant(arg)]
+            constant_part = expr.func(*constant_args)
+            if (len(constant_args) > 1 
+                and constant_part.free_symbols & anchor_symbols
+                and not is_trivial(constant_part)):
+                constant_args = [constant_symbol(constant_part)]
+            else:
+                constant_args = [hoist(arg) for arg in constant_args]
+            return expr.func(
+                *(constant_args+[hoist(arg) for arg in other_args])
+            )
+        return expr.func(*[hoist(arg) for arg in expr.args])
+
+    return [hoist(sympy.sympify(func_i)) for func_i in func]
\ No newline at end of file
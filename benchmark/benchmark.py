@@ -0,0 +1,439 @@
+""" Benchmarks of the options of the solvers on the sample models.
+
+    Each variant of a benchmark is generated in models/<model>_<variant> by
+    AutoGenU, built for the instruction sets of the host, and simulated with
+    the same settings as the sample notebooks. Then the best CPU time per control update over the runs, the
+    mean and the maximum of the optimality error over the simulation, and
+    the final state are printed. The error mean is nan if the simulation
+    diverges. Run from the root directory of the repository, e.g.,
+
+        python3 benchmark/benchmark.py mixed_precision
+        python3 benchmark/benchmark.py --runs 5 krylov_method
+
+    Without arguments, the available benchmarks are listed.
+"""
+
+import os
+import re
+import sys
+import math
+import argparse
+import subprocess
+import sympy
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..'))
+from autogenu import autogenu
+
+
+def cartpole(model_name):
+    """ The cart-pole of cartpole.ipynb.
+    """
+    dimx, dimu = 4, 2
+    ag = autogenu.AutoGenU(model_name, dimx, dimu)
+    t = ag.define_t()
+    x = ag.define_x()
+    u = ag.define_u()
+    m_c, m_p, l, g = ag.define_scalar_vars('m_c', 'm_p', 'l', 'g')
+    u_min, u_max, dummy_weight = ag.define_scalar_vars(
+        'u_min', 'u_max', 'dummy_weight'
+    )
+    q = ag.define_array_var('q', dimx)
+    q_terminal = ag.define_array_var('q_terminal', dimx)
+    x_ref = ag.define_array_var('x_ref', dimx)
+    r = ag.define_array_var('r', dimu)
+    sin, cos = sympy.sin, sympy.cos
+    f = [x[2],
+         x[3],
+         (u[0] + m_p*sin(x[1])*(l*x[1]*x[1] + g*cos(x[1])))
+            / (m_c+m_p*sin(x[1])*sin(x[1])),
+         (-u[0]*cos(x[1]) - m_p*l*x[1]*x[1]*cos(x[1])*sin(x[1])
+            - (m_c+m_p)*g*sin(x[1]))
+            / (l*(m_c + m_p*sin(x[1])*sin(x[1])))]
+    C = [u[0]**2 + u[1]**2 - ((u_max-u_min)**2)/4]
+    h = []
+    L = (sum(q[i]*(x[i] - x_ref[i])**2 for i in range(dimx))/2
+         + (r[0] * u[0]**2)/2 - dummy_weight*u[1])
+    phi = sum(q_terminal[i]*(x[i] - x_ref[i])**2 for i in range(dimx))/2
+    ag.set_functions(f, C, h, L, phi)
+    ag.set_scalar_vars(['m_c', 2], ['m_p', 0.2], ['l', 0.5],
+                       ['g', 9.80665], ['u_min', -15], ['u_max', 15],
+                       ['dummy_weight', 0.1])
+    ag.set_array_var('q', [2.5, 10, 0.01, 0.01])
+    ag.set_array_var('r', [1, 0.01])
+    ag.set_array_var('q_terminal', [2.5, 10, 0.01, 0.01])
+    ag.set_array_var('x_ref', [0, 'M_PI', 0, 0])
+    ag.set_solver_type(autogenu.SolverType.ContinuationGMRES)
+    ag.set_solver_parameters(2.0, 1.0, 100, 1.0e-08, 1000, 10)
+    ag.set_initialization_parameters([0.01, 10, 0.01], 1.0e-06, 50)
+    ag.set_simulation_parameters(0, [0, 0, 0, 0], 10, 0.001)
+    return ag
+
+
+def cartpole_ms(model_name):
+    """ The cart-pole of cartpole.ipynb solved by MultipleShootingCGMRES with
+        N = 50 and kmax = 10 as hexacopter.ipynb.
+    """
+    ag = cartpole(model_name)
+    ag.set_solver_type(autogenu.SolverType.MultipleShootingCGMRES)
+    ag.set_solver_parameters(2.0, 1.0, 50, 1.0e-08, 1000, 10)
+    return ag
+
+
+def hexacopter(model_name):
+    """ The hexacopter of hexacopter.ipynb.
+    """
+    dimx, dimu = 12, 6
+    ag = autogenu.AutoGenU(model_name, dimx, dimu)
+    t = ag.define_t()
+    x = ag.define_x()
+    u = ag.define_u()
+    m, l, k, Ixx, Iyy, Izz, gamma, g = ag.define_scalar_vars(
+        'm', 'l', 'k', 'Ixx', 'Iyy', 'Izz', 'gamma', 'g'
+    )
+    z_ref, u_min, u_max, epsilon = ag.define_scalar_vars(
+        'z_ref', 'u_min', 'u_max', 'epsilon'
+    )
+    q = ag.define_array_var('q', dimx)
+    q_terminal = ag.define_array_var('q_terminal', dimx)
+    r = ag.define_array_var('r', dimu)
+    sin, cos, ln, sqrt = sympy.sin, sympy.cos, sympy.log, sympy.sqrt
+    xyz_ref = [sin(2*t), (1-cos(2*t)), z_ref + 2*sin(t)]
+    xyz_ref_diff = [sympy.diff(xyz_ref[i], t) for i in range(3)]
+    U1 = sum(u[i] for i in range(dimu))
+    U2 = l*(-u[0]/2 - u[1] - u[2]/2 + u[3]/2 + u[4]+ u[5]/2)
+    U3 = l*(-(sqrt(3)/2)*u[0] + (sqrt(3)/2)*u[2] + (sqrt(3)/2)*u[3]
+            - (sqrt(3)/2)*u[5])
+    U4 = k*(-u[0] + u[1] - u[2] + u[3] - u[4] + u[5]) - gamma * x[11]
+    f = [x[6],
+         x[7],
+         x[8],
+         x[9],
+         x[10],
+         x[11],
+         (cos(x[5])*sin(x[4])*cos(x[3]) + sin(x[5])*sin(x[3]))*U1/m,
+         (sin(x[5])*sin(x[4])*cos(x[3]) - cos(x[5])*sin(x[3]))*U1/m,
+         -g + (cos(x[3])*cos(x[4]))*U1/m,
+         ((Iyy-Izz)/Ixx)*x[10]*x[11] + U2/Ixx,
+         ((Izz-Ixx)/Iyy)*x[9]*x[11] + U3/Iyy,
+         ((Ixx-Iyy)/Izz)*x[9]*x[10] + U4/Izz]
+    C = []
+    h = []
+    u_ref = (m*g)/6
+    u_barrier = sum(-ln(u[i]-u_min) - ln(u_max-u[i]) for i in range(dimu))
+    L = (sum((q[i]*(x[i]-xyz_ref[i])**2)/2 for i in range(3))
+         + sum((q[i]*x[i]**2)/2 for i in range(3, 6))
+         + sum((q[i+6]*(x[i+6]-xyz_ref_diff[i])**2)/2 for i in range(3))
+         + sum((q[i]*x[i]**2)/2 for i in range(9, 12))
+         + sum(r[i] * (u[i]-u_ref)**2 for i in range(dimu))/2
+         + epsilon * u_barrier)
+    phi = (sum((q_terminal[i]*(x[i]-xyz_ref[i])**2)/2 for i in range(3))
+           + sum((q_terminal[i]*x[i]**2)/2 for i in range(3, 6))
+           + sum((q_terminal[i+6]*(x[i+6]-xyz_ref_diff[i])**2)/2
+                 for i in range(3))
+           + sum((q_terminal[i]*x[i]**2)/2 for i in range(9, 12)))
+    ag.set_functions(f, C, h, L, phi)
+    ag.set_scalar_vars(['m', 1.44], ['l', 0.23], ['k', 1.6e-09],
+                       ['Ixx', 0.0348], ['Iyy', 0.0459], ['Izz', 0.0977],
+                       ['gamma', 0.01], ['g', 9.80665], ['z_ref', 5],
+                       ['u_min', 0.144], ['u_max', 6], ['epsilon', 0.01])
+    ag.set_array_var(
+        'q', [1, 1, 1, 0.01, 0.01, 0, 0.01, 0.01, 0.01, 0.1, 0.1, 0.001]
+    )
+    ag.set_array_var('r', [0.01, 0.01, 0.01, 0.01, 0.01, 0.01])
+    ag.set_array_var(
+        'q_terminal',
+        [1, 1, 1, 0.01, 0.01, 0, 0.01, 0.01, 0.01, 0.1, 0.1, 0.001]
+    )
+    ag.set_solver_type(autogenu.SolverType.MultipleShootingCGMRES)
+    ag.set_solver_parameters(1.0, 1.0, 50, 1.0e-08, 1000, 10)
+    ag.set_initialization_parameters([1, 1, 1, 1, 1, 1], 1.0e-06, 50)
+    ag.set_simulation_parameters(0, [0 for i in range(dimx)], 10, 0.001)
+    return ag
+
+
+def hexacopter_large(model_name):
+    """ The hexacopter of hexacopter.ipynb with N = 200 and kmax = 30, whose
+        Krylov basis is 12 times as large as that of hexacopter. The
+        simulation time is 2 s.
+    """
+    ag = hexacopter(model_name)
+    ag.set_solver_parameters(1.0, 1.0, 200, 1.0e-08, 1000, 30)
+    ag.set_simulation_parameters(0, [0 for i in range(12)], 2, 0.001)
+    return ag
+
+
+def mobilerobot(model_name):
+    """ The mobile robot of mobilerobot.ipynb.
+    """
+    dimx, dimu = 3, 2
+    ag = autogenu.AutoGenU(model_name, dimx, dimu)
+    t = ag.define_t()
+    x = ag.define_x()
+    u = ag.define_u()
+    vx_ref = ag.define_scalar_var('vx_ref')
+    v_min, v_max = ag.define_scalar_vars('v_min', 'v_max')
+    w_min, w_max = ag.define_scalar_vars('w_min', 'w_max')
+    X_1, Y_1, R_1 = ag.define_scalar_vars('X_1', 'Y_1', 'R_1')
+    X_2, Y_2, R_2 = ag.define_scalar_vars('X_2', 'Y_2', 'R_2')
+    xx_ref = vx_ref * t
+    q = ag.define_array_var('q', dimx)
+    r = ag.define_array_var('r', dimu)
+    x_ref = ag.define_array_var('x_ref', dimx)
+    sin, cos = sympy.sin, sympy.cos
+    f = [u[0] * cos(x[2]),
+         u[0] * sin(x[2]),
+         u[1]]
+    C = []
+    h = [R_1**2 - (x[0]-X_1)**2 - (x[1]-Y_1)**2,
+         R_2**2 - (x[0]-X_2)**2 - (x[1]-Y_2)**2,
+         v_min - u[0],
+         u[0] - v_max,
+         w_min - u[1],
+         u[1] - w_max]
+    L = ((q[0]*(x[0]-xx_ref)**2 + q[1]*x[1]**2 + q[2]*x[2]**2) / 2
+         + (r[0]*(u[0]*cos(x[2])-vx_ref)**2 + r[1]*u[1]**2) / 2)
+    phi = (q[0]*(x[0]-xx_ref)**2 + q[1]*x[1]**2 + q[2]*x[2]**2) / 2
+    ag.set_functions(f, C, h, L, phi)
+    ag.set_scalar_vars(['vx_ref', 0.4], ['X_1', 1], ['Y_1', 0.25],
+                       ['R_1', 0.5], ['X_2', 2], ['Y_2', -0.25],
+                       ['R_2', 0.5], ['v_min', -0.5], ['v_max', 0.5],
+                       ['w_min', -0.75], ['w_max', 0.75])
+    ag.set_array_var('q', [10, 1, 0.01])
+    ag.set_array_var('r', [0.1, 0.1])
+    ag.set_array_var('x_ref', [0, 0, 0])
+    ag.set_FB_epsilon([0.01, 0.01, 0.0001, 0.0001, 0.0001, 0.0001])
+    ag.set_solver_type(autogenu.SolverType.MultipleShootingCGMRES)
+    ag.set_solver_parameters(1.5, 1.0, 50, 1.0e-08, 1000, 15)
+    ag.set_initialization_parameters(
+        [0.1, 0.1, 0.01, 0.01, 0.01, 0.01, 0.01, 0.01], 1.0e-06, 50
+    )
+    ag.set_simulation_parameters(0, [0, 0, 0], 10, 0.001)
+    return ag
+
+
+def cartpole_uncondensed(model_name):
+    """ The cart-pole of cartpole_ms solved by UncondensedMSCGMRES with the
+        default block-Jacobi preconditioner and the smallest kmax accepted by
+        the generator, 17.
+    """
+    ag = cartpole_ms(model_name)
+    ag.set_solver_type(autogenu.SolverType.UncondensedMSCGMRES)
+    ag.set_solver_parameters(2.0, 1.0, 50, 1.0e-08, 1000, 17)
+    return ag
+
+
+def cartpole_uncondensed_lu(model_name):
+    """ The cart-pole of cartpole_ms solved by UncondensedMSCGMRES with the
+        block-tridiagonal LU factorization refreshed every 5 updates.
+    """
+    ag = cartpole_ms(model_name)
+    ag.set_solver_type(autogenu.SolverType.UncondensedMSCGMRES)
+    ag.set_block_tridiagonal_lu(5)
+    return ag
+
+
+def mobilerobot_uncondensed(model_name):
+    """ The mobile robot of mobilerobot solved by UncondensedMSCGMRES with the
+        default block-Jacobi preconditioner and the smallest kmax accepted by
+        the generator, 21.
+    """
+    ag = mobilerobot(model_name)
+    ag.set_solver_type(autogenu.SolverType.UncondensedMSCGMRES)
+    ag.set_solver_parameters(1.5, 1.0, 50, 1.0e-08, 1000, 21)
+    return ag
+
+
+def mobilerobot_uncondensed_lu(model_name):
+    """ The mobile robot of mobilerobot solved by UncondensedMSCGMRES with the
+        block-tridiagonal LU factorization refreshed every 5 updates.
+    """
+    ag = mobilerobot(model_name)
+    ag.set_solver_type(autogenu.SolverType.UncondensedMSCGMRES)
+    ag.set_block_tridiagonal_lu(5)
+    return ag
+
+
+def krylov_method(name, kmax_factor=1):
+    """ Returns the function that replaces the solver declared in main.cpp
+        by the one with the matrix-free Krylov method name, e.g.,
+        cgmres::BasicMultipleShootingCGMRES<Model, cgmres::MatrixFreeBiCGStab>,
+        and multiplies kmax, the last argument of its constructor, by
+        kmax_factor.
+    """
+    def edit_main(main):
+        main = re.sub(r'(nmpc_solver\(.*, )(\d+)\);',
+                      lambda m: '%s%d);' %(m.group(1),
+                                           kmax_factor*int(m.group(2))),
+                      main)
+        return re.sub(r'cgmres::(\w+)<([\w:]+)>(\s+)nmpc_solver',
+                      r'cgmres::Basic\1<\2, cgmres::%s>\3nmpc_solver' %name,
+                      main)
+    return edit_main
+
+
+# The benchmarks. Each benchmark is a tuple of the models and the variants.
+# Each variant is a tuple of its name, the keyword arguments of
+# generate_source_files(), the function that sets the options of the
+# generator, and optionally the function that edits the generated main.cpp.
+BENCHMARKS = {
+    'mixed_precision': (
+        [cartpole, cartpole_ms, hexacopter, hexacopter_large],
+        [('double', {}, None),
+         ('float', {}, lambda ag: ag.set_single_precision_basis(True))]
+    ),
+    'krylov_method': (
+        [cartpole, cartpole_ms, hexacopter, mobilerobot],
+        [('GMRES', {}, None),
+         ('BiCGStab', {}, None, krylov_method('MatrixFreeBiCGStab')),
+         ('IDRs', {}, None, krylov_method('MatrixFreeIDRs')),
+         ('BiCGStab_2kmax', {}, None,
+          krylov_method('MatrixFreeBiCGStab', 2)),
+         ('IDRs_2kmax', {}, None, krylov_method('MatrixFreeIDRs', 2))]
+    ),
+    'exact_jvp': (
+        [cartpole, cartpole_ms, hexacopter, mobilerobot],
+        [('forward_difference', {}, None),
+         ('dual', {},
+          lambda ag: ag.set_exact_jacobian_vector_product(True)),
+         ('symbolic_jvp', {'use_symbolic_jvp': True},
+          lambda ag: ag.set_exact_jacobian_vector_product(True))]
+    ),
+    'fused_hamiltonian': (
+        [cartpole, cartpole_ms, hexacopter],
+        [('separate', {}, None),
+         ('fused', {'use_fused_hamiltonian': True}, None)]
+    ),
+    'fixed_size': (
+        [cartpole, cartpole_ms, hexacopter, mobilerobot],
+        [('dynamic', {}, None),
+         ('fixed', {}, lambda ag: ag.set_fixed_size_gmres(True))]
+    ),
+    'num_threads': (
+        [hexacopter, hexacopter_large],
+        [('1', {}, None),
+         ('2', {}, lambda ag: ag.set_num_threads(2, 0)),
+         ('4', {}, lambda ag: ag.set_num_threads(4, 0))]
+    ),
+    'dense_jacobian': (
+        [cartpole_ms],
+        [('GMRES', {}, None),
+         ('dense_1', {}, lambda ag: ag.set_dense_jacobian(1)),
+         ('dense_5_0.1', {}, lambda ag: ag.set_dense_jacobian(5, 0.1)),
+         ('dense_50_0.1', {}, lambda ag: ag.set_dense_jacobian(50, 0.1)),
+         ('dense_1000_0.1', {}, lambda ag: ag.set_dense_jacobian(1000, 0.1))]
+    ),
+    'uncondensed': (
+        [cartpole_ms, cartpole_uncondensed, cartpole_uncondensed_lu,
+         mobilerobot, mobilerobot_uncondensed, mobilerobot_uncondensed_lu],
+        [('default', {}, None)]
+    ),
+    'runtime_parameters': (
+        [cartpole, cartpole_ms, hexacopter],
+        [('constexpr', {}, None),
+         ('runtime', {'use_runtime_parameters': True}, None),
+         ('runtime_reduced',
+          {'use_runtime_parameters': True, 'use_strength_reduction': True},
+          None)]
+    ),
+    'krylov_recycling': (
+        [cartpole_ms, hexacopter, mobilerobot],
+        [('GMRES', {}, None),
+         ('recycle_2', {}, lambda ag: ag.set_krylov_recycling(2)),
+         ('recycle_4', {}, lambda ag: ag.set_krylov_recycling(4))]
+    ),
+    'riccati_recursion': (
+        [cartpole_ms, mobilerobot, hexacopter],
+        [('GMRES', {}, None),
+         ('riccati', {}, lambda ag: ag.set_riccati_recursion(True))]
+    ),
+    'strength_reduction': (
+        [cartpole, cartpole_ms, hexacopter, mobilerobot],
+        [('default', {}, None),
+         ('reduced', {'use_strength_reduction': True}, None)]
+    ),
+}
+
+
+def run_variant(model, variant, num_runs):
+    """ Generates, builds, and simulates a variant of a model. Returns the
+        best CPU time per control update in seconds, the mean and the
+        maximum of the optimality error, the final state, and the other
+        lines printed by main.cpp after the simulation, e.g., the number of
+        the factorizations of set_dense_jacobian().
+    """
+    variant_name, generate_options, set_options = variant[:3]
+    model_name = model.__name__+'_'+variant_name
+    ag = model(model_name)
+    ag.generate_source_files(False, True, **generate_options)
+    if set_options is not None:
+        set_options(ag)
+    ag.generate_main()
+    ag.generate_cmake()
+    model_dir = os.path.join('models', model_name)
+    if len(variant) > 3:
+        main_path = os.path.join(model_dir, 'main.cpp')
+        with open(main_path) as f:
+            main = f.read()
+        with open(main_path, 'w') as f:
+            f.write(variant[3](main))
+    build_dir = os.path.join(model_dir, 'build')
+    result_dir = os.path.join(model_dir, 'simulation_result')
+    os.makedirs(build_dir, exist_ok=True)
+    os.makedirs(result_dir, exist_ok=True)
+    subprocess.run(['cmake', '..', '-DCMAKE_BUILD_TYPE=Release',
+                    '-DCGMRES_NATIVE_ARCH=ON'],
+                   cwd=build_dir, check=True, stdout=subprocess.DEVNULL)
+    subprocess.run(['cmake', '--build', '.'], cwd=build_dir, check=True,
+                   stdout=subprocess.DEVNULL)
+    cpu_time = math.inf
+    notes = []
+    for i in range(num_runs):
+        output = subprocess.run(['./a.out'], cwd=build_dir, check=True,
+                                stdout=subprocess.PIPE,
+                                universal_newlines=True).stdout
+        for line in output.splitlines():
+            if line.startswith('CPU time for per control update'):
+                cpu_time = min(cpu_time, float(line.split()[-2]))
+            elif line.startswith('Number of') and line not in notes:
+                notes.append(line)
+    def load(name):
+        with open(os.path.join(result_dir, model_name+'_'+name+'.dat')) as f:
+            return [[float(v) for v in line.split()] for line in f
+                    if line.strip()]
+    errors = [row[0] for row in load('error')]
+    error_mean = sum(errors) / len(errors)
+    error_max = max(errors) if not any(map(math.isnan, errors)) else math.nan
+    return cpu_time, error_mean, error_max, load('state')[-1], notes
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('benchmarks', nargs='*', choices=sorted(BENCHMARKS),
+                        metavar='benchmark')
+    parser.add_argument('--runs', type=int, default=5,
+                        help='number of the simulations of each variant')
+    args = parser.parse_args()
+    if not args.benchmarks:
+        print('Available benchmarks: '+', '.join(sorted(BENCHMARKS)))
+        return
+    for benchmark in args.benchmarks:
+        models, variants = BENCHMARKS[benchmark]
+        print(benchmark)
+        print('%-26s %-20s %10s %11s %11s  %s'
+              %('model', 'variant', 'time [us]', 'error mean', 'error max',
+                'final state'))
+        for model in models:
+            for variant in variants:
+                (cpu_time, error_mean, error_max, final_state,
+                 notes) = run_variant(model, variant, args.runs)
+                print('%-26s %-20s %10.1f %11.3e %11.3e  %s'
+                      %(model.__name__, variant[0], cpu_time*1e6, error_mean,
+                        error_max,
+                        ' '.join('%.4g' %v for v in final_state[:4])))
+                for note in notes:
+                    print('  '+note)
+                sys.stdout.flush()
+
+
+if __name__ == '__main__':
+    main()
\ No newline at end of file
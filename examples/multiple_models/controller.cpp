@@ -0,0 +1,86 @@
+// The controllers of both models are compiled in this file. The solvers are 
+// templates on the model, and each nmpc_model.hpp declares NMPCModel in the 
+// namespace named after its model.
+#include "controller.hpp"
+
+#include <chrono>
+#include "hexacopter/nmpc_model.hpp"
+#include "mobilerobot/nmpc_model.hpp"
+#include "multiple_shooting_cgmres.hpp"
+#include "numerical_integrator.hpp"
+
+
+namespace cgmres {
+
+namespace {
+
+template <class Model>
+class MultipleShootingController : public Controller {
+public:
+  MultipleShootingController(const ControllerSettings& settings, 
+                             StageThreadPool& thread_pool)
+    : nmpc_solver_(settings.T_f, settings.alpha, settings.N, 
+                   settings.finite_difference_increment, settings.zeta, 
+                   settings.kmax),
+      integrator_(),
+      state_vec_(settings.initial_state),
+      next_state_vec_(Model::dim_state()),
+      control_input_vec_(Model::dim_control_input()) {
+    nmpc_solver_.setThreadPool(thread_pool, 0);
+    nmpc_solver_.setParametersForInitialization(
+        settings.initial_guess_solution.data(), 
+        settings.newton_residual_tolerance, settings.max_newton_iteration);
+    nmpc_solver_.initializeSolution(0, state_vec_.data());
+    nmpc_solver_.getControlInput(control_input_vec_.data());
+  }
+
+  double update(const double time, const double sampling_period) override {
+    integrator_.rungeKuttaGill(time, state_vec_.data(), 
+                               control_input_vec_.data(), sampling_period, 
+                               next_state_vec_.data());
+    const auto start_clock = std::chrono::system_clock::now();
+    nmpc_solver_.controlUpdate(time, state_vec_.data(), sampling_period, 
+                               control_input_vec_.data());
+    const auto end_clock = std::chrono::system_clock::now();
+    state_vec_.swap(next_state_vec_);
+    return 1e-06 * std::chrono::duration_cast<std::chrono::microseconds>(
+        end_clock-start_clock).count();
+  }
+
+  double errorNorm(const double time) override {
+    return nmpc_solver_.getErrorNorm(time, state_vec_.data());
+  }
+
+  const std::vector<double>& state() const override {
+    return state_vec_;
+  }
+
+private:
+  MultipleShootingCGMRES<Model> nmpc_solver_;
+  NumericalIntegrator<Model> integrator_;
+  std::vector<double> state_vec_, next_state_vec_, control_input_vec_;
+};
+
+} // namespace
+
+namespace hexacopter {
+
+std::unique_ptr<Controller> NewController(const ControllerSettings& settings, 
+                                          StageThreadPool& thread_pool) {
+  return std::unique_ptr<Controller>(
+      new MultipleShootingController<NMPCModel>(settings, thread_pool));
+}
+
+} // namespace hexacopter
+
+namespace mobilerobot {
+
+std::unique_ptr<Controller> NewController(const ControllerSettings& settings, 
+                                          StageThreadPool& thread_pool) {
+  return std::unique_ptr<Controller>(
+      new MultipleShootingController<NMPCModel>(settings, thread_pool));
+}
+
+} // namespace mobilerobot
+
+} // namespace cgmres
\ No newline at end of file
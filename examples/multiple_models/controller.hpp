@@ -0,0 +1,59 @@
+// Interface of the closed loops of the models in the example of several 
+// models in one binary. The solvers of both models are instantiated in 
+// controller.cpp, and main.cpp uses the models only through this interface.
+
+#ifndef CONTROLLER_H
+#define CONTROLLER_H
+
+#include <memory>
+#include <vector>
+#include "stage_thread_pool.hpp"
+
+
+namespace cgmres {
+
+// Parameters of the solver and the initial conditions of a closed loop.
+struct ControllerSettings {
+  double T_f, alpha;
+  int N;
+  double finite_difference_increment, zeta;
+  int kmax;
+  std::vector<double> initial_guess_solution;
+  double newton_residual_tolerance;
+  int max_newton_iteration;
+  std::vector<double> initial_state;
+};
+
+// Closed loop of a model controlled by MultipleShootingCGMRES. 
+class Controller {
+public:
+  virtual ~Controller() {}
+
+  // Integrates the state over sampling_period from time by the current 
+  // control input and updates the control input by controlUpdate() of the 
+  // solver. Returns the CPU time of controlUpdate() in seconds.
+  virtual double update(const double time, const double sampling_period) = 0;
+
+  // Returns the optimality error of the current solution.
+  virtual double errorNorm(const double time) = 0;
+
+  // Returns the current state.
+  virtual const std::vector<double>& state() const = 0;
+};
+
+// Constructs the closed loop of each model whose stages are evaluated by 
+// thread_pool. The functions are defined in controller.cpp.
+namespace hexacopter {
+std::unique_ptr<Controller> NewController(const ControllerSettings& settings, 
+                                          StageThreadPool& thread_pool);
+} // namespace hexacopter
+
+namespace mobilerobot {
+std::unique_ptr<Controller> NewController(const ControllerSettings& settings, 
+                                          StageThreadPool& thread_pool);
+} // namespace mobilerobot
+
+} // namespace cgmres
+
+
+#endif // CONTROLLER_H
\ No newline at end of file
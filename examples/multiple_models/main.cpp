@@ -0,0 +1,70 @@
+// Controls the hexacopter of hexacopter.ipynb and the mobile robot of 
+// mobilerobot.ipynb in one process. The two solvers share one 
+// StageThreadPool and are updated one after another in each sampling period.
+
+#include <iostream>
+#include <cstdlib>
+#include "controller.hpp"
+#include "stage_thread_pool.hpp"
+
+
+int main(int argc, char** argv) {
+  cgmres::StageThreadPool thread_pool;
+  thread_pool.setNumThreads(argc > 1 ? std::atoi(argv[1]) : 2);
+
+  cgmres::ControllerSettings hexacopter_settings;
+  hexacopter_settings.T_f = 1.0;
+  hexacopter_settings.alpha = 1.0;
+  hexacopter_settings.N = 50;
+  hexacopter_settings.finite_difference_increment = 1.0e-08;
+  hexacopter_settings.zeta = 1000;
+  hexacopter_settings.kmax = 10;
+  hexacopter_settings.initial_guess_solution = {1, 1, 1, 1, 1, 1};
+  hexacopter_settings.newton_residual_tolerance = 1.0e-06;
+  hexacopter_settings.max_newton_iteration = 50;
+  hexacopter_settings.initial_state = std::vector<double>(12, 0);
+
+  cgmres::ControllerSettings mobilerobot_settings;
+  mobilerobot_settings.T_f = 1.5;
+  mobilerobot_settings.alpha = 1.0;
+  mobilerobot_settings.N = 50;
+  mobilerobot_settings.finite_difference_increment = 1.0e-08;
+  mobilerobot_settings.zeta = 1000;
+  mobilerobot_settings.kmax = 15;
+  mobilerobot_settings.initial_guess_solution 
+      = {0.1, 0.1, 0.01, 0.01, 0.01, 0.01, 0.01, 0.01};
+  mobilerobot_settings.newton_residual_tolerance = 1.0e-06;
+  mobilerobot_settings.max_newton_iteration = 50;
+  mobilerobot_settings.initial_state = std::vector<double>(3, 0);
+
+  std::unique_ptr<cgmres::Controller> controllers[] = {
+      cgmres::hexacopter::NewController(hexacopter_settings, thread_pool), 
+      cgmres::mobilerobot::NewController(mobilerobot_settings, thread_pool)};
+  const char* names[] = {"hexacopter", "mobilerobot"};
+
+  const double end_time = 10, sampling_period = 0.001;
+  const int num_updates = static_cast<int>(end_time/sampling_period);
+  double total_times[] = {0, 0}, max_errors[] = {0, 0};
+  for (int i=0; i<num_updates; ++i) {
+    const double time = i * sampling_period;
+    for (int j=0; j<2; ++j) {
+      const double error = controllers[j]->errorNorm(time);
+      if (!(error <= max_errors[j])) {
+        max_errors[j] = error;
+      }
+      total_times[j] += controllers[j]->update(time, sampling_period);
+    }
+  }
+
+  std::cout << "Number of threads: " << thread_pool.num_threads() << "\n";
+  for (int j=0; j<2; ++j) {
+    std::cout << names[j] << ": CPU time for per control update: " 
+              << total_times[j]/num_updates << " [sec], max error: " 
+              << max_errors[j] << ", final state:";
+    for (const double x : controllers[j]->state()) {
+      std::cout << " " << x;
+    }
+    std::cout << std::endl;
+  }
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+""" Example of the controllers of several models in one binary.
+
+    Generates the hexacopter of hexacopter.ipynb and the mobile robot of
+    mobilerobot.ipynb in models/hexacopter and models/mobilerobot, builds
+    them with main.cpp in this directory into one executable, and runs it.
+    The two solvers are MultipleShootingCGMRES<cgmres::hexacopter::NMPCModel>
+    and MultipleShootingCGMRES<cgmres::mobilerobot::NMPCModel> and share one
+    StageThreadPool. Run from the root
+    directory of the repository, e.g.,
+
+        python3 examples/multiple_models/multiple_models.py 2
+
+    where the argument is the number of the threads of the pool.
+"""
+
+import os
+import sys
+import subprocess
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '..', '..',
+                             'benchmark'))
+import benchmark
+
+
+def main():
+    for model in [benchmark.hexacopter, benchmark.mobilerobot]:
+        ag = model(model.__name__)
+        ag.generate_source_files(False, True)
+    source_dir = os.path.abspath(os.path.dirname(__file__))
+    build_dir = os.path.join('models', 'multiple_models', 'build')
+    os.makedirs(build_dir, exist_ok=True)
+    subprocess.run(['cmake', source_dir, '-DCMAKE_BUILD_TYPE=Release',
+                    '-DMODELS_DIR='+os.path.abspath('models')],
+                   cwd=build_dir, check=True, stdout=subprocess.DEVNULL)
+    subprocess.run(['cmake', '--build', '.'], cwd=build_dir, check=True,
+                   stdout=subprocess.DEVNULL)
+    subprocess.run(['./multiple_models']+sys.argv[1:], cwd=build_dir,
+                   check=True)
+
+
+if __name__ == '__main__':
+    main()
\ No newline at end of file
@@ -0,0 +1,139 @@
+// Dense matrix stored in a contiguous, aligned, and row-padded array. This 
+// class is used for the workspaces of the solvers instead of the array of 
+// pointers allocated by linearalgebra::NewMatrix().
+
+#ifndef ALIGNED_MATRIX_H
+#define ALIGNED_MATRIX_H
+
+#include <stdexcept>
+#include "linear_algebra.hpp"
+
+
+namespace cgmres {
+
+// Dense row-major matrix whose components are stored in one contiguous array 
+// allocated by linearalgebra::NewAlignedVector(). The array is aligned to 
+// linearalgebra::kAlignment bytes and the length of each row is padded to 
+// linearalgebra::PaddedDimension(dim_column), so that every row is also 
+// aligned and mat[i][j] is computed from a single base pointer. The padded 
+// components are set zero at the allocation. The whole array, i.e., 
+// data()[0], ..., data()[size()-1], can be processed as one vector.
+class AlignedMatrix {
+public:
+  // Constructs an empty matrix that does not allocate memory.
+  AlignedMatrix();
+
+  // Constructs a matrix whose dimensions are given by dim_row and dim_column 
+  // and sets all components zero.
+  AlignedMatrix(const int dim_row, const int dim_column);
+
+  // Free memory of the matrix.
+  ~AlignedMatrix();
+
+  // Reallocates the matrix whose dimensions are given by dim_row and 
+  // dim_column and sets all components zero. If the allocation throws 
+  // std::bad_alloc, the matrix is unchanged. The array of 
+  // FixedSizeAlignedMatrix is not freed but replaced by the allocated one.
+  void resize(const int dim_row, const int dim_column);
+
+  // Returns the pointer to the head of the i-th row.
+  inline double* operator[](const int i) {
+    return data_ + i*stride_;
+  }
+
+  // Returns the pointer to the head of the i-th row.
+  inline const double* operator[](const int i) const {
+    return data_ + i*stride_;
+  }
+
+  // Returns the pointer to the head of the array.
+  inline double* data() {
+    return data_;
+  }
+
+  // Returns the pointer to the head of the array.
+  inline const double* data() const {
+    return data_;
+  }
+
+  // Returns the number of the rows.
+  inline int dim_row() const {
+    return dim_row_;
+  }
+
+  // Returns the number of the columns.
+  inline int dim_column() const {
+    return dim_column_;
+  }
+
+  // Returns the padded length of each row.
+  inline int stride() const {
+    return stride_;
+  }
+
+  // Returns the number of the components of the array including the padding, 
+  // which is equivalent to dim_row*stride.
+  inline int size() const {
+    return dim_row_*stride_;
+  }
+
+  // Prohibits copy due to memory allocation.
+  AlignedMatrix(const AlignedMatrix&) = delete;
+  AlignedMatrix& operator=(const AlignedMatrix&) = delete;
+
+protected:
+  // Constructs a matrix on data, whose length must be at least 
+  // dim_row*linearalgebra::PaddedDimension(dim_column) and which is neither 
+  // set zero nor freed by this class.
+  AlignedMatrix(double* data, const int dim_row, const int dim_column);
+
+private:
+  int dim_row_, dim_column_, stride_;
+  double *data_;
+  bool owns_data_;
+};
+
+// Returns dim rounded up to a multiple of the number of doubles in 
+// linearalgebra::kAlignment bytes as linearalgebra::PaddedDimension() at 
+// compile time.
+constexpr int FixedPaddedDimension(const int dim) {
+  return ((dim+linearalgebra::kAlignment/sizeof(double)-1)
+              / (linearalgebra::kAlignment/sizeof(double))) 
+          * (linearalgebra::kAlignment/sizeof(double));
+}
+
+// AlignedMatrix whose dimensions are fixed at compile time and whose array is 
+// a member of this class, so that no memory is allocated. It is passed to 
+// the functions taking AlignedMatrix as it is. The dimensions passed to the 
+// constructor must be equal to DimRow and DimColumn. Note that the alignment 
+// is guaranteed only for the objects with automatic or static storage 
+// duration in C++11.
+template <int DimRow, int DimColumn>
+class FixedSizeAlignedMatrix : public AlignedMatrix {
+public:
+  // Constructs the matrix with setting all components zero.
+  FixedSizeAlignedMatrix()
+    : AlignedMatrix(array_, DimRow, DimColumn),
+      array_() {
+  }
+
+  // Constructs the matrix with setting all components zero after checking 
+  // the dimensions given at runtime. Throws std::invalid_argument if they are 
+  // not equal to DimRow and DimColumn.
+  FixedSizeAlignedMatrix(const int dim_row, const int dim_column)
+    : FixedSizeAlignedMatrix() {
+    if (dim_row != DimRow || dim_column != DimColumn) {
+      throw std::invalid_argument(
+          "The dimensions of FixedSizeAlignedMatrix do not match");
+    }
+  }
+
+private:
+  alignas(linearalgebra::kAlignment) 
+      double array_[DimRow*FixedPaddedDimension(DimColumn)];
+};
+
+} // namespace cgmres
+
+
+#endif // ALIGNED_MATRIX_H
\ No newline at end of file
@@ -0,0 +1,70 @@
+// Block-Jacobi preconditioner for MatrixFreeGMRES whose blocks are the 
+// Jacobians of the optimality residual of each stage of the horizon.
+
+#ifndef BLOCK_JACOBI_PRECONDITIONER_H
+#define BLOCK_JACOBI_PRECONDITIONER_H
+
+#include "linear_algebra.hpp"
+#include "aligned_matrix.hpp"
+
+
+namespace cgmres {
+
+// Right preconditioner of MatrixFreeGMRES whose preconditioning matrix is 
+// block diagonal. The i-th block is the Jacobian of the optimality residual 
+// of the i-th stage with respect to the control input and the Lagrange 
+// multiplier for the equality constraints of the i-th stage, which is 
+// computed by the continuation classes. The blocks are factorized by 
+// linearalgebra::LUFactorize(). If a block is singular, the block is 
+// replaced with the identity, which only weakens the preconditioning.
+class BlockJacobiPreconditioner {
+public:
+  // Constructs BlockJacobiPreconditioner with num_blocks blocks whose 
+  // dimensions are dim_block and sets all blocks the identity. The blocks 
+  // are allocated at the first call of setColumnOfBlocks() or factorize() 
+  // so that an unused instance is cheap.
+  BlockJacobiPreconditioner(const int num_blocks, const int dim_block);
+
+  // Free vectors and matrices.
+  ~BlockJacobiPreconditioner();
+
+  // Sets the column-th column of all blocks. The column of the i-th block is 
+  // column_seq[i*dim_block], ..., column_seq[(i+1)*dim_block-1]. Call 
+  // factorize() after all columns are set.
+  void setColumnOfBlocks(const int column, const double* column_seq);
+
+  // Computes the LU factorizations of all blocks.
+  void factorize();
+
+  // Computes preconditioned_vec = M^{-1} * vec, where M is the block 
+  // diagonal matrix. This function is called in MatrixFreeGMRES.
+  void apply(const double* vec, double* preconditioned_vec) const;
+
+  // Returns the number of the blocks.
+  int num_blocks() const;
+
+  // Returns the dimension of each block.
+  int dim_block() const;
+
+  // Prohibits copy due to memory allocation.
+  BlockJacobiPreconditioner(const BlockJacobiPreconditioner&) = delete;
+  BlockJacobiPreconditioner& operator=(const BlockJacobiPreconditioner&) 
+      = delete;
+
+private:
+  int num_blocks_, dim_block_;
+  // The i-th block is stored in the rows from i*dim_block_ to 
+  // (i+1)*dim_block_-1.
+  AlignedMatrix block_mat_;
+  int *pivot_seq_;
+  bool *is_singular_seq_;
+
+  // Allocates the blocks and sets all of them the identity if they have not 
+  // been allocated.
+  void allocateBlocks();
+};
+
+} // namespace cgmres
+
+
+#endif // BLOCK_JACOBI_PRECONDITIONER_H
\ No newline at end of file
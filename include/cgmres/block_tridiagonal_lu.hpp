@@ -0,0 +1,91 @@
+// LU factorization of the block-tridiagonal matrix, which is the Jacobian of 
+// the optimality residual of the multiple-shooting optimal control problem 
+// without condensing if the unknowns are ordered stage by stage.
+
+#ifndef BLOCK_TRIDIAGONAL_LU_H
+#define BLOCK_TRIDIAGONAL_LU_H
+
+#include "linear_algebra.hpp"
+#include "aligned_matrix.hpp"
+
+
+namespace cgmres {
+
+// Direct solver of the linear problem whose coefficient matrix is 
+// block-tridiagonal with num_blocks block rows. The i-th block row has the 
+// lower block L_i (coupled with the (i-1)-th block column), the diagonal 
+// block D_i, and the upper block U_i (coupled with the (i+1)-th block 
+// column). The matrix is factorized by the block LU decomposition without 
+// pivoting across the blocks, i.e., by the recursion 
+// D'_i = D_i - L_i * D'_{i-1}^{-1} * U_{i-1}, in which each D'_i is 
+// factorized by linearalgebra::LUFactorize(). If any D'_i is singular, the 
+// whole matrix is regarded as singular and is not solved; see is_singular(). 
+// The cost of factorize() and solve() is linear in num_blocks.
+class BlockTridiagonalLU {
+public:
+  // Constructs BlockTridiagonalLU with num_blocks block rows whose dimensions 
+  // are dim_block. The matrices are allocated at the first call of 
+  // setColumnOfBlock() or factorize() so that an unused instance is cheap.
+  BlockTridiagonalLU(const int num_blocks, const int dim_block);
+
+  // Free vectors and matrices.
+  ~BlockTridiagonalLU();
+
+  // Sets the column-th column of the block of the block_row-th block row and 
+  // the block_column-th block column, which must be block_row-1, block_row, 
+  // or block_row+1, to column_vec. Call factorize() after all columns are 
+  // set.
+  void setColumnOfBlock(const int block_row, const int block_column, 
+                        const int column, const double* column_vec);
+
+  // Computes the block LU factorization. The blocks set by 
+  // setColumnOfBlock() are overwritten. The factorization stops at the first 
+  // singular D'_i, after which is_singular() returns true.
+  void factorize();
+
+  // Computes solution_vec = A^{-1} * vec by the factorization, where vec and 
+  // solution_vec are ordered block by block. Must not be called if 
+  // is_singular() is true.
+  void solve(const double* vec, double* solution_vec) const;
+
+  // Returns true if the latest factorize() found a singular D'_i or if 
+  // factorize() has not been called.
+  bool is_singular() const;
+
+  // Returns the number of the block rows.
+  int num_blocks() const;
+
+  // Returns the dimension of each block.
+  int dim_block() const;
+
+  // Prohibits copy due to memory allocation.
+  BlockTridiagonalLU(const BlockTridiagonalLU&) = delete;
+  BlockTridiagonalLU& operator=(const BlockTridiagonalLU&) = delete;
+
+private:
+  int num_blocks_, dim_block_;
+  // The blocks of the i-th block row are stored in the rows from 
+  // i*dim_block_ to (i+1)*dim_block_-1. After factorize(), diagonal_mat_ 
+  // stores the LU factorizations of D'_i and upper_mat_ stores 
+  // D'_i^{-1} * U_i.
+  AlignedMatrix lower_mat_, diagonal_mat_, upper_mat_;
+  int *pivot_seq_;
+  bool is_singular_;
+  double *column_vec_;
+
+  // Allocates the matrices if they have not been allocated.
+  void allocateMatrices();
+
+  // Computes the LU factorization of the i-th diagonal block in place by 
+  // linearalgebra::LUFactorize(). Returns false if the block is singular.
+  bool factorizeBlock(const int i);
+
+  // Computes vec = D'_i^{-1} * vec by the factorization of the i-th 
+  // diagonal block.
+  void solveBlock(const int i, double* vec) const;
+};
+
+} // namespace cgmres
+
+
+#endif // BLOCK_TRIDIAGONAL_LU_H
\ No newline at end of file
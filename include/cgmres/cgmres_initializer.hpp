@@ -18,6 +18,7 @@ namespace cgmres {
 // whose length is zero by Newton GMRES method. Before using 
 // computeInitialSolution() method, you have to set initial guess solution by 
 // setInitialGuessSolution().
+template <class Model>
 class CGMRESInitializer {
 public:
   // Sets parameters and allocates vectors. 
@@ -68,6 +69,18 @@ public:
                               const double* initial_state_vec, 
                               double* initial_solution_vec);
 
+  // Sets whether the Newton GMRES method computes the products of the 
+  // Jacobian of the optimality residual and the directions exactly by the 
+  // forward-mode automatic differentiation instead of the forward difference 
+  // approximation. The default is false.
+  void setExactJacobianVectorProduct(const bool exact_jacobian_vector_product);
+
+  // Sets the parameters of the model of the Newton GMRES method, which are 
+  // used from the next computeInitialSolution(). See 
+  // OptimalControlProblem::setParameters().
+  template <class Parameters>
+  void setParameters(const Parameters& parameters);
+
   // Computes the initial lambda, which is the Lagrange multiplier of the state 
   // equation. This corresponds to the partial derivative of the terminal cost
   // with respect to the state.
@@ -80,8 +93,8 @@ public:
   int dim_solution() const;
 
 private:
-  NewtonGMRESForOCP<ZeroHorizonOCP> newton_;
-  MatrixFreeGMRES<NewtonGMRESForOCP<ZeroHorizonOCP>, 
+  NewtonGMRESForOCP<ZeroHorizonOCP<Model>> newton_;
+  MatrixFreeGMRES<NewtonGMRESForOCP<ZeroHorizonOCP<Model>>, 
                   const double, const double*, const double*> mfgmres_;
   const int dim_control_input_, dim_constraints_, dim_solution_;
   int max_newton_iteration_;
@@ -89,6 +102,107 @@ private:
   double *initial_guess_solution_vec_, *solution_update_vec_;
 };
 
+template <class Model>
+CGMRESInitializer<Model>::CGMRESInitializer(
+    const double finite_difference_increment, const int kmax, 
+    const double residual_tolerance, const int max_newton_iteration)
+  : newton_(finite_difference_increment),
+    mfgmres_(newton_.dim_solution(), kmax),
+    dim_control_input_(newton_.dim_control_input()),
+    dim_constraints_(newton_.dim_constraints()),
+    dim_solution_(newton_.dim_solution()),
+    max_newton_iteration_(max_newton_iteration),
+    newton_residual_tolerance_(residual_tolerance),
+    initial_guess_solution_vec_(linearalgebra::NewVector(dim_solution_)),
+    solution_update_vec_(linearalgebra::NewVector(dim_solution_)) {
+}
+
+template <class Model>
+CGMRESInitializer<Model>::CGMRESInitializer(
+    const double finite_difference_increment, const int kmax)
+  : newton_(finite_difference_increment),
+    mfgmres_(newton_.dim_solution(), kmax),
+    dim_control_input_(newton_.dim_control_input()),
+    dim_constraints_(newton_.dim_constraints()),
+    dim_solution_(newton_.dim_solution()),
+    max_newton_iteration_(50),
+    newton_residual_tolerance_(1e-08),
+    initial_guess_solution_vec_(linearalgebra::NewVector(dim_solution_)),
+    solution_update_vec_(linearalgebra::NewVector(dim_solution_)) {
+}
+
+template <class Model>
+CGMRESInitializer<Model>::~CGMRESInitializer() {
+  linearalgebra::DeleteVector(initial_guess_solution_vec_);
+  linearalgebra::DeleteVector(solution_update_vec_);
+}
+
+template <class Model>
+void CGMRESInitializer<Model>::setCriterionsOfNewtonTermination(
+    const double newton_residual_tolerance, 
+    const int max_newton_iteration) {
+  newton_residual_tolerance_ = newton_residual_tolerance;
+  max_newton_iteration_ = max_newton_iteration;
+}
+
+template <class Model>
+void CGMRESInitializer<Model>::setInitialGuessSolution(
+    const double* initial_guess_solution) {
+  for (int i=0; i<dim_solution_; ++i) {
+    initial_guess_solution_vec_[i] = initial_guess_solution[i];
+  }
+}
+
+template <class Model>
+void CGMRESInitializer<Model>::computeInitialSolution(
+    const double initial_time, const double* initial_state_vec, 
+    double* initial_solution_vec) {
+  newton_.syncParameters();
+  for (int i=0; i<dim_solution_; ++i) {
+    initial_solution_vec[i] = initial_guess_solution_vec_[i];
+  }
+  int num_itr = 0;
+  double optimality_error = newton_.errorNorm(initial_time, initial_state_vec, 
+                                              initial_solution_vec);
+  while (optimality_error > newton_residual_tolerance_ 
+         && num_itr < max_newton_iteration_) {
+    mfgmres_.solveLinearProblem(newton_, initial_time, initial_state_vec, 
+                                initial_solution_vec, solution_update_vec_);
+    for (int i=0; i<dim_solution_; ++i) {
+      initial_solution_vec[i] += solution_update_vec_[i];
+    }
+    optimality_error = newton_.errorNorm(initial_time, initial_state_vec, 
+                                         initial_solution_vec);
+    ++num_itr;
+  }
+}
+
+template <class Model>
+void CGMRESInitializer<Model>::setExactJacobianVectorProduct(
+    const bool exact_jacobian_vector_product) {
+  newton_.setExactJacobianVectorProduct(exact_jacobian_vector_product);
+}
+
+template <class Model>
+template <class Parameters>
+void CGMRESInitializer<Model>::setParameters(
+    const Parameters& parameters) {
+  newton_.setParameters(parameters);
+}
+
+template <class Model>
+void CGMRESInitializer<Model>::getInitialLambda(
+    const double initial_time, const double* initial_state_vec, 
+    double* initial_lambda_vec) {
+  newton_.getTerminalCostDerivatives(initial_time, initial_state_vec, 
+                                     initial_lambda_vec);
+}
+
+template <class Model>
+int CGMRESInitializer<Model>::dim_solution() const {
+  return dim_solution_;
+}
+
 } // namespace cgmres
 
 #endif // CGMRES_INITIALIZER_H
\ No newline at end of file
@@ -8,9 +8,13 @@
 #define CONTINUATION_GMRES_H
 
 #include "matrixfree_gmres.hpp"
+#include "matrixfree_bicgstab.hpp"
+#include "matrixfree_idrs.hpp"
+#include "dense_lu_solver.hpp"
 #include "cgmres_initializer.hpp"
 #include "single_shooting_continuation.hpp"
 #include "linear_algebra.hpp"
+#include "horizon_storage.hpp"
 
 
 namespace cgmres {
@@ -22,8 +26,25 @@ namespace cgmres {
 // For this initialization, you are required to set parameters by
 // setParametersForInitialization() method and initializeSolution() method. 
 // Without these initialization, all components of the solution is zero.
-class ContinuationGMRES {
+// The matrix-free Krylov method of controlUpdate() is KrylovMethod, which 
+// has the same interface as MatrixFreeGMRES, e.g., MatrixFreeBiCGStab or 
+// MatrixFreeIDRs. ContinuationGMRES is this solver with 
+// ControlUpdateKrylovMethod. 
+// Model is the model of NMPC, e.g., NMPCModel generated by AutoGenU in the 
+// namespace named after the model, so that the solvers of different models 
+// can share one binary. If FixedN is not kDynamicSize, the solution and the 
+// other sequences over the horizon are members of the solver sized by 
+// FixedN, which must be equal to N passed to the constructor, and no memory 
+// is allocated for them. The vectors and matrices of the block-Jacobi 
+// preconditioner and of the dense LU solver are allocated when they are 
+// enabled, and those of the initialization by the constructor.
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN = kDynamicSize>
+class BasicContinuationGMRES {
 public:
+  // The model of NMPC, which the simulator also integrates.
+  using NMPCModel = Model;
+
   // Constructs ContinuationGMRES with setting parameters and allocates vectors 
   // and matrices used in the C/GMRES method. 
   // Arguments:
@@ -37,12 +58,9 @@ public:
   //  kmax: A parameter for the GMRES method. This parameter represents the
   //     dimension of the Krylov subspace and maximum iteration number of the
   //     GMRES method.
-  ContinuationGMRES(const double T_f, const double alpha, const int N,
-                    const double finite_difference_increment,
-                    const double zeta, const int kmax);
-
-  // Free vectors and matrices.
-  ~ContinuationGMRES();
+  BasicContinuationGMRES(const double T_f, const double alpha, const int N, 
+                         const double finite_difference_increment, 
+                         const double zeta, const int kmax);
 
   // Updates the solution by solving the matrix-free GMRES. The optimal control
   // to be applied to the actual system is assigned in control_input_vec.
@@ -82,19 +100,297 @@ public:
   // and the current solution.
   double getErrorNorm(const double time, const double* state_vec);
 
+  // Sets the parameters of the models of the continuation problem and of the 
+  // initialization, which are used from the next controlUpdate() and 
+  // initializeSolution(), respectively. This can be called from any thread, 
+  // also during controlUpdate(), which never waits for it. See 
+  // Model::setParameters().
+  template <class Parameters>
+  void setParameters(const Parameters& parameters);
+
+  // Sets the tolerances of the residual of the GMRES method. The GMRES 
+  // iteration in controlUpdate() terminates as soon as the residual norm is 
+  // less than or equal to max(absolute_tolerance, 
+  // relative_tolerance*(the initial residual norm)). If both of the 
+  // tolerances are zero (default), kmax iterations are always performed.
+  void setGMRESTolerance(const double absolute_tolerance, 
+                         const double relative_tolerance);
+
+  // Sets the maximum number of the restarts of the GMRES method. The GMRES 
+  // method with the kmax-dimensional Krylov subspace is restarted at most 
+  // max_restarts times in controlUpdate() while the residual does not satisfy
+  // the tolerances set by setGMRESTolerance(). The default is zero.
+  void setMaxGMRESRestarts(const int max_restarts);
+
+  // Enables the block-Jacobi preconditioner of the GMRES method. The blocks, 
+  // i.e., the Jacobians of the optimality residual of each stage with respect 
+  // to the control input and the constraints of the stage, are recomputed 
+  // every update_period calls of controlUpdate(). If update_period is zero 
+  // (default), the preconditioner is not used.
+  void setBlockJacobiPreconditioner(const int update_period);
+
+  // Sets whether the Jacobian-vector products in the GMRES method of 
+  // controlUpdate() and of the initialization are computed exactly by the 
+  // forward-mode automatic differentiation, i.e., by the functions of 
+  // Model instantiated with the dual numbers, instead of the forward 
+  // difference approximation with finite_difference_increment. This removes 
+  // the truncation error of the products, which may reduce the GMRES 
+  // iterations needed for a given accuracy. The default is false.
+  void setExactJacobianVectorProduct(const bool exact_jacobian_vector_product);
+
+  // Sets whether the linear problem in controlUpdate() is solved by the LU 
+  // factorization of the explicitly assembled coefficient matrix, i.e., the 
+  // Jacobian of the optimality residual, instead of the GMRES method. 
+  // The matrix is assembled by N*(dim_control_input+dim_constraints) 
+  // directional derivatives and is reused for update_period calls of 
+  // controlUpdate(), which then cost only two triangular solves besides the 
+  // right-hand side. If refresh_tolerance is positive, the solution under the 
+  // frozen matrix is improved by the iterative refinement while its residual 
+  // is larger than refresh_tolerance relative to the right-hand side, and the 
+  // matrix is reassembled if the refinement stalls. See DenseLUSolver. Since 
+  // each reassembly costs as much as N*(dim_control_input+dim_constraints) 
+  // GMRES iterations, this is slower than the GMRES method unless the 
+  // reassemblies are rare; see getNumDenseJacobianFactorizations(). If 
+  // update_period is zero (default), the GMRES method is used. If the 
+  // matrix is singular, the GMRES method is used in that controlUpdate() and 
+  // the matrix is reassembled in the next one.
+  void setDenseJacobian(const int update_period, 
+                        const double refresh_tolerance);
+
+  // Returns the number of the GMRES iterations in the latest controlUpdate().
+  // If setDenseJacobian() is enabled, returns the number of the directional 
+  // derivatives of DenseLUSolver instead.
+  int getGMRESIterations() const;
+
+  // Returns the residual norm of the GMRES method in the latest 
+  // controlUpdate(). If setDenseJacobian() is enabled, returns that of 
+  // DenseLUSolver instead.
+  double getGMRESResidualNorm() const;
+
+  // Returns the number of the factorizations of the Jacobian by 
+  // setDenseJacobian() since the construction of the solver, i.e., how often 
+  // the frozen matrix is refreshed. Returns zero if it is not enabled.
+  int getNumDenseJacobianFactorizations() const;
+
   // Prohibits copy due to memory allocation.
-  ContinuationGMRES(const ContinuationGMRES&) = delete;
-  ContinuationGMRES& operator=(const ContinuationGMRES&) = delete;
+  BasicContinuationGMRES(const BasicContinuationGMRES&) = delete;
+  BasicContinuationGMRES& operator=(const BasicContinuationGMRES&) 
+      = delete;
 
 private:
-  SingleShootingContinuation continuation_problem_;
-  MatrixFreeGMRES<SingleShootingContinuation, const double, const double*, 
-                  const double*> mfgmres_;
-  CGMRESInitializer solution_initializer_;
+  SingleShootingContinuation<Model, FixedN> continuation_problem_;
+  KrylovMethod<SingleShootingContinuation<Model, FixedN>, const double, 
+               const double*, const double*> mfgmres_;
+  CGMRESInitializer<Model> solution_initializer_;
   const int dim_control_input_, dim_constraints_;
-  double *solution_vec_, *solution_update_vec_, *initial_solution_vec_;
+  HorizonArray<double, HorizonSize(FixedN, Model::dim_control_input()
+                                               +Model::dim_constraints())> 
+      solution_vec_, solution_update_vec_;
+  double initial_solution_vec_[
+      Model::dim_control_input()+Model::dim_constraints()];
+  BlockJacobiPreconditioner preconditioner_;
+  int preconditioner_update_period_, num_updates_from_preconditioning_;
+  DenseLUSolver<SingleShootingContinuation<Model, FixedN>, const double, 
+                const double*, const double*> dense_lu_solver_;
+  bool use_dense_jacobian_;
 };
 
+// The solver with the GMRES method selected by ControlUpdateKrylovMethod, 
+// e.g., ContinuationGMRES<NMPCModel> whose N and kmax are given to the 
+// constructor, or ContinuationGMRES<NMPCModel, 50, 10> whose sequences over 
+// the horizon and the Krylov subspace are sized by N = 50 and kmax = 10 at 
+// compile time. 
+template <class Model, int FixedN = kDynamicSize, 
+          int FixedKmax = kDynamicSize>
+using ContinuationGMRES = BasicContinuationGMRES<
+    Model, 
+    ControlUpdateKrylovMethod<
+        FixedKmax, HorizonSize(FixedN, Model::dim_control_input()
+                                           +Model::dim_constraints())>::
+        template Method, 
+    FixedN>;
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+BasicContinuationGMRES<Model, KrylovMethod, FixedN>::BasicContinuationGMRES(
+    const double T_f, const double alpha, const int N, 
+    const double finite_difference_increment, const double zeta, const int kmax)
+  : continuation_problem_(T_f, alpha, N, finite_difference_increment, zeta),
+    mfgmres_(continuation_problem_.dim_solution(), kmax),
+    solution_initializer_(finite_difference_increment, kmax),
+    dim_control_input_(continuation_problem_.dim_control_input()),
+    dim_constraints_(continuation_problem_.dim_constraints()),
+    solution_vec_(continuation_problem_.dim_solution()),
+    solution_update_vec_(continuation_problem_.dim_solution()), 
+    initial_solution_vec_(),
+    preconditioner_(N, dim_control_input_+dim_constraints_),
+    preconditioner_update_period_(0),
+    num_updates_from_preconditioning_(0),
+    dense_lu_solver_(continuation_problem_.dim_solution()),
+    use_dense_jacobian_(false) {
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicContinuationGMRES<Model, KrylovMethod, FixedN>::controlUpdate(
+    const double time, const double* state_vec, const double sampling_period, 
+    double* control_input_vec) {
+  continuation_problem_.syncParameters();
+  if (use_dense_jacobian_) {
+    dense_lu_solver_.solveLinearProblem(continuation_problem_, time, state_vec, 
+                                        solution_vec_, solution_update_vec_);
+    // If the matrix is singular, the GMRES method solves the problem of this 
+    // update and the matrix is reassembled in the next update.
+    if (dense_lu_solver_.is_singular()) {
+      mfgmres_.solveLinearProblem(continuation_problem_, time, state_vec, 
+                                  solution_vec_, solution_update_vec_);
+    }
+  }
+  else if (preconditioner_update_period_ > 0) {
+    if (num_updates_from_preconditioning_ == 0) {
+      continuation_problem_.computeBlockJacobiPreconditioner(
+          time, state_vec, solution_vec_, preconditioner_);
+    }
+    num_updates_from_preconditioning_ = (num_updates_from_preconditioning_+1) 
+                                        % preconditioner_update_period_;
+    mfgmres_.solveLinearProblem(preconditioner_, continuation_problem_, time, 
+                                state_vec, solution_vec_, solution_update_vec_);
+  }
+  else {
+    mfgmres_.solveLinearProblem(continuation_problem_, time, state_vec, 
+                                solution_vec_, solution_update_vec_);
+  }
+  continuation_problem_.integrateSolution(solution_vec_, solution_update_vec_, 
+                                          sampling_period);
+  for (int i=0; i<dim_control_input_; ++i) {
+    control_input_vec[i] = solution_vec_[i];
+  }
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicContinuationGMRES<Model, KrylovMethod, FixedN>::
+setParametersForInitialization(const double* initial_guess_solution, 
+                               const double newton_residual_tolerance, 
+                               const int max_newton_iteration) {
+  solution_initializer_.setInitialGuessSolution(initial_guess_solution);
+  solution_initializer_.setCriterionsOfNewtonTermination(
+      newton_residual_tolerance, max_newton_iteration);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicContinuationGMRES<Model, KrylovMethod, FixedN>::initializeSolution(
+    const double initial_time, const double* initial_state_vec) {
+  continuation_problem_.syncParameters();
+  solution_initializer_.computeInitialSolution(initial_time, initial_state_vec, 
+                                             initial_solution_vec_);
+  for (int i=0; i<continuation_problem_.N(); ++i) {
+    for (int j=0; j<solution_initializer_.dim_solution(); ++j) {
+      solution_vec_[i*(dim_control_input_+dim_constraints_)+j] 
+          = initial_solution_vec_[j];
+    }
+  }
+  continuation_problem_.resetHorizonLength(initial_time);
+  num_updates_from_preconditioning_ = 0;
+  dense_lu_solver_.resetFactorization();
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicContinuationGMRES<Model, KrylovMethod, FixedN>::getControlInput(
+    double* control_input_vec) const {
+  for (int i=0; i<dim_control_input_; ++i) {
+    control_input_vec[i] = solution_vec_[i];
+  }
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+double BasicContinuationGMRES<Model, KrylovMethod, FixedN>::getErrorNorm(
+    const double time, const double* state_vec) {
+  return continuation_problem_.computeErrorNorm(time, state_vec, 
+                                                  solution_vec_);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+template <class Parameters>
+void BasicContinuationGMRES<Model, KrylovMethod, FixedN>::setParameters(
+    const Parameters& parameters) {
+  continuation_problem_.setParameters(parameters);
+  solution_initializer_.setParameters(parameters);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicContinuationGMRES<Model, KrylovMethod, FixedN>::setGMRESTolerance(
+    const double absolute_tolerance, const double relative_tolerance) {
+  mfgmres_.setTolerance(absolute_tolerance, relative_tolerance);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicContinuationGMRES<Model, KrylovMethod, FixedN>::setMaxGMRESRestarts(
+    const int max_restarts) {
+  mfgmres_.setMaxRestarts(max_restarts);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicContinuationGMRES<Model, KrylovMethod, FixedN>::
+setBlockJacobiPreconditioner(const int update_period) {
+  preconditioner_update_period_ = update_period;
+  num_updates_from_preconditioning_ = 0;
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicContinuationGMRES<Model, KrylovMethod, FixedN>::
+setExactJacobianVectorProduct(const bool exact_jacobian_vector_product) {
+  continuation_problem_.setExactJacobianVectorProduct(
+      exact_jacobian_vector_product);
+  solution_initializer_.setExactJacobianVectorProduct(
+      exact_jacobian_vector_product);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicContinuationGMRES<Model, KrylovMethod, FixedN>::setDenseJacobian(
+    const int update_period, const double refresh_tolerance) {
+  use_dense_jacobian_ = (update_period > 0);
+  if (use_dense_jacobian_) {
+    dense_lu_solver_.setUpdatePolicy(update_period, refresh_tolerance);
+  }
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+int BasicContinuationGMRES<Model, KrylovMethod, FixedN>::
+getGMRESIterations() const {
+  if (use_dense_jacobian_ && !dense_lu_solver_.is_singular()) {
+    return dense_lu_solver_.num_iterations();
+  }
+  return mfgmres_.num_iterations();
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+double BasicContinuationGMRES<Model, KrylovMethod, FixedN>::
+getGMRESResidualNorm() const {
+  if (use_dense_jacobian_ && !dense_lu_solver_.is_singular()) {
+    return dense_lu_solver_.residual_norm();
+  }
+  return mfgmres_.residual_norm();
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+int BasicContinuationGMRES<Model, KrylovMethod, FixedN>::
+getNumDenseJacobianFactorizations() const {
+  return dense_lu_solver_.num_factorizations();
+}
+
 } // namespace cgmres
 
 
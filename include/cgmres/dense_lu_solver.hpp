@@ -0,0 +1,242 @@
+// Direct solver of the linear problem of the C/GMRES method that assembles 
+// the coefficient matrix explicitly and reuses its LU factorization over 
+// several control updates. It can be used in the C/GMRES method in place of 
+// MatrixFreeGMRES for small problems.
+
+#ifndef DENSE_LU_SOLVER_H
+#define DENSE_LU_SOLVER_H
+
+#include <cmath>
+#include "linear_algebra.hpp"
+#include "aligned_matrix.hpp"
+
+
+namespace cgmres {
+
+// Solves the linear problem Ax = b provided by LinearProblemGenerator with the 
+// same bFunc() and AxFunc() as MatrixFreeGMRES. The template parameters are 
+// also the same as those of MatrixFreeGMRES. The coefficient matrix A is 
+// assembled column by column by AxFunc() with the unit vectors and is 
+// factorized by the LU decomposition with partial pivoting. The factorization 
+// is frozen and reused in the subsequent calls of solveLinearProblem(), each 
+// of which then costs bFunc() and two triangular solves, until it is 
+// refreshed by the policy set by setUpdatePolicy(). The factorization is 
+// computed by linearalgebra::LUFactorize(). If it regards the matrix as 
+// singular, the solution is not updated and the matrix is reassembled in the 
+// next call; the caller then solves the problem in another way, see 
+// is_singular(). The vectors and the matrix are allocated at the first call 
+// of solveLinearProblem(), i.e., this class costs no memory as long as 
+// solveLinearProblem() is not called.
+template <class LinearProblemGenerator, typename... LinearProblemArgs>
+class DenseLUSolver {
+public:
+  // Constructs DenseLUSolver for the linear problem whose dimension is 
+  // dim_linear_problem. No memory is allocated.
+  DenseLUSolver(const int dim_linear_problem)
+    : dim_linear_problem_(dim_linear_problem), 
+      update_period_(1), 
+      num_updates_from_factorization_(0), 
+      num_iterations_(0), 
+      num_factorizations_(0), 
+      refresh_tolerance_(0), 
+      residual_norm_(0), 
+      is_singular_(true), 
+      lu_mat_(), 
+      pivot_seq_(nullptr), 
+      b_vec_(nullptr), 
+      direction_vec_(nullptr), 
+      ax_vec_(nullptr) {
+  }
+
+  // Free vectors and matrices.
+  ~DenseLUSolver() {
+    delete[] pivot_seq_;
+    linearalgebra::DeleteVector(b_vec_);
+    linearalgebra::DeleteVector(direction_vec_);
+    linearalgebra::DeleteVector(ax_vec_);
+  }
+
+  // Sets the policy of the refresh of the frozen factorization. The matrix 
+  // is reassembled and refactorized every update_period calls of 
+  // solveLinearProblem(), which must be positive. If refresh_tolerance is 
+  // positive, the residual of the solution by the frozen factorization, 
+  // which costs one more AxFunc(), is also checked in each call. While the 
+  // residual norm is larger than refresh_tolerance times the norm of b, the 
+  // solution is improved by the iterative refinement with the frozen 
+  // factorization, and the matrix is refactorized only if the residual does 
+  // not halve or kMaxRefinements = 3 refinements do not suffice. Each 
+  // refactorization costs dim_linear_problem AxFunc() and O(n^3) operations, 
+  // so the policy pays off only if it is rare; see num_factorizations(). 
+  // The default is update_period = 1, i.e., the factorization is not reused, 
+  // and refresh_tolerance = 0.
+  void setUpdatePolicy(const int update_period, 
+                       const double refresh_tolerance) {
+    update_period_ = update_period;
+    refresh_tolerance_ = refresh_tolerance;
+    num_updates_from_factorization_ = 0;
+  }
+
+  // Discards the factorization, which is then recomputed in the next call of 
+  // solveLinearProblem(). 
+  void resetFactorization() {
+    num_updates_from_factorization_ = 0;
+  }
+
+  // Solves the linear problem and adds the solution to solution_vec, i.e., 
+  // solution_vec is the initial guess as MatrixFreeGMRES. If the matrix is 
+  // singular, solution_vec is not changed and is_singular() returns true. 
+  void solveLinearProblem(LinearProblemGenerator& linear_problem_generator,
+                          LinearProblemArgs... linear_problem_args,
+                          double* solution_vec) {
+    if (b_vec_ == nullptr) {
+      allocateVectors();
+    }
+    num_iterations_ = 0;
+    linear_problem_generator.bFunc(linear_problem_args..., solution_vec, 
+                                   b_vec_);
+    bool is_factorized = false;
+    if (num_updates_from_factorization_ == 0) {
+      factorize(linear_problem_generator, linear_problem_args...);
+      is_factorized = true;
+    }
+    if (is_singular_) {
+      residual_norm_ = 0;
+      return;
+    }
+    solveFactorized(b_vec_, direction_vec_);
+    residual_norm_ = 0;
+    if (!is_factorized && refresh_tolerance_ > 0) {
+      const double b_norm 
+          = std::sqrt(linearalgebra::SquaredNorm(dim_linear_problem_, b_vec_));
+      // Iterative refinement by the frozen factorization, i.e., the 
+      // Richardson iteration preconditioned by it. 
+      for (int k=0; ; ++k) {
+        // ax_vec_ = b - A * direction_vec_
+        linear_problem_generator.AxFunc(linear_problem_args..., 
+                                        direction_vec_, ax_vec_);
+        ++num_iterations_;
+        for (int i=0; i<dim_linear_problem_; ++i) {
+          ax_vec_[i] = b_vec_[i] - ax_vec_[i];
+        }
+        const double residual_norm = std::sqrt(
+            linearalgebra::SquaredNorm(dim_linear_problem_, ax_vec_));
+        if (residual_norm <= refresh_tolerance_*b_norm) {
+          residual_norm_ = residual_norm;
+          break;
+        }
+        if (k == kMaxRefinements 
+            || (k > 0 && residual_norm > 0.5*residual_norm_)) {
+          factorize(linear_problem_generator, linear_problem_args...);
+          residual_norm_ = 0;
+          if (is_singular_) {
+            return;
+          }
+          solveFactorized(b_vec_, direction_vec_);
+          break;
+        }
+        residual_norm_ = residual_norm;
+        solveFactorized(ax_vec_, ax_vec_);
+        linearalgebra::AddScaledVector(dim_linear_problem_, 1, ax_vec_, 
+                                       direction_vec_);
+      }
+    }
+    linearalgebra::AddScaledVector(dim_linear_problem_, 1, direction_vec_, 
+                                   solution_vec);
+    num_updates_from_factorization_ = (num_updates_from_factorization_+1) 
+                                      % update_period_;
+  }
+
+  // Returns the number of the calls of AxFunc() in the latest 
+  // solveLinearProblem(), which is dim_linear_problem if the matrix is 
+  // assembled.
+  int num_iterations() const {
+    return num_iterations_;
+  }
+
+  // Returns the residual norm of the solution in the latest 
+  // solveLinearProblem(). This is zero if the matrix is factorized in the 
+  // call, the matrix is singular, or refresh_tolerance is zero, i.e., if the 
+  // residual is not computed.
+  double residual_norm() const {
+    return residual_norm_;
+  }
+
+  // Returns the number of the factorizations, i.e., the assemblies of the 
+  // matrix, since the construction. 
+  int num_factorizations() const {
+    return num_factorizations_;
+  }
+
+  // Returns true if the latest factorization found the matrix singular, in 
+  // which case the latest solveLinearProblem() did not change solution_vec 
+  // and the next one reassembles the matrix.
+  bool is_singular() const {
+    return is_singular_;
+  }
+
+  // Prohibits copy due to memory allocation.
+  DenseLUSolver(const DenseLUSolver&) = delete;
+  DenseLUSolver& operator=(const DenseLUSolver&) = delete;
+
+private:
+  // The maximum number of the iterative refinements by the frozen 
+  // factorization before it is refreshed.
+  static constexpr int kMaxRefinements = 3;
+
+  int dim_linear_problem_, update_period_, num_updates_from_factorization_, 
+      num_iterations_, num_factorizations_;
+  double refresh_tolerance_, residual_norm_;
+  bool is_singular_;
+  AlignedMatrix lu_mat_;
+  int *pivot_seq_;
+  double *b_vec_, *direction_vec_, *ax_vec_;
+
+  // Allocates the vectors and the matrix.
+  void allocateVectors() {
+    lu_mat_.resize(dim_linear_problem_, dim_linear_problem_);
+    pivot_seq_ = new int[dim_linear_problem_];
+    b_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+    direction_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+    ax_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+  }
+
+  // Assembles the coefficient matrix by AxFunc() and computes its LU 
+  // factorization with partial pivoting. If the matrix is singular, 
+  // is_singular_ is set and the factorization is discarded so that the next 
+  // call of solveLinearProblem() reassembles the matrix.
+  void factorize(LinearProblemGenerator& linear_problem_generator,
+                 LinearProblemArgs... linear_problem_args) {
+    for (int i=0; i<dim_linear_problem_; ++i) {
+      direction_vec_[i] = 0;
+    }
+    for (int j=0; j<dim_linear_problem_; ++j) {
+      direction_vec_[j] = 1;
+      linear_problem_generator.AxFunc(linear_problem_args..., direction_vec_, 
+                                      ax_vec_);
+      direction_vec_[j] = 0;
+      for (int i=0; i<dim_linear_problem_; ++i) {
+        lu_mat_[i][j] = ax_vec_[i];
+      }
+    }
+    num_iterations_ += dim_linear_problem_;
+    ++num_factorizations_;
+    num_updates_from_factorization_ = 0;
+    is_singular_ = !linearalgebra::LUFactorize(dim_linear_problem_, 
+                                               lu_mat_.stride(), lu_mat_[0], 
+                                               pivot_seq_);
+  }
+
+  // Computes solution = A^{-1} * vec by the factorization.
+  void solveFactorized(const double* vec, double* solution) const {
+    for (int i=0; i<dim_linear_problem_; ++i) {
+      solution[i] = vec[i];
+    }
+    linearalgebra::LUSolve(dim_linear_problem_, lu_mat_.stride(), lu_mat_[0], 
+                           pivot_seq_, solution);
+  }
+};
+
+} // namespace cgmres
+
+
+#endif // DENSE_LU_SOLVER_H
\ No newline at end of file
@@ -0,0 +1,312 @@
+// Dual number for the forward-mode automatic differentiation. The functions of 
+// NMPCModel are instantiated with this type to compute the exact directional 
+// derivatives of the optimality residual in one sweep instead of the forward 
+// difference approximation.
+
+#ifndef DUAL_NUMBER_H
+#define DUAL_NUMBER_H
+
+#include <cmath>
+
+
+namespace cgmres {
+
+// Dual number value + derivative * epsilon with epsilon^2 = 0. If the inputs 
+// of a function are set as x + v * epsilon, the derivative of the output is 
+// the directional derivative of the function along v. The arithmetic 
+// operators and the mathematical functions that appear in the generated code 
+// of NMPCModel are overloaded. The mathematical functions are hidden friends, 
+// so that they are found only by the argument-dependent lookup and do not 
+// hide the functions of <cmath> for double in namespace cgmres.
+class Dual {
+public:
+  // Constructs zero.
+  constexpr Dual()
+    : value_(0), 
+      derivative_(0) {
+  }
+
+  // Constructs a constant, i.e., a dual number whose derivative is zero. This 
+  // constructor is not explicit so that the parameters and literals of the 
+  // generated code are converted implicitly.
+  constexpr Dual(const double value)
+    : value_(value), 
+      derivative_(0) {
+  }
+
+  // Constructs a dual number whose value and derivative are given.
+  constexpr Dual(const double value, const double derivative)
+    : value_(value), 
+      derivative_(derivative) {
+  }
+
+  // Returns the value.
+  inline double value() const {
+    return value_;
+  }
+
+  // Returns the derivative.
+  inline double derivative() const {
+    return derivative_;
+  }
+
+  inline Dual& operator+=(const Dual& b) {
+    value_ += b.value_;
+    derivative_ += b.derivative_;
+    return *this;
+  }
+
+  inline Dual& operator-=(const Dual& b) {
+    value_ -= b.value_;
+    derivative_ -= b.derivative_;
+    return *this;
+  }
+
+  inline Dual& operator*=(const Dual& b) {
+    derivative_ = derivative_ * b.value_ + value_ * b.derivative_;
+    value_ *= b.value_;
+    return *this;
+  }
+
+  inline Dual& operator/=(const Dual& b) {
+    const double inverse = 1.0 / b.value_;
+    value_ *= inverse;
+    derivative_ = (derivative_ - value_ * b.derivative_) * inverse;
+    return *this;
+  }
+
+  friend inline Dual operator+(const Dual& a) {
+    return a;
+  }
+
+  friend inline Dual operator-(const Dual& a) {
+    return Dual(-a.value_, -a.derivative_);
+  }
+
+  friend inline Dual operator+(const Dual& a, const Dual& b) {
+    return Dual(a.value_+b.value_, a.derivative_+b.derivative_);
+  }
+
+  friend inline Dual operator+(const Dual& a, const double b) {
+    return Dual(a.value_+b, a.derivative_);
+  }
+
+  friend inline Dual operator+(const double a, const Dual& b) {
+    return Dual(a+b.value_, b.derivative_);
+  }
+
+  friend inline Dual operator-(const Dual& a, const Dual& b) {
+    return Dual(a.value_-b.value_, a.derivative_-b.derivative_);
+  }
+
+  friend inline Dual operator-(const Dual& a, const double b) {
+    return Dual(a.value_-b, a.derivative_);
+  }
+
+  friend inline Dual operator-(const double a, const Dual& b) {
+    return Dual(a-b.value_, -b.derivative_);
+  }
+
+  friend inline Dual operator*(const Dual& a, const Dual& b) {
+    return Dual(a.value_*b.value_, 
+                a.derivative_*b.value_+a.value_*b.derivative_);
+  }
+
+  friend inline Dual operator*(const Dual& a, const double b) {
+    return Dual(a.value_*b, a.derivative_*b);
+  }
+
+  friend inline Dual operator*(const double a, const Dual& b) {
+    return Dual(a*b.value_, a*b.derivative_);
+  }
+
+  friend inline Dual operator/(const Dual& a, const Dual& b) {
+    const double inverse = 1.0 / b.value_;
+    const double value = a.value_ * inverse;
+    return Dual(value, (a.derivative_-value*b.derivative_)*inverse);
+  }
+
+  friend inline Dual operator/(const Dual& a, const double b) {
+    const double inverse = 1.0 / b;
+    return Dual(a.value_*inverse, a.derivative_*inverse);
+  }
+
+  friend inline Dual operator/(const double a, const Dual& b) {
+    const double inverse = 1.0 / b.value_;
+    const double value = a * inverse;
+    return Dual(value, -value*b.derivative_*inverse);
+  }
+
+  // The comparisons are performed on the values, e.g., for the conditions of 
+  // piecewise functions.
+  friend inline bool operator<(const Dual& a, const Dual& b) {
+    return a.value_ < b.value_;
+  }
+
+  friend inline bool operator<(const Dual& a, const double b) {
+    return a.value_ < b;
+  }
+
+  friend inline bool operator<(const double a, const Dual& b) {
+    return a < b.value_;
+  }
+
+  friend inline bool operator>(const Dual& a, const Dual& b) {
+    return a.value_ > b.value_;
+  }
+
+  friend inline bool operator>(const Dual& a, const double b) {
+    return a.value_ > b;
+  }
+
+  friend inline bool operator>(const double a, const Dual& b) {
+    return a > b.value_;
+  }
+
+  friend inline bool operator<=(const Dual& a, const Dual& b) {
+    return a.value_ <= b.value_;
+  }
+
+  friend inline bool operator<=(const Dual& a, const double b) {
+    return a.value_ <= b;
+  }
+
+  friend inline bool operator<=(const double a, const Dual& b) {
+    return a <= b.value_;
+  }
+
+  friend inline bool operator>=(const Dual& a, const Dual& b) {
+    return a.value_ >= b.value_;
+  }
+
+  friend inline bool operator>=(const Dual& a, const double b) {
+    return a.value_ >= b;
+  }
+
+  friend inline bool operator>=(const double a, const Dual& b) {
+    return a >= b.value_;
+  }
+
+  friend inline Dual sqrt(const Dual& a) {
+    const double value = std::sqrt(a.value_);
+    return Dual(value, 0.5*a.derivative_/value);
+  }
+
+  friend inline Dual exp(const Dual& a) {
+    const double value = std::exp(a.value_);
+    return Dual(value, value*a.derivative_);
+  }
+
+  friend inline Dual log(const Dual& a) {
+    return Dual(std::log(a.value_), a.derivative_/a.value_);
+  }
+
+  friend inline Dual sin(const Dual& a) {
+    return Dual(std::sin(a.value_), std::cos(a.value_)*a.derivative_);
+  }
+
+  friend inline Dual cos(const Dual& a) {
+    return Dual(std::cos(a.value_), -std::sin(a.value_)*a.derivative_);
+  }
+
+  // Computes sin(a) and cos(a) at once, sharing std::sin() and std::cos() 
+  // of the value between them.
+  friend inline void sincos(const Dual& a, Dual* sin_a, Dual* cos_a) {
+    const double sin_value = std::sin(a.value_);
+    const double cos_value = std::cos(a.value_);
+    *sin_a = Dual(sin_value, cos_value*a.derivative_);
+    *cos_a = Dual(cos_value, -sin_value*a.derivative_);
+  }
+
+  friend inline Dual tan(const Dual& a) {
+    const double value = std::tan(a.value_);
+    return Dual(value, (1+value*value)*a.derivative_);
+  }
+
+  friend inline Dual asin(const Dual& a) {
+    return Dual(std::asin(a.value_), 
+                a.derivative_/std::sqrt(1-a.value_*a.value_));
+  }
+
+  friend inline Dual acos(const Dual& a) {
+    return Dual(std::acos(a.value_), 
+                -a.derivative_/std::sqrt(1-a.value_*a.value_));
+  }
+
+  friend inline Dual atan(const Dual& a) {
+    return Dual(std::atan(a.value_), a.derivative_/(1+a.value_*a.value_));
+  }
+
+  friend inline Dual atan2(const Dual& a, const Dual& b) {
+    const double squared_norm = a.value_*a.value_ + b.value_*b.value_;
+    return Dual(std::atan2(a.value_, b.value_), 
+                (b.value_*a.derivative_-a.value_*b.derivative_)
+                / squared_norm);
+  }
+
+  friend inline Dual sinh(const Dual& a) {
+    return Dual(std::sinh(a.value_), std::cosh(a.value_)*a.derivative_);
+  }
+
+  friend inline Dual cosh(const Dual& a) {
+    return Dual(std::cosh(a.value_), std::sinh(a.value_)*a.derivative_);
+  }
+
+  friend inline Dual tanh(const Dual& a) {
+    const double value = std::tanh(a.value_);
+    return Dual(value, (1-value*value)*a.derivative_);
+  }
+
+  friend inline Dual fabs(const Dual& a) {
+    return (a.value_ < 0) ? -a : a;
+  }
+
+  friend inline Dual abs(const Dual& a) {
+    return (a.value_ < 0) ? -a : a;
+  }
+
+  // The exponent of the form pow(x, 2) in the generated code is integral and 
+  // the derivative is computed without the logarithm. The value is computed 
+  // by the power b itself, not by the power b-1 times a, so that it is exact 
+  // at a = 0 for 0 < b < 1, where the power b-1 is infinite.
+  friend inline Dual pow(const Dual& a, const double b) {
+    if (b == 0) {
+      return Dual(1);
+    }
+    const double value = std::pow(a.value_, b);
+    if (a.derivative_ == 0) {
+      return Dual(value);
+    }
+    if (a.value_ == 0) {
+      return Dual(value, b*std::pow(a.value_, b-1)*a.derivative_);
+    }
+    return Dual(value, b*value/a.value_*a.derivative_);
+  }
+
+  friend inline Dual pow(const double a, const Dual& b) {
+    const double value = std::pow(a, b.value_);
+    return Dual(value, value*std::log(a)*b.derivative_);
+  }
+
+  friend inline Dual pow(const Dual& a, const Dual& b) {
+    const double value = std::pow(a.value_, b.value_);
+    return Dual(value, 
+                value*(b.derivative_*std::log(a.value_)
+                       +b.value_*a.derivative_/a.value_));
+  }
+
+private:
+  double value_, derivative_;
+};
+
+// Computes sin(a) and cos(a) at once. The compilers merge the two calls 
+// into one call of sincos where the platform provides it.
+inline void sincos(const double a, double* sin_a, double* cos_a) {
+  *sin_a = std::sin(a);
+  *cos_a = std::cos(a);
+}
+
+} // namespace cgmres
+
+
+#endif // DUAL_NUMBER_H
\ No newline at end of file
@@ -0,0 +1,583 @@
+// Workspaces of the matrix-free GMRES method. DynamicGMRESWorkspace allocates 
+// the vectors and matrices whose dimensions are given at runtime. 
+// FixedSizeGMRESWorkspace stores them in arrays whose dimensions are fixed at 
+// compile time, so that the loops over them have constant bounds and no heap 
+// allocation is needed. MixedPrecisionGMRESWorkspace stores the basis of the 
+// Krylov subspace in single precision. 
+// 
+// In addition to the vectors and matrices, a workspace provides 
+// basisWorkVec(k), the double-precision vector in which the k-th basis vector 
+// is computed, storeBasisVec(k, scale), which sets the k-th basis vector 
+// scale*basisWorkVec(k), loadBasisVec(k), which sets basisWorkVec(k) the k-th 
+// basis vector, and basisVec(k), which returns the k-th basis vector in 
+// double precision. If the basis is stored in double precision, 
+// basisWorkVec(k) and basisVec(k) are basis_mat_[k] itself and loadBasisVec() 
+// does nothing. A workspace also provides applyGivensRotations(k, column_vec), 
+// which applies the first k Givens rotations to a column of the Hessenberg 
+// matrix, and solveHessenberg(k), which solves the k-dimensional least 
+// squares problem by the back substitution. FixedSizeGMRESWorkspace unrolls 
+// them for each k at compile time.
+
+#ifndef GMRES_WORKSPACE_H
+#define GMRES_WORKSPACE_H
+
+#include <algorithm>
+#include <stdexcept>
+#include "linear_algebra.hpp"
+#include "aligned_matrix.hpp"
+
+
+namespace cgmres {
+
+namespace givensrotations {
+
+// Applies the i-th Givens rotation given by c and s to the i-th and the 
+// (i+1)-th components of column_vec.
+inline void Rotate(const double c, const double s, const int i, 
+                   double* column_vec) {
+  const double tmp1 = c * column_vec[i] - s * column_vec[i+1];
+  const double tmp2 = s * column_vec[i] + c * column_vec[i+1];
+  column_vec[i] = tmp1;
+  column_vec[i+1] = tmp2;
+}
+
+// Applies the 0-th, ..., (k-1)-th Givens rotations given by c_vec and s_vec 
+// to column_vec in this order.
+inline void RotateColumn(const int k, const double* c_vec, 
+                         const double* s_vec, double* column_vec) {
+  for (int j=0; j<k; ++j) {
+    Rotate(c_vec[j], s_vec[j], j, column_vec);
+  }
+}
+
+// Solves the k-dimensional upper triangular system whose j-th column is the 
+// j-th row of mat, i.e., the Hessenberg matrix after the Givens rotations, 
+// for the right-hand side g_vec by the back substitution and stores the 
+// solution in y_vec.
+template <class Matrix>
+inline void SolveUpperTriangular(const int k, const Matrix& mat, 
+                                 const double* g_vec, double* y_vec) {
+  for (int i=k-1; i>=0; --i) {
+    double tmp = g_vec[i];
+    for (int j=i+1; j<k; ++j) {
+      tmp -= mat[j][i] * y_vec[j];
+    }
+    y_vec[i] = tmp / mat[i][i];
+  }
+}
+
+// RotateColumn() with k = K unrolled at compile time.
+template <int K>
+struct UnrolledRotateColumn {
+  static inline void apply(const double* c_vec, const double* s_vec, 
+                           double* column_vec) {
+    UnrolledRotateColumn<K-1>::apply(c_vec, s_vec, column_vec);
+    Rotate(c_vec[K-1], s_vec[K-1], K-1, column_vec);
+  }
+};
+
+template <>
+struct UnrolledRotateColumn<0> {
+  static inline void apply(const double*, const double*, double*) {
+  }
+};
+
+// Subtracts mat[j][i] * y_vec[j] from tmp for j = J, ..., K-1 in this order 
+// as SolveUpperTriangular(), unrolled at compile time.
+template <int J, int K>
+struct UnrolledSubtractRow {
+  template <class Matrix>
+  static inline double apply(const double tmp, const Matrix& mat, 
+                             const int i, const double* y_vec) {
+    return UnrolledSubtractRow<J+1, K>::apply(tmp-mat[J][i]*y_vec[J], mat, 
+                                              i, y_vec);
+  }
+};
+
+template <int K>
+struct UnrolledSubtractRow<K, K> {
+  template <class Matrix>
+  static inline double apply(const double tmp, const Matrix&, const int, 
+                             const double*) {
+    return tmp;
+  }
+};
+
+// The rows I, I-1, ..., 0 of SolveUpperTriangular() with k = K unrolled at 
+// compile time.
+template <int K, int I>
+struct UnrolledSolveUpperTriangular {
+  template <class Matrix>
+  static inline void apply(const Matrix& mat, const double* g_vec, 
+                           double* y_vec) {
+    y_vec[I] = UnrolledSubtractRow<I+1, K>::apply(g_vec[I], mat, I, y_vec) 
+                / mat[I][I];
+    UnrolledSolveUpperTriangular<K, I-1>::apply(mat, g_vec, y_vec);
+  }
+};
+
+template <int K>
+struct UnrolledSolveUpperTriangular<K, -1> {
+  template <class Matrix>
+  static inline void apply(const Matrix&, const double*, double*) {
+  }
+};
+
+// Calls the unrolled RotateColumn() and SolveUpperTriangular() whose k is 
+// equal to the k given at runtime, which must not be larger than KMax. The 
+// comparisons are predicted well because k increases one by one in the 
+// Arnoldi process.
+template <int KMax>
+struct UnrolledDispatch {
+  static inline void rotateColumn(const int k, const double* c_vec, 
+                                  const double* s_vec, double* column_vec) {
+    if (k == KMax) {
+      UnrolledRotateColumn<KMax>::apply(c_vec, s_vec, column_vec);
+    }
+    else {
+      UnrolledDispatch<KMax-1>::rotateColumn(k, c_vec, s_vec, column_vec);
+    }
+  }
+
+  template <class Matrix>
+  static inline void solveUpperTriangular(const int k, const Matrix& mat, 
+                                          const double* g_vec, 
+                                          double* y_vec) {
+    if (k == KMax) {
+      UnrolledSolveUpperTriangular<KMax, KMax-1>::apply(mat, g_vec, y_vec);
+    }
+    else {
+      UnrolledDispatch<KMax-1>::solveUpperTriangular(k, mat, g_vec, y_vec);
+    }
+  }
+};
+
+template <>
+struct UnrolledDispatch<0> {
+  static inline void rotateColumn(const int, const double*, const double*, 
+                                  double*) {
+  }
+
+  template <class Matrix>
+  static inline void solveUpperTriangular(const int, const Matrix&, 
+                                          const double*, double*) {
+  }
+};
+
+} // namespace givensrotations
+
+// Workspace of BasicMatrixFreeGMRES whose dimension of the linear problem and 
+// that of the Krylov subspace are given at runtime. The vectors are allocated 
+// by linearalgebra::NewVector() and the matrices are AlignedMatrix.
+class DynamicGMRESWorkspace {
+protected:
+  // Constructs the workspace with setting both dimensions zero, sets nullptr 
+  // for all vectors, and leaves all matrices empty.
+  DynamicGMRESWorkspace()
+    : dim_linear_problem_(0),
+      kmax_(0),
+      hessenberg_mat_(),
+      basis_mat_(),
+      givens_c_vec_(nullptr),
+      givens_s_vec_(nullptr),
+      g_vec_(nullptr),
+      restart_vec_(nullptr),
+      preconditioned_vec_(nullptr),
+      krylov_solution_vec_(nullptr) {
+  }
+
+  // Constructs the workspace with setting dimension of the linear problem 
+  // dim_linear_problem and that of the Krylov subspace as kmax, and allocates 
+  // all vectors and all matrices. kmax is reduced to dim_linear_problem if 
+  // it is larger than dim_linear_problem.
+  DynamicGMRESWorkspace(const int dim_linear_problem, const int kmax)
+    : dim_linear_problem_(dim_linear_problem),
+      kmax_(std::min(kmax, dim_linear_problem)),
+      hessenberg_mat_(kmax+1, kmax+1),
+      basis_mat_(kmax+1, dim_linear_problem),
+      givens_c_vec_(linearalgebra::NewVector(kmax+1)),
+      givens_s_vec_(linearalgebra::NewVector(kmax+1)),
+      g_vec_(linearalgebra::NewVector(kmax+1)),
+      restart_vec_(linearalgebra::NewVector(kmax+1)),
+      preconditioned_vec_(linearalgebra::NewVector(dim_linear_problem)),
+      krylov_solution_vec_(linearalgebra::NewVector(dim_linear_problem)) {
+  }
+
+  // Frees memory of the vectors.
+  ~DynamicGMRESWorkspace() {
+    linearalgebra::DeleteVector(givens_c_vec_);
+    linearalgebra::DeleteVector(givens_s_vec_);
+    linearalgebra::DeleteVector(g_vec_);
+    linearalgebra::DeleteVector(restart_vec_);
+    linearalgebra::DeleteVector(preconditioned_vec_);
+    linearalgebra::DeleteVector(krylov_solution_vec_);
+  }
+
+  // Sets dimensions of the linear problem and that of the Krylov subspace and 
+  // reallocates all vectors and all matrices.
+  void resizeWorkspace(const int dim_linear_problem, const int kmax) {
+    linearalgebra::DeleteVector(givens_c_vec_);
+    linearalgebra::DeleteVector(givens_s_vec_);
+    linearalgebra::DeleteVector(g_vec_);
+    linearalgebra::DeleteVector(restart_vec_);
+    linearalgebra::DeleteVector(preconditioned_vec_);
+    linearalgebra::DeleteVector(krylov_solution_vec_);
+    dim_linear_problem_ = dim_linear_problem;
+    kmax_ = std::min(kmax, dim_linear_problem);
+    hessenberg_mat_.resize(kmax+1, kmax+1);
+    basis_mat_.resize(kmax+1, dim_linear_problem);
+    givens_c_vec_ = linearalgebra::NewVector(kmax+1);
+    givens_s_vec_ = linearalgebra::NewVector(kmax+1);
+    g_vec_ = linearalgebra::NewVector(kmax+1);
+    restart_vec_ = linearalgebra::NewVector(kmax+1);
+    preconditioned_vec_ = linearalgebra::NewVector(dim_linear_problem);
+    krylov_solution_vec_ = linearalgebra::NewVector(dim_linear_problem);
+  }
+
+  inline double* basisWorkVec(const int k) {
+    return basis_mat_[k];
+  }
+
+  inline void storeBasisVec(const int k, const double scale) {
+    if (scale != 1) {
+      linearalgebra::ScaleVector(dim_linear_problem_, scale, basis_mat_[k]);
+    }
+  }
+
+  inline void loadBasisVec(const int k) {
+    (void)k;
+  }
+
+  inline const double* basisVec(const int k) const {
+    return basis_mat_[k];
+  }
+
+  inline void applyGivensRotations(const int k, double* column_vec) const {
+    givensrotations::RotateColumn(k, givens_c_vec_, givens_s_vec_, 
+                                  column_vec);
+  }
+
+  inline void solveHessenberg(const int k) {
+    givensrotations::SolveUpperTriangular(k, hessenberg_mat_, g_vec_, 
+                                          givens_c_vec_);
+  }
+
+  // Prohibits copy due to memory allocation.
+  DynamicGMRESWorkspace(const DynamicGMRESWorkspace&) = delete;
+  DynamicGMRESWorkspace& operator=(const DynamicGMRESWorkspace&) = delete;
+
+  int dim_linear_problem_, kmax_;
+  AlignedMatrix hessenberg_mat_, basis_mat_;
+  double *givens_c_vec_, *givens_s_vec_, *g_vec_, *restart_vec_,
+      *preconditioned_vec_, *krylov_solution_vec_;
+};
+
+// Dense row-major matrix of single-precision components whose dimensions are 
+// given at runtime. As in AlignedMatrix, the array is allocated by 
+// linearalgebra::NewAlignedFloatVector(), i.e., aligned to 
+// linearalgebra::kAlignment bytes, and the length of each row is padded to 
+// linearalgebra::PaddedDimension(dim_column).
+class SinglePrecisionMatrix {
+public:
+  // Constructs an empty matrix that does not allocate memory.
+  SinglePrecisionMatrix()
+    : stride_(0),
+      data_(nullptr) {
+  }
+
+  // Free memory of the matrix.
+  ~SinglePrecisionMatrix() {
+    linearalgebra::DeleteAlignedVector(data_);
+  }
+
+  // Reallocates the matrix whose dimensions are given by dim_row and 
+  // dim_column and sets all components zero. If the allocation throws 
+  // std::bad_alloc, the matrix is unchanged.
+  void resize(const int dim_row, const int dim_column) {
+    const int stride = linearalgebra::PaddedDimension(dim_column);
+    float* data = linearalgebra::NewAlignedFloatVector(dim_row*stride);
+    linearalgebra::DeleteAlignedVector(data_);
+    stride_ = stride;
+    data_ = data;
+  }
+
+  // Returns the pointer to the head of the i-th row.
+  inline float* operator[](const int i) {
+    return data_ + i*stride_;
+  }
+
+  // Returns the pointer to the head of the i-th row.
+  inline const float* operator[](const int i) const {
+    return data_ + i*stride_;
+  }
+
+  // Returns the padded length of each row.
+  inline int stride() const {
+    return stride_;
+  }
+
+  // Prohibits copy due to memory allocation.
+  SinglePrecisionMatrix(const SinglePrecisionMatrix&) = delete;
+  SinglePrecisionMatrix& operator=(const SinglePrecisionMatrix&) = delete;
+
+private:
+  int stride_;
+  float *data_;
+};
+
+// Workspace of BasicMatrixFreeGMRES whose dimensions are given at runtime 
+// and whose basis of the Krylov subspace basis_mat_ is stored in single 
+// precision. This halves the memory of the basis and the memory traffic of 
+// the orthogonalization, which streams the whole basis in every iteration. 
+// The conversions cost as much as the saved traffic as long as the basis 
+// fits in the cache, e.g., for the sample models. The Hessenberg matrix, the 
+// Givens rotations, and the update of the solution are computed in double 
+// precision. Each basis vector is computed in double precision in 
+// arnoldi_vec_ and is rounded to single precision when it is stored.
+class MixedPrecisionGMRESWorkspace {
+protected:
+  // Constructs the workspace with setting both dimensions zero, sets nullptr 
+  // for all vectors, and leaves all matrices empty.
+  MixedPrecisionGMRESWorkspace()
+    : dim_linear_problem_(0),
+      kmax_(0),
+      hessenberg_mat_(),
+      basis_mat_(),
+      givens_c_vec_(nullptr),
+      givens_s_vec_(nullptr),
+      g_vec_(nullptr),
+      restart_vec_(nullptr),
+      preconditioned_vec_(nullptr),
+      krylov_solution_vec_(nullptr),
+      arnoldi_vec_(nullptr),
+      direction_vec_(nullptr) {
+  }
+
+  // Constructs the workspace with setting dimension of the linear problem 
+  // dim_linear_problem and that of the Krylov subspace as kmax, and allocates 
+  // all vectors and all matrices. 
+  MixedPrecisionGMRESWorkspace(const int dim_linear_problem, const int kmax)
+    : MixedPrecisionGMRESWorkspace() {
+    resizeWorkspace(dim_linear_problem, kmax);
+  }
+
+  // Frees memory of the vectors.
+  ~MixedPrecisionGMRESWorkspace() {
+    linearalgebra::DeleteVector(givens_c_vec_);
+    linearalgebra::DeleteVector(givens_s_vec_);
+    linearalgebra::DeleteVector(g_vec_);
+    linearalgebra::DeleteVector(restart_vec_);
+    linearalgebra::DeleteVector(preconditioned_vec_);
+    linearalgebra::DeleteVector(krylov_solution_vec_);
+    linearalgebra::DeleteVector(arnoldi_vec_);
+    linearalgebra::DeleteVector(direction_vec_);
+  }
+
+  // Sets dimensions of the linear problem and that of the Krylov subspace and 
+  // reallocates all vectors and all matrices.
+  void resizeWorkspace(const int dim_linear_problem, const int kmax) {
+    linearalgebra::DeleteVector(givens_c_vec_);
+    linearalgebra::DeleteVector(givens_s_vec_);
+    linearalgebra::DeleteVector(g_vec_);
+    linearalgebra::DeleteVector(restart_vec_);
+    linearalgebra::DeleteVector(preconditioned_vec_);
+    linearalgebra::DeleteVector(krylov_solution_vec_);
+    linearalgebra::DeleteVector(arnoldi_vec_);
+    linearalgebra::DeleteVector(direction_vec_);
+    dim_linear_problem_ = dim_linear_problem;
+    kmax_ = std::min(kmax, dim_linear_problem);
+    hessenberg_mat_.resize(kmax+1, kmax+1);
+    basis_mat_.resize(kmax+1, dim_linear_problem);
+    givens_c_vec_ = linearalgebra::NewVector(kmax+1);
+    givens_s_vec_ = linearalgebra::NewVector(kmax+1);
+    g_vec_ = linearalgebra::NewVector(kmax+1);
+    restart_vec_ = linearalgebra::NewVector(kmax+1);
+    preconditioned_vec_ = linearalgebra::NewVector(dim_linear_problem);
+    krylov_solution_vec_ = linearalgebra::NewVector(dim_linear_problem);
+    arnoldi_vec_ = linearalgebra::NewVector(dim_linear_problem);
+    direction_vec_ = linearalgebra::NewVector(dim_linear_problem);
+  }
+
+  inline double* basisWorkVec(const int k) {
+    (void)k;
+    return arnoldi_vec_;
+  }
+
+  inline void storeBasisVec(const int k, const double scale) {
+    linearalgebra::ConvertVector(dim_linear_problem_, scale, arnoldi_vec_, 
+                                 basis_mat_[k]);
+  }
+
+  inline void loadBasisVec(const int k) {
+    linearalgebra::ConvertVector(dim_linear_problem_, basis_mat_[k], 
+                                 arnoldi_vec_);
+  }
+
+  inline const double* basisVec(const int k) {
+    linearalgebra::ConvertVector(dim_linear_problem_, basis_mat_[k], 
+                                 direction_vec_);
+    return direction_vec_;
+  }
+
+  inline void applyGivensRotations(const int k, double* column_vec) const {
+    givensrotations::RotateColumn(k, givens_c_vec_, givens_s_vec_, 
+                                  column_vec);
+  }
+
+  inline void solveHessenberg(const int k) {
+    givensrotations::SolveUpperTriangular(k, hessenberg_mat_, g_vec_, 
+                                          givens_c_vec_);
+  }
+
+  // Prohibits copy due to memory allocation.
+  MixedPrecisionGMRESWorkspace(const MixedPrecisionGMRESWorkspace&) = delete;
+  MixedPrecisionGMRESWorkspace& operator=(
+      const MixedPrecisionGMRESWorkspace&) = delete;
+
+  int dim_linear_problem_, kmax_;
+  AlignedMatrix hessenberg_mat_;
+  SinglePrecisionMatrix basis_mat_;
+  double *givens_c_vec_, *givens_s_vec_, *g_vec_, *restart_vec_,
+      *preconditioned_vec_, *krylov_solution_vec_, *arnoldi_vec_, 
+      *direction_vec_;
+};
+
+// Dense row-major matrix whose dimensions are fixed at compile time. As in 
+// AlignedMatrix, the array is aligned to linearalgebra::kAlignment bytes and 
+// the length of each row is padded to FixedPaddedDimension(DimColumn). The 
+// components are set zero at the construction. mat[i] returns the pointer to 
+// the head of the i-th row. Note that the alignment is guaranteed only for 
+// the objects with automatic or static storage duration in C++11.
+template <int DimRow, int DimColumn>
+class FixedSizeMatrix {
+public:
+  // Constructs the matrix with setting all components zero.
+  FixedSizeMatrix()
+    : data_() {
+  }
+
+  // Returns the pointer to the head of the i-th row.
+  inline double* operator[](const int i) {
+    return data_ + i*kStride;
+  }
+
+  // Returns the pointer to the head of the i-th row.
+  inline const double* operator[](const int i) const {
+    return data_ + i*kStride;
+  }
+
+  // Returns the padded length of each row.
+  inline int stride() const {
+    return kStride;
+  }
+
+private:
+  static constexpr int kStride = FixedPaddedDimension(DimColumn);
+  alignas(linearalgebra::kAlignment) double data_[DimRow*kStride];
+};
+
+// Workspace of BasicMatrixFreeGMRES whose dimension of the linear problem 
+// DimLinearProblem and that of the Krylov subspace Kmax are fixed at compile 
+// time. All vectors and matrices are members of this class and no memory is 
+// allocated. The vectors are aligned and padded as those allocated by 
+// linearalgebra::NewAlignedVector(). The Givens rotations and the back 
+// substitution are unrolled for each dimension of the Krylov subspace up to 
+// Kmax. The dimensions passed at runtime must be equal to them.
+template <int Kmax, int DimLinearProblem>
+class FixedSizeGMRESWorkspace {
+  static_assert(Kmax > 0, "Kmax must be positive");
+  static_assert(Kmax <= DimLinearProblem,
+                "Kmax must not be larger than DimLinearProblem");
+
+protected:
+  // Constructs the workspace with setting all components zero.
+  FixedSizeGMRESWorkspace()
+    : hessenberg_mat_(),
+      basis_mat_(),
+      givens_c_vec_(),
+      givens_s_vec_(),
+      g_vec_(),
+      restart_vec_(),
+      preconditioned_vec_(),
+      krylov_solution_vec_() {
+  }
+
+  // Constructs the workspace with setting all components zero after checking 
+  // the dimensions given at runtime.
+  FixedSizeGMRESWorkspace(const int dim_linear_problem, const int kmax)
+    : FixedSizeGMRESWorkspace() {
+    resizeWorkspace(dim_linear_problem, kmax);
+  }
+
+  // Checks that dim_linear_problem and kmax, which is reduced to 
+  // dim_linear_problem if it is larger than dim_linear_problem, are equal to 
+  // DimLinearProblem and Kmax, respectively. Throws std::invalid_argument if 
+  // they are not.
+  void resizeWorkspace(const int dim_linear_problem, const int kmax) {
+    if (dim_linear_problem != DimLinearProblem
+        || std::min(kmax, dim_linear_problem) != Kmax) {
+      throw std::invalid_argument(
+          "The dimensions of FixedSizeGMRESWorkspace do not match");
+    }
+  }
+
+  inline double* basisWorkVec(const int k) {
+    return basis_mat_[k];
+  }
+
+  inline void storeBasisVec(const int k, const double scale) {
+    if (scale != 1) {
+      linearalgebra::ScaleVector(dim_linear_problem_, scale, basis_mat_[k]);
+    }
+  }
+
+  inline void loadBasisVec(const int k) {
+    (void)k;
+  }
+
+  inline const double* basisVec(const int k) const {
+    return basis_mat_[k];
+  }
+
+  inline void applyGivensRotations(const int k, double* column_vec) const {
+    givensrotations::UnrolledDispatch<Kmax>::rotateColumn(
+        k, givens_c_vec_, givens_s_vec_, column_vec);
+  }
+
+  inline void solveHessenberg(const int k) {
+    givensrotations::UnrolledDispatch<Kmax>::solveUpperTriangular(
+        k, hessenberg_mat_, g_vec_, givens_c_vec_);
+  }
+
+  static constexpr int dim_linear_problem_ = DimLinearProblem;
+  static constexpr int kmax_ = Kmax;
+  FixedSizeMatrix<Kmax+1, Kmax+1> hessenberg_mat_;
+  FixedSizeMatrix<Kmax+1, DimLinearProblem> basis_mat_;
+  alignas(linearalgebra::kAlignment) 
+      double givens_c_vec_[FixedPaddedDimension(Kmax+1)];
+  alignas(linearalgebra::kAlignment) 
+      double givens_s_vec_[FixedPaddedDimension(Kmax+1)];
+  alignas(linearalgebra::kAlignment) 
+      double g_vec_[FixedPaddedDimension(Kmax+1)];
+  alignas(linearalgebra::kAlignment) 
+      double restart_vec_[FixedPaddedDimension(Kmax+1)];
+  alignas(linearalgebra::kAlignment) 
+      double preconditioned_vec_[FixedPaddedDimension(DimLinearProblem)];
+  alignas(linearalgebra::kAlignment) 
+      double krylov_solution_vec_[FixedPaddedDimension(DimLinearProblem)];
+};
+
+template <int DimRow, int DimColumn>
+constexpr int FixedSizeMatrix<DimRow, DimColumn>::kStride;
+
+template <int Kmax, int DimLinearProblem>
+constexpr int 
+FixedSizeGMRESWorkspace<Kmax, DimLinearProblem>::dim_linear_problem_;
+
+template <int Kmax, int DimLinearProblem>
+constexpr int FixedSizeGMRESWorkspace<Kmax, DimLinearProblem>::kmax_;
+
+} // namespace cgmres
+
+
+#endif // GMRES_WORKSPACE_H
\ No newline at end of file
@@ -0,0 +1,129 @@
+// Storage of the sequences and the matrices over the horizon of the solvers. 
+// Their sizes are fixed at compile time if the number of the discretization 
+// of the horizon N is a template parameter of the solvers, and are given at 
+// runtime otherwise.
+
+#ifndef HORIZON_STORAGE_H
+#define HORIZON_STORAGE_H
+
+#include <stdexcept>
+#include <type_traits>
+#include "linear_algebra.hpp"
+#include "aligned_matrix.hpp"
+
+
+namespace cgmres {
+
+// The value of the template parameters FixedN and FixedKmax of the solvers 
+// meaning that N and kmax are given at runtime by the arguments of the 
+// constructors. This is the default of them.
+constexpr int kDynamicSize = 0;
+
+// Returns N*dim+offset if N is fixed at compile time, i.e., is not 
+// kDynamicSize, and kDynamicSize otherwise.
+constexpr int HorizonSize(const int N, const int dim, const int offset=0) {
+  return (N == kDynamicSize) ? kDynamicSize : N*dim+offset;
+}
+
+// Array of Size components of Scalar stored in this object, so that no memory 
+// is allocated. The array is converted to the pointer to its head implicitly 
+// and is used in the same way as the arrays allocated by 
+// linearalgebra::NewVector(). data() returns the pointer explicitly, e.g., 
+// for the functions of the model, which deduce the type of the pointer. All 
+// components are set zero at the construction.
+template <typename Scalar, int Size>
+class HorizonArray {
+public:
+  // Constructs the array after checking the size given at runtime. Throws 
+  // std::invalid_argument if it is not equal to Size.
+  explicit HorizonArray(const int size) 
+    : array_() {
+    if (size != Size) {
+      throw std::invalid_argument("The size of HorizonArray does not match");
+    }
+  }
+
+  // Returns the pointer to the head of the array.
+  inline operator Scalar*() {
+    return array_;
+  }
+
+  // Returns the pointer to the head of the array.
+  inline operator const Scalar*() const {
+    return array_;
+  }
+
+  // Returns the pointer to the head of the array.
+  inline Scalar* data() {
+    return array_;
+  }
+
+  // Returns the pointer to the head of the array.
+  inline const Scalar* data() const {
+    return array_;
+  }
+
+  // Prohibits copy.
+  HorizonArray(const HorizonArray&) = delete;
+  HorizonArray& operator=(const HorizonArray&) = delete;
+
+private:
+  alignas(linearalgebra::kAlignment) Scalar array_[(Size > 0) ? Size : 1];
+};
+
+// Array whose size is given at runtime. The array is allocated at the 
+// construction and freed at the destruction.
+template <typename Scalar>
+class HorizonArray<Scalar, kDynamicSize> {
+public:
+  // Allocates the array with setting all components zero.
+  explicit HorizonArray(const int size) 
+    : array_(new Scalar[size]()) {
+  }
+
+  // Frees the array.
+  ~HorizonArray() {
+    delete[] array_;
+  }
+
+  // Returns the pointer to the head of the array.
+  inline operator Scalar*() {
+    return array_;
+  }
+
+  // Returns the pointer to the head of the array.
+  inline operator const Scalar*() const {
+    return array_;
+  }
+
+  // Returns the pointer to the head of the array.
+  inline Scalar* data() {
+    return array_;
+  }
+
+  // Returns the pointer to the head of the array.
+  inline const Scalar* data() const {
+    return array_;
+  }
+
+  // Prohibits copy due to memory allocation.
+  HorizonArray(const HorizonArray&) = delete;
+  HorizonArray& operator=(const HorizonArray&) = delete;
+
+private:
+  Scalar* array_;
+};
+
+// The matrix over the horizon whose number of the rows is DimRow, e.g., 
+// the state of each stage. This is FixedSizeAlignedMatrix if DimRow is fixed 
+// at compile time and AlignedMatrix if DimRow is kDynamicSize. Both are 
+// constructed from the dimensions and passed as AlignedMatrix.
+template <int DimRow, int DimColumn>
+using HorizonMatrix = typename std::conditional<
+    DimRow == kDynamicSize, AlignedMatrix, 
+    FixedSizeAlignedMatrix<DimRow, DimColumn>>::type;
+
+} // namespace cgmres
+
+
+#endif // HORIZON_STORAGE_H
\ No newline at end of file
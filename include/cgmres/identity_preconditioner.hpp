@@ -0,0 +1,29 @@
+// Identity preconditioner, which is the default right preconditioner of the 
+// matrix-free Krylov methods.
+
+#ifndef IDENTITY_PRECONDITIONER_H
+#define IDENTITY_PRECONDITIONER_H
+
+
+namespace cgmres {
+
+// Right preconditioner of the matrix-free Krylov methods whose 
+// preconditioning matrix is the identity. This is the default 
+// preconditioner of solveLinearProblem() of MatrixFreeGMRES, 
+// MatrixFreeBiCGStab, and MatrixFreeIDRs. They skip the preconditioning for 
+// this class and apply() is never called. A preconditioner passed to 
+// solveLinearProblem() must have 
+// apply(const double* vec, double* preconditioned_vec) that computes 
+// preconditioned_vec = M^{-1} * vec, where M is the preconditioning matrix.
+class IdentityPreconditioner {
+public:
+  inline void apply(const double* vec, double* preconditioned_vec) const {
+    (void)vec;
+    (void)preconditioned_vec;
+  }
+};
+
+} // namespace cgmres
+
+
+#endif // IDENTITY_PRECONDITIONER_H
\ No newline at end of file
@@ -1,6 +1,8 @@
 // Provides functions used for condensing of variables related to the 
 // constraints on the saturation function on the control ionput in the 
-// multiple-shooting based continuation/GMRES method.
+// multiple-shooting based continuation/GMRES method. The functions are 
+// templates with respect to the scalar type of the vectors and are 
+// instantiated for double and Dual.
 
 #ifndef INPUT_SATURATION_FUNCTIONS_H 
 #define INPUT_SATURATION_FUNCTIONS_H 
@@ -15,26 +17,29 @@ namespace inputsaturationfunctions {
 // with respect to the control input vector and adds it to a given errors in 
 // optimality. Resultant derivative is added to 
 // optimality_residual_for_control_input_and_constraints_vec.
+template <typename Scalar>
 void addHamiltonianDerivativeWithSaturatedInput(
     InputSaturationSet& input_saturation_set,
-    const double* control_input_and_constraints_vec, 
-    const double* input_saturation_multiplier_vec, 
-    double* optimality_residual_for_control_input_and_constraints_vec);
+    const Scalar* control_input_and_constraints_vec, 
+    const Scalar* input_saturation_multiplier_vec, 
+    Scalar* optimality_residual_for_control_input_and_constraints_vec);
 
 // Computes the partial derivative of the Hamiltonian with respect to the 
 // dummy input.
+template <typename Scalar>
 void computeOptimalityResidualForDummyInput(
     InputSaturationSet& input_saturation_set,
-    const double* dummy_input_vec, 
-    const double* input_saturation_multiplier_vec, 
-    double* optimality_residual_for_dummy_input);
+    const Scalar* dummy_input_vec, 
+    const Scalar* input_saturation_multiplier_vec, 
+    Scalar* optimality_residual_for_dummy_input);
 
 // Computes the optimality residual of the condensed constraints on
 // the control input saturation function.
+template <typename Scalar>
 void computeOptimalityResidualForInputSaturation(
     InputSaturationSet& input_saturation_set,
-    const double* control_input_and_constraint_vec, 
-    const double* dummy_input_vec, double* optimality_residual_for_saturation);
+    const Scalar* control_input_and_constraint_vec, 
+    const Scalar* dummy_input_vec, Scalar* optimality_residual_for_saturation);
 
 } // namespace inputsaturationfunctions
 } // namespace cgmres
@@ -4,8 +4,27 @@
 
 namespace cgmres {
 
-// Functions supporting linear algebra. 
+// Functions supporting linear algebra. The vector kernels InnerProduct(), 
+// SquaredNorm(), AddScaledVector(), ScaleVector(), ScaledSum(), and 
+// ConvertVector() are defined inline so that they are inlined into the loops 
+// of the solvers and vectorized by the compiler for the instruction sets of 
+// the translation unit. The kernels of the GMRES method, 
+// OrthogonalizeAgainstRows() and AddLinearCombination(), process all the 
+// basis vectors in one call. They are compiled for AVX-512 and for AVX2 with 
+// FMA in addition to the baseline instruction set, and the variant for the 
+// running CPU is selected at the first call. Therefore the default build uses 
+// the SIMD instructions of the CPU and still runs on any x86-64 CPU. If 
+// CGMRES_DISABLE_SIMD is defined or the compiler is not GCC-compatible, the 
+// portable variants are always used.
 namespace linearalgebra {
+// Alignment in bytes of the memory allocated by NewAlignedVector(). This is 
+// the size of a cache line and of an AVX-512 register.
+constexpr int kAlignment = 64;
+
+// Returns dim rounded up to a multiple of the number of doubles in kAlignment 
+// bytes. 
+int PaddedDimension(const int dim);
+
 // Allocates memory for a vector whose dimension is dim and set all components 
 // zero. Then returns the pointer to the vector.
 double* NewVector(const int dim);
@@ -13,6 +32,24 @@ double* NewVector(const int dim);
 // Free memory of a vector. 
 void DeleteVector(double* vec);
 
+// Allocates memory for a vector whose dimension is dim as NewVector(). The 
+// memory is aligned to kAlignment bytes and has PaddedDimension(dim) 
+// components, all of which are set zero. The pointer is offset into a larger 
+// allocation, so the vector must be freed by DeleteAlignedVector() and not by 
+// DeleteVector() or delete[].
+double* NewAlignedVector(const int dim);
+
+// Free memory of a vector allocated by NewAlignedVector(). 
+void DeleteAlignedVector(double* vec);
+
+// Allocates memory for a vector of single-precision components whose 
+// dimension is dim as NewAlignedVector(). The vector must be freed by 
+// DeleteAlignedVector().
+float* NewAlignedFloatVector(const int dim);
+
+// Free memory of a vector allocated by NewAlignedFloatVector(). 
+void DeleteAlignedVector(float* vec);
+
 // Allocates memory for a matrix whose dimensions are given by dim_row and 
 // dim_column and set all components zero. Then returns the pointer to the 
 // matrix.
@@ -21,11 +58,134 @@ double** NewMatrix(const int dim_row, const int dim_column);
 //  Free memory of a matrix.
 void DeleteMatrix(double** mat);
 
+// Tolerance of the pivots of LUFactorize() relative to the largest magnitude 
+// of the entries of the matrix below which the matrix is regarded as 
+// singular.
+constexpr double kLUPivotTolerance = 1.0e-12;
+
+// Computes the LU factorization with partial pivoting of the dim x dim matrix 
+// whose i-th row starts at mat+i*stride in place, i.e., P * A = L * U with the 
+// unit lower triangular L stored below the diagonal and U on and above it. 
+// The row exchanged with the k-th row at the k-th step is stored in 
+// pivot_seq[k]. Returns false if a pivot is not larger than kLUPivotTolerance 
+// times the largest magnitude of the entries of the matrix, which also 
+// rejects NaN. The matrix is then regarded as singular and the factorization 
+// is incomplete and must not be passed to LUSolve().
+bool LUFactorize(const int dim, const int stride, double* mat, 
+                 int* pivot_seq);
+
+// Computes vec = A^{-1} * vec in place by the factorization lu_mat and 
+// pivot_seq computed by LUFactorize().
+void LUSolve(const int dim, const int stride, const double* lu_mat, 
+             const int* pivot_seq, double* vec);
+
+// Computes the eigenvalues of the dim x dim matrix whose i-th row starts at 
+// mat+i*stride, which is overwritten, by the reduction to the Hessenberg 
+// form by the Gaussian elimination with pivoting and the Francis double-shift 
+// QR algorithm as elmhes() and hqr() of "W. H. Press et al., Numerical 
+// Recipes in C, 2nd edition, Cambridge University Press (1992)". The real and 
+// imaginary parts of the eigenvalues are stored in real_vec and imag_vec, 
+// respectively, where a complex conjugate pair is stored in consecutive 
+// components with the positive imaginary part first. Returns false if the QR 
+// algorithm does not converge in 30 iterations for an eigenvalue, e.g., 
+// because of NaN. This is intended for small matrices, e.g., of the harmonic 
+// Ritz values of the Krylov subspace. 
+bool ComputeEigenvalues(const int dim, const int stride, double* mat, 
+                        double* real_vec, double* imag_vec);
+
 // Returns inner product of vec_1 and vec_2.
-double InnerProduct(const int dim, const double *vec1, const double *vec2);
+inline double InnerProduct(const int dim, const double *vec1, 
+                           const double *vec2) {
+  // Several accumulators are used so that the compiler can vectorize the 
+  // reduction without reordering floating-point operations.
+  double ans0 = 0, ans1 = 0, ans2 = 0, ans3 = 0;
+  int i = 0;
+  for (; i+4<=dim; i+=4) {
+    ans0 += vec1[i] * vec2[i];
+    ans1 += vec1[i+1] * vec2[i+1];
+    ans2 += vec1[i+2] * vec2[i+2];
+    ans3 += vec1[i+3] * vec2[i+3];
+  }
+  double ans = (ans0+ans1) + (ans2+ans3);
+  for (; i<dim; ++i) {
+    ans += vec1[i] * vec2[i];
+  }
+  return ans;
+}
 
 // Returns squared norm of vec.
-double SquaredNorm(const int dim, const double *vec);
+inline double SquaredNorm(const int dim, const double *vec) {
+  return InnerProduct(dim, vec, vec);
+}
+
+// Computes result_vec += scale * vec.
+inline void AddScaledVector(const int dim, const double scale, 
+                            const double *vec, double *result_vec) {
+  for (int i=0; i<dim; ++i) {
+    result_vec[i] += scale * vec[i];
+  }
+}
+
+// Computes vec *= scale.
+inline void ScaleVector(const int dim, const double scale, double *vec) {
+  for (int i=0; i<dim; ++i) {
+    vec[i] *= scale;
+  }
+}
+
+// Computes result_vec = vec1 + scale * vec2. result_vec may be the same 
+// pointer as vec1 or vec2.
+inline void ScaledSum(const int dim, const double *vec1, const double scale, 
+                      const double *vec2, double *result_vec) {
+  for (int i=0; i<dim; ++i) {
+    result_vec[i] = vec1[i] + scale * vec2[i];
+  }
+}
+
+// Computes result_vec = scale * vec rounded to single precision.
+inline void ConvertVector(const int dim, const double scale, 
+                          const double *vec, float *result_vec) {
+  for (int i=0; i<dim; ++i) {
+    result_vec[i] = static_cast<float>(scale * vec[i]);
+  }
+}
+
+// Computes result_vec = vec in double precision.
+inline void ConvertVector(const int dim, const float *vec, 
+                          double *result_vec) {
+  for (int i=0; i<dim; ++i) {
+    result_vec[i] = static_cast<double>(vec[i]);
+  }
+}
+
+// Orthogonalizes vec against the num_rows rows of the row-major matrix mat, 
+// whose i-th row starts at mat+i*stride, by the modified Gram-Schmidt, i.e., 
+// sets coeff_vec[i] the inner product of vec and the i-th row and computes 
+// vec -= coeff_vec[i] * (i-th row) for i = 0, ..., num_rows-1 in turn. 
+// Returns the norm of vec after the orthogonalization.
+double OrthogonalizeAgainstRows(const int dim, const int num_rows, 
+                                const double* mat, const int stride, 
+                                double* vec, double* coeff_vec);
+
+// The overload for the matrix stored in single precision, e.g., the Krylov 
+// basis of the mixed-precision GMRES method. The arithmetic is performed in 
+// double precision.
+double OrthogonalizeAgainstRows(const int dim, const int num_rows, 
+                                const float* mat, const int stride, 
+                                double* vec, double* coeff_vec);
+
+// Computes vec += coeff_vec[i] * (i-th row) over i = 0, ..., num_rows-1, 
+// where the i-th row of the row-major matrix mat starts at mat+i*stride. 
+// Each component of vec is loaded and stored once.
+void AddLinearCombination(const int dim, const int num_rows, 
+                          const double* mat, const int stride, 
+                          const double* coeff_vec, double* vec);
+
+// The overload for the matrix stored in single precision. The arithmetic is 
+// performed in double precision.
+void AddLinearCombination(const int dim, const int num_rows, 
+                          const float* mat, const int stride, 
+                          const double* coeff_vec, double* vec);
 
 } // namespace linearalgebra
 
@@ -0,0 +1,395 @@
+// The matrix-free biconjugate gradient stabilized (BiCGStab) method, which 
+// can be used in the C/GMRES method in place of MatrixFreeGMRES. This program 
+// is written with reference to "H. A. van der Vorst, Bi-CGSTAB: A fast and 
+// smoothly converging variant of Bi-CG for the solution of nonsymmetric 
+// linear systems, SIAM Journal on Scientific and Statistical Computing, 
+// Vol. 13, No. 2, pp. 631-644 (1992)".
+
+#ifndef MATRIXFREE_BICGSTAB_H
+#define MATRIXFREE_BICGSTAB_H
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "linear_algebra.hpp"
+#include "identity_preconditioner.hpp"
+#include "minimal_residual_smoothing.hpp"
+
+
+namespace cgmres {
+
+// Serves the matrix-free BiCGStab method, which solves the linear problem 
+// Ax = b provided by LinearProblemGenerator with the same bFunc() and 
+// AxFunc() as MatrixFreeGMRES. The template parameters are also the same as 
+// those of MatrixFreeGMRES. Unlike the GMRES method, the BiCGStab method 
+// uses the short recurrences and its memory and the cost of each iteration 
+// do not depend on the number of the iterations. kmax is the maximum number 
+// of the calls of AxFunc(), which is twice the number of the BiCGStab 
+// iterations, so that the computational cost is comparable to that of 
+// MatrixFreeGMRES with the same kmax. The iterates are smoothed by 
+// MinimalResidualSmoothing, so that the residual of the solution is never 
+// larger than that of the initial guess.
+template <class LinearProblemGenerator, typename... LinearProblemArgs>
+class MatrixFreeBiCGStab {
+public:
+  // Constructs MatrixFreeBiCGStab with setting dimension of the solution and 
+  // the maximum number of the calls of AxFunc() zero, and sets nullptr for 
+  // all vectors.
+  MatrixFreeBiCGStab()
+    : dim_linear_problem_(0), 
+      kmax_(0), 
+      num_iterations_(0), 
+      max_restarts_(0), 
+      num_restarts_(0), 
+      absolute_tolerance_(0), 
+      relative_tolerance_(0), 
+      residual_norm_(0), 
+      residual_vec_(nullptr), 
+      shadow_residual_vec_(nullptr), 
+      direction_vec_(nullptr), 
+      direction_image_vec_(nullptr), 
+      residual_image_vec_(nullptr), 
+      preconditioned_direction_vec_(nullptr), 
+      preconditioned_residual_vec_(nullptr), 
+      normalized_vec_(nullptr), 
+      smoothing_() {
+  }
+
+  // Constructs MatrixFreeBiCGStab with setting dimension of the solution 
+  // dim_linear_problem and the maximum number of the calls of AxFunc() kmax, 
+  // and allocates all vectors used in the matrix-free BiCGStab method.
+  MatrixFreeBiCGStab(const int dim_linear_problem, const int kmax)
+    : dim_linear_problem_(dim_linear_problem), 
+      kmax_(kmax), 
+      num_iterations_(0), 
+      max_restarts_(0), 
+      num_restarts_(0), 
+      absolute_tolerance_(0), 
+      relative_tolerance_(0), 
+      residual_norm_(0), 
+      residual_vec_(nullptr), 
+      shadow_residual_vec_(nullptr), 
+      direction_vec_(nullptr), 
+      direction_image_vec_(nullptr), 
+      residual_image_vec_(nullptr), 
+      preconditioned_direction_vec_(nullptr), 
+      preconditioned_residual_vec_(nullptr), 
+      normalized_vec_(nullptr), 
+      smoothing_(dim_linear_problem) {
+    allocateVectors();
+  }
+
+  // Destructs MatrixFreeBiCGStab with freeing memory of vectors.
+  ~MatrixFreeBiCGStab() {
+    deleteVectors();
+  }
+
+  // Sets dimension of the solution and the maximum number of the calls of 
+  // AxFunc() and reallocates all vectors.
+  void setParameters(const int dim_linear_problem, const int kmax) {
+    deleteVectors();
+    dim_linear_problem_ = dim_linear_problem;
+    kmax_ = kmax;
+    smoothing_.resize(dim_linear_problem);
+    allocateVectors();
+  }
+
+  // Sets the tolerances of the residual for the termination. The iteration 
+  // terminates as soon as the residual norm is less than or equal to 
+  // max(absolute_tolerance, relative_tolerance*||b-Ax_0||). If both of the 
+  // tolerances are zero (default), AxFunc() is called kmax times unless the 
+  // method breaks down.
+  void setTolerance(const double absolute_tolerance, 
+                    const double relative_tolerance) {
+    absolute_tolerance_ = absolute_tolerance;
+    relative_tolerance_ = relative_tolerance;
+  }
+
+  // Returns the number of the calls of AxFunc() in the latest 
+  // solveLinearProblem().
+  int num_iterations() const {
+    return num_iterations_;
+  }
+
+  // Returns the residual norm ||b-Ax|| of the solution of the latest 
+  // solveLinearProblem(), which is obtained from the recurrence.
+  double residual_norm() const {
+    return residual_norm_;
+  }
+
+  // Sets the maximum number of the restarts. When the BiCGStab method breaks 
+  // down, i.e., the residual becomes orthogonal to the shadow residual, the 
+  // method is restarted with the current residual as the shadow residual at 
+  // most max_restarts times. The default is zero, i.e., the iteration 
+  // terminates at the breakdown.
+  void setMaxRestarts(const int max_restarts) {
+    max_restarts_ = max_restarts;
+  }
+
+  // Returns the number of the restarts performed in the latest 
+  // solveLinearProblem().
+  int num_restarts() const {
+    return num_restarts_;
+  }
+
+  // Solves the linear problem by the matrix-free BiCGStab method and adds 
+  // the solution update to solution_vec.
+  void solveLinearProblem(LinearProblemGenerator& linear_problem_generator, 
+                          LinearProblemArgs... linear_problem_args, 
+                          double* solution_vec) {
+    IdentityPreconditioner preconditioner;
+    solveLinearProblem(preconditioner, linear_problem_generator, 
+                       linear_problem_args..., solution_vec);
+  }
+
+  // Solves the linear problem by the matrix-free BiCGStab method with the 
+  // right preconditioner, i.e., solves A * M^{-1} * u = b - A * x_0 and sets 
+  // x = x_0 + M^{-1} * u in solution_vec. Preconditioner must have 
+  // apply(const double* vec, double* preconditioned_vec) that computes 
+  // M^{-1} * vec. With IdentityPreconditioner, no additional operation is 
+  // performed.
+  template <class Preconditioner>
+  void solveLinearProblem(Preconditioner& preconditioner, 
+                          LinearProblemGenerator& linear_problem_generator, 
+                          LinearProblemArgs... linear_problem_args, 
+                          double* solution_vec) {
+    num_iterations_ = 0;
+    num_restarts_ = 0;
+    linear_problem_generator.bFunc(linear_problem_args..., solution_vec, 
+                                   residual_vec_);
+    residual_norm_ = smoothing_.initialize(solution_vec, residual_vec_);
+    const double residual_tolerance 
+        = std::max(absolute_tolerance_, relative_tolerance_*residual_norm_);
+    double rho = 1, alpha = 1, omega = 1;
+    bool is_breakdown = false;
+    initializeShadowResidual();
+    while (residual_norm_ > residual_tolerance && num_iterations_ < kmax_) {
+      const double rho_next = linearalgebra::InnerProduct(
+          dim_linear_problem_, shadow_residual_vec_, residual_vec_);
+      // The method breaks down if the residual is orthogonal to the shadow 
+      // residual, if the image of the direction is, or if the stabilization 
+      // step stagnates, i.e., omega is zero.
+      if (is_breakdown || omega == 0 
+          || isOrthogonal(rho_next, shadow_residual_vec_, residual_vec_)) {
+        if (num_restarts_ >= max_restarts_) {
+          break;
+        }
+        restartFromSmoothedSolution(solution_vec);
+        rho = 1;
+        alpha = 1;
+        omega = 1;
+        is_breakdown = false;
+        ++num_restarts_;
+        continue;
+      }
+      const double beta = (rho_next/rho) * (alpha/omega);
+      rho = rho_next;
+      // direction_vec_ = residual_vec_ 
+      //                  + beta * (direction_vec_ - omega * direction_image_vec_)
+      linearalgebra::AddScaledVector(dim_linear_problem_, -omega, 
+                                     direction_image_vec_, direction_vec_);
+      linearalgebra::ScaledSum(dim_linear_problem_, residual_vec_, beta, 
+                               direction_vec_, direction_vec_);
+      const double* preconditioned_direction_vec = direction_vec_;
+      if (!isIdentity(preconditioner)) {
+        preconditioner.apply(direction_vec_, preconditioned_direction_vec_);
+        preconditioned_direction_vec = preconditioned_direction_vec_;
+      }
+      multiplyCoefficientMatrix(linear_problem_generator, 
+                                linear_problem_args..., 
+                                preconditioned_direction_vec, 
+                                direction_image_vec_);
+      ++num_iterations_;
+      const double shadow_image = linearalgebra::InnerProduct(
+          dim_linear_problem_, shadow_residual_vec_, direction_image_vec_);
+      if (isOrthogonal(shadow_image, shadow_residual_vec_, 
+                       direction_image_vec_)) {
+        is_breakdown = true;
+        continue;
+      }
+      alpha = rho / shadow_image;
+      // The intermediate residual s = r - alpha * A * M^{-1} * p is stored in 
+      // residual_vec_.
+      linearalgebra::AddScaledVector(dim_linear_problem_, -alpha, 
+                                     direction_image_vec_, residual_vec_);
+      linearalgebra::AddScaledVector(dim_linear_problem_, alpha, 
+                                     preconditioned_direction_vec, 
+                                     solution_vec);
+      residual_norm_ = smoothing_.update(solution_vec, residual_vec_);
+      if (residual_norm_ <= residual_tolerance || num_iterations_ >= kmax_) {
+        break;
+      }
+      const double* preconditioned_residual_vec = residual_vec_;
+      if (!isIdentity(preconditioner)) {
+        preconditioner.apply(residual_vec_, preconditioned_residual_vec_);
+        preconditioned_residual_vec = preconditioned_residual_vec_;
+      }
+      multiplyCoefficientMatrix(linear_problem_generator, 
+                                linear_problem_args..., 
+                                preconditioned_residual_vec, 
+                                residual_image_vec_);
+      ++num_iterations_;
+      omega = computeOmega();
+      linearalgebra::AddScaledVector(dim_linear_problem_, omega, 
+                                     preconditioned_residual_vec, 
+                                     solution_vec);
+      linearalgebra::AddScaledVector(dim_linear_problem_, -omega, 
+                                     residual_image_vec_, residual_vec_);
+      residual_norm_ = smoothing_.update(solution_vec, residual_vec_);
+    }
+    // The smoothed iterate, whose residual is residual_norm_, is returned.
+    const double* smoothed_solution_vec = smoothing_.smoothed_solution_vec();
+    for (int i=0; i<dim_linear_problem_; ++i) {
+      solution_vec[i] = smoothed_solution_vec[i];
+    }
+  }
+
+  // Prohibits copy constructors.
+  MatrixFreeBiCGStab(const MatrixFreeBiCGStab&) = delete;
+  MatrixFreeBiCGStab& operator=(const MatrixFreeBiCGStab&) = delete;
+
+private:
+  int dim_linear_problem_, kmax_, num_iterations_, max_restarts_, 
+      num_restarts_;
+  double absolute_tolerance_, relative_tolerance_, residual_norm_;
+  double *residual_vec_, *shadow_residual_vec_, *direction_vec_, 
+      *direction_image_vec_, *residual_image_vec_, 
+      *preconditioned_direction_vec_, *preconditioned_residual_vec_, 
+      *normalized_vec_;
+  MinimalResidualSmoothing smoothing_;
+
+  // Computes image_vec = A * vec by AxFunc() with vec normalized and scales 
+  // the result back. AxFunc() of the C/GMRES solvers approximates the 
+  // product by the forward difference with the increment proportional to 
+  // vec, which is accurate only if the norm of vec is about one as the basis 
+  // vectors of the GMRES method are.
+  void multiplyCoefficientMatrix(
+      LinearProblemGenerator& linear_problem_generator, 
+      LinearProblemArgs... linear_problem_args, const double* vec, 
+      double* image_vec) {
+    const double norm = std::sqrt(linearalgebra::SquaredNorm(
+        dim_linear_problem_, vec));
+    if (norm == 0) {
+      for (int i=0; i<dim_linear_problem_; ++i) {
+        image_vec[i] = 0;
+      }
+      return;
+    }
+    for (int i=0; i<dim_linear_problem_; ++i) {
+      normalized_vec_[i] = vec[i] / norm;
+    }
+    linear_problem_generator.AxFunc(linear_problem_args..., normalized_vec_, 
+                                    image_vec);
+    linearalgebra::ScaleVector(dim_linear_problem_, norm, image_vec);
+  }
+
+  // Sets the current residual as the shadow residual and sets the direction 
+  // and its image zero.
+  void initializeShadowResidual() {
+    for (int i=0; i<dim_linear_problem_; ++i) {
+      shadow_residual_vec_[i] = residual_vec_[i];
+      direction_vec_[i] = 0;
+      direction_image_vec_[i] = 0;
+    }
+  }
+
+  // Sets the smoothed iterate and its residual as the current ones and 
+  // restarts from them. The recurrences may have lost the accuracy at the 
+  // breakdown, whereas the smoothed iterate is never worse than the initial 
+  // guess.
+  void restartFromSmoothedSolution(double* solution_vec) {
+    const double* smoothed_solution_vec = smoothing_.smoothed_solution_vec();
+    const double* smoothed_residual_vec = smoothing_.smoothed_residual_vec();
+    for (int i=0; i<dim_linear_problem_; ++i) {
+      solution_vec[i] = smoothed_solution_vec[i];
+      residual_vec_[i] = smoothed_residual_vec[i];
+    }
+    initializeShadowResidual();
+  }
+
+  // Returns true if inner_product, the inner product of vec1 and vec2, is 
+  // zero up to the rounding errors relative to their norms or is not finite.
+  bool isOrthogonal(const double inner_product, const double* vec1, 
+                    const double* vec2) const {
+    const double norm_product = std::sqrt(
+        linearalgebra::SquaredNorm(dim_linear_problem_, vec1)
+        * linearalgebra::SquaredNorm(dim_linear_problem_, vec2));
+    return !(std::abs(inner_product) 
+             > std::numeric_limits<double>::epsilon() * norm_product);
+  }
+
+  // Returns omega that minimizes 
+  // ||residual_vec_ - omega * residual_image_vec_||, or zero if they are 
+  // orthogonal. If the angle between them is large, omega is enlarged as in 
+  // "G. L. G. Sleijpen and H. A. van der Vorst, Maintaining convergence 
+  // properties of BiCGstab methods in finite precision arithmetic, Numerical 
+  // Algorithms, Vol. 10, pp. 203-223 (1995)" so that the next rho does not 
+  // vanish.
+  double computeOmega() const {
+    constexpr double kappa = 0.7;
+    const double image_norm = std::sqrt(linearalgebra::SquaredNorm(
+        dim_linear_problem_, residual_image_vec_));
+    const double residual_norm = std::sqrt(linearalgebra::SquaredNorm(
+        dim_linear_problem_, residual_vec_));
+    const double inner_product = linearalgebra::InnerProduct(
+        dim_linear_problem_, residual_image_vec_, residual_vec_);
+    if (!(std::abs(inner_product) 
+          > std::numeric_limits<double>::epsilon()*image_norm*residual_norm)) {
+      return 0;
+    }
+    const double rho = std::abs(inner_product) / (image_norm*residual_norm);
+    double omega = inner_product / (image_norm*image_norm);
+    if (rho < kappa) {
+      omega *= kappa / rho;
+    }
+    return omega;
+  }
+
+  void allocateVectors() {
+    residual_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+    shadow_residual_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+    direction_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+    direction_image_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+    residual_image_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+    preconditioned_direction_vec_
+        = linearalgebra::NewVector(dim_linear_problem_);
+    preconditioned_residual_vec_
+        = linearalgebra::NewVector(dim_linear_problem_);
+    normalized_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+  }
+
+  void deleteVectors() {
+    linearalgebra::DeleteVector(residual_vec_);
+    linearalgebra::DeleteVector(shadow_residual_vec_);
+    linearalgebra::DeleteVector(direction_vec_);
+    linearalgebra::DeleteVector(direction_image_vec_);
+    linearalgebra::DeleteVector(residual_image_vec_);
+    linearalgebra::DeleteVector(preconditioned_direction_vec_);
+    linearalgebra::DeleteVector(preconditioned_residual_vec_);
+    linearalgebra::DeleteVector(normalized_vec_);
+    residual_vec_ = nullptr;
+    shadow_residual_vec_ = nullptr;
+    direction_vec_ = nullptr;
+    direction_image_vec_ = nullptr;
+    residual_image_vec_ = nullptr;
+    preconditioned_direction_vec_ = nullptr;
+    preconditioned_residual_vec_ = nullptr;
+    normalized_vec_ = nullptr;
+  }
+
+  // Returns true if the preconditioner is IdentityPreconditioner.
+  static constexpr bool isIdentity(const IdentityPreconditioner&) {
+    return true;
+  }
+
+  // Returns true if the preconditioner is IdentityPreconditioner.
+  template <class Preconditioner>
+  static constexpr bool isIdentity(const Preconditioner&) {
+    return false;
+  }
+};
+
+} // namespace cgmres
+
+
+#endif // MATRIXFREE_BICGSTAB_H
\ No newline at end of file
@@ -0,0 +1,783 @@
+// The matrix-free GCRO-DR method, i.e., the generalized conjugate residual 
+// method with inner orthogonalization and deflated restarting, which recycles 
+// a subspace of the Krylov subspace of the previous linear problem. It can be 
+// used in the C/GMRES method in place of MatrixFreeGMRES. This program is 
+// written with reference to "M. L. Parks, E. de Sturler, G. Mackey, 
+// D. D. Johnson, and S. Maiti, Recycling Krylov subspaces for sequences of 
+// linear systems, SIAM Journal on Scientific Computing, Vol. 28, No. 5, 
+// pp. 1651-1674 (2006)".
+
+#ifndef MATRIXFREE_GCRODR_H
+#define MATRIXFREE_GCRODR_H
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "linear_algebra.hpp"
+#include "aligned_matrix.hpp"
+#include "gmres_workspace.hpp"
+#include "identity_preconditioner.hpp"
+
+
+namespace cgmres {
+
+// Serves the matrix-free GCRO-DR method, which solves the linear problem 
+// Ax = b provided by LinearProblemGenerator with the same bFunc() and 
+// AxFunc() as MatrixFreeGMRES. The template parameters are also the same as 
+// those of MatrixFreeGMRES. The recycled subspace U is spanned by the 
+// harmonic Ritz vectors of the recycle_dim smallest harmonic Ritz values of 
+// the previous solveLinearProblem(), i.e., the approximate eigenvectors that 
+// slow down the GMRES method most, and is kept over the calls. Since A 
+// changes between the calls in the C/GMRES method, the image C = A * U is 
+// recomputed by AxFunc() for each vector of U and orthonormalized in each 
+// call. The residual is then projected onto the orthogonal complement of C, 
+// and the remaining kmax-recycle_dim calls of AxFunc() build the Krylov 
+// subspace of (I - C * C^T) * A by the Arnoldi process. Therefore a cycle 
+// costs kmax calls of AxFunc() as MatrixFreeGMRES, and the first call, 
+// without the recycled subspace, is the GMRES method itself.
+template <class LinearProblemGenerator, typename... LinearProblemArgs>
+class MatrixFreeGCRODR {
+public:
+  // Constructs MatrixFreeGCRODR with setting dimension of the solution, that 
+  // of the Krylov subspace, and that of the recycled subspace zero. No memory 
+  // is allocated.
+  MatrixFreeGCRODR() 
+    : dim_linear_problem_(0), 
+      kmax_(0), 
+      recycle_dim_(0), 
+      num_recycled_(0), 
+      num_iterations_(0), 
+      max_restarts_(0), 
+      num_restarts_(0), 
+      absolute_tolerance_(0), 
+      relative_tolerance_(0), 
+      residual_norm_(0), 
+      recycle_mat_(), 
+      image_mat_(), 
+      ritz_mat_(), 
+      ritz_image_mat_(), 
+      basis_mat_(), 
+      hessenberg_mat_(), 
+      arnoldi_mat_(), 
+      projection_mat_(), 
+      augmented_mat_(), 
+      cross_mat_(), 
+      normal_mat_(), 
+      pencil_mat_(), 
+      eigen_mat_(), 
+      inverse_iteration_mat_(), 
+      ritz_coeff_mat_(), 
+      givens_c_vec_(nullptr), 
+      givens_s_vec_(nullptr), 
+      g_vec_(nullptr), 
+      y_vec_(nullptr), 
+      coeff_vec_(nullptr), 
+      recycle_coeff_vec_(nullptr), 
+      recycle_norm_vec_(nullptr), 
+      eigen_real_vec_(nullptr), 
+      eigen_imag_vec_(nullptr), 
+      eigen_vec_(nullptr), 
+      preconditioned_vec_(nullptr), 
+      krylov_solution_vec_(nullptr), 
+      work_vec_(nullptr), 
+      order_seq_(nullptr), 
+      pivot_seq_(nullptr), 
+      is_image_valid_(false) {
+  }
+
+  // Constructs MatrixFreeGCRODR with setting dimension of the solution 
+  // dim_linear_problem, that of the Krylov subspace including the recycled 
+  // subspace kmax, and that of the recycled subspace recycle_dim, and 
+  // allocates all vectors and matrices. kmax is reduced to 
+  // dim_linear_problem and recycle_dim to kmax-1 if they are larger.
+  MatrixFreeGCRODR(const int dim_linear_problem, const int kmax, 
+                   const int recycle_dim) 
+    : MatrixFreeGCRODR() {
+    setParameters(dim_linear_problem, kmax, recycle_dim);
+  }
+
+  // Destructs MatrixFreeGCRODR with freeing memory of vectors and matrices.
+  ~MatrixFreeGCRODR() {
+    deleteVectors();
+  }
+
+  // Sets the dimensions as the constructor, reallocates all vectors and 
+  // matrices, and discards the recycled subspace.
+  void setParameters(const int dim_linear_problem, const int kmax, 
+                     const int recycle_dim) {
+    deleteVectors();
+    dim_linear_problem_ = dim_linear_problem;
+    kmax_ = std::min(kmax, dim_linear_problem);
+    recycle_dim_ = std::max(std::min(recycle_dim, kmax_-1), 0);
+    num_recycled_ = 0;
+    is_image_valid_ = false;
+    allocateVectors();
+  }
+
+  // Sets the tolerances of the residual for the termination. The iteration 
+  // terminates as soon as the residual norm is less than or equal to 
+  // max(absolute_tolerance, relative_tolerance*||b-Ax_0||). This is also 
+  // checked after the projection onto the recycled subspace, which may then 
+  // save the Arnoldi process. If both of the tolerances are zero (default), 
+  // AxFunc() is called kmax times in each cycle.
+  void setTolerance(const double absolute_tolerance, 
+                    const double relative_tolerance) {
+    absolute_tolerance_ = absolute_tolerance;
+    relative_tolerance_ = relative_tolerance;
+  }
+
+  // Returns the number of the calls of AxFunc() in the latest 
+  // solveLinearProblem(), including those for the image of the recycled 
+  // subspace.
+  int num_iterations() const {
+    return num_iterations_;
+  }
+
+  // Returns the estimate of the residual norm ||b-Ax|| at the end of the 
+  // latest solveLinearProblem().
+  double residual_norm() const {
+    return residual_norm_;
+  }
+
+  // Sets the maximum number of the restarts. While the residual does not 
+  // satisfy the tolerances, a cycle is restarted with the recycled subspace 
+  // of the previous cycle at most max_restarts times. The default is zero, 
+  // i.e., no restart.
+  void setMaxRestarts(const int max_restarts) {
+    max_restarts_ = max_restarts;
+  }
+
+  // Returns the number of the restarts performed in the latest 
+  // solveLinearProblem().
+  int num_restarts() const {
+    return num_restarts_;
+  }
+
+  // Returns the dimension of the recycled subspace that the next 
+  // solveLinearProblem() uses. This is smaller than recycle_dim in the first 
+  // call and if the vectors of the subspace become linearly dependent.
+  int num_recycled() const {
+    return num_recycled_;
+  }
+
+  // Discards the recycled subspace, e.g., when the solution is reinitialized 
+  // and the next linear problem is not close to the previous one.
+  void resetRecycledSubspace() {
+    num_recycled_ = 0;
+    is_image_valid_ = false;
+  }
+
+  // Solves the linear problem by the matrix-free GCRO-DR method and adds the 
+  // solution update to solution_vec.
+  void solveLinearProblem(LinearProblemGenerator& linear_problem_generator, 
+                          LinearProblemArgs... linear_problem_args, 
+                          double* solution_vec) {
+    IdentityPreconditioner preconditioner;
+    solveLinearProblem(preconditioner, linear_problem_generator, 
+                       linear_problem_args..., solution_vec);
+  }
+
+  // Solves the linear problem by the matrix-free GCRO-DR method with the 
+  // right preconditioner, i.e., solves A * M^{-1} * u = b - A * x_0 and sets 
+  // x = x_0 + M^{-1} * u in solution_vec. The recycled subspace is a subspace 
+  // of u. Preconditioner must have 
+  // apply(const double* vec, double* preconditioned_vec) that computes 
+  // M^{-1} * vec. With IdentityPreconditioner, no additional operation is 
+  // performed.
+  template <class Preconditioner>
+  void solveLinearProblem(Preconditioner& preconditioner, 
+                          LinearProblemGenerator& linear_problem_generator, 
+                          LinearProblemArgs... linear_problem_args, 
+                          double* solution_vec) {
+    num_iterations_ = 0;
+    num_restarts_ = 0;
+    is_image_valid_ = false;
+    double* residual_vec = basis_mat_[0];
+    linear_problem_generator.bFunc(linear_problem_args..., solution_vec, 
+                                   residual_vec);
+    double beta = std::sqrt(linearalgebra::SquaredNorm(dim_linear_problem_, 
+                                                       residual_vec));
+    const double residual_tolerance 
+        = std::max(absolute_tolerance_, relative_tolerance_*beta);
+    residual_norm_ = beta;
+    while (residual_norm_ > residual_tolerance) {
+      refreshRecycledSubspace(preconditioner, linear_problem_generator, 
+                              linear_problem_args...);
+      if (num_recycled_ > 0) {
+        // Projects the residual onto the orthogonal complement of C, i.e., 
+        // recycle_coeff_vec_ = C * r, r -= C^T * recycle_coeff_vec_, and 
+        // solution_vec += M^{-1} * U^T * recycle_coeff_vec_.
+        linearalgebra::OrthogonalizeAgainstRows(
+            dim_linear_problem_, num_recycled_, image_mat_[0], 
+            image_mat_.stride(), residual_vec, recycle_coeff_vec_);
+        updateSolution(preconditioner, 0, solution_vec);
+        beta = std::sqrt(linearalgebra::SquaredNorm(dim_linear_problem_, 
+                                                    residual_vec));
+        residual_norm_ = beta;
+        if (residual_norm_ <= residual_tolerance) {
+          break;
+        }
+      }
+      linearalgebra::ScaleVector(dim_linear_problem_, 1/beta, residual_vec);
+      const int k = arnoldiCycle(preconditioner, linear_problem_generator, 
+                                 linear_problem_args..., beta, 
+                                 residual_tolerance);
+      num_iterations_ += k;
+      if (k == 0) {
+        break;
+      }
+      residual_norm_ = std::abs(g_vec_[k]);
+      // The least squares problem is that of the GMRES method because r is 
+      // orthogonal to C. Its solution y gives the coefficients of the Krylov 
+      // basis, and -B * y those of U, where B = C * A * M^{-1} * V is the 
+      // projection of the Arnoldi process.
+      givensrotations::SolveUpperTriangular(k, hessenberg_mat_, g_vec_, 
+                                            y_vec_);
+      for (int i=0; i<num_recycled_; ++i) {
+        recycle_coeff_vec_[i] = 0;
+      }
+      for (int j=0; j<k; ++j) {
+        linearalgebra::AddScaledVector(num_recycled_, -y_vec_[j], 
+                                       projection_mat_[j], recycle_coeff_vec_);
+      }
+      updateSolution(preconditioner, k, solution_vec);
+      const bool restart = (num_restarts_ < max_restarts_) 
+                           && (residual_norm_ > residual_tolerance);
+      if (restart) {
+        // The residual r = V * (beta * e_1 - H * y) by the Arnoldi relation, 
+        // where H is the Hessenberg matrix before the Givens rotations.
+        for (int i=0; i<=k; ++i) {
+          coeff_vec_[i] = (i == 0) ? beta : 0;
+        }
+        for (int j=0; j<k; ++j) {
+          linearalgebra::AddScaledVector(j+2, -y_vec_[j], arnoldi_mat_[j], 
+                                         coeff_vec_);
+        }
+        for (int i=0; i<dim_linear_problem_; ++i) {
+          work_vec_[i] = 0;
+        }
+        linearalgebra::AddLinearCombination(dim_linear_problem_, k+1, 
+                                            basis_mat_[0], basis_mat_.stride(), 
+                                            coeff_vec_, work_vec_);
+      }
+      updateRecycledSubspace(k);
+      if (!restart) {
+        break;
+      }
+      for (int i=0; i<dim_linear_problem_; ++i) {
+        residual_vec[i] = work_vec_[i];
+      }
+      beta = std::sqrt(linearalgebra::SquaredNorm(dim_linear_problem_, 
+                                                  residual_vec));
+      ++num_restarts_;
+    }
+  }
+
+  // Prohibits copy constructors.
+  MatrixFreeGCRODR(const MatrixFreeGCRODR&) = delete;
+  MatrixFreeGCRODR& operator=(const MatrixFreeGCRODR&) = delete;
+
+private:
+  int dim_linear_problem_, kmax_, recycle_dim_, num_recycled_, 
+      num_iterations_, max_restarts_, num_restarts_;
+  double absolute_tolerance_, relative_tolerance_, residual_norm_;
+  // recycle_mat_[i] and image_mat_[i] are the i-th vectors of U and C, 
+  // respectively. ritz_mat_[i] is the i-th harmonic Ritz vector and 
+  // ritz_image_mat_[i] is its image. basis_mat_ 
+  // is the basis of the Krylov subspace. The j-th column of the Hessenberg 
+  // matrix is stored in hessenberg_mat_[j], which is overwritten by the 
+  // Givens rotations, and in arnoldi_mat_[j]. projection_mat_[j] is the j-th 
+  // column of B. The other matrices are those of the harmonic Ritz problem.
+  AlignedMatrix recycle_mat_, image_mat_, ritz_mat_, ritz_image_mat_, 
+      basis_mat_, 
+      hessenberg_mat_, arnoldi_mat_, projection_mat_, augmented_mat_, 
+      cross_mat_, normal_mat_, pencil_mat_, eigen_mat_, 
+      inverse_iteration_mat_, ritz_coeff_mat_;
+  double *givens_c_vec_, *givens_s_vec_, *g_vec_, *y_vec_, *coeff_vec_, 
+      *recycle_coeff_vec_, *recycle_norm_vec_, *eigen_real_vec_, 
+      *eigen_imag_vec_, *eigen_vec_, *preconditioned_vec_, 
+      *krylov_solution_vec_, *work_vec_;
+  int *order_seq_, *pivot_seq_;
+  // True if image_mat_ is the image of recycle_mat_ under the linear problem 
+  // of the current solveLinearProblem(), e.g., after a restart.
+  bool is_image_valid_;
+
+  // A vector of U is dropped if the norm of its image orthogonalized against 
+  // the images of the preceding vectors is below this value times the norm 
+  // of the image, i.e., if the images are numerically linearly dependent.
+  static constexpr double kDropTolerance = 1.0e-08;
+
+  // Orthonormalizes U and computes C = A * M^{-1} * U by AxFunc() unless C 
+  // is already valid for the current linear problem, i.e., after a restart. 
+  // Then orthonormalizes C by the modified Gram-Schmidt and applies the same 
+  // transformation to U, so that C = A * M^{-1} * U still holds. The vectors 
+  // whose images are linearly dependent are dropped.
+  template <class Preconditioner>
+  void refreshRecycledSubspace(
+      Preconditioner& preconditioner, 
+      LinearProblemGenerator& linear_problem_generator, 
+      LinearProblemArgs... linear_problem_args) {
+    if (!is_image_valid_) {
+      orthonormalizeRecycledSubspace();
+    }
+    int num_independent = 0;
+    for (int j=0; j<num_recycled_; ++j) {
+      double* recycle_vec = recycle_mat_[num_independent];
+      double* image_vec = image_mat_[num_independent];
+      if (j != num_independent) {
+        for (int i=0; i<dim_linear_problem_; ++i) {
+          recycle_vec[i] = recycle_mat_[j][i];
+          image_vec[i] = image_mat_[j][i];
+        }
+      }
+      if (!is_image_valid_) {
+        const double* direction_vec = recycle_vec;
+        if (!isIdentity(preconditioner)) {
+          preconditioner.apply(recycle_vec, preconditioned_vec_);
+          direction_vec = preconditioned_vec_;
+        }
+        linear_problem_generator.AxFunc(linear_problem_args..., direction_vec, 
+                                        image_vec);
+        ++num_iterations_;
+      }
+      const double image_norm = std::sqrt(linearalgebra::SquaredNorm(
+          dim_linear_problem_, image_vec));
+      const double norm = linearalgebra::OrthogonalizeAgainstRows(
+          dim_linear_problem_, num_independent, image_mat_[0], 
+          image_mat_.stride(), image_vec, coeff_vec_);
+      // The negated comparison also drops NaN.
+      if (!(norm > kDropTolerance*image_norm)) {
+        continue;
+      }
+      for (int i=0; i<num_independent; ++i) {
+        coeff_vec_[i] = - coeff_vec_[i];
+      }
+      linearalgebra::AddLinearCombination(dim_linear_problem_, 
+                                          num_independent, recycle_mat_[0], 
+                                          recycle_mat_.stride(), coeff_vec_, 
+                                          recycle_vec);
+      linearalgebra::ScaleVector(dim_linear_problem_, 1/norm, recycle_vec);
+      linearalgebra::ScaleVector(dim_linear_problem_, 1/norm, image_vec);
+      ++num_independent;
+    }
+    num_recycled_ = num_independent;
+    is_image_valid_ = true;
+  }
+
+  // Orthonormalizes U by the modified Gram-Schmidt and drops the vectors 
+  // that are linearly dependent on the preceding ones.
+  void orthonormalizeRecycledSubspace() {
+    int num_independent = 0;
+    for (int j=0; j<num_recycled_; ++j) {
+      double* recycle_vec = recycle_mat_[num_independent];
+      if (j != num_independent) {
+        for (int i=0; i<dim_linear_problem_; ++i) {
+          recycle_vec[i] = recycle_mat_[j][i];
+        }
+      }
+      const double original_norm = std::sqrt(linearalgebra::SquaredNorm(
+          dim_linear_problem_, recycle_vec));
+      const double norm = linearalgebra::OrthogonalizeAgainstRows(
+          dim_linear_problem_, num_independent, recycle_mat_[0], 
+          recycle_mat_.stride(), recycle_vec, coeff_vec_);
+      if (!(norm > kDropTolerance*original_norm)) {
+        continue;
+      }
+      linearalgebra::ScaleVector(dim_linear_problem_, 1/norm, recycle_vec);
+      ++num_independent;
+    }
+    num_recycled_ = num_independent;
+  }
+
+  // Performs the Arnoldi process of (I - C * C^T) * A * M^{-1} with at most 
+  // kmax-num_recycled_ calls of AxFunc() and the QR factorization of the 
+  // Hessenberg matrix by the Givens rotations starting from the normalized 
+  // residual basis_mat_[0] whose norm before the normalization is beta. 
+  // Returns the dimension of the Krylov subspace.
+  template <class Preconditioner>
+  int arnoldiCycle(Preconditioner& preconditioner, 
+                   LinearProblemGenerator& linear_problem_generator, 
+                   LinearProblemArgs... linear_problem_args, 
+                   const double beta, const double residual_tolerance) {
+    for (int i=0; i<kmax_+1; ++i) {
+      givens_c_vec_[i] = 0;
+      givens_s_vec_[i] = 0;
+      g_vec_[i] = 0;
+    }
+    g_vec_[0] = beta;
+    const int max_dim_krylov = kmax_ - num_recycled_;
+    int k;
+    for (k=0; k<max_dim_krylov; ++k) {
+      const double* direction_vec = basis_mat_[k];
+      if (!isIdentity(preconditioner)) {
+        preconditioner.apply(direction_vec, preconditioned_vec_);
+        direction_vec = preconditioned_vec_;
+      }
+      double* arnoldi_vec = basis_mat_[k+1];
+      linear_problem_generator.AxFunc(linear_problem_args..., direction_vec, 
+                                      arnoldi_vec);
+      // projection_mat_[k] = C * arnoldi_vec and 
+      // arnoldi_vec -= C^T * projection_mat_[k].
+      linearalgebra::OrthogonalizeAgainstRows(
+          dim_linear_problem_, num_recycled_, image_mat_[0], 
+          image_mat_.stride(), arnoldi_vec, projection_mat_[k]);
+      hessenberg_mat_[k][k+1] = linearalgebra::OrthogonalizeAgainstRows(
+          dim_linear_problem_, k+1, basis_mat_[0], basis_mat_.stride(), 
+          arnoldi_vec, hessenberg_mat_[k]);
+      if (!(std::abs(hessenberg_mat_[k][k+1])
+            >= std::numeric_limits<double>::epsilon())) {
+        break;
+      }
+      linearalgebra::ScaleVector(dim_linear_problem_, 
+                                 1/hessenberg_mat_[k][k+1], arnoldi_vec);
+      for (int i=0; i<=k+1; ++i) {
+        arnoldi_mat_[k][i] = hessenberg_mat_[k][i];
+      }
+      givensrotations::RotateColumn(k, givens_c_vec_, givens_s_vec_, 
+                                    hessenberg_mat_[k]);
+      const double nu = std::sqrt(
+          hessenberg_mat_[k][k]*hessenberg_mat_[k][k]
+          +hessenberg_mat_[k][k+1]*hessenberg_mat_[k][k+1]);
+      givens_c_vec_[k] = hessenberg_mat_[k][k] / nu;
+      givens_s_vec_[k] = - hessenberg_mat_[k][k+1] / nu;
+      hessenberg_mat_[k][k] = givens_c_vec_[k] * hessenberg_mat_[k][k] 
+                              - givens_s_vec_[k] * hessenberg_mat_[k][k+1];
+      hessenberg_mat_[k][k+1] = 0;
+      givensrotations::Rotate(givens_c_vec_[k], givens_s_vec_[k], k, g_vec_);
+      if (std::abs(g_vec_[k+1]) <= residual_tolerance) {
+        ++k;
+        break;
+      }
+    }
+    return k;
+  }
+
+  // Adds M^{-1} * (V^T * y + U^T * recycle_coeff_vec_) to solution_vec, 
+  // where y is the first k components of y_vec_.
+  template <class Preconditioner>
+  void updateSolution(Preconditioner& preconditioner, const int k, 
+                      double* solution_vec) {
+    double* update_vec = isIdentity(preconditioner) ? solution_vec 
+                                                    : krylov_solution_vec_;
+    if (!isIdentity(preconditioner)) {
+      for (int i=0; i<dim_linear_problem_; ++i) {
+        krylov_solution_vec_[i] = 0;
+      }
+    }
+    linearalgebra::AddLinearCombination(dim_linear_problem_, k, 
+                                        basis_mat_[0], basis_mat_.stride(), 
+                                        y_vec_, update_vec);
+    linearalgebra::AddLinearCombination(dim_linear_problem_, num_recycled_, 
+                                        recycle_mat_[0], recycle_mat_.stride(), 
+                                        recycle_coeff_vec_, update_vec);
+    if (!isIdentity(preconditioner)) {
+      preconditioner.apply(krylov_solution_vec_, preconditioned_vec_);
+      linearalgebra::AddScaledVector(dim_linear_problem_, 1.0, 
+                                     preconditioned_vec_, solution_vec);
+    }
+  }
+
+  // Replaces U by the harmonic Ritz vectors of the recycle_dim smallest 
+  // harmonic Ritz values with respect to the subspace W = [U, V] of the 
+  // latest cycle, whose Krylov subspace is k-dimensional. With 
+  // A * M^{-1} * W = [C, V] * G and X = [C, V]^T * W, the harmonic Ritz 
+  // vectors are W * z for the generalized eigenvalue problem 
+  // G^T * G * z = theta * G^T * X * z, which is solved as the standard 
+  // eigenvalue problem (G^T * G)^{-1} * G^T * X * z = z / theta. U is 
+  // normalized by D = diag(|u_i|) in W, i.e., W = [U * D^{-1}, V]. A complex 
+  // conjugate pair is represented by the real and imaginary parts of the 
+  // vector. The image of the new U is [C, V] * G * z, which is used in the 
+  // restart of the current solveLinearProblem() without calling AxFunc(). If 
+  // the eigenvalue problem fails, U is kept.
+  void updateRecycledSubspace(const int k) {
+    const int p = num_recycled_;
+    const int m = p + k;
+    if (recycle_dim_ == 0 || k == 0) {
+      return;
+    }
+    for (int j=0; j<p; ++j) {
+      recycle_norm_vec_[j] = std::sqrt(linearalgebra::SquaredNorm(
+          dim_linear_problem_, recycle_mat_[j]));
+    }
+    // G = [[D^{-1}, B], [0, H]] and X = [[C^T * U * D^{-1}, 0], 
+    // [V^T * U * D^{-1}, I]].
+    for (int i=0; i<=m; ++i) {
+      for (int j=0; j<m; ++j) {
+        augmented_mat_[i][j] = 0;
+        cross_mat_[i][j] = 0;
+      }
+    }
+    for (int i=0; i<p; ++i) {
+      augmented_mat_[i][i] = 1 / recycle_norm_vec_[i];
+      for (int j=0; j<k; ++j) {
+        augmented_mat_[i][p+j] = projection_mat_[j][i];
+      }
+      for (int j=0; j<p; ++j) {
+        cross_mat_[i][j] = linearalgebra::InnerProduct(
+            dim_linear_problem_, image_mat_[i], recycle_mat_[j]) 
+            / recycle_norm_vec_[j];
+      }
+    }
+    for (int i=0; i<=k; ++i) {
+      for (int j=std::max(i-1, 0); j<k; ++j) {
+        augmented_mat_[p+i][p+j] = arnoldi_mat_[j][i];
+      }
+      for (int j=0; j<p; ++j) {
+        cross_mat_[p+i][j] = linearalgebra::InnerProduct(
+            dim_linear_problem_, basis_mat_[i], recycle_mat_[j]) 
+            / recycle_norm_vec_[j];
+      }
+      if (i < k) {
+        cross_mat_[p+i][p+i] = 1;
+      }
+    }
+    // normal_mat_ = G^T * G and pencil_mat_[j] is the j-th column of 
+    // G^T * X, which is overwritten by that of (G^T * G)^{-1} * G^T * X.
+    for (int i=0; i<m; ++i) {
+      for (int j=0; j<m; ++j) {
+        double normal = 0, cross = 0;
+        for (int l=0; l<=m; ++l) {
+          normal += augmented_mat_[l][i] * augmented_mat_[l][j];
+          cross += augmented_mat_[l][j] * cross_mat_[l][i];
+        }
+        normal_mat_[i][j] = normal;
+        pencil_mat_[i][j] = cross;
+      }
+    }
+    if (!linearalgebra::LUFactorize(m, normal_mat_.stride(), normal_mat_[0], 
+                                    pivot_seq_)) {
+      return;
+    }
+    double max_abs_entry = 0;
+    for (int j=0; j<m; ++j) {
+      linearalgebra::LUSolve(m, normal_mat_.stride(), normal_mat_[0], 
+                             pivot_seq_, pencil_mat_[j]);
+      for (int i=0; i<m; ++i) {
+        eigen_mat_[i][j] = pencil_mat_[j][i];
+        max_abs_entry = std::max(max_abs_entry, std::abs(pencil_mat_[j][i]));
+      }
+    }
+    // eigen_mat_ is overwritten, and pencil_mat_ is kept as the transpose of 
+    // the matrix for the inverse iteration.
+    if (!linearalgebra::ComputeEigenvalues(m, eigen_mat_.stride(), 
+                                           eigen_mat_[0], eigen_real_vec_, 
+                                           eigen_imag_vec_)) {
+      return;
+    }
+    // The eigenvalues in the descending order of the magnitude, i.e., the 
+    // harmonic Ritz values in the ascending order.
+    for (int i=0; i<m; ++i) {
+      order_seq_[i] = i;
+    }
+    std::sort(order_seq_, order_seq_+m, [this](const int i, const int j) {
+      return std::hypot(eigen_real_vec_[i], eigen_imag_vec_[i])
+             > std::hypot(eigen_real_vec_[j], eigen_imag_vec_[j]);
+    });
+    int num_ritz = 0;
+    for (int i=0; i<m && num_ritz<recycle_dim_; ++i) {
+      const int l = order_seq_[i];
+      if (eigen_imag_vec_[l] < 0) {
+        continue;
+      }
+      if (eigen_imag_vec_[l] > 0 && num_ritz+2 > recycle_dim_) {
+        continue;
+      }
+      if (computeEigenvector(m, eigen_real_vec_[l], eigen_imag_vec_[l], 
+                             max_abs_entry)) {
+        for (int j=0; j<m; ++j) {
+          ritz_coeff_mat_[num_ritz][j] = eigen_vec_[j];
+        }
+        ++num_ritz;
+        if (eigen_imag_vec_[l] > 0) {
+          for (int j=0; j<m; ++j) {
+            ritz_coeff_mat_[num_ritz][j] = eigen_vec_[m+j];
+          }
+          ++num_ritz;
+        }
+      }
+    }
+    if (num_ritz == 0) {
+      return;
+    }
+    // ritz_mat_[i] = W * ritz_coeff_mat_[i] and 
+    // ritz_image_mat_[i] = [C, V] * G * ritz_coeff_mat_[i].
+    for (int i=0; i<num_ritz; ++i) {
+      for (int j=0; j<p; ++j) {
+        coeff_vec_[j] = ritz_coeff_mat_[i][j] / recycle_norm_vec_[j];
+      }
+      for (int l=0; l<dim_linear_problem_; ++l) {
+        ritz_mat_[i][l] = 0;
+      }
+      linearalgebra::AddLinearCombination(dim_linear_problem_, p, 
+                                          recycle_mat_[0], 
+                                          recycle_mat_.stride(), coeff_vec_, 
+                                          ritz_mat_[i]);
+      linearalgebra::AddLinearCombination(dim_linear_problem_, k, 
+                                          basis_mat_[0], basis_mat_.stride(), 
+                                          &(ritz_coeff_mat_[i][p]), 
+                                          ritz_mat_[i]);
+      for (int j=0; j<=m; ++j) {
+        coeff_vec_[j] = 0;
+        for (int l=0; l<m; ++l) {
+          coeff_vec_[j] += augmented_mat_[j][l] * ritz_coeff_mat_[i][l];
+        }
+      }
+      for (int l=0; l<dim_linear_problem_; ++l) {
+        ritz_image_mat_[i][l] = 0;
+      }
+      linearalgebra::AddLinearCombination(dim_linear_problem_, p, 
+                                          image_mat_[0], image_mat_.stride(), 
+                                          coeff_vec_, ritz_image_mat_[i]);
+      linearalgebra::AddLinearCombination(dim_linear_problem_, k+1, 
+                                          basis_mat_[0], basis_mat_.stride(), 
+                                          &(coeff_vec_[p]), 
+                                          ritz_image_mat_[i]);
+    }
+    for (int i=0; i<num_ritz; ++i) {
+      for (int l=0; l<dim_linear_problem_; ++l) {
+        recycle_mat_[i][l] = ritz_mat_[i][l];
+        image_mat_[i][l] = ritz_image_mat_[i][l];
+      }
+    }
+    num_recycled_ = num_ritz;
+  }
+
+  // Computes the eigenvector of the m x m matrix whose transpose is 
+  // pencil_mat_ for the eigenvalue real_part + i * imag_part by two steps of 
+  // the inverse iteration with the shift perturbed relative to 
+  // max_abs_entry, the largest magnitude of the entries of the matrix. The 
+  // real part of the eigenvector is stored in the first m components of 
+  // eigen_vec_ and the imaginary part in the next m components, which are 
+  // computed together by the equivalent real system of dimension 2m. 
+  // Returns false if the shifted matrix is regarded as singular.
+  bool computeEigenvector(const int m, const double real_part, 
+                          const double imag_part, const double max_abs_entry) {
+    const int dim = (imag_part == 0) ? m : 2*m;
+    const double shift 
+        = real_part + std::sqrt(std::numeric_limits<double>::epsilon()) 
+                      * (std::abs(real_part)+std::abs(imag_part)+max_abs_entry);
+    // [[N - shift * I, imag_part * I], [-imag_part * I, N - shift * I]]
+    for (int i=0; i<dim; ++i) {
+      for (int j=0; j<dim; ++j) {
+        inverse_iteration_mat_[i][j] = 0;
+      }
+    }
+    for (int i=0; i<m; ++i) {
+      for (int j=0; j<m; ++j) {
+        inverse_iteration_mat_[i][j] = pencil_mat_[j][i];
+      }
+      inverse_iteration_mat_[i][i] -= shift;
+    }
+    if (imag_part != 0) {
+      for (int i=0; i<m; ++i) {
+        for (int j=0; j<m; ++j) {
+          inverse_iteration_mat_[m+i][m+j] = inverse_iteration_mat_[i][j];
+        }
+        inverse_iteration_mat_[i][m+i] = imag_part;
+        inverse_iteration_mat_[m+i][i] = - imag_part;
+      }
+    }
+    if (!linearalgebra::LUFactorize(dim, inverse_iteration_mat_.stride(), 
+                                    inverse_iteration_mat_[0], pivot_seq_)) {
+      return false;
+    }
+    for (int i=0; i<dim; ++i) {
+      eigen_vec_[i] = (i < m) ? 1 : 0;
+    }
+    for (int iteration=0; iteration<2; ++iteration) {
+      linearalgebra::LUSolve(dim, inverse_iteration_mat_.stride(), 
+                             inverse_iteration_mat_[0], pivot_seq_, 
+                             eigen_vec_);
+      const double norm = std::sqrt(linearalgebra::SquaredNorm(dim, 
+                                                               eigen_vec_));
+      if (!(norm > 0) || !std::isfinite(norm)) {
+        return false;
+      }
+      linearalgebra::ScaleVector(dim, 1/norm, eigen_vec_);
+    }
+    return true;
+  }
+
+  void allocateVectors() {
+    const int dim_recycle = std::max(recycle_dim_, 1);
+    recycle_mat_.resize(dim_recycle, dim_linear_problem_);
+    image_mat_.resize(dim_recycle, dim_linear_problem_);
+    ritz_mat_.resize(dim_recycle, dim_linear_problem_);
+    ritz_image_mat_.resize(dim_recycle, dim_linear_problem_);
+    basis_mat_.resize(kmax_+1, dim_linear_problem_);
+    hessenberg_mat_.resize(kmax_+1, kmax_+1);
+    arnoldi_mat_.resize(kmax_+1, kmax_+1);
+    projection_mat_.resize(kmax_+1, dim_recycle);
+    augmented_mat_.resize(kmax_+1, kmax_);
+    cross_mat_.resize(kmax_+1, kmax_);
+    normal_mat_.resize(kmax_, kmax_);
+    pencil_mat_.resize(kmax_, kmax_);
+    eigen_mat_.resize(kmax_, kmax_);
+    inverse_iteration_mat_.resize(2*kmax_, 2*kmax_);
+    ritz_coeff_mat_.resize(dim_recycle, kmax_);
+    givens_c_vec_ = linearalgebra::NewVector(kmax_+1);
+    givens_s_vec_ = linearalgebra::NewVector(kmax_+1);
+    g_vec_ = linearalgebra::NewVector(kmax_+1);
+    y_vec_ = linearalgebra::NewVector(kmax_+1);
+    coeff_vec_ = linearalgebra::NewVector(kmax_+1);
+    recycle_coeff_vec_ = linearalgebra::NewVector(dim_recycle);
+    recycle_norm_vec_ = linearalgebra::NewVector(dim_recycle);
+    eigen_real_vec_ = linearalgebra::NewVector(kmax_);
+    eigen_imag_vec_ = linearalgebra::NewVector(kmax_);
+    eigen_vec_ = linearalgebra::NewVector(2*kmax_);
+    preconditioned_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+    krylov_solution_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+    work_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+    order_seq_ = new int[kmax_];
+    pivot_seq_ = new int[2*kmax_];
+  }
+
+  void deleteVectors() {
+    linearalgebra::DeleteVector(givens_c_vec_);
+    linearalgebra::DeleteVector(givens_s_vec_);
+    linearalgebra::DeleteVector(g_vec_);
+    linearalgebra::DeleteVector(y_vec_);
+    linearalgebra::DeleteVector(coeff_vec_);
+    linearalgebra::DeleteVector(recycle_coeff_vec_);
+    linearalgebra::DeleteVector(recycle_norm_vec_);
+    linearalgebra::DeleteVector(eigen_real_vec_);
+    linearalgebra::DeleteVector(eigen_imag_vec_);
+    linearalgebra::DeleteVector(eigen_vec_);
+    linearalgebra::DeleteVector(preconditioned_vec_);
+    linearalgebra::DeleteVector(krylov_solution_vec_);
+    linearalgebra::DeleteVector(work_vec_);
+    delete[] order_seq_;
+    delete[] pivot_seq_;
+    givens_c_vec_ = nullptr;
+    givens_s_vec_ = nullptr;
+    g_vec_ = nullptr;
+    y_vec_ = nullptr;
+    coeff_vec_ = nullptr;
+    recycle_coeff_vec_ = nullptr;
+    recycle_norm_vec_ = nullptr;
+    eigen_real_vec_ = nullptr;
+    eigen_imag_vec_ = nullptr;
+    eigen_vec_ = nullptr;
+    preconditioned_vec_ = nullptr;
+    krylov_solution_vec_ = nullptr;
+    work_vec_ = nullptr;
+    order_seq_ = nullptr;
+    pivot_seq_ = nullptr;
+  }
+
+  // Returns true if the preconditioner is IdentityPreconditioner.
+  static constexpr bool isIdentity(const IdentityPreconditioner&) {
+    return true;
+  }
+
+  // Returns true if the preconditioner is IdentityPreconditioner.
+  template <class Preconditioner>
+  static constexpr bool isIdentity(const Preconditioner&) {
+    return false;
+  }
+};
+
+} // namespace cgmres
+
+
+#endif // MATRIXFREE_GCRODR_H
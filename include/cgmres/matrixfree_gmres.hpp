@@ -9,7 +9,12 @@
 #include <iostream>
 #include <cmath>
 #include <limits>
+#include <algorithm>
 #include "linear_algebra.hpp"
+#include "aligned_matrix.hpp"
+#include "horizon_storage.hpp"
+#include "gmres_workspace.hpp"
+#include "identity_preconditioner.hpp"
 
 
 namespace cgmres {
@@ -28,75 +33,100 @@ namespace cgmres {
 // and
 // AxFunc(const double, const double* const double* const double*),
 // you have to define MatrixFreeGMRES<Newton, const double, const double*>.
-template <class LinearProblemGenerator, typename... LinearProblemArgs>
-class MatrixFreeGMRES {
+// MatrixFreeGMRES and FixedSizeMatrixFreeGMRES, which are defined below, are 
+// BasicMatrixFreeGMRES with DynamicGMRESWorkspace and FixedSizeGMRESWorkspace, 
+// respectively. The Workspace provides the vectors and matrices.
+template <class Workspace, class LinearProblemGenerator, 
+          typename... LinearProblemArgs>
+class BasicMatrixFreeGMRES : private Workspace {
 public:
   // Constructs MatrixFreeGMRES with setting dimension of the solution 
   // and that of the Krylov subspace zero, and sets nullptr for all vectors 
-  // and all matrices.
-  // MatrixFreeGMRES();
-  MatrixFreeGMRES()
-    : dim_linear_problem_(0), 
-      kmax_(0), 
-      hessenberg_mat_(nullptr), 
-      basis_mat_(nullptr), 
-      b_vec_(nullptr), 
-      givens_c_vec_(nullptr), 
-      givens_s_vec_(nullptr), 
-      g_vec_(nullptr) {
+  // and leaves all matrices empty.
+  // BasicMatrixFreeGMRES();
+  BasicMatrixFreeGMRES()
+    : Workspace(), 
+      num_iterations_(0), 
+      max_restarts_(0), 
+      num_restarts_(0), 
+      absolute_tolerance_(0), 
+      relative_tolerance_(0), 
+      residual_norm_(0) {
   }
 
   // Constructs MatrixFreeGMRES with setting dimension of the solution 
   // dim_linear_problem and that of the Krylov subspace as kmax, and allocate 
   // all vectors and all matrices used in the matrix-free GMRES.
-  // MatrixFreeGMRES(const int dim_linear_problem, const int kmax);
-  MatrixFreeGMRES(const int dim_linear_problem, const int kmax)
-    : dim_linear_problem_(dim_linear_problem), 
-      kmax_(kmax), 
-      hessenberg_mat_(linearalgebra::NewMatrix(kmax+1, kmax+1)), 
-      basis_mat_(linearalgebra::NewMatrix(kmax+1, dim_linear_problem)), 
-      b_vec_(linearalgebra::NewVector(dim_linear_problem)), 
-      givens_c_vec_(linearalgebra::NewVector(kmax+1)), 
-      givens_s_vec_(linearalgebra::NewVector(kmax+1)), 
-      g_vec_(linearalgebra::NewVector(kmax+1)) {
-    if (kmax > dim_linear_problem) {
-      kmax_ = dim_linear_problem;
-    }
+  // BasicMatrixFreeGMRES(const int dim_linear_problem, const int kmax);
+  BasicMatrixFreeGMRES(const int dim_linear_problem, const int kmax)
+    : Workspace(dim_linear_problem, kmax), 
+      num_iterations_(0), 
+      max_restarts_(0), 
+      num_restarts_(0), 
+      absolute_tolerance_(0), 
+      relative_tolerance_(0), 
+      residual_norm_(0) {
   }
 
   // Destructs MatrixFreeGMRES with freeing memory of vectors and matrices. 
   // If there are no allocations, this method does not free memory.
-  // ~MatrixFreeGMRES();
-  ~MatrixFreeGMRES() {
-    linearalgebra::DeleteMatrix(hessenberg_mat_);
-    linearalgebra::DeleteMatrix(basis_mat_);
-    linearalgebra::DeleteVector(b_vec_);
-    linearalgebra::DeleteVector(givens_c_vec_);
-    linearalgebra::DeleteVector(givens_s_vec_);
-    linearalgebra::DeleteVector(g_vec_);
+  // ~BasicMatrixFreeGMRES();
+  ~BasicMatrixFreeGMRES() {
   }
 
   // Sets dimensions of the solution and that of the Krylov subspace and 
   // reallocates all vectors and alld matrices used in the matrix-free GMRES.
   // void setParameters(const int dim_linear_problem, const int kmax);
   void setParameters(const int dim_linear_problem, const int kmax) {
-    linearalgebra::DeleteMatrix(hessenberg_mat_);
-    linearalgebra::DeleteMatrix(basis_mat_);
-    linearalgebra::DeleteVector(b_vec_);
-    linearalgebra::DeleteVector(givens_c_vec_);
-    linearalgebra::DeleteVector(givens_s_vec_);
-    linearalgebra::DeleteVector(g_vec_);
-    dim_linear_problem_ = dim_linear_problem;
-    kmax_ = kmax;
-    if (kmax > dim_linear_problem) {
-      kmax_ = dim_linear_problem;
-    }
-    hessenberg_mat_ = linearalgebra::NewMatrix(kmax+1, kmax+1);
-    basis_mat_ = linearalgebra::NewMatrix(kmax+1, dim_linear_problem);
-    b_vec_ = linearalgebra::NewVector(dim_linear_problem);
-    givens_c_vec_ = linearalgebra::NewVector(kmax+1);
-    givens_s_vec_ = linearalgebra::NewVector(kmax+1);
-    g_vec_ = linearalgebra::NewVector(kmax+1);
+    this->resizeWorkspace(dim_linear_problem, kmax);
+  }
+
+  // Sets the tolerances of the residual for the termination of the GMRES 
+  // iteration. The iteration terminates as soon as the estimate of the 
+  // residual norm, which is obtained from the Givens rotations without extra 
+  // computation, is less than or equal to 
+  // max(absolute_tolerance, relative_tolerance*||b-Ax_0||). If both of the 
+  // tolerances are zero (default), the GMRES iteration is performed kmax 
+  // times.
+  // void setTolerance(const double absolute_tolerance, 
+  //                   const double relative_tolerance);
+  void setTolerance(const double absolute_tolerance, 
+                    const double relative_tolerance) {
+    absolute_tolerance_ = absolute_tolerance;
+    relative_tolerance_ = relative_tolerance;
+  }
+
+  // Returns the number of the GMRES iterations, i.e., the dimension of the 
+  // Krylov subspace, used in the latest solveLinearProblem().
+  // int num_iterations() const;
+  int num_iterations() const {
+    return num_iterations_;
+  }
+
+  // Returns the estimate of the residual norm ||b-Ax|| at the end of the 
+  // latest solveLinearProblem().
+  // double residual_norm() const;
+  double residual_norm() const {
+    return residual_norm_;
+  }
+
+  // Sets the maximum number of the restarts of the GMRES method. If 
+  // max_restarts is positive, the GMRES(kmax) method, i.e., the restarted 
+  // GMRES method whose Krylov subspace is at most kmax-dimensional, is 
+  // performed at most max_restarts+1 times. The residual of the next cycle 
+  // is obtained from the Arnoldi relation and does not need bFunc(). The 
+  // restart is skipped when the residual satisfies the tolerances set by 
+  // setTolerance(). The default is zero, i.e., no restart.
+  // void setMaxRestarts(const int max_restarts);
+  void setMaxRestarts(const int max_restarts) {
+    max_restarts_ = max_restarts;
+  }
+
+  // Returns the number of the restarts performed in the latest 
+  // solveLinearProblem().
+  // int num_restarts() const;
+  int num_restarts() const {
+    return num_restarts_;
   }
 
   // Solves the matrix-free GMRES and generates solution_update_vector, 
@@ -104,6 +134,116 @@ public:
   void solveLinearProblem(LinearProblemGenerator& linear_problem_generator,
                           LinearProblemArgs... linear_problem_args,
                           double* solution_vec) {
+    IdentityPreconditioner preconditioner;
+    solveLinearProblem(preconditioner, linear_problem_generator, 
+                       linear_problem_args..., solution_vec);
+  }
+
+  // Solves the matrix-free GMRES with the right preconditioner, i.e., solves 
+  // A * M^{-1} * u = b - A * x_0 and sets x = x_0 + M^{-1} * u in 
+  // solution_vec. Preconditioner must have 
+  // apply(const double* vec, double* preconditioned_vec) that computes 
+  // M^{-1} * vec. With IdentityPreconditioner, no additional operation is 
+  // performed.
+  template <class Preconditioner>
+  void solveLinearProblem(Preconditioner& preconditioner, 
+                          LinearProblemGenerator& linear_problem_generator,
+                          LinearProblemArgs... linear_problem_args,
+                          double* solution_vec) {
+    num_iterations_ = 0;
+    num_restarts_ = 0;
+    // Generates the initial basis of the Krylov subspace.
+    double* residual_vec = basisWorkVec(0);
+    linear_problem_generator.bFunc(linear_problem_args..., solution_vec, 
+                                   residual_vec);
+    double beta = std::sqrt(linearalgebra::SquaredNorm(dim_linear_problem_, 
+                                                       residual_vec));
+    const double residual_tolerance 
+        = std::max(absolute_tolerance_, relative_tolerance_*beta);
+    if (beta <= residual_tolerance) {
+      // The initial guess already satisfies the tolerance.
+      residual_norm_ = beta;
+      return;
+    }
+    // basis_mat_[0] = residual_vec / beta
+    storeBasisVec(0, 1/beta);
+    while (true) {
+      const int k = arnoldiCycle(preconditioner, linear_problem_generator, 
+                                 linear_problem_args..., beta, 
+                                 residual_tolerance);
+      num_iterations_ += k;
+      residual_norm_ = std::abs(g_vec_[k]);
+      const bool restart = (num_restarts_ < max_restarts_) && (k == kmax_) 
+                           && (residual_norm_ > residual_tolerance);
+      if (restart) {
+        // The residual of the current cycle is 
+        // g_vec_[k] * basis_mat_^T * Q^T * e_{k+1}, where Q is the product of 
+        // the Givens rotations. Q^T * e_{k+1} is stored in restart_vec_ 
+        // before givens_c_vec_ is overwritten in the back substitution.
+        for (int i=0; i<k; ++i) {
+          restart_vec_[i] = 0;
+        }
+        restart_vec_[k] = 1;
+        for (int j=k-1; j>=0; --j) {
+          inverseGivensRotation(restart_vec_, j);
+        }
+      }
+      updateSolution(preconditioner, k, solution_vec);
+      if (!restart) {
+        break;
+      }
+      // residual_vec = sign(g_vec_[k]) * basis_mat_^T * restart_vec_, which 
+      // is the normalized residual because basis_mat_ and Q are orthogonal.
+      const double sign = (g_vec_[k] > 0) ? 1 : -1;
+      for (int j=0; j<=k; ++j) {
+        restart_vec_[j] *= sign;
+      }
+      loadBasisVec(0);
+      linearalgebra::ScaleVector(dim_linear_problem_, restart_vec_[0], 
+                                 residual_vec);
+      linearalgebra::AddLinearCombination(dim_linear_problem_, k, 
+                                          basis_mat_[1], basis_mat_.stride(), 
+                                          &(restart_vec_[1]), residual_vec);
+      storeBasisVec(0, 1.0);
+      beta = residual_norm_;
+      ++num_restarts_;
+    }
+  }
+
+  // Prohibits copy constructors.
+  BasicMatrixFreeGMRES(const BasicMatrixFreeGMRES&) = delete;
+  BasicMatrixFreeGMRES& operator=(const BasicMatrixFreeGMRES&) = delete;
+
+private:
+  using Workspace::dim_linear_problem_;
+  using Workspace::kmax_;
+  using Workspace::hessenberg_mat_;
+  using Workspace::basis_mat_;
+  using Workspace::givens_c_vec_;
+  using Workspace::givens_s_vec_;
+  using Workspace::g_vec_;
+  using Workspace::restart_vec_;
+  using Workspace::preconditioned_vec_;
+  using Workspace::krylov_solution_vec_;
+  using Workspace::basisWorkVec;
+  using Workspace::storeBasisVec;
+  using Workspace::loadBasisVec;
+  using Workspace::basisVec;
+  using Workspace::applyGivensRotations;
+  using Workspace::solveHessenberg;
+
+  int num_iterations_, max_restarts_, num_restarts_;
+  double absolute_tolerance_, relative_tolerance_, residual_norm_;
+
+  // Performs the Arnoldi process and the QR factorization of the Hessenberg 
+  // matrix by the Givens rotations starting from the normalized residual 
+  // basis_mat_[0] whose norm before the normalization is beta. Returns the 
+  // dimension of the Krylov subspace.
+  template <class Preconditioner>
+  int arnoldiCycle(Preconditioner& preconditioner, 
+                   LinearProblemGenerator& linear_problem_generator,
+                   LinearProblemArgs... linear_problem_args, 
+                   const double beta, const double residual_tolerance) {
     // Initializes vectors for QR factrization by Givens rotation.
     // Set givens_c_vec_, givens_s_vec_, g_vec_ as zero.
     for (int i=0; i<kmax_+1; ++i) {
@@ -111,30 +251,27 @@ public:
       givens_s_vec_[i] = 0;
       g_vec_[i] = 0;
     }
-    // Generates the initial basis of the Krylov subspace.
-    linear_problem_generator.bFunc(linear_problem_args..., solution_vec, 
-                                   b_vec_);
-    g_vec_[0] = std::sqrt(linearalgebra::SquaredNorm(dim_linear_problem_, 
-                                                     b_vec_));
-    // basis_mat_[0] = b_vec_ / g_vec[0]
-    for (int i=0; i<dim_linear_problem_; ++i) {
-      basis_mat_[0][i] = b_vec_[i] / g_vec_[0];
-    }
+    g_vec_[0] = beta;
     // k : the dimension of the Krylov subspace at the current iteration.
     int k;
     for (k=0; k<kmax_; ++k) {
-      linear_problem_generator.AxFunc(linear_problem_args..., basis_mat_[k], 
-                                      basis_mat_[k+1]);
-      for (int j=0; j<=k; ++j) {
-        hessenberg_mat_[k][j] = linearalgebra::InnerProduct(
-            dim_linear_problem_, basis_mat_[k+1], basis_mat_[j]);
-        // basis_mat_[k+1] -= hessenberg_mat_[k][j] * basis_mat_[j];
-        for (int i=0; i<dim_linear_problem_; ++i) {
-          basis_mat_[k+1][i] -= hessenberg_mat_[k][j] * basis_mat_[j][i];
-        }
+      const double* direction_vec = basisVec(k);
+      if (!isIdentity(preconditioner)) {
+        preconditioner.apply(direction_vec, preconditioned_vec_);
+        direction_vec = preconditioned_vec_;
       }
-      hessenberg_mat_[k][k+1] = std::sqrt(linearalgebra::SquaredNorm(
-          dim_linear_problem_, basis_mat_[k+1]));
+      // arnoldi_vec is the next basis vector basis_mat_[k+1] before it is 
+      // stored in basis_mat_.
+      double* arnoldi_vec = basisWorkVec(k+1);
+      linear_problem_generator.AxFunc(linear_problem_args..., direction_vec, 
+                                      arnoldi_vec);
+      // Modified Gram-Schmidt: hessenberg_mat_[k][j] is the inner product of 
+      // arnoldi_vec and basis_mat_[j], and 
+      // arnoldi_vec -= hessenberg_mat_[k][j] * basis_mat_[j] for 
+      // j = 0, ..., k. hessenberg_mat_[k][k+1] is the norm of the rest.
+      hessenberg_mat_[k][k+1] = linearalgebra::OrthogonalizeAgainstRows(
+          dim_linear_problem_, k+1, basis_mat_[0], basis_mat_.stride(), 
+          arnoldi_vec, hessenberg_mat_[k]);
       if (std::abs(hessenberg_mat_[k][k+1]) 
           < std::numeric_limits<double>::epsilon()) {
         std::cout << "The modified Gram-Schmidt breakdown at k = " << k 
@@ -142,15 +279,11 @@ public:
         break;
       }
       else {
-        // basis_mat_[k+1] = basis_mat_[k+1] / hessenberg_mat_[k][k+1];
-        for (int i=0; i<dim_linear_problem_; ++i) {
-          basis_mat_[k+1][i] = basis_mat_[k+1][i] / hessenberg_mat_[k][k+1];
-        }
+        // basis_mat_[k+1] = arnoldi_vec / hessenberg_mat_[k][k+1];
+        storeBasisVec(k+1, 1/hessenberg_mat_[k][k+1]);
       }
       // Givens Rotation for QR factrization of the least squares problem.
-      for (int j=0; j<k; ++j) {
-        givensRotation(hessenberg_mat_[k], j);
-      }
+      applyGivensRotations(k, hessenberg_mat_[k]);
       double nu = std::sqrt(hessenberg_mat_[k][k]*hessenberg_mat_[k][k]
                             +hessenberg_mat_[k][k+1]*hessenberg_mat_[k][k+1]);
       if (nu) {
@@ -160,37 +293,69 @@ public:
                                 - givens_s_vec_[k] * hessenberg_mat_[k][k+1];
         hessenberg_mat_[k][k+1] = 0;
         givensRotation(g_vec_,k);
+        // |g_vec_[k+1]| is the residual norm with the (k+1)-dimensional 
+        // Krylov subspace.
+        if (std::abs(g_vec_[k+1]) <= residual_tolerance) {
+          ++k;
+          break;
+        }
       }
       else {
         std::cout << "Lose orthogonality of the basis of the Krylov subspace" 
                   << std::endl;
       }
     }
-    // Computes solution_vec by solving hessenberg_mat_ * y = g_vec.
-    for (int i=k-1; i>=0; --i) {
-      double tmp = g_vec_[i];
-      for (int j=i+1; j<k; ++j) {
-        tmp -= hessenberg_mat_[j][i] * givens_c_vec_[j];
-      }
-      givens_c_vec_[i] = tmp / hessenberg_mat_[i][i];
+    return k;
+  }
+
+  // Solves hessenberg_mat_ * y = g_vec_ with the k-dimensional Krylov 
+  // subspace by solveHessenberg() of the workspace and adds 
+  // M^{-1} * basis_mat_^T * y to solution_vec. y is stored in givens_c_vec_.
+  template <class Preconditioner>
+  void updateSolution(Preconditioner& preconditioner, const int k, 
+                      double* solution_vec) {
+    solveHessenberg(k);
+    if (isIdentity(preconditioner)) {
+      // solution_vec += basis_mat_^T * givens_c_vec_
+      linearalgebra::AddLinearCombination(dim_linear_problem_, k, 
+                                          basis_mat_[0], basis_mat_.stride(), 
+                                          givens_c_vec_, solution_vec);
     }
-    for (int i=0; i<dim_linear_problem_; ++i) {
-      double tmp = 0;
-      for (int j=0; j<k; ++j) { 
-        tmp += basis_mat_[j][i] * givens_c_vec_[j];
+    else {
+      // solution_vec += M^{-1} * basis_mat_^T * givens_c_vec_
+      for (int i=0; i<dim_linear_problem_; ++i) {
+        krylov_solution_vec_[i] = 0;
       }
-      solution_vec[i] += tmp;
+      linearalgebra::AddLinearCombination(dim_linear_problem_, k, 
+                                          basis_mat_[0], basis_mat_.stride(), 
+                                          givens_c_vec_, krylov_solution_vec_);
+      preconditioner.apply(krylov_solution_vec_, preconditioned_vec_);
+      linearalgebra::AddScaledVector(dim_linear_problem_, 1.0, 
+                                     preconditioned_vec_, solution_vec);
     }
   }
 
-  // Prohibits copy constructors.
-  MatrixFreeGMRES(const MatrixFreeGMRES&) = delete;
-  MatrixFreeGMRES& operator=(const MatrixFreeGMRES&) = delete;
+  // Returns true if the preconditioner is IdentityPreconditioner. 
+  static constexpr bool isIdentity(const IdentityPreconditioner&) {
+    return true;
+  }
 
-private:
-  int dim_linear_problem_, kmax_;
-  double **hessenberg_mat_, **basis_mat_;
-  double *b_vec_, *givens_c_vec_, *givens_s_vec_, *g_vec_;
+  // Returns true if the preconditioner is IdentityPreconditioner. 
+  template <class Preconditioner>
+  static constexpr bool isIdentity(const Preconditioner&) {
+    return false;
+  }
+
+  // Applies the inverse of the Givens rotation for i_column element and 
+  // i_column+1 element of column_vec.
+  inline void inverseGivensRotation(double* column_vec, const int i_column) {
+    double tmp1 = givens_c_vec_[i_column] * column_vec[i_column] 
+                  + givens_s_vec_[i_column] * column_vec[i_column+1];
+    double tmp2 = - givens_s_vec_[i_column] * column_vec[i_column] 
+                  + givens_c_vec_[i_column] * column_vec[i_column+1];
+    column_vec[i_column] = tmp1;
+    column_vec[i_column+1] = tmp2;
+  }
 
   // Applies the Givens rotation for i_column element and i_column+1 
   // element of column_vec, which is a column vector of a matrix.
@@ -205,6 +370,77 @@ private:
 }
 };
 
+// The matrix-free GMRES method whose dimension of the linear problem and that 
+// of the Krylov subspace are given at runtime.
+template <class LinearProblemGenerator, typename... LinearProblemArgs>
+using MatrixFreeGMRES = BasicMatrixFreeGMRES<DynamicGMRESWorkspace, 
+                                             LinearProblemGenerator, 
+                                             LinearProblemArgs...>;
+
+// The matrix-free GMRES method whose dimension of the Krylov subspace Kmax and 
+// that of the linear problem DimLinearProblem are fixed at compile time. The 
+// vectors and matrices are stored in the object itself, the loops over them 
+// have constant bounds, and the Givens rotations and the back substitution 
+// are unrolled for each dimension of the Krylov subspace. 
+// The dimensions passed to the constructor must be equal to Kmax and 
+// DimLinearProblem. 
+template <int Kmax, int DimLinearProblem, class LinearProblemGenerator, 
+          typename... LinearProblemArgs>
+using FixedSizeMatrixFreeGMRES 
+    = BasicMatrixFreeGMRES<FixedSizeGMRESWorkspace<Kmax, DimLinearProblem>, 
+                           LinearProblemGenerator, LinearProblemArgs...>;
+
+// The matrix-free GMRES method whose basis of the Krylov subspace is stored 
+// in single precision. The other computations are performed in double 
+// precision.
+template <class LinearProblemGenerator, typename... LinearProblemArgs>
+using MixedPrecisionMatrixFreeGMRES 
+    = BasicMatrixFreeGMRES<MixedPrecisionGMRESWorkspace, 
+                           LinearProblemGenerator, LinearProblemArgs...>;
+
+// The matrix-free GMRES method used in controlUpdate() of ContinuationGMRES, 
+// MultipleShootingCGMRES, MSCGMRESWithInputSaturation, and 
+// UncondensedMSCGMRES whose FixedKmax is kDynamicSize. If 
+// CGMRES_SINGLE_PRECISION_BASIS is defined, e.g., in CMakeLists.txt 
+// generated by AutoGenU, this is MixedPrecisionMatrixFreeGMRES. Otherwise, 
+// this is MatrixFreeGMRES. 
+#if defined(CGMRES_SINGLE_PRECISION_BASIS)
+template <class LinearProblemGenerator, typename... LinearProblemArgs>
+using ControlUpdateGMRES 
+    = MixedPrecisionMatrixFreeGMRES<LinearProblemGenerator, 
+                                    LinearProblemArgs...>;
+#else
+template <class LinearProblemGenerator, typename... LinearProblemArgs>
+using ControlUpdateGMRES = MatrixFreeGMRES<LinearProblemGenerator, 
+                                           LinearProblemArgs...>;
+#endif
+
+// Selects the matrix-free GMRES method of controlUpdate() of the solvers from 
+// their template parameter FixedKmax and the dimension of their linear 
+// problem DimLinearProblem, which is fixed if FixedN is. If FixedKmax is 
+// kDynamicSize, Method is ControlUpdateGMRES. Otherwise, Method is 
+// FixedSizeMatrixFreeGMRES whose dimension of the Krylov subspace is 
+// min(FixedKmax, DimLinearProblem). 
+template <int FixedKmax, int DimLinearProblem>
+struct ControlUpdateKrylovMethod {
+  static_assert(DimLinearProblem != kDynamicSize, 
+                "FixedKmax requires FixedN to be fixed");
+
+  template <class LinearProblemGenerator, typename... LinearProblemArgs>
+  using Method 
+      = FixedSizeMatrixFreeGMRES<(FixedKmax < DimLinearProblem) 
+                                     ? FixedKmax : DimLinearProblem, 
+                                 DimLinearProblem, LinearProblemGenerator, 
+                                 LinearProblemArgs...>;
+};
+
+template <int DimLinearProblem>
+struct ControlUpdateKrylovMethod<kDynamicSize, DimLinearProblem> {
+  template <class LinearProblemGenerator, typename... LinearProblemArgs>
+  using Method = ControlUpdateGMRES<LinearProblemGenerator, 
+                                    LinearProblemArgs...>;
+};
+
 } // namespace cgmres
 
 
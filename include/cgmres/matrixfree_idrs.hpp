@@ -0,0 +1,471 @@
+// The matrix-free induced dimension reduction (IDR(s)) method, which can be 
+// used in the C/GMRES method in place of MatrixFreeGMRES. This program is 
+// written with reference to "M. B. van Gijzen and P. Sonneveld, Algorithm 
+// 913: An elegant IDR(s) variant that efficiently exploits 
+// biorthogonality properties, ACM Transactions on Mathematical Software, 
+// Vol. 38, No. 1, pp. 5:1-5:19 (2011)".
+
+#ifndef MATRIXFREE_IDRS_H
+#define MATRIXFREE_IDRS_H
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <random>
+#include "linear_algebra.hpp"
+#include "aligned_matrix.hpp"
+#include "identity_preconditioner.hpp"
+#include "minimal_residual_smoothing.hpp"
+
+
+namespace cgmres {
+
+// Serves the matrix-free IDR(s) method with the biorthogonalization, which 
+// solves the linear problem Ax = b provided by LinearProblemGenerator with 
+// the same bFunc() and AxFunc() as MatrixFreeGMRES. The template parameters 
+// are also the same as those of MatrixFreeGMRES. The memory is proportional 
+// to the dimension of the shadow space s and does not depend on the number 
+// of the iterations. IDR(1) is mathematically equivalent to the BiCGStab 
+// method and a larger s usually needs fewer calls of AxFunc(). kmax is the 
+// maximum number of the calls of AxFunc(), so that the computational cost is 
+// comparable to that of MatrixFreeGMRES with the same kmax. The iterates are 
+// smoothed by MinimalResidualSmoothing as in MatrixFreeBiCGStab.
+template <class LinearProblemGenerator, typename... LinearProblemArgs>
+class MatrixFreeIDRs {
+public:
+  // The default dimension of the shadow space.
+  static constexpr int kDefaultShadowSpaceDimension = 4;
+
+  // Constructs MatrixFreeIDRs with setting dimension of the solution and the 
+  // maximum number of the calls of AxFunc() zero, and sets nullptr for all 
+  // vectors and leaves all matrices empty.
+  MatrixFreeIDRs()
+    : dim_linear_problem_(0), 
+      kmax_(0), 
+      shadow_dim_(0), 
+      num_iterations_(0), 
+      max_restarts_(0), 
+      num_restarts_(0), 
+      absolute_tolerance_(0), 
+      relative_tolerance_(0), 
+      residual_norm_(0), 
+      shadow_mat_(), 
+      residual_image_mat_(), 
+      update_mat_(), 
+      projection_mat_(), 
+      residual_vec_(nullptr), 
+      work_vec_(nullptr), 
+      preconditioned_vec_(nullptr), 
+      image_vec_(nullptr), 
+      projected_residual_vec_(nullptr), 
+      coeff_vec_(nullptr), 
+      normalized_vec_(nullptr), 
+      smoothing_() {
+  }
+
+  // Constructs MatrixFreeIDRs with setting dimension of the solution 
+  // dim_linear_problem and the maximum number of the calls of AxFunc() kmax, 
+  // and allocates all vectors and matrices. The dimension of the shadow 
+  // space is kDefaultShadowSpaceDimension or dim_linear_problem if it is 
+  // smaller.
+  MatrixFreeIDRs(const int dim_linear_problem, const int kmax)
+    : dim_linear_problem_(dim_linear_problem), 
+      kmax_(kmax), 
+      shadow_dim_(std::min(kDefaultShadowSpaceDimension, dim_linear_problem)), 
+      num_iterations_(0), 
+      max_restarts_(0), 
+      num_restarts_(0), 
+      absolute_tolerance_(0), 
+      relative_tolerance_(0), 
+      residual_norm_(0), 
+      shadow_mat_(), 
+      residual_image_mat_(), 
+      update_mat_(), 
+      projection_mat_(), 
+      residual_vec_(nullptr), 
+      work_vec_(nullptr), 
+      preconditioned_vec_(nullptr), 
+      image_vec_(nullptr), 
+      projected_residual_vec_(nullptr), 
+      coeff_vec_(nullptr), 
+      normalized_vec_(nullptr), 
+      smoothing_(dim_linear_problem) {
+    allocateVectors();
+  }
+
+  // Destructs MatrixFreeIDRs with freeing memory of vectors and matrices.
+  ~MatrixFreeIDRs() {
+    deleteVectors();
+  }
+
+  // Sets dimension of the solution and the maximum number of the calls of 
+  // AxFunc() and reallocates all vectors and matrices. The dimension of the 
+  // shadow space is kept if possible.
+  void setParameters(const int dim_linear_problem, const int kmax) {
+    deleteVectors();
+    dim_linear_problem_ = dim_linear_problem;
+    kmax_ = kmax;
+    if (shadow_dim_ == 0) {
+      shadow_dim_ = kDefaultShadowSpaceDimension;
+    }
+    shadow_dim_ = std::min(shadow_dim_, dim_linear_problem_);
+    smoothing_.resize(dim_linear_problem);
+    allocateVectors();
+  }
+
+  // Sets the dimension of the shadow space s and reallocates all vectors and 
+  // matrices. s is clamped to [1, dim_linear_problem].
+  void setShadowSpaceDimension(const int shadow_dim) {
+    deleteVectors();
+    shadow_dim_ = std::max(std::min(shadow_dim, dim_linear_problem_), 1);
+    allocateVectors();
+  }
+
+  // Returns the dimension of the shadow space.
+  int shadow_dim() const {
+    return shadow_dim_;
+  }
+
+  // Sets the tolerances of the residual for the termination. The iteration 
+  // terminates as soon as the residual norm is less than or equal to 
+  // max(absolute_tolerance, relative_tolerance*||b-Ax_0||). If both of the 
+  // tolerances are zero (default), AxFunc() is called kmax times unless the 
+  // method breaks down.
+  void setTolerance(const double absolute_tolerance, 
+                    const double relative_tolerance) {
+    absolute_tolerance_ = absolute_tolerance;
+    relative_tolerance_ = relative_tolerance;
+  }
+
+  // Returns the number of the calls of AxFunc() in the latest 
+  // solveLinearProblem().
+  int num_iterations() const {
+    return num_iterations_;
+  }
+
+  // Returns the residual norm ||b-Ax|| of the solution of the latest 
+  // solveLinearProblem(), which is obtained from the recurrence.
+  double residual_norm() const {
+    return residual_norm_;
+  }
+
+  // Sets the maximum number of the restarts. When the IDR(s) method breaks 
+  // down, i.e., a diagonal component of the projection of the residual 
+  // images onto the shadow space vanishes, the method is restarted from the 
+  // current solution at most max_restarts times. The default is zero, i.e., 
+  // the iteration terminates at the breakdown.
+  void setMaxRestarts(const int max_restarts) {
+    max_restarts_ = max_restarts;
+  }
+
+  // Returns the number of the restarts performed in the latest 
+  // solveLinearProblem().
+  int num_restarts() const {
+    return num_restarts_;
+  }
+
+  // Solves the linear problem by the matrix-free IDR(s) method and adds the 
+  // solution update to solution_vec.
+  void solveLinearProblem(LinearProblemGenerator& linear_problem_generator, 
+                          LinearProblemArgs... linear_problem_args, 
+                          double* solution_vec) {
+    IdentityPreconditioner preconditioner;
+    solveLinearProblem(preconditioner, linear_problem_generator, 
+                       linear_problem_args..., solution_vec);
+  }
+
+  // Solves the linear problem by the matrix-free IDR(s) method with the 
+  // right preconditioner, i.e., solves A * M^{-1} * u = b - A * x_0 and sets 
+  // x = x_0 + M^{-1} * u in solution_vec. Preconditioner must have 
+  // apply(const double* vec, double* preconditioned_vec) that computes 
+  // M^{-1} * vec. With IdentityPreconditioner, no additional operation is 
+  // performed.
+  template <class Preconditioner>
+  void solveLinearProblem(Preconditioner& preconditioner, 
+                          LinearProblemGenerator& linear_problem_generator, 
+                          LinearProblemArgs... linear_problem_args, 
+                          double* solution_vec) {
+    num_iterations_ = 0;
+    num_restarts_ = 0;
+    linear_problem_generator.bFunc(linear_problem_args..., solution_vec, 
+                                   residual_vec_);
+    residual_norm_ = smoothing_.initialize(solution_vec, residual_vec_);
+    const double residual_tolerance
+        = std::max(absolute_tolerance_, relative_tolerance_*residual_norm_);
+    double omega = 1;
+    initializeSpaces();
+    while (residual_norm_ > residual_tolerance && num_iterations_ < kmax_) {
+      // projected_residual_vec_ = shadow_mat_ * residual_vec_
+      for (int i=0; i<shadow_dim_; ++i) {
+        projected_residual_vec_[i] = linearalgebra::InnerProduct(
+            dim_linear_problem_, shadow_mat_[i], residual_vec_);
+      }
+      bool is_converged = false, is_breakdown = false;
+      // Generates shadow_dim_ residuals in the next Sonneveld space.
+      for (int k=0; k<shadow_dim_ && num_iterations_<kmax_; ++k) {
+        // Solves the lower triangular system 
+        // projection_mat_(k:s, k:s) * c = projected_residual_vec_(k:s).
+        for (int i=k; i<shadow_dim_; ++i) {
+          double tmp = projected_residual_vec_[i];
+          for (int j=k; j<i; ++j) {
+            tmp -= projection_mat_[i][j] * coeff_vec_[j];
+          }
+          coeff_vec_[i] = tmp / projection_mat_[i][i];
+        }
+        // work_vec_ = residual_vec_ - residual_image_mat_^T * c
+        for (int i=0; i<dim_linear_problem_; ++i) {
+          work_vec_[i] = residual_vec_[i];
+        }
+        for (int i=k; i<shadow_dim_; ++i) {
+          linearalgebra::AddScaledVector(dim_linear_problem_, -coeff_vec_[i], 
+                                         residual_image_mat_[i], work_vec_);
+        }
+        const double* preconditioned_vec = work_vec_;
+        if (!isIdentity(preconditioner)) {
+          preconditioner.apply(work_vec_, preconditioned_vec_);
+          preconditioned_vec = preconditioned_vec_;
+        }
+        // update_mat_[k] = update_mat_^T * c + omega * M^{-1} * work_vec_
+        linearalgebra::ScaleVector(dim_linear_problem_, coeff_vec_[k], 
+                                   update_mat_[k]);
+        for (int i=k+1; i<shadow_dim_; ++i) {
+          linearalgebra::AddScaledVector(dim_linear_problem_, coeff_vec_[i], 
+                                         update_mat_[i], update_mat_[k]);
+        }
+        linearalgebra::AddScaledVector(dim_linear_problem_, omega, 
+                                       preconditioned_vec, update_mat_[k]);
+        multiplyCoefficientMatrix(linear_problem_generator, 
+                                  linear_problem_args..., update_mat_[k], 
+                                  residual_image_mat_[k]);
+        ++num_iterations_;
+        // Biorthogonalizes residual_image_mat_[k] against shadow_mat_[i] for 
+        // i < k.
+        for (int i=0; i<k; ++i) {
+          const double alpha = linearalgebra::InnerProduct(
+              dim_linear_problem_, shadow_mat_[i], residual_image_mat_[k])
+              / projection_mat_[i][i];
+          linearalgebra::AddScaledVector(dim_linear_problem_, -alpha, 
+                                         residual_image_mat_[i], 
+                                         residual_image_mat_[k]);
+          linearalgebra::AddScaledVector(dim_linear_problem_, -alpha, 
+                                         update_mat_[i], update_mat_[k]);
+        }
+        for (int i=k; i<shadow_dim_; ++i) {
+          projection_mat_[i][k] = linearalgebra::InnerProduct(
+              dim_linear_problem_, shadow_mat_[i], residual_image_mat_[k]);
+        }
+        // The shadow vectors are orthonormal, so that projection_mat_[k][k] 
+        // is compared with the norm of residual_image_mat_[k] only. The 
+        // comparison is also true if it is not finite.
+        if (!(std::abs(projection_mat_[k][k])
+              > std::numeric_limits<double>::epsilon()
+                * std::sqrt(linearalgebra::SquaredNorm(
+                      dim_linear_problem_, residual_image_mat_[k])))) {
+          is_breakdown = true;
+          break;
+        }
+        // Makes the residual orthogonal to shadow_mat_[i] for i <= k.
+        const double beta = projected_residual_vec_[k] / projection_mat_[k][k];
+        linearalgebra::AddScaledVector(dim_linear_problem_, -beta, 
+                                       residual_image_mat_[k], residual_vec_);
+        linearalgebra::AddScaledVector(dim_linear_problem_, beta, 
+                                       update_mat_[k], solution_vec);
+        residual_norm_ = smoothing_.update(solution_vec, residual_vec_);
+        if (residual_norm_ <= residual_tolerance) {
+          is_converged = true;
+          break;
+        }
+        for (int i=k+1; i<shadow_dim_; ++i) {
+          projected_residual_vec_[i] -= beta * projection_mat_[i][k];
+        }
+      }
+      if (is_converged || num_iterations_ >= kmax_) {
+        break;
+      }
+      if (!is_breakdown) {
+        // Dimension reduction step: the residual enters the next Sonneveld 
+        // space by the minimal residual step.
+        const double* preconditioned_vec = residual_vec_;
+        if (!isIdentity(preconditioner)) {
+          preconditioner.apply(residual_vec_, preconditioned_vec_);
+          preconditioned_vec = preconditioned_vec_;
+        }
+        multiplyCoefficientMatrix(linear_problem_generator, 
+                                  linear_problem_args..., preconditioned_vec, 
+                                  image_vec_);
+        ++num_iterations_;
+        omega = computeOmega();
+        if (omega != 0) {
+          linearalgebra::AddScaledVector(dim_linear_problem_, omega, 
+                                         preconditioned_vec, solution_vec);
+          linearalgebra::AddScaledVector(dim_linear_problem_, -omega, 
+                                         image_vec_, residual_vec_);
+          residual_norm_ = smoothing_.update(solution_vec, residual_vec_);
+          continue;
+        }
+      }
+      if (num_restarts_ >= max_restarts_) {
+        break;
+      }
+      // Restarts from the smoothed iterate because the recurrences may have 
+      // lost the accuracy at the breakdown.
+      const double* smoothed_solution_vec = smoothing_.smoothed_solution_vec();
+      const double* smoothed_residual_vec = smoothing_.smoothed_residual_vec();
+      for (int i=0; i<dim_linear_problem_; ++i) {
+        solution_vec[i] = smoothed_solution_vec[i];
+        residual_vec_[i] = smoothed_residual_vec[i];
+      }
+      omega = 1;
+      initializeSpaces();
+      ++num_restarts_;
+    }
+    // The smoothed iterate, whose residual is residual_norm_, is returned.
+    const double* smoothed_solution_vec = smoothing_.smoothed_solution_vec();
+    for (int i=0; i<dim_linear_problem_; ++i) {
+      solution_vec[i] = smoothed_solution_vec[i];
+    }
+  }
+
+  // Prohibits copy constructors.
+  MatrixFreeIDRs(const MatrixFreeIDRs&) = delete;
+  MatrixFreeIDRs& operator=(const MatrixFreeIDRs&) = delete;
+
+private:
+  int dim_linear_problem_, kmax_, shadow_dim_, num_iterations_, 
+      max_restarts_, num_restarts_;
+  double absolute_tolerance_, relative_tolerance_, residual_norm_;
+  // shadow_mat_[i] is the i-th orthonormal basis vector of the shadow space. 
+  // update_mat_[i] is a solution update and residual_image_mat_[i] is its 
+  // image by the coefficient matrix.
+  AlignedMatrix shadow_mat_, residual_image_mat_, update_mat_, 
+      projection_mat_;
+  double *residual_vec_, *work_vec_, *preconditioned_vec_, *image_vec_, 
+      *projected_residual_vec_, *coeff_vec_, *normalized_vec_;
+  MinimalResidualSmoothing smoothing_;
+
+  // Computes image_vec = A * vec by AxFunc() with vec normalized and scales 
+  // the result back, since the forward difference approximation of AxFunc() 
+  // is accurate only for vec of about unit norm. See MatrixFreeBiCGStab.
+  void multiplyCoefficientMatrix(
+      LinearProblemGenerator& linear_problem_generator, 
+      LinearProblemArgs... linear_problem_args, const double* vec, 
+      double* image_vec) {
+    const double norm = std::sqrt(linearalgebra::SquaredNorm(
+        dim_linear_problem_, vec));
+    if (norm == 0) {
+      for (int i=0; i<dim_linear_problem_; ++i) {
+        image_vec[i] = 0;
+      }
+      return;
+    }
+    for (int i=0; i<dim_linear_problem_; ++i) {
+      normalized_vec_[i] = vec[i] / norm;
+    }
+    linear_problem_generator.AxFunc(linear_problem_args..., normalized_vec_, 
+                                    image_vec);
+    linearalgebra::ScaleVector(dim_linear_problem_, norm, image_vec);
+  }
+
+  // Sets residual_image_mat_ and update_mat_ zero and projection_mat_ the 
+  // identity.
+  void initializeSpaces() {
+    for (int i=0; i<shadow_dim_; ++i) {
+      for (int j=0; j<dim_linear_problem_; ++j) {
+        residual_image_mat_[i][j] = 0;
+        update_mat_[i][j] = 0;
+      }
+      for (int j=0; j<shadow_dim_; ++j) {
+        projection_mat_[i][j] = 0;
+      }
+      projection_mat_[i][i] = 1;
+    }
+  }
+
+  // Returns omega that minimizes ||residual_vec_ - omega * image_vec_||, or 
+  // zero if they are orthogonal. If the angle between them is large, omega 
+  // is enlarged as in MatrixFreeBiCGStab.
+  double computeOmega() const {
+    constexpr double kappa = 0.7;
+    const double image_norm = std::sqrt(linearalgebra::SquaredNorm(
+        dim_linear_problem_, image_vec_));
+    const double residual_norm = std::sqrt(linearalgebra::SquaredNorm(
+        dim_linear_problem_, residual_vec_));
+    const double inner_product = linearalgebra::InnerProduct(
+        dim_linear_problem_, image_vec_, residual_vec_);
+    if (!(std::abs(inner_product) 
+          > std::numeric_limits<double>::epsilon()*image_norm*residual_norm)) {
+      return 0;
+    }
+    const double rho = std::abs(inner_product) / (image_norm*residual_norm);
+    double omega = inner_product / (image_norm*image_norm);
+    if (rho < kappa) {
+      omega *= kappa / rho;
+    }
+    return omega;
+  }
+
+  // Allocates the vectors and matrices and generates the orthonormal basis 
+  // of the shadow space from pseudo-random numbers with a fixed seed, so 
+  // that the results are reproducible.
+  void allocateVectors() {
+    shadow_mat_.resize(shadow_dim_, dim_linear_problem_);
+    residual_image_mat_.resize(shadow_dim_, dim_linear_problem_);
+    update_mat_.resize(shadow_dim_, dim_linear_problem_);
+    projection_mat_.resize(shadow_dim_, shadow_dim_);
+    residual_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+    work_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+    preconditioned_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+    image_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+    projected_residual_vec_ = linearalgebra::NewVector(shadow_dim_);
+    coeff_vec_ = linearalgebra::NewVector(shadow_dim_);
+    normalized_vec_ = linearalgebra::NewVector(dim_linear_problem_);
+    std::mt19937 random_engine(0);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    for (int i=0; i<shadow_dim_; ++i) {
+      for (int j=0; j<dim_linear_problem_; ++j) {
+        shadow_mat_[i][j] = distribution(random_engine);
+      }
+      const double norm = linearalgebra::OrthogonalizeAgainstRows(
+          dim_linear_problem_, i, shadow_mat_[0], shadow_mat_.stride(), 
+          shadow_mat_[i], coeff_vec_);
+      linearalgebra::ScaleVector(dim_linear_problem_, 1/norm, shadow_mat_[i]);
+    }
+  }
+
+  void deleteVectors() {
+    linearalgebra::DeleteVector(residual_vec_);
+    linearalgebra::DeleteVector(work_vec_);
+    linearalgebra::DeleteVector(preconditioned_vec_);
+    linearalgebra::DeleteVector(image_vec_);
+    linearalgebra::DeleteVector(projected_residual_vec_);
+    linearalgebra::DeleteVector(coeff_vec_);
+    linearalgebra::DeleteVector(normalized_vec_);
+    residual_vec_ = nullptr;
+    work_vec_ = nullptr;
+    preconditioned_vec_ = nullptr;
+    image_vec_ = nullptr;
+    projected_residual_vec_ = nullptr;
+    coeff_vec_ = nullptr;
+    normalized_vec_ = nullptr;
+  }
+
+  // Returns true if the preconditioner is IdentityPreconditioner.
+  static constexpr bool isIdentity(const IdentityPreconditioner&) {
+    return true;
+  }
+
+  // Returns true if the preconditioner is IdentityPreconditioner.
+  template <class Preconditioner>
+  static constexpr bool isIdentity(const Preconditioner&) {
+    return false;
+  }
+};
+
+template <class LinearProblemGenerator, typename... LinearProblemArgs>
+constexpr int MatrixFreeIDRs<LinearProblemGenerator, LinearProblemArgs...>::
+    kDefaultShadowSpaceDimension;
+
+} // namespace cgmres
+
+
+#endif // MATRIXFREE_IDRS_H
\ No newline at end of file
@@ -0,0 +1,67 @@
+// Minimal residual smoothing of the iterates of the Krylov methods whose 
+// residual norms are not monotone, e.g., MatrixFreeBiCGStab and 
+// MatrixFreeIDRs. This program is written with reference to "L. Zhou and 
+// H. F. Walker, Residual smoothing techniques for iterative methods, SIAM 
+// Journal on Scientific Computing, Vol. 15, No. 2, pp. 297-312 (1994)".
+
+#ifndef MINIMAL_RESIDUAL_SMOOTHING_H
+#define MINIMAL_RESIDUAL_SMOOTHING_H
+
+#include <cmath>
+#include "linear_algebra.hpp"
+
+
+namespace cgmres {
+
+// Computes the smoothed iterates y_k = y_{k-1} + eta_k * (x_k - y_{k-1}), 
+// where x_k is the k-th iterate of a Krylov method and eta_k minimizes the 
+// norm of the smoothed residual s_k = s_{k-1} + eta_k * (r_k - s_{k-1}). The 
+// norm of s_k is non-increasing and the smoothed iterate is never worse 
+// than the initial guess, which is important if the number of the 
+// iterations is fixed as in the C/GMRES method. 
+class MinimalResidualSmoothing {
+public:
+  // Constructs MinimalResidualSmoothing with setting the dimension zero and 
+  // sets nullptr for all vectors.
+  MinimalResidualSmoothing();
+
+  // Constructs MinimalResidualSmoothing and allocates the vectors whose 
+  // dimensions are dim.
+  MinimalResidualSmoothing(const int dim);
+
+  // Free vectors.
+  ~MinimalResidualSmoothing();
+
+  // Reallocates the vectors whose dimensions are dim.
+  void resize(const int dim);
+
+  // Sets the smoothed iterate and residual as solution_vec and residual_vec, 
+  // which are the initial guess and its residual. Returns the residual norm.
+  double initialize(const double* solution_vec, const double* residual_vec);
+
+  // Updates the smoothed iterate and residual by the iterate solution_vec 
+  // and its residual residual_vec. Returns the norm of the smoothed residual. 
+  // An iterate whose residual is not finite is ignored.
+  double update(const double* solution_vec, const double* residual_vec);
+
+  // Returns the smoothed iterate.
+  const double* smoothed_solution_vec() const;
+
+  // Returns the residual of the smoothed iterate.
+  const double* smoothed_residual_vec() const;
+
+  // Prohibits copy due to memory allocation.
+  MinimalResidualSmoothing(const MinimalResidualSmoothing&) = delete;
+  MinimalResidualSmoothing& operator=(const MinimalResidualSmoothing&) 
+      = delete;
+
+private:
+  int dim_;
+  double smoothed_residual_norm_;
+  double *smoothed_solution_vec_, *smoothed_residual_vec_;
+};
+
+} // namespace cgmres
+
+
+#endif // MINIMAL_RESIDUAL_SMOOTHING_H
\ No newline at end of file
@@ -0,0 +1,175 @@
+// Loader of the model plugin, i.e., the shared library that exports the 
+// equations of the model by the C ABI of model_plugin_abi.hpp.
+
+#ifndef MODEL_PLUGIN_H
+#define MODEL_PLUGIN_H
+
+#include <string>
+#include <stdexcept>
+
+
+namespace cgmres {
+namespace modelplugin {
+
+// Functions of the ABI resolved from the plugin.
+struct Functions {
+  void (*state_func)(const double, const double*, const double*, double*);
+  void (*phix_func)(const double, const double*, double*);
+  void (*hx_func)(const double, const double*, const double*, 
+                  const double*, double*);
+  void (*hu_func)(const double, const double*, const double*, 
+                  const double*, double*);
+  void (*state_func_jvp)(const double, const double*, const double*, 
+                         const double*, const double*, double*, double*);
+  void (*phix_func_jvp)(const double, const double*, const double*, 
+                        double*, double*);
+  void (*hx_func_jvp)(const double, const double*, const double*, 
+                      const double*, const double*, const double*, 
+                      const double*, double*, double*);
+  void (*hu_func_jvp)(const double, const double*, const double*, 
+                      const double*, const double*, const double*, 
+                      const double*, double*, double*);
+};
+
+// Stands in for every function of the ABI while no plugin is loaded so that 
+// the forwarders of ModelPlugin need not check is_loaded() on every call.
+template <typename... Args>
+void NotLoaded(Args...) {
+  throw std::runtime_error("The model plugin is not loaded. Call "
+                           "ModelPlugin::load() before the solvers evaluate "
+                           "the model.");
+}
+
+// Opens the plugin at path and resolves its functions into functions. 
+// Returns the handle of the library. Throws std::runtime_error if the 
+// library or any function of the ABI is not found or if the ABI version or 
+// the dimensions do not match.
+void* Open(const std::string& path, const int dim_state, 
+           const int dim_control_input, const int dim_constraints, 
+           Functions& functions);
+
+// Closes the plugin opened by Open().
+void Close(void* handle);
+
+} // namespace modelplugin
+
+
+// Loads the model plugin by dlopen() (LoadLibrary() on Windows) and provides 
+// its functions to Model, i.e., NMPCModel generated with 
+// use_model_plugin=True, which forwards its equations to this class. The 
+// equations of the model can then be changed by rebuilding only the plugin, 
+// and the plugin can be swapped at runtime by calling load() again between 
+// the control updates. The dimensions of the plugin must be equal to those 
+// of Model, which are compile-time constants of the solvers. The functions 
+// are shared by all objects of Model in the process, and load() and unload() 
+// must not be called while the solvers are evaluating the model. Each model 
+// has its own plugin.
+template <class Model>
+class ModelPlugin {
+public:
+  // Loads the plugin from path and replaces the currently loaded plugin. 
+  // Throws std::runtime_error if the library or any function of the ABI is 
+  // not found or if the ABI version or the dimensions do not match. The 
+  // currently loaded plugin is then kept.
+  static void load(const std::string& path) {
+    modelplugin::Functions functions;
+    void* handle = modelplugin::Open(path, Model::dim_state(), 
+                                     Model::dim_control_input(), 
+                                     Model::dim_constraints(), functions);
+    unload();
+    handle_ = handle;
+    functions_ = functions;
+  }
+
+  // Unloads the currently loaded plugin.
+  static void unload() {
+    if (handle_ != nullptr) {
+      modelplugin::Close(handle_);
+      handle_ = nullptr;
+      functions_ = not_loaded_functions_;
+    }
+  }
+
+  // Returns true if a plugin is loaded.
+  static bool is_loaded() {
+    return (handle_ != nullptr);
+  }
+
+  // Compute the equations of the model by the loaded plugin. See 
+  // model_plugin_abi.hpp. Throw std::runtime_error if no plugin is loaded, 
+  // i.e., before load() or after unload().
+  static void stateFunc(const double t, const double* x, const double* u, 
+                        double* dx) {
+    functions_.state_func(t, x, u, dx);
+  }
+
+  static void phixFunc(const double t, const double* x, double* phix) {
+    functions_.phix_func(t, x, phix);
+  }
+
+  static void hxFunc(const double t, const double* x, const double* u, 
+                     const double* lmd, double* hx) {
+    functions_.hx_func(t, x, u, lmd, hx);
+  }
+
+  static void huFunc(const double t, const double* x, const double* u, 
+                     const double* lmd, double* hu) {
+    functions_.hu_func(t, x, u, lmd, hu);
+  }
+
+  static void stateFuncJvp(const double t, const double* x, const double* u, 
+                           const double* x_dir, const double* u_dir, 
+                           double* dx, double* dx_dir) {
+    functions_.state_func_jvp(t, x, u, x_dir, u_dir, dx, dx_dir);
+  }
+
+  static void phixFuncJvp(const double t, const double* x, 
+                          const double* x_dir, double* phix, 
+                          double* phix_dir) {
+    functions_.phix_func_jvp(t, x, x_dir, phix, phix_dir);
+  }
+
+  static void hxFuncJvp(const double t, const double* x, const double* u, 
+                        const double* lmd, const double* x_dir, 
+                        const double* u_dir, const double* lmd_dir, 
+                        double* hx, double* hx_dir) {
+    functions_.hx_func_jvp(t, x, u, lmd, x_dir, u_dir, lmd_dir, hx, hx_dir);
+  }
+
+  static void huFuncJvp(const double t, const double* x, const double* u, 
+                        const double* lmd, const double* x_dir, 
+                        const double* u_dir, const double* lmd_dir, 
+                        double* hu, double* hu_dir) {
+    functions_.hu_func_jvp(t, x, u, lmd, x_dir, u_dir, lmd_dir, hu, hu_dir);
+  }
+
+  ModelPlugin() = delete;
+
+private:
+  // Functions that throw std::runtime_error, which functions_ holds while no 
+  // plugin is loaded.
+  static const modelplugin::Functions not_loaded_functions_;
+
+  static void* handle_;
+  static modelplugin::Functions functions_;
+};
+
+template <class Model>
+const modelplugin::Functions ModelPlugin<Model>::not_loaded_functions_ = {
+    modelplugin::NotLoaded, modelplugin::NotLoaded, modelplugin::NotLoaded, 
+    modelplugin::NotLoaded, modelplugin::NotLoaded, modelplugin::NotLoaded, 
+    modelplugin::NotLoaded, modelplugin::NotLoaded};
+
+template <class Model>
+void* ModelPlugin<Model>::handle_ = nullptr;
+
+template <class Model>
+modelplugin::Functions ModelPlugin<Model>::functions_ = {
+    modelplugin::NotLoaded, modelplugin::NotLoaded, modelplugin::NotLoaded, 
+    modelplugin::NotLoaded, modelplugin::NotLoaded, modelplugin::NotLoaded, 
+    modelplugin::NotLoaded, modelplugin::NotLoaded};
+
+} // namespace cgmres
+
+
+#endif // MODEL_PLUGIN_H
\ No newline at end of file
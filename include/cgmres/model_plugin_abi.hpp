@@ -0,0 +1,66 @@
+// C ABI of the model plugin, i.e., the shared library that exports the 
+// equations of NMPCModel so that the solvers can load them at runtime by 
+// ModelPlugin without being rebuilt. The plugin is generated by AutoGenU with 
+// use_model_plugin=True. 
+
+#ifndef MODEL_PLUGIN_ABI_H
+#define MODEL_PLUGIN_ABI_H
+
+// Version of the ABI. ModelPlugin rejects the plugins of other versions. 
+// Increment this if any of the following declarations is changed.
+#define CGMRES_MODEL_PLUGIN_ABI_VERSION 1
+
+#if defined(_WIN32)
+  #define CGMRES_MODEL_PLUGIN_EXPORT __declspec(dllexport)
+#else
+  #define CGMRES_MODEL_PLUGIN_EXPORT __attribute__((visibility("default")))
+#endif
+
+
+extern "C" {
+
+// Returns CGMRES_MODEL_PLUGIN_ABI_VERSION of the plugin.
+CGMRES_MODEL_PLUGIN_EXPORT int cgmres_model_plugin_abi_version();
+
+// Return the dimensions of the state, the control input, and the equality 
+// constraints of the model.
+CGMRES_MODEL_PLUGIN_EXPORT int cgmres_model_dim_state();
+CGMRES_MODEL_PLUGIN_EXPORT int cgmres_model_dim_control_input();
+CGMRES_MODEL_PLUGIN_EXPORT int cgmres_model_dim_constraints();
+
+// Compute the equations of the model. The arguments are the same as those of 
+// stateFunc(), phixFunc(), hxFunc(), and huFunc() of NMPCModel for double.
+CGMRES_MODEL_PLUGIN_EXPORT void cgmres_model_state_func(
+    const double t, const double* x, const double* u, double* dx);
+CGMRES_MODEL_PLUGIN_EXPORT void cgmres_model_phix_func(
+    const double t, const double* x, double* phix);
+CGMRES_MODEL_PLUGIN_EXPORT void cgmres_model_hx_func(
+    const double t, const double* x, const double* u, const double* lmd, 
+    double* hx);
+CGMRES_MODEL_PLUGIN_EXPORT void cgmres_model_hu_func(
+    const double t, const double* x, const double* u, const double* lmd, 
+    double* hu);
+
+// Compute the equations of the model and their directional derivatives along 
+// the directions suffixed by _dir, which are written into the outputs 
+// suffixed by _dir. These correspond to the instantiations of the equations 
+// of NMPCModel for Dual.
+CGMRES_MODEL_PLUGIN_EXPORT void cgmres_model_state_func_jvp(
+    const double t, const double* x, const double* u, const double* x_dir, 
+    const double* u_dir, double* dx, double* dx_dir);
+CGMRES_MODEL_PLUGIN_EXPORT void cgmres_model_phix_func_jvp(
+    const double t, const double* x, const double* x_dir, double* phix, 
+    double* phix_dir);
+CGMRES_MODEL_PLUGIN_EXPORT void cgmres_model_hx_func_jvp(
+    const double t, const double* x, const double* u, const double* lmd, 
+    const double* x_dir, const double* u_dir, const double* lmd_dir, 
+    double* hx, double* hx_dir);
+CGMRES_MODEL_PLUGIN_EXPORT void cgmres_model_hu_func_jvp(
+    const double t, const double* x, const double* u, const double* lmd, 
+    const double* x_dir, const double* u_dir, const double* lmd_dir, 
+    double* hu, double* hu_dir);
+
+} // extern "C"
+
+
+#endif // MODEL_PLUGIN_ABI_H
\ No newline at end of file
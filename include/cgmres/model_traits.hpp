@@ -0,0 +1,105 @@
+// Detects the optional functions of the models of NMPC, e.g., NMPCModel 
+// generated by AutoGenU, at compile time. The solvers are templates on the 
+// model and use these traits instead of macros so that the models of one 
+// binary may provide different sets of functions.
+
+#ifndef MODEL_TRAITS_H
+#define MODEL_TRAITS_H
+
+#include <type_traits>
+#include <utility>
+
+
+namespace cgmres {
+namespace modeltraits {
+
+// std::true_type if Model provides hamiltonianDerivativesFunc(), i.e., if it 
+// is generated with use_fused_hamiltonian=True, and std::false_type 
+// otherwise.
+template <class Model, class = void>
+struct HasHamiltonianDerivativesFunc : std::false_type {
+};
+
+template <class Model>
+struct HasHamiltonianDerivativesFunc<
+    Model, 
+    decltype(std::declval<const Model&>().hamiltonianDerivativesFunc(
+        0.0, 0.0, std::declval<const double*>(), 
+        std::declval<const double*>(), std::declval<const double*>(), 
+        std::declval<double*>(), std::declval<double*>(), 
+        std::declval<double*>()), void())> : std::true_type {
+};
+
+// std::true_type if Model provides setParameters() and syncParameters(), 
+// i.e., if it is generated with use_runtime_parameters=True, and 
+// std::false_type otherwise.
+template <class Model, class = void>
+struct HasRuntimeParameters : std::false_type {
+};
+
+template <class Model>
+struct HasRuntimeParameters<
+    Model, decltype(std::declval<Model&>().syncParameters(), void())> 
+    : std::true_type {
+};
+
+namespace internal {
+
+template <class Model>
+inline void HamiltonianDerivativesFunc(
+    std::true_type, const Model& model, const double t, const double t_hx, 
+    const double* x, const double* u, const double* lmd, double* dx, 
+    double* hx, double* hu) {
+  model.hamiltonianDerivativesFunc(t, t_hx, x, u, lmd, dx, hx, hu);
+}
+
+template <class Model>
+inline void HamiltonianDerivativesFunc(
+    std::false_type, const Model& model, const double t, const double t_hx, 
+    const double* x, const double* u, const double* lmd, double* dx, 
+    double* hx, double* hu) {
+  model.stateFunc(t, x, u, dx);
+  model.hxFunc(t_hx, x, u, lmd, hx);
+  model.huFunc(t, x, u, lmd, hu);
+}
+
+template <class Model>
+inline void SyncParameters(std::true_type, Model& model) {
+  model.syncParameters();
+}
+
+template <class Model>
+inline void SyncParameters(std::false_type, Model&) {
+}
+
+} // namespace internal
+
+// Computes the state equation and the partial derivatives of the Hamiltonian 
+// with respect to the state and the control input by 
+// Model::hamiltonianDerivativesFunc() if Model provides it, and by 
+// stateFunc(), hxFunc(), and huFunc() otherwise. The solvers call this only 
+// if HasHamiltonianDerivativesFunc<Model> is true; the other case only keeps 
+// their code compilable for the models without it.
+template <class Model>
+inline void HamiltonianDerivativesFunc(const Model& model, const double t, 
+                                       const double t_hx, const double* x, 
+                                       const double* u, const double* lmd, 
+                                       double* dx, double* hx, double* hu) {
+  internal::HamiltonianDerivativesFunc(
+      HasHamiltonianDerivativesFunc<Model>(), model, t, t_hx, x, u, lmd, dx, 
+      hx, hu);
+}
+
+// Copies the parameters set by setParameters() of model into the parameters 
+// read by its equations if Model has the runtime parameters, and does nothing 
+// otherwise.
+template <class Model>
+inline void SyncParameters(Model& model) {
+  internal::SyncParameters(HasRuntimeParameters<Model>(), model);
+}
+
+} // namespace modeltraits
+} // namespace cgmres
+
+
+#endif // MODEL_TRAITS_H
\ No newline at end of file
@@ -11,10 +11,14 @@
 #define MS_CGMRES_WITH_INPUT_SATURATION_H
 
 #include "matrixfree_gmres.hpp"
+#include "matrixfree_bicgstab.hpp"
+#include "matrixfree_idrs.hpp"
 #include "ms_continuation_with_input_saturation.hpp"
 #include "input_saturation_set.hpp"
 #include "ms_cgmres_with_input_saturation_initializer.hpp"
 #include "linear_algebra.hpp"
+#include "aligned_matrix.hpp"
+#include "horizon_storage.hpp"
 
 
 namespace cgmres {
@@ -30,8 +34,27 @@ namespace cgmres {
 // For this initialization, you are required to set parameters by
 // setParametersForInitialization() method and initializeSolution() method. 
 // Without these initialization, all components of the solution is zero.
-class MSCGMRESWithInputSaturation {
+// The matrix-free Krylov method of controlUpdate() is KrylovMethod, which 
+// has the same interface as MatrixFreeGMRES, e.g., MatrixFreeBiCGStab or 
+// MatrixFreeIDRs. MSCGMRESWithInputSaturation is this solver with 
+// ControlUpdateKrylovMethod. 
+// Model is the model of NMPC, e.g., NMPCModel generated by AutoGenU in the 
+// namespace named after the model, so that the solvers of different models 
+// can share one binary. If FixedN is not kDynamicSize, the sequences and the 
+// matrices of the state and the Lagrange multiplier over the horizon are 
+// members of the solver sized by FixedN, which must be equal to N passed to 
+// the constructor, and no memory is allocated for them. Those of the dummy 
+// input and the Lagrange multiplier for the input saturation are allocated 
+// by the constructor since their dimension is given by InputSaturationSet at 
+// runtime, and so are those of the initialization. The block-Jacobi 
+// preconditioner is allocated when it is enabled.
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN = kDynamicSize>
+class BasicMSCGMRESWithInputSaturation {
 public:
+  // The model of NMPC, which the simulator also integrates.
+  using NMPCModel = Model;
+
   // Constructs MultipleShootingCGMRES with setting parameters and allocates 
   // vectors and matrices used in the C/GMRES method. 
   // Arguments:
@@ -46,13 +69,11 @@ public:
   //  kmax: A parameter for the GMRES method. This parameter represents the
   //     dimension of the Krylov subspace and maximum iteration number of the
   //     GMRES method.
-  MSCGMRESWithInputSaturation(const InputSaturationSet& input_saturation_set,
-                              const double T_f, const double alpha, const int N,
-                              const double finite_difference_increment,
-                              const double zeta, const int kmax);
-
-  // Free vectors and matrices.
-  ~MSCGMRESWithInputSaturation();
+  BasicMSCGMRESWithInputSaturation(
+      const InputSaturationSet& input_saturation_set, const double T_f, 
+      const double alpha, const int N, 
+      const double finite_difference_increment, const double zeta, 
+      const int kmax);
 
   // Updates the solution by solving the matrix-free GMRES. The optimal control
   // to be applied to the actual system is assigned in control_input_vec.
@@ -104,27 +125,346 @@ public:
   // and the current solution.
   double getErrorNorm(const double time, const double* state_vec);
 
+  // Sets the parameters of the models of the continuation problem and of the 
+  // initialization, which are used from the next controlUpdate() and 
+  // initializeSolution(), respectively. This can be called from any thread, 
+  // also during controlUpdate(), which never waits for it. See 
+  // Model::setParameters().
+  template <class Parameters>
+  void setParameters(const Parameters& parameters);
+
+  // Sets the tolerances of the residual of the GMRES method. The GMRES 
+  // iteration in controlUpdate() terminates as soon as the residual norm is 
+  // less than or equal to max(absolute_tolerance, 
+  // relative_tolerance*(the initial residual norm)). If both of the 
+  // tolerances are zero (default), kmax iterations are always performed.
+  void setGMRESTolerance(const double absolute_tolerance, 
+                         const double relative_tolerance);
+
+  // Sets the maximum number of the restarts of the GMRES method. The GMRES 
+  // method with the kmax-dimensional Krylov subspace is restarted at most 
+  // max_restarts times in controlUpdate() while the residual does not satisfy
+  // the tolerances set by setGMRESTolerance(). The default is zero.
+  void setMaxGMRESRestarts(const int max_restarts);
+
+  // Enables the block-Jacobi preconditioner of the GMRES method. The blocks, 
+  // i.e., the Jacobians of the optimality residual of each stage with respect 
+  // to the control input and the constraints of the stage, are recomputed 
+  // every update_period calls of controlUpdate(). If update_period is zero 
+  // (default), the preconditioner is not used.
+  void setBlockJacobiPreconditioner(const int update_period);
+
+  // Sets whether the Jacobian-vector products in the GMRES method of 
+  // controlUpdate() and of the initialization are computed exactly by the 
+  // forward-mode automatic differentiation, i.e., by the functions of 
+  // Model instantiated with the dual numbers, instead of the forward 
+  // difference approximation with finite_difference_increment. This removes 
+  // the truncation error of the products, which may reduce the GMRES 
+  // iterations needed for a given accuracy. The default is false.
+  void setExactJacobianVectorProduct(const bool exact_jacobian_vector_product);
+
+  // Sets the number of the threads that evaluate the stages of the horizon, 
+  // i.e., the state equation and the partial derivatives of the Hamiltonian 
+  // of each stage, in parallel in controlUpdate(). The threads are used only 
+  // if N is greater than or equal to min_N because their synchronization 
+  // does not pay for short horizons. The threads are created in this 
+  // function and persist until the destruction of the solver. The solution 
+  // is the same as that of the serial evaluation. The recursions of the state 
+  // and lambda of the condensing are always serial. num_threads is clamped to 
+  // the number of the hardware threads. The default is one thread.
+  void setNumThreads(const int num_threads, const int min_N);
+
+  // Sets the pool that evaluates the stages of the horizon instead of the 
+  // threads of setNumThreads(), so that the solvers of several models in one 
+  // process share the threads, e.g., 
+  //   cgmres::StageThreadPool thread_pool;
+  //   thread_pool.setNumThreads(4);
+  //   solver1.setThreadPool(thread_pool, 50);
+  //   solver2.setThreadPool(thread_pool, 50);
+  // The solvers sharing thread_pool must call controlUpdate() one after 
+  // another, and the number of the threads of thread_pool must not be changed 
+  // while it is shared. See MultipleShootingOCP::setThreadPool().
+  void setThreadPool(StageThreadPool& thread_pool, const int min_N);
+
+  // Returns the number of the GMRES iterations in the latest controlUpdate().
+  int getGMRESIterations() const;
+
+  // Returns the residual norm of the GMRES method in the latest 
+  // controlUpdate().
+  double getGMRESResidualNorm() const;
+
   // Prohibits copy due to memory allocation.
-  MSCGMRESWithInputSaturation(const MSCGMRESWithInputSaturation&) = delete;
-  MSCGMRESWithInputSaturation& operator=(const MSCGMRESWithInputSaturation&) 
-      = delete;
+  BasicMSCGMRESWithInputSaturation(
+      const BasicMSCGMRESWithInputSaturation&) = delete;
+  BasicMSCGMRESWithInputSaturation& operator=(
+      const BasicMSCGMRESWithInputSaturation&) = delete;
 
 private:
-  MSContinuationWithInputSaturation continuation_problem_;
-  MatrixFreeGMRES<MSContinuationWithInputSaturation, const double, const double*, 
-                  const double*, double const* const*, double const* const*, 
-                  double const* const*, double const* const*> mfgmres_;
-  MSCGMRESWithInputSaturationInitializer solution_initializer_;
+  MSContinuationWithInputSaturation<Model, FixedN> continuation_problem_;
+  KrylovMethod<MSContinuationWithInputSaturation<Model, FixedN>, const double, 
+               const double*, const double*, const AlignedMatrix&, 
+               const AlignedMatrix&, const AlignedMatrix&, 
+               const AlignedMatrix&> mfgmres_;
+  MSCGMRESWithInputSaturationInitializer<Model> solution_initializer_;
   const int dim_state_, dim_control_input_, dim_constraints_, dim_saturation_,
             N_;
-  double *control_input_and_constraints_seq_, 
-         *control_input_and_constraints_update_seq_, 
-         *initial_control_input_and_constraints_vec_, *initial_lambda_vec_,
-         *initial_dummy_input_vec_, *initial_input_saturation_vec_;
-  double **state_mat_, **lambda_mat_, **dummy_input_mat_,
-         **input_saturation_multiplier_mat_;
+  HorizonArray<double, HorizonSize(FixedN, Model::dim_control_input()
+                                               +Model::dim_constraints())> 
+      control_input_and_constraints_seq_, 
+      control_input_and_constraints_update_seq_;
+  double initial_control_input_and_constraints_vec_[
+      Model::dim_control_input()+Model::dim_constraints()];
+  double initial_lambda_vec_[Model::dim_state()];
+  HorizonArray<double, kDynamicSize> initial_dummy_input_vec_, 
+      initial_input_saturation_vec_;
+  HorizonMatrix<FixedN, Model::dim_state()> state_mat_, lambda_mat_;
+  AlignedMatrix dummy_input_mat_, input_saturation_multiplier_mat_;
+  BlockJacobiPreconditioner preconditioner_;
+  int preconditioner_update_period_, num_updates_from_preconditioning_;
 };
 
+// The solver with the GMRES method selected by ControlUpdateKrylovMethod, 
+// e.g., MSCGMRESWithInputSaturation<NMPCModel> whose N and kmax are given to 
+// the constructor, or MSCGMRESWithInputSaturation<NMPCModel, 50, 10> whose 
+// sequences over the horizon and the Krylov subspace are sized by N = 50 and 
+// kmax = 10 at compile time. 
+template <class Model, int FixedN = kDynamicSize, 
+          int FixedKmax = kDynamicSize>
+using MSCGMRESWithInputSaturation = BasicMSCGMRESWithInputSaturation<
+    Model, 
+    ControlUpdateKrylovMethod<
+        FixedKmax, HorizonSize(FixedN, Model::dim_control_input()
+                                           +Model::dim_constraints())>::
+        template Method, 
+    FixedN>;
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+BasicMSCGMRESWithInputSaturation(
+    const InputSaturationSet& input_saturation_set, const double T_f, 
+    const double alpha, const int N, const double finite_difference_increment, 
+    const double zeta, const int kmax)
+  : continuation_problem_(input_saturation_set, T_f, alpha, N, 
+                        finite_difference_increment, zeta),
+    mfgmres_(continuation_problem_.dim_condensed_problem(), kmax),
+    solution_initializer_(input_saturation_set, finite_difference_increment, 
+                          kmax),
+    dim_state_(continuation_problem_.dim_state()),
+    dim_control_input_(continuation_problem_.dim_control_input()),
+    dim_constraints_(continuation_problem_.dim_constraints()),
+    dim_saturation_(continuation_problem_.dim_saturation()),
+    N_(N),
+    control_input_and_constraints_seq_(
+        N*(dim_control_input_+dim_constraints_)),
+    control_input_and_constraints_update_seq_(
+        N*(dim_control_input_+dim_constraints_)),
+    initial_control_input_and_constraints_vec_(),
+    initial_lambda_vec_(),
+    initial_dummy_input_vec_(dim_saturation_),
+    initial_input_saturation_vec_(dim_saturation_),
+    state_mat_(N, dim_state_),
+    lambda_mat_(N, dim_state_),
+    dummy_input_mat_(N, dim_saturation_),
+    input_saturation_multiplier_mat_(N, dim_saturation_),
+    preconditioner_(N, dim_control_input_+dim_constraints_),
+    preconditioner_update_period_(0),
+    num_updates_from_preconditioning_(0) {
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+controlUpdate(
+    const double time, const double* state_vec, const double sampling_period, 
+    double* control_input_vec) {
+  continuation_problem_.syncParameters();
+  if (preconditioner_update_period_ > 0) {
+    if (num_updates_from_preconditioning_ == 0) {
+      continuation_problem_.computeBlockJacobiPreconditioner(
+          time, state_vec, control_input_and_constraints_seq_, state_mat_, 
+          lambda_mat_, input_saturation_multiplier_mat_, preconditioner_);
+    }
+    num_updates_from_preconditioning_ = (num_updates_from_preconditioning_+1) 
+                                        % preconditioner_update_period_;
+    mfgmres_.solveLinearProblem(preconditioner_, continuation_problem_, time, 
+                                state_vec, control_input_and_constraints_seq_, 
+                                state_mat_, lambda_mat_, dummy_input_mat_, 
+                                input_saturation_multiplier_mat_,
+                                control_input_and_constraints_update_seq_);
+  }
+  else {
+    mfgmres_.solveLinearProblem(continuation_problem_, time, state_vec, 
+                                control_input_and_constraints_seq_, 
+                                state_mat_, lambda_mat_, dummy_input_mat_, 
+                                input_saturation_multiplier_mat_,
+                                control_input_and_constraints_update_seq_);
+  }
+  continuation_problem_.integrateSolution(
+      control_input_and_constraints_seq_, state_mat_, lambda_mat_, 
+      dummy_input_mat_, input_saturation_multiplier_mat_,
+      control_input_and_constraints_update_seq_, sampling_period);
+  getControlInput(control_input_vec);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+getControlInput(double* control_input_vec) const {
+  for (int i=0; i<dim_control_input_; ++i) {
+    control_input_vec[i] = control_input_and_constraints_seq_[i];
+  }
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+setParametersForInitialization(const double* initial_guess_solution, 
+                               const double newton_residual_tolerance, 
+                               const int max_newton_iteration) {
+  solution_initializer_.setInitialGuessSolution(initial_guess_solution);
+  solution_initializer_.setCriterionsOfNewtonTermination(
+    newton_residual_tolerance, max_newton_iteration);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+setInitialInputSaturationMultiplier(
+    const double initial_input_saturation_multiplier) {
+  solution_initializer_.setInitialInputSaturationMultiplier(
+      initial_input_saturation_multiplier);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+setInitialInputSaturationMultiplier(
+    const double* initial_input_saturation_multiplier) {
+  solution_initializer_.setInitialInputSaturationMultiplier(
+      initial_input_saturation_multiplier);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+initializeSolution(const double initial_time, const double* initial_state_vec) {
+  continuation_problem_.syncParameters();
+  solution_initializer_.computeInitialSolution(
+      initial_time, initial_state_vec, 
+      initial_control_input_and_constraints_vec_, initial_dummy_input_vec_, 
+      initial_input_saturation_vec_);
+  solution_initializer_.getInitialLambda(initial_time, initial_state_vec, 
+                                         initial_lambda_vec_);
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_control_input_+dim_constraints_; ++j) {
+      control_input_and_constraints_seq_[i*(dim_control_input_+dim_constraints_)+j] 
+          = initial_control_input_and_constraints_vec_[j];
+    }
+  }
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_state_; ++j) {
+      state_mat_[i][j] = initial_state_vec[j];
+    }
+  }
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_state_; ++j) {
+      lambda_mat_[i][j] = initial_lambda_vec_[j];
+    }
+  }
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_saturation_; ++j) {
+      dummy_input_mat_[i][j] = initial_dummy_input_vec_[j];
+    }
+  }
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_saturation_; ++j) {
+      input_saturation_multiplier_mat_[i][j] = initial_input_saturation_vec_[j];
+    }
+  }
+  continuation_problem_.resetHorizonLength(initial_time);
+  num_updates_from_preconditioning_ = 0;
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+double BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+getErrorNorm(const double time, const double* state_vec) {
+  return continuation_problem_.computeErrorNorm(
+      time, state_vec, control_input_and_constraints_seq_, state_mat_,
+      lambda_mat_, dummy_input_mat_, input_saturation_multiplier_mat_);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+template <class Parameters>
+void BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+setParameters(const Parameters& parameters) {
+  continuation_problem_.setParameters(parameters);
+  solution_initializer_.setParameters(parameters);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+setGMRESTolerance(
+    const double absolute_tolerance, const double relative_tolerance) {
+  mfgmres_.setTolerance(absolute_tolerance, relative_tolerance);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+setMaxGMRESRestarts(const int max_restarts) {
+  mfgmres_.setMaxRestarts(max_restarts);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+setBlockJacobiPreconditioner(const int update_period) {
+  preconditioner_update_period_ = update_period;
+  num_updates_from_preconditioning_ = 0;
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+setExactJacobianVectorProduct(const bool exact_jacobian_vector_product) {
+  continuation_problem_.setExactJacobianVectorProduct(
+      exact_jacobian_vector_product);
+  solution_initializer_.setExactJacobianVectorProduct(
+      exact_jacobian_vector_product);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+setNumThreads(const int num_threads, const int min_N) {
+  continuation_problem_.setNumThreads(num_threads, min_N);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+setThreadPool(StageThreadPool& thread_pool, const int min_N) {
+  continuation_problem_.setThreadPool(thread_pool, min_N);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+int BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+getGMRESIterations() const {
+  return mfgmres_.num_iterations();
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+double BasicMSCGMRESWithInputSaturation<Model, KrylovMethod, FixedN>::
+getGMRESResidualNorm() const {
+  return mfgmres_.residual_norm();
+}
+
 } // namespace cgmres
 
 
@@ -22,6 +22,7 @@ namespace cgmres {
 // whose length is zero by Newton GMRES method. Before using 
 // computeInitialSolution() method, you have to set initial guess solution by 
 // setInitialGuessSolution().
+template <class Model>
 class MSCGMRESWithInputSaturationInitializer {
 public:
   // Sets parameters and allocates vectors. 
@@ -91,6 +92,18 @@ public:
                               double* initial_dummy_input_vec,
                               double* initial_input_saturation_vec);
 
+  // Sets whether the Newton GMRES method computes the products of the 
+  // Jacobian of the optimality residual and the directions exactly by the 
+  // forward-mode automatic differentiation instead of the forward difference 
+  // approximation. The default is false.
+  void setExactJacobianVectorProduct(const bool exact_jacobian_vector_product);
+
+  // Sets the parameters of the model of the Newton GMRES method, which are 
+  // used from the next computeInitialSolution(). See 
+  // OptimalControlProblem::setParameters().
+  template <class Parameters>
+  void setParameters(const Parameters& parameters);
+
   // Computes the initial lambda, which is the Lagrange multiplier of the state 
   // equation. This corresponds to the partial derivative of the terminal cost
   // with respect to the state.
@@ -103,9 +116,9 @@ public:
   int dim_solution() const;
 
 private:
-  NewtonGMRESForOCP<ZeroHorizonOCPWithInputSaturation, 
+  NewtonGMRESForOCP<ZeroHorizonOCPWithInputSaturation<Model>, 
                     InputSaturationSet> newton_;
-  MatrixFreeGMRES<NewtonGMRESForOCP<ZeroHorizonOCPWithInputSaturation, 
+  MatrixFreeGMRES<NewtonGMRESForOCP<ZeroHorizonOCPWithInputSaturation<Model>, 
                                     InputSaturationSet>, 
                   const double, const double*, const double*> mfgmres_;
   InputSaturationSet input_saturation_set_;
@@ -122,6 +135,181 @@ private:
                            const double max_input) const;
 };
 
+template <class Model>
+MSCGMRESWithInputSaturationInitializer<Model>::
+MSCGMRESWithInputSaturationInitializer(
+    const InputSaturationSet& input_saturation_set,
+    const double finite_difference_increment, const int kmax, 
+    const double newton_residual_tolerance, const int max_newton_iteration)
+  : newton_(finite_difference_increment, input_saturation_set),
+    mfgmres_(newton_.dim_solution(), kmax),
+    input_saturation_set_(input_saturation_set),
+    dim_control_input_(newton_.dim_control_input()),
+    dim_constraints_(newton_.dim_constraints()),
+    dim_input_saturation_(input_saturation_set.dim_saturation()),
+    dim_solution_(newton_.dim_solution()),
+    max_newton_iteration_(max_newton_iteration),
+    newton_residual_tolerance_(newton_residual_tolerance),
+    initial_guess_solution_vec_(linearalgebra::NewVector(dim_solution_)),
+    initial_solution_vec_(linearalgebra::NewVector(dim_solution_)),
+    solution_update_vec_(linearalgebra::NewVector(dim_solution_)) {
+}
+
+template <class Model>
+MSCGMRESWithInputSaturationInitializer<Model>::
+MSCGMRESWithInputSaturationInitializer(
+    const InputSaturationSet& input_saturation_set,
+    const double finite_difference_increment, const int kmax)
+  : newton_(finite_difference_increment, input_saturation_set),
+    mfgmres_(newton_.dim_solution(), kmax),
+    input_saturation_set_(input_saturation_set),
+    dim_control_input_(newton_.dim_control_input()),
+    dim_constraints_(newton_.dim_constraints()),
+    dim_input_saturation_(input_saturation_set.dim_saturation()),
+    dim_solution_(newton_.dim_solution()),
+    max_newton_iteration_(50),
+    newton_residual_tolerance_(1e-08),
+    initial_guess_solution_vec_(linearalgebra::NewVector(dim_solution_)),
+    initial_solution_vec_(linearalgebra::NewVector(dim_solution_)),
+    solution_update_vec_(linearalgebra::NewVector(dim_solution_)) {
+}
+
+template <class Model>
+MSCGMRESWithInputSaturationInitializer<Model>::
+~MSCGMRESWithInputSaturationInitializer() {
+  linearalgebra::DeleteVector(initial_guess_solution_vec_);
+  linearalgebra::DeleteVector(initial_solution_vec_);
+  linearalgebra::DeleteVector(solution_update_vec_);
+}
+
+template <class Model>
+void MSCGMRESWithInputSaturationInitializer<Model>::
+setCriterionsOfNewtonTermination(const double newton_residual_tolerance, 
+                                 const int max_newton_iteration) {
+  newton_residual_tolerance_ = newton_residual_tolerance;
+  max_newton_iteration_ = max_newton_iteration;
+}
+
+template <class Model>
+void MSCGMRESWithInputSaturationInitializer<Model>::setInitialGuessSolution(
+    const double* initial_guess_control_input_and_constraints) {
+  for (int i=0; i<dim_control_input_+dim_constraints_; ++i) {
+    initial_guess_solution_vec_[i] 
+        = initial_guess_control_input_and_constraints[i];
+  }
+  for (int i=0; i<dim_input_saturation_; ++i) {
+    initial_guess_solution_vec_[dim_control_input_+dim_constraints_+i]
+        = computeDummyInput(
+            initial_guess_control_input_and_constraints[
+                  input_saturation_set_.index(i)], 
+            input_saturation_set_.min(i), input_saturation_set_.max(i));
+  }
+  for (int i=0; i<dim_input_saturation_; ++i) {
+    initial_guess_solution_vec_[dim_control_input_+dim_constraints_
+                                +dim_input_saturation_+i]
+        = 0.001;
+  }
+}
+
+template <class Model>
+void MSCGMRESWithInputSaturationInitializer<Model>::
+setInitialInputSaturationMultiplier(
+    const double initial_input_saturation_multiplier) {
+  for (int i=0; i<input_saturation_set_.dim_saturation(); ++i) {
+    initial_guess_solution_vec_[dim_control_input_+dim_constraints_
+                                +dim_input_saturation_+i]
+        = initial_input_saturation_multiplier;
+  }
+} 
+
+template <class Model>
+void MSCGMRESWithInputSaturationInitializer<Model>::
+setInitialInputSaturationMultiplier(
+    const double* initial_input_saturation_multiplier) {
+  for (int i=0; i<input_saturation_set_.dim_saturation(); ++i) {
+    initial_guess_solution_vec_[dim_control_input_+dim_constraints_
+                                +dim_input_saturation_+i]
+        = initial_input_saturation_multiplier[i];
+  }
+} 
+
+template <class Model>
+void MSCGMRESWithInputSaturationInitializer<Model>::computeInitialSolution(
+    const double initial_time, const double* initial_state_vec, 
+    double* initial_control_input_and_constraints_vec, 
+    double* initial_dummy_input_vec, double* initial_input_saturation_vec) {
+  newton_.syncParameters();
+  for (int i=0; i<dim_solution_; ++i) {
+    initial_solution_vec_[i] = initial_guess_solution_vec_[i];
+  }
+  int num_itr = 0;
+  double optimality_error = newton_.errorNorm(initial_time, initial_state_vec, 
+                                              initial_solution_vec_);
+  while (optimality_error > newton_residual_tolerance_ 
+         && num_itr < max_newton_iteration_) {
+    mfgmres_.solveLinearProblem(newton_, initial_time, initial_state_vec, 
+                                initial_solution_vec_, solution_update_vec_);
+    for (int i=0; i<dim_solution_; ++i) {
+      initial_solution_vec_[i] += solution_update_vec_[i];
+    }
+    optimality_error = newton_.errorNorm(initial_time, initial_state_vec, 
+                                         initial_solution_vec_);
+    ++num_itr;
+  }
+  for (int i=0; i<dim_control_input_+dim_constraints_; ++i) {
+    initial_control_input_and_constraints_vec[i] = initial_solution_vec_[i];
+  }
+  for (int i=0; i<dim_input_saturation_; ++i) {
+    initial_dummy_input_vec[i] 
+        = initial_solution_vec_[dim_control_input_+dim_constraints_+i];
+  }
+  for (int i=0; i<dim_input_saturation_; ++i) {
+    initial_input_saturation_vec[i] 
+        = initial_solution_vec_[dim_control_input_+dim_constraints_+dim_input_saturation_+i];
+  }
+}
+
+template <class Model>
+void MSCGMRESWithInputSaturationInitializer<Model>::
+setExactJacobianVectorProduct(const bool exact_jacobian_vector_product) {
+  newton_.setExactJacobianVectorProduct(exact_jacobian_vector_product);
+}
+
+template <class Model>
+template <class Parameters>
+void MSCGMRESWithInputSaturationInitializer<Model>::setParameters(
+    const Parameters& parameters) {
+  newton_.setParameters(parameters);
+}
+
+template <class Model>
+void MSCGMRESWithInputSaturationInitializer<Model>::getInitialLambda(
+    const double initial_time, const double* initial_state_vec, 
+    double* initial_lambda_vec) {
+  newton_.getTerminalCostDerivatives(initial_time, initial_state_vec, 
+                                     initial_lambda_vec);
+}
+
+template <class Model>
+int MSCGMRESWithInputSaturationInitializer<Model>::dim_solution() const {
+  return dim_solution_;
+}
+
+template <class Model>
+double MSCGMRESWithInputSaturationInitializer<Model>::computeDummyInput(
+    const double input, const double min_input, const double max_input) const {
+  if (min_input < input && input < max_input) {
+    double max_plus_min = max_input + min_input;
+    double max_minus_min = max_input - min_input;
+    return std::sqrt(
+        (max_minus_min*max_minus_min)/4
+            -(input-max_plus_min/2)*(input-max_plus_min/2));
+  }
+  else {
+    return (min_input+max_input) / 2;
+  }
+}
+
 } // namespace cgmres
 
 
@@ -10,6 +10,10 @@
 #include "optimal_control_problem.hpp"
 #include "time_varying_smooth_horizon.hpp"
 #include "linear_algebra.hpp"
+#include "aligned_matrix.hpp"
+#include "horizon_storage.hpp"
+#include "dual_number.hpp"
+#include "stage_thread_pool.hpp"
 
 
 namespace cgmres {
@@ -17,7 +21,8 @@ namespace cgmres {
 // This class provides multiple-shooting two-point boundary-value problem of 
 // the finite-horizon optimal control problem. Functions for condensing of the 
 // solution are also provided.
-class MSOCPWithInputSaturation final : public OptimalControlProblem {
+template <class Model, int FixedN = kDynamicSize>
+class MSOCPWithInputSaturation final : public OptimalControlProblem<Model> {
 public:
   // Constructs MSOCPWithInputSaturation with setting parameters and allocates 
   // vectors and matrices.
@@ -41,9 +46,6 @@ public:
                            const double T_f, const double alpha, const int N,
                            const double initial_time);
 
-  // Free vectors and matrices.
-  ~MSOCPWithInputSaturation();
-
   // Computes the optimaliy residual with respect to the control input and the 
   // equality constraints under time, state_vec, and solution_vec 
   // that represents the control input sequence. The result is stored in 
@@ -51,8 +53,8 @@ public:
   void computeOptimalityResidualForControlInputAndConstraints(
       const double time, const double* state_vec, 
       const double* control_input_and_constraints_seq, 
-      double const* const* state_mat, double const* const* lambda_mat, 
-      double const* const* input_saturation_multiplier_mat,
+      const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+      const AlignedMatrix& input_saturation_multiplier_mat,
       double* optimality_redisual_for_control_input_and_constraints);
 
   // Computes the optimaliy residual with respect to the state and lambda,
@@ -63,9 +65,27 @@ public:
   void computeOptimalityResidualForStateAndLambda(
       const double time, const double* state_vec, 
       const double* control_input_and_constraints_seq, 
-      double const* const* state_mat, double const* const* lambda_mat, 
-      double** optimality_residual_for_state, 
-      double** optimality_residual_for_lambda);
+      const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+      AlignedMatrix& optimality_residual_for_state, 
+      AlignedMatrix& optimality_residual_for_lambda);
+
+  // Computes the optimality residuals with respect to the control input and 
+  // the equality constraints, the state, and lambda at once. The results are 
+  // the same as those of 
+  // computeOptimalityResidualForControlInputAndConstraints() and 
+  // computeOptimalityResidualForStateAndLambda(), but the horizon is swept 
+  // only once forward and once backward. If Model provides 
+  // hamiltonianDerivativesFunc(), the state equation and the partial 
+  // derivatives of the Hamiltonian of each stage are computed by one call of 
+  // it in one sweep.
+  void computeOptimalityResidual(
+      const double time, const double* state_vec, 
+      const double* control_input_and_constraints_seq, 
+      const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+      const AlignedMatrix& input_saturation_multiplier_mat,
+      double* optimality_residual_for_control_input_and_constraints, 
+      AlignedMatrix& optimality_residual_for_state, 
+      AlignedMatrix& optimality_residual_for_lambda);
 
   // Computes the state and lambda, the Lagrange multiplier with respect to 
   // the state equation from the optimality residual with respect to the state 
@@ -74,9 +94,51 @@ public:
   void computeStateAndLambdaFromOptimalityResidual(
       const double time, const double* state_vec, 
       const double* control_input_and_constraints_seq, 
-      double const* const* optimality_residual_for_state,
-      double const* const* optimality_residual_for_lambda,
-      double** state_mat, double** lambda_mat);
+      const AlignedMatrix& optimality_residual_for_state,
+      const AlignedMatrix& optimality_residual_for_lambda,
+      AlignedMatrix& state_mat, AlignedMatrix& lambda_mat);
+
+  // Computes the state and lambda from the optimality residuals with respect 
+  // to the state and lambda as computeStateAndLambdaFromOptimalityResidual() 
+  // and the optimality residual with respect to the control input and the 
+  // equality constraints under them as 
+  // computeOptimalityResidualForControlInputAndConstraints(). The 
+  // Lagrange multiplier with respect to the saturation is 
+  // input_saturation_multiplier_mat. The latter 
+  // of each stage is computed in the backward sweep as soon as lambda of the 
+  // stage is obtained, so that the horizon is swept only once forward and 
+  // once backward. The results are the same as those of the separate 
+  // functions.
+  void computeCondensedOptimalityResidual(
+      const double time, const double* state_vec, 
+      const double* control_input_and_constraints_seq, 
+      const AlignedMatrix& optimality_residual_for_state,
+      const AlignedMatrix& optimality_residual_for_lambda,
+      const AlignedMatrix& input_saturation_multiplier_mat,
+      AlignedMatrix& state_mat, AlignedMatrix& lambda_mat, 
+      double* optimality_residual_for_control_input_and_constraints);
+
+  // Computes the directional derivative of the condensed optimality residual 
+  // with respect to the control input and the equality constraints along 
+  // direction_vec. The condensed optimality residual is the optimality 
+  // residual with respect to the control input and the constraints under the 
+  // state and lambda given by computeStateAndLambdaFromOptimalityResidual() 
+  // from control_input_and_constraints_seq, optimality_residual_for_state, 
+  // and optimality_residual_for_lambda. The Lagrange multiplier with respect 
+  // to the saturation is input_saturation_multiplier_mat and its derivative 
+  // along direction_vec is input_saturation_multiplier_derivative_mat. The 
+  // derivative is computed exactly by the forward-mode automatic 
+  // differentiation, i.e., by computing the condensed optimality residual 
+  // with the dual numbers. The result is stored in 
+  // optimality_residual_derivative.
+  void computeCondensedOptimalityResidualDirectionalDerivative(
+      const double time, const double* state_vec, 
+      const double* control_input_and_constraints_seq, 
+      const AlignedMatrix& optimality_residual_for_state,
+      const AlignedMatrix& optimality_residual_for_lambda,
+      const AlignedMatrix& input_saturation_multiplier_mat,
+      const AlignedMatrix& input_saturation_multiplier_derivative_mat,
+      const double* direction_vec, double* optimality_residual_derivative);
 
   // Computes optimality residual for dummy input and constraints
   // on the saturation functions for the contorl input. 
@@ -84,10 +146,10 @@ public:
   // optimality_residual_for_input_saturation
   void computeResidualForDummyInputAndInputSaturation(
       const double* control_input_and_constraints_seq, 
-      double const* const* dummy_input_mat, 
-      double const* const* input_saturation_multiplier_mat, 
-      double** optimality_residual_for_dummy_input, 
-      double** optimality_residual_for_input_saturation);
+      const AlignedMatrix& dummy_input_mat, 
+      const AlignedMatrix& input_saturation_multiplier_mat, 
+      AlignedMatrix& optimality_residual_for_dummy_input, 
+      AlignedMatrix& optimality_residual_for_input_saturation);
 
   // Computes the invers of the matrix of optimality residual for dummy input
   // and constraints on the saturation functions for the control input,
@@ -98,12 +160,12 @@ public:
   // resulted_Lagrange_multiplier_mat.
   void multiplyResidualForDummyInputAndInputSaturationInverse(
       const double* control_input_and_constraints_seq, 
-      double const* const* dummy_input_mat, 
-      double const* const* saturation_Lagrange_multiplier_mat, 
-      double const* const* multiplied_dummy_input_mat, 
-      double const* const* multiplied_Lagrange_multiplier_mat, 
-      double** resulted_dummy_input_mat, 
-      double** resulted_Lagrange_multiplier_mat);
+      const AlignedMatrix& dummy_input_mat, 
+      const AlignedMatrix& saturation_Lagrange_multiplier_mat, 
+      const AlignedMatrix& multiplied_dummy_input_mat, 
+      const AlignedMatrix& multiplied_Lagrange_multiplier_mat, 
+      AlignedMatrix& resulted_dummy_input_mat, 
+      AlignedMatrix& resulted_Lagrange_multiplier_mat);
 
   // Computes the difference value of the dummy input corresponding to the
   // difference in the control input and Lagrange multiplier with respect to
@@ -112,9 +174,9 @@ public:
   // assigned in dummy_residual_difference_mat.
   void computeResidualDifferenceForDummyInput(
       const double* control_input_and_constraints_seq, 
-      double const* const* dummy_input_mat, 
+      const AlignedMatrix& dummy_input_mat, 
       const double* control_input_and_constraints_update_seq, 
-      double** dummy_residual_difference_mat);
+      AlignedMatrix& dummy_residual_difference_mat);
 
   // Computes the difference value of the Lagrange multipliers with respect to
   // the constraints on the condensed saturation functions of the control
@@ -125,10 +187,10 @@ public:
   // input_saturation_residual_difference_mat.
   void computeResidualDifferenceForInputSaturation(
       const double* control_input_and_constraints_seq, 
-      double const* const* dummy_input_mat, 
-      double const* const* input_saturation_multiplier_mat, 
+      const AlignedMatrix& dummy_input_mat, 
+      const AlignedMatrix& input_saturation_multiplier_mat, 
       const double* control_input_and_constraints_update_seq, 
-      double** input_saturation_residual_difference_mat);
+      AlignedMatrix& input_saturation_residual_difference_mat);
 
   // Predicts the state in the finite future. Under time,state_vec, and 
   // solution_vec that represents the control input sequence., and 
@@ -139,6 +201,31 @@ public:
                                 const double prediction_length,
                                 double* predicted_state);
 
+  // Sets the number of the threads that evaluate the stages of the horizon 
+  // in parallel in computeOptimalityResidual(), 
+  // computeOptimalityResidualForControlInputAndConstraints(), 
+  // computeOptimalityResidualForStateAndLambda(), and 
+  // computeCondensedOptimalityResidual(). The threads are used only if N is 
+  // greater than or equal to min_N because the synchronization of the threads 
+  // does not pay for short horizons. The threads are created here and persist 
+  // until the next call or the destruction. The results are the same as 
+  // those of the serial evaluation. The recursions of the state and lambda 
+  // in computeStateAndLambdaFromOptimalityResidual() and 
+  // computeCondensedOptimalityResidualDirectionalDerivative() are always 
+  // serial. The default is one thread.
+  void setNumThreads(const int num_threads, const int min_N);
+
+  // Sets the pool whose threads evaluate the stages of the horizon as 
+  // setNumThreads() instead of the threads owned by this object, so that 
+  // the solvers of several models can share one pool. thread_pool is used 
+  // only if N is greater than or equal to min_N. Its number of the threads 
+  // must be set before this call and must not be changed while it is 
+  // shared. Since StageThreadPool::parallelFor() must not be called 
+  // concurrently, the solvers sharing thread_pool must be updated one after 
+  // another, e.g., in one control loop. thread_pool must outlive this 
+  // object or be replaced by the next call of setNumThreads().
+  void setThreadPool(StageThreadPool& thread_pool, const int min_N);
+
   // Reset the length of the horizon by resetting parameters related to the 
   // horizon.
   void resetHorizonLength(const double initial_time);
@@ -159,12 +246,805 @@ public:
   int N() const;
 
 private:
+  using OptimalControlProblem<Model>::model_;
+  using OptimalControlProblem<Model>::dim_state_;
+  using OptimalControlProblem<Model>::dim_control_input_;
+  using OptimalControlProblem<Model>::dim_constraints_;
+  using OptimalControlProblem<Model>::dim_control_input_and_constraints_;
+
   TimeVaryingSmoothHorizon horizon_;
   InputSaturationSet input_saturation_set_;
   int dim_solution_, dim_saturation_, N_;
-  double *dx_vec_;
+  // The work vectors of a stage are sized by the compile-time dimensions of 
+  // Model.
+  double dx_vec_[dim_state_], hx_vec_[dim_state_];
+  // The sequences over the horizon are sized by FixedN if it is fixed.
+  HorizonArray<double, HorizonSize(FixedN, 1, 1)> tau_vec_;
+  HorizonArray<double, HorizonSize(FixedN, 1)> backward_tau_vec_;
+  HorizonArray<Dual, HorizonSize(FixedN, dim_control_input_and_constraints_)> 
+      dual_control_input_and_constraints_seq_;
+  Dual dual_state_vec_[dim_state_];
+  HorizonArray<Dual, HorizonSize(FixedN, dim_state_)> dual_state_mat_, 
+      dual_lambda_mat_;
+  Dual dual_dx_vec_[dim_state_], 
+      dual_hu_vec_[dim_control_input_and_constraints_];
+  // The dimension of the input saturation is given at runtime.
+  HorizonArray<Dual, kDynamicSize> dual_input_saturation_multiplier_vec_;
+  StageThreadPool own_thread_pool_;
+  StageThreadPool* thread_pool_;
+  AlignedMatrix thread_dx_mat_, thread_hx_mat_;
+
+  // Computes the times of the stages in the forward sweep, tau_vec_, and 
+  // those in the backward sweep, backward_tau_vec_. They are accumulated in 
+  // the same order as the serial sweeps so that the parallel evaluation gives 
+  // the same results.
+  void computeStageTimes(const double time, const double delta_tau);
+
+  // Computes the optimality residual for the state of the stage-th stage and 
+  // that for lambda of the previous stage at the times given by 
+  // computeStageTimes(). dx_vec is the workspace of the calling thread.
+  void computeOptimalityResidualForStateAndLambdaOfStage(
+      const int stage, const double delta_tau, const double* state_vec, 
+      const double* control_input_and_constraints_seq, 
+      const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+      double* dx_vec, AlignedMatrix& optimality_residual_for_state, 
+      AlignedMatrix& optimality_residual_for_lambda);
 };
 
+template <class Model, int FixedN>
+MSOCPWithInputSaturation<Model, FixedN>::MSOCPWithInputSaturation(
+    const InputSaturationSet& input_saturation_set, const double T_f, 
+    const double alpha, const int N)
+  : OptimalControlProblem<Model>(),
+    horizon_(T_f, alpha),
+    input_saturation_set_(input_saturation_set),
+    dim_solution_(N*(model_.dim_control_input()+model_.dim_constraints())),
+    dim_saturation_(input_saturation_set_.dim_saturation()),
+    N_(N),
+    dx_vec_(),
+    hx_vec_(),
+    tau_vec_(N+1),
+    backward_tau_vec_(N),
+    dual_control_input_and_constraints_seq_(dim_solution_),
+    dual_state_vec_(),
+    dual_state_mat_(N*model_.dim_state()),
+    dual_lambda_mat_(N*model_.dim_state()),
+    dual_dx_vec_(),
+    dual_hu_vec_(),
+    dual_input_saturation_multiplier_vec_(dim_saturation_),
+    own_thread_pool_(),
+    thread_pool_(&own_thread_pool_),
+    thread_dx_mat_(1, model_.dim_state()),
+    thread_hx_mat_(1, model_.dim_state()) {
+}
+
+template <class Model, int FixedN>
+MSOCPWithInputSaturation<Model, FixedN>::MSOCPWithInputSaturation(
+    const InputSaturationSet& input_saturation_set, const double T_f, 
+    const double alpha, const int N, const double initial_time)
+  : OptimalControlProblem<Model>(),
+    horizon_(T_f, alpha, initial_time),
+    input_saturation_set_(input_saturation_set),
+    dim_solution_(N*(model_.dim_control_input()+model_.dim_constraints())),
+    dim_saturation_(input_saturation_set_.dim_saturation()),
+    N_(N),
+    dx_vec_(),
+    hx_vec_(),
+    tau_vec_(N+1),
+    backward_tau_vec_(N),
+    dual_control_input_and_constraints_seq_(dim_solution_),
+    dual_state_vec_(),
+    dual_state_mat_(N*model_.dim_state()),
+    dual_lambda_mat_(N*model_.dim_state()),
+    dual_dx_vec_(),
+    dual_hu_vec_(),
+    dual_input_saturation_multiplier_vec_(dim_saturation_),
+    own_thread_pool_(),
+    thread_pool_(&own_thread_pool_),
+    thread_dx_mat_(1, model_.dim_state()),
+    thread_hx_mat_(1, model_.dim_state()) {
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::
+computeOptimalityResidualForControlInputAndConstraints(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+    const AlignedMatrix& input_saturation_multipler_mat,
+    double* optimality_residual_for_control_input_and_constraints) {
+  // Set the length of the horizon and discretize the horizon.
+  double horizon_length = horizon_.getLength(time);
+  double delta_tau = horizon_length / N_;
+  if (thread_pool_->num_threads() > 1) {
+    computeStageTimes(time, delta_tau);
+    thread_pool_->parallelFor(0, N_, 
+        [&](const int /*thread_index*/, const int begin, const int end) {
+      for (int i=begin; i<end; ++i) {
+        int i_total = i * dim_control_input_and_constraints_;
+        model_.huFunc(
+            tau_vec_[i], (i == 0) ? state_vec : state_mat[i-1], 
+            &(control_input_and_constraints_seq[i_total]), lambda_mat[i], 
+            &(optimality_residual_for_control_input_and_constraints[i_total]));
+        inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
+            input_saturation_set_, &(control_input_and_constraints_seq[i_total]), 
+            input_saturation_multipler_mat[i], 
+            &(optimality_residual_for_control_input_and_constraints[i_total]));
+      }
+    });
+    return;
+  }
+  // Compute optimality error for control input and constraints.
+  // Compute optimality error for contol input and constraints.
+  model_.huFunc(time, state_vec, control_input_and_constraints_seq, 
+                lambda_mat[0], optimality_residual_for_control_input_and_constraints);
+  inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
+      input_saturation_set_, control_input_and_constraints_seq, 
+      input_saturation_multipler_mat[0], 
+      optimality_residual_for_control_input_and_constraints
+  );
+  double tau = time + delta_tau;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.huFunc(tau, state_mat[i-1], 
+                  &(control_input_and_constraints_seq[i_total]), 
+                  lambda_mat[i], 
+                  &(optimality_residual_for_control_input_and_constraints[i_total]));
+    inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
+        input_saturation_set_, &(control_input_and_constraints_seq[i_total]), 
+        input_saturation_multipler_mat[i], 
+        &(optimality_residual_for_control_input_and_constraints[i_total])
+    );
+  }
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::
+computeOptimalityResidualForStateAndLambda(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+    AlignedMatrix& optimality_residual_for_state, 
+    AlignedMatrix& optimality_residual_for_lambda) {
+  // Set the length of the horizon and discretize the horizon.
+  double horizon_length = horizon_.getLength(time);
+  double delta_tau = horizon_length / N_;
+  if (thread_pool_->num_threads() > 1) {
+    computeStageTimes(time, delta_tau);
+    thread_pool_->parallelFor(0, N_, 
+        [&](const int thread_index, const int begin, const int end) {
+      for (int i=begin; i<end; ++i) {
+        computeOptimalityResidualForStateAndLambdaOfStage(
+            i, delta_tau, state_vec, control_input_and_constraints_seq, 
+            state_mat, lambda_mat, thread_dx_mat_[thread_index], 
+            optimality_residual_for_state, optimality_residual_for_lambda);
+      }
+    });
+    model_.phixFunc(tau_vec_[N_], state_mat[N_-1], dx_vec_);
+    for (int i=0; i<dim_state_; ++i) {
+      optimality_residual_for_lambda[N_-1][i] 
+          = lambda_mat[N_-1][i] - dx_vec_[i];
+    }
+    return;
+  }
+  // Compute optimality error for state.
+  model_.stateFunc(time, state_vec, control_input_and_constraints_seq, dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    optimality_residual_for_state[0][i] = 
+        state_mat[0][i] - state_vec[i] - delta_tau * dx_vec_[i];
+  }
+  double tau = time + delta_tau;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.stateFunc(tau, state_mat[i-1], 
+                     &(control_input_and_constraints_seq[i_total]), dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      optimality_residual_for_state[i][j] = 
+          state_mat[i][j] - state_mat[i-1][j] - delta_tau * dx_vec_[j];
+    }
+  }
+  // Compute optimality error for lambda.
+  model_.phixFunc(tau, state_mat[N_-1], dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    optimality_residual_for_lambda[N_-1][i] = lambda_mat[N_-1][i] - dx_vec_[i];
+  }
+  for (int i=N_-1; i>=1; --i, tau-=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.hxFunc(tau, state_mat[i-1], 
+                  &(control_input_and_constraints_seq[i_total]), 
+                  lambda_mat[i], dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      optimality_residual_for_lambda[i-1][j] = 
+          lambda_mat[i-1][j] - lambda_mat[i][j] - delta_tau * dx_vec_[j];
+    }
+  }
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::computeOptimalityResidual(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+    const AlignedMatrix& input_saturation_multiplier_mat,
+    double* optimality_residual_for_control_input_and_constraints, 
+    AlignedMatrix& optimality_residual_for_state, 
+    AlignedMatrix& optimality_residual_for_lambda) {
+  // Set the length of the horizon and discretize the horizon.
+  double horizon_length = horizon_.getLength(time);
+  double delta_tau = horizon_length / N_;
+  if (thread_pool_->num_threads() > 1) {
+    computeStageTimes(time, delta_tau);
+    thread_pool_->parallelFor(0, N_, 
+        [&](const int thread_index, const int begin, const int end) {
+      for (int i=begin; i<end; ++i) {
+        int i_total = i * dim_control_input_and_constraints_;
+        if (modeltraits::HasHamiltonianDerivativesFunc<Model>::value
+            && i > 0) {
+          double* dx_vec = thread_dx_mat_[thread_index];
+          double* hx_vec = thread_hx_mat_[thread_index];
+          modeltraits::HamiltonianDerivativesFunc(
+              model_, tau_vec_[i], backward_tau_vec_[i], state_mat[i-1], 
+              &(control_input_and_constraints_seq[i_total]), lambda_mat[i], 
+              dx_vec, hx_vec, 
+              &(optimality_residual_for_control_input_and_constraints[i_total]));
+          inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
+              input_saturation_set_, &(control_input_and_constraints_seq[i_total]), 
+              input_saturation_multiplier_mat[i], 
+              &(optimality_residual_for_control_input_and_constraints[i_total]));
+          for (int j=0; j<dim_state_; ++j) {
+            optimality_residual_for_state[i][j] = 
+                state_mat[i][j] - state_mat[i-1][j] - delta_tau * dx_vec[j];
+          }
+          for (int j=0; j<dim_state_; ++j) {
+            optimality_residual_for_lambda[i-1][j] = 
+                lambda_mat[i-1][j] - lambda_mat[i][j] - delta_tau * hx_vec[j];
+          }
+          continue;
+        }
+        computeOptimalityResidualForStateAndLambdaOfStage(
+            i, delta_tau, state_vec, control_input_and_constraints_seq, 
+            state_mat, lambda_mat, thread_dx_mat_[thread_index], 
+            optimality_residual_for_state, optimality_residual_for_lambda);
+        model_.huFunc(
+            tau_vec_[i], (i == 0) ? state_vec : state_mat[i-1], 
+            &(control_input_and_constraints_seq[i_total]), lambda_mat[i], 
+            &(optimality_residual_for_control_input_and_constraints[i_total]));
+        inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
+            input_saturation_set_, &(control_input_and_constraints_seq[i_total]), 
+            input_saturation_multiplier_mat[i], 
+            &(optimality_residual_for_control_input_and_constraints[i_total]));
+      }
+    });
+    model_.phixFunc(tau_vec_[N_], state_mat[N_-1], dx_vec_);
+    for (int i=0; i<dim_state_; ++i) {
+      optimality_residual_for_lambda[N_-1][i] 
+          = lambda_mat[N_-1][i] - dx_vec_[i];
+    }
+    return;
+  }
+  if (modeltraits::HasHamiltonianDerivativesFunc<Model>::value) {
+    // The first stage has no optimality residual for lambda.
+    model_.stateFunc(time, state_vec, control_input_and_constraints_seq, 
+                     dx_vec_);
+    for (int i=0; i<dim_state_; ++i) {
+      optimality_residual_for_state[0][i] = 
+          state_mat[0][i] - state_vec[i] - delta_tau * dx_vec_[i];
+    }
+    model_.huFunc(time, state_vec, control_input_and_constraints_seq, 
+                  lambda_mat[0], 
+                  optimality_residual_for_control_input_and_constraints);
+    inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
+        input_saturation_set_, control_input_and_constraints_seq, 
+        input_saturation_multiplier_mat[0], 
+        optimality_residual_for_control_input_and_constraints);
+    // Compute the optimality residuals of the other stages with the state 
+    // equation and the partial derivatives of the Hamiltonian at once. The 
+    // partial derivative with respect to the state is evaluated at the time of 
+    // the backward sweep as in the separate evaluation.
+    computeStageTimes(time, delta_tau);
+    for (int i=1; i<N_; ++i) {
+      int i_total = i * dim_control_input_and_constraints_;
+      modeltraits::HamiltonianDerivativesFunc(
+          model_, tau_vec_[i], backward_tau_vec_[i], state_mat[i-1], 
+          &(control_input_and_constraints_seq[i_total]), lambda_mat[i], 
+          dx_vec_, hx_vec_, 
+          &(optimality_residual_for_control_input_and_constraints[i_total]));
+      inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
+          input_saturation_set_, &(control_input_and_constraints_seq[i_total]), 
+          input_saturation_multiplier_mat[i], 
+          &(optimality_residual_for_control_input_and_constraints[i_total]));
+      for (int j=0; j<dim_state_; ++j) {
+        optimality_residual_for_state[i][j] = 
+            state_mat[i][j] - state_mat[i-1][j] - delta_tau * dx_vec_[j];
+      }
+      for (int j=0; j<dim_state_; ++j) {
+        optimality_residual_for_lambda[i-1][j] = 
+            lambda_mat[i-1][j] - lambda_mat[i][j] - delta_tau * hx_vec_[j];
+      }
+    }
+    model_.phixFunc(tau_vec_[N_], state_mat[N_-1], dx_vec_);
+    for (int i=0; i<dim_state_; ++i) {
+      optimality_residual_for_lambda[N_-1][i] 
+          = lambda_mat[N_-1][i] - dx_vec_[i];
+    }
+    return;
+  }
+  // Compute the optimality residuals for the state and for the control input 
+  // and constraints of each stage in the forward sweep.
+  model_.stateFunc(time, state_vec, control_input_and_constraints_seq, dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    optimality_residual_for_state[0][i] = 
+        state_mat[0][i] - state_vec[i] - delta_tau * dx_vec_[i];
+  }
+  model_.huFunc(time, state_vec, control_input_and_constraints_seq, 
+                lambda_mat[0], 
+                optimality_residual_for_control_input_and_constraints);
+  inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
+      input_saturation_set_, control_input_and_constraints_seq, 
+      input_saturation_multiplier_mat[0], 
+      optimality_residual_for_control_input_and_constraints);
+  double tau = time + delta_tau;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.stateFunc(tau, state_mat[i-1], 
+                     &(control_input_and_constraints_seq[i_total]), dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      optimality_residual_for_state[i][j] = 
+          state_mat[i][j] - state_mat[i-1][j] - delta_tau * dx_vec_[j];
+    }
+    model_.huFunc(
+        tau, state_mat[i-1], &(control_input_and_constraints_seq[i_total]), 
+        lambda_mat[i], 
+        &(optimality_residual_for_control_input_and_constraints[i_total]));
+    inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
+        input_saturation_set_, &(control_input_and_constraints_seq[i_total]), 
+        input_saturation_multiplier_mat[i], 
+        &(optimality_residual_for_control_input_and_constraints[i_total]));
+  }
+  // Compute the optimality residual for lambda in the backward sweep.
+  model_.phixFunc(tau, state_mat[N_-1], dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    optimality_residual_for_lambda[N_-1][i] = lambda_mat[N_-1][i] - dx_vec_[i];
+  }
+  for (int i=N_-1; i>=1; --i, tau-=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.hxFunc(tau, state_mat[i-1], 
+                  &(control_input_and_constraints_seq[i_total]), 
+                  lambda_mat[i], dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      optimality_residual_for_lambda[i-1][j] = 
+          lambda_mat[i-1][j] - lambda_mat[i][j] - delta_tau * dx_vec_[j];
+    }
+  }
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::
+computeStateAndLambdaFromOptimalityResidual(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& optimality_residual_for_state, 
+    const AlignedMatrix& optimality_residual_for_lambda, 
+    AlignedMatrix& state_mat, AlignedMatrix& lambda_mat) {
+  // Set the length of the horizon and discretize the horizon.
+  double horizon_length = horizon_.getLength(time);
+  double delta_tau = horizon_length / N_;
+  // Compute the sequence of state under the error for state.
+  model_.stateFunc(time, state_vec, control_input_and_constraints_seq, dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    state_mat[0][i] = 
+        state_vec[i] 
+        + delta_tau * dx_vec_[i] + optimality_residual_for_state[0][i];
+  }
+  double tau = time + delta_tau;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.stateFunc(tau, state_mat[i-1], 
+                     &(control_input_and_constraints_seq[i_total]), dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      state_mat[i][j] = 
+          state_mat[i-1][j] 
+          + delta_tau * dx_vec_[j] + optimality_residual_for_state[i][j];
+    }
+  }
+  // Compute the sequence of lambda under the error for lambda.
+  model_.phixFunc(tau, state_mat[N_-1], dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    lambda_mat[N_-1][i] = dx_vec_[i] + optimality_residual_for_lambda[N_-1][i];
+  }
+  for (int i=N_-1; i>=1; --i, tau-=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.hxFunc(tau, state_mat[i-1], 
+                  &(control_input_and_constraints_seq[i_total]), 
+                  lambda_mat[i], dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      lambda_mat[i-1][j] = 
+          lambda_mat[i][j] 
+          + delta_tau * dx_vec_[j] + optimality_residual_for_lambda[i-1][j];
+    }
+  }
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::
+computeResidualForDummyInputAndInputSaturation(
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& dummy_input_mat, 
+    const AlignedMatrix& input_saturation_multiplier_mat, 
+    AlignedMatrix& errors_for_dummy_input, 
+    AlignedMatrix& errors_for_input_saturation) {
+  for (int i=0; i<N_; ++i) {
+    inputsaturationfunctions::computeOptimalityResidualForDummyInput(
+        input_saturation_set_, dummy_input_mat[i], 
+        input_saturation_multiplier_mat[i], errors_for_dummy_input[i]);
+  }
+  for (int i=0; i<N_; ++i) {
+    inputsaturationfunctions::computeOptimalityResidualForInputSaturation(
+        input_saturation_set_,
+        &(control_input_and_constraints_seq[i*dim_control_input_and_constraints_]),
+        dummy_input_mat[i], errors_for_input_saturation[i]);
+  }
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::
+computeCondensedOptimalityResidual(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& optimality_residual_for_state,
+    const AlignedMatrix& optimality_residual_for_lambda,
+    const AlignedMatrix& input_saturation_multiplier_mat,
+    AlignedMatrix& state_mat, AlignedMatrix& lambda_mat, 
+    double* optimality_residual_for_control_input_and_constraints) {
+  // Set the length of the horizon and discretize the horizon.
+  double horizon_length = horizon_.getLength(time);
+  double delta_tau = horizon_length / N_;
+  if (thread_pool_->num_threads() > 1) {
+    computeStateAndLambdaFromOptimalityResidual(
+        time, state_vec, control_input_and_constraints_seq, 
+        optimality_residual_for_state, optimality_residual_for_lambda, 
+        state_mat, lambda_mat);
+    computeOptimalityResidualForControlInputAndConstraints(
+        time, state_vec, control_input_and_constraints_seq, state_mat, 
+        lambda_mat, input_saturation_multiplier_mat, 
+        optimality_residual_for_control_input_and_constraints);
+    return;
+  }
+  // Compute the sequence of state under the error for state. The time of each 
+  // stage is stored to compute the optimality residual for the control input 
+  // and constraints at the same time as the forward sweep.
+  model_.stateFunc(time, state_vec, control_input_and_constraints_seq, dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    state_mat[0][i] = 
+        state_vec[i] 
+        + delta_tau * dx_vec_[i] + optimality_residual_for_state[0][i];
+  }
+  double tau = time + delta_tau;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    tau_vec_[i] = tau;
+    model_.stateFunc(tau, state_mat[i-1], 
+                     &(control_input_and_constraints_seq[i_total]), dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      state_mat[i][j] = 
+          state_mat[i-1][j] 
+          + delta_tau * dx_vec_[j] + optimality_residual_for_state[i][j];
+    }
+  }
+  // Compute the sequence of lambda under the error for lambda and the 
+  // optimality residual for the control input and constraints of each stage 
+  // while the state and lambda of the stage are still in cache.
+  model_.phixFunc(tau, state_mat[N_-1], dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    lambda_mat[N_-1][i] = dx_vec_[i] + optimality_residual_for_lambda[N_-1][i];
+  }
+  for (int i=N_-1; i>=1; --i, tau-=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.huFunc(
+        tau_vec_[i], state_mat[i-1], 
+        &(control_input_and_constraints_seq[i_total]), lambda_mat[i], 
+        &(optimality_residual_for_control_input_and_constraints[i_total]));
+    inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
+        input_saturation_set_, &(control_input_and_constraints_seq[i_total]), 
+        input_saturation_multiplier_mat[i], 
+        &(optimality_residual_for_control_input_and_constraints[i_total]));
+    model_.hxFunc(tau, state_mat[i-1], 
+                  &(control_input_and_constraints_seq[i_total]), 
+                  lambda_mat[i], dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      lambda_mat[i-1][j] = 
+          lambda_mat[i][j] 
+          + delta_tau * dx_vec_[j] + optimality_residual_for_lambda[i-1][j];
+    }
+  }
+  model_.huFunc(time, state_vec, control_input_and_constraints_seq, 
+                lambda_mat[0], 
+                optimality_residual_for_control_input_and_constraints);
+  inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
+      input_saturation_set_, control_input_and_constraints_seq, 
+      input_saturation_multiplier_mat[0], 
+      optimality_residual_for_control_input_and_constraints);
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::
+computeCondensedOptimalityResidualDirectionalDerivative(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& optimality_residual_for_state,
+    const AlignedMatrix& optimality_residual_for_lambda,
+    const AlignedMatrix& input_saturation_multiplier_mat,
+    const AlignedMatrix& input_saturation_multiplier_derivative_mat,
+    const double* direction_vec, double* optimality_residual_derivative) {
+  // Set the length of the horizon and discretize the horizon.
+  double horizon_length = horizon_.getLength(time);
+  double delta_tau = horizon_length / N_;
+  // The derivatives of the control input and the constraints are set by 
+  // direction_vec and those of the initial state are zero. The i-th rows of 
+  // the state and lambda are stored from dual_state_mat_[i*dim_state_] and 
+  // dual_lambda_mat_[i*dim_state_].
+  for (int i=0; i<dim_solution_; ++i) {
+    dual_control_input_and_constraints_seq_[i] 
+        = Dual(control_input_and_constraints_seq[i], direction_vec[i]);
+  }
+  for (int i=0; i<dim_state_; ++i) {
+    dual_state_vec_[i] = Dual(state_vec[i]);
+  }
+  // Compute the sequence of state under the error for state.
+  model_.stateFunc(time, dual_state_vec_, 
+                   dual_control_input_and_constraints_seq_.data(), 
+                   dual_dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    dual_state_mat_[i] = dual_state_vec_[i] + delta_tau * dual_dx_vec_[i] 
+                         + optimality_residual_for_state[0][i];
+  }
+  double tau = time + delta_tau;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.stateFunc(tau, &(dual_state_mat_[(i-1)*dim_state_]), 
+                     &(dual_control_input_and_constraints_seq_[i_total]), 
+                     dual_dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      dual_state_mat_[i*dim_state_+j] = 
+          dual_state_mat_[(i-1)*dim_state_+j] 
+          + delta_tau * dual_dx_vec_[j] + optimality_residual_for_state[i][j];
+    }
+  }
+  // Compute the sequence of lambda under the error for lambda.
+  model_.phixFunc(tau, &(dual_state_mat_[(N_-1)*dim_state_]), dual_dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    dual_lambda_mat_[(N_-1)*dim_state_+i] 
+        = dual_dx_vec_[i] + optimality_residual_for_lambda[N_-1][i];
+  }
+  for (int i=N_-1; i>=1; --i, tau-=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.hxFunc(tau, &(dual_state_mat_[(i-1)*dim_state_]), 
+                  &(dual_control_input_and_constraints_seq_[i_total]), 
+                  &(dual_lambda_mat_[i*dim_state_]), dual_dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      dual_lambda_mat_[(i-1)*dim_state_+j] = 
+          dual_lambda_mat_[i*dim_state_+j] 
+          + delta_tau * dual_dx_vec_[j] 
+          + optimality_residual_for_lambda[i-1][j];
+    }
+  }
+  // Compute the derivative of the optimality error for control input and 
+  // constraints.
+  for (int j=0; j<dim_saturation_; ++j) {
+    dual_input_saturation_multiplier_vec_[j] 
+        = Dual(input_saturation_multiplier_mat[0][j], 
+               input_saturation_multiplier_derivative_mat[0][j]);
+  }
+  model_.huFunc(time, dual_state_vec_, 
+                dual_control_input_and_constraints_seq_.data(), 
+                dual_lambda_mat_.data(), dual_hu_vec_);
+  inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
+      input_saturation_set_, dual_control_input_and_constraints_seq_.data(), 
+      dual_input_saturation_multiplier_vec_.data(), dual_hu_vec_);
+  for (int j=0; j<dim_control_input_and_constraints_; ++j) {
+    optimality_residual_derivative[j] = dual_hu_vec_[j].derivative();
+  }
+  tau = time + delta_tau;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    for (int j=0; j<dim_saturation_; ++j) {
+      dual_input_saturation_multiplier_vec_[j] 
+          = Dual(input_saturation_multiplier_mat[i][j], 
+                 input_saturation_multiplier_derivative_mat[i][j]);
+    }
+    model_.huFunc(tau, &(dual_state_mat_[(i-1)*dim_state_]), 
+                  &(dual_control_input_and_constraints_seq_[i_total]), 
+                  &(dual_lambda_mat_[i*dim_state_]), dual_hu_vec_);
+    inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
+        input_saturation_set_, 
+        &(dual_control_input_and_constraints_seq_[i_total]), 
+        dual_input_saturation_multiplier_vec_.data(), dual_hu_vec_);
+    for (int j=0; j<dim_control_input_and_constraints_; ++j) {
+      optimality_residual_derivative[i_total+j] = dual_hu_vec_[j].derivative();
+    }
+  }
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::
+multiplyResidualForDummyInputAndInputSaturationInverse(
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& dummy_input_mat, 
+    const AlignedMatrix& input_saturation_multiplier_mat, 
+    const AlignedMatrix& multiplied_dummy_input_mat, 
+    const AlignedMatrix& multiplied_Lagrange_multiplier_mat, 
+    AlignedMatrix& resulted_dummy_input_mat, 
+    AlignedMatrix& resulted_Lagrange_multiplier_mat) {
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_saturation_; ++j) {
+      resulted_dummy_input_mat[i][j] = 
+          multiplied_Lagrange_multiplier_mat[i][j] / (2*dummy_input_mat[i][j]);
+    }
+  }
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_saturation_; ++j) {
+      resulted_Lagrange_multiplier_mat[i][j] = 
+          multiplied_dummy_input_mat[i][j] / (2*dummy_input_mat[i][j]) 
+          - ((input_saturation_multiplier_mat[i][j]
+                  +input_saturation_set_.quadratic_weight(j)) 
+              *resulted_dummy_input_mat[i][j]) / dummy_input_mat[i][j];
+    }
+  }
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::
+computeResidualDifferenceForDummyInput(
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& dummy_input_mat, 
+    const double* control_input_and_constraints_update_seq, 
+    AlignedMatrix& dummy_residual_difference_mat) {
+  for (int i=0; i<N_; ++i) { 
+    int i_total = i * dim_control_input_and_constraints_;
+    for (int j=0; j<dim_saturation_; ++j) {
+      int index_j = input_saturation_set_.index(j);
+      dummy_residual_difference_mat[i][j] = 
+          ((2*control_input_and_constraints_seq[i_total+index_j] 
+              -input_saturation_set_.min(j)-input_saturation_set_.max(j))
+              *control_input_and_constraints_update_seq[i_total+index_j]) 
+          / (2*dummy_input_mat[i][j]);
+    }
+  }
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::
+computeResidualDifferenceForInputSaturation(
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& dummy_input_mat, 
+    const AlignedMatrix& input_saturation_multiplier_mat, 
+    const double* control_input_and_constraints_update_seq, 
+    AlignedMatrix& input_saturation_difference_mat) {
+  for (int i=0; i<N_; ++i) {
+    int i_total = i * dim_control_input_and_constraints_;
+    for (int j=0; j<dim_saturation_; ++j) {
+      int index_j = input_saturation_set_.index(j);
+      input_saturation_difference_mat[i][j] = 
+          - ((input_saturation_multiplier_mat[i][j]
+                +input_saturation_set_.quadratic_weight(j))
+          *(2*control_input_and_constraints_seq[i_total+index_j]
+                -input_saturation_set_.min(j)-input_saturation_set_.max(j))
+          *control_input_and_constraints_update_seq[i_total+index_j]) 
+          / (2*dummy_input_mat[i][j]*dummy_input_mat[i][j]);
+    }
+  }
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::predictStateFromSolution(
+    const double current_time, const double* current_state,
+    const double* solution_vec, const double prediction_length,
+    double* predicted_state) {
+  model_.stateFunc(current_time, current_state, solution_vec, dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    predicted_state[i] =  current_state[i] + prediction_length * dx_vec_[i];
+  }
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::resetHorizonLength(
+    const double initial_time) {
+  horizon_.resetLength(initial_time);
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::resetHorizonLength(
+    const double T_f, const double alpha, const double initial_time) {
+  horizon_.resetLength(T_f, alpha, initial_time);
+}
+
+template <class Model, int FixedN>
+int MSOCPWithInputSaturation<Model, FixedN>::dim_solution() const {
+  return dim_solution_;
+}
+
+template <class Model, int FixedN>
+int MSOCPWithInputSaturation<Model, FixedN>::dim_saturation() const {
+  return dim_saturation_;
+}
+
+template <class Model, int FixedN>
+int MSOCPWithInputSaturation<Model, FixedN>::N() const {
+  return N_;
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::setNumThreads(
+    const int num_threads, const int min_N) {
+  thread_pool_ = &own_thread_pool_;
+  if (N_ >= min_N) {
+    own_thread_pool_.setNumThreads(num_threads);
+  }
+  else {
+    own_thread_pool_.setNumThreads(1);
+  }
+  thread_dx_mat_.resize(thread_pool_->num_threads(), dim_state_);
+  thread_hx_mat_.resize(thread_pool_->num_threads(), dim_state_);
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::setThreadPool(
+    StageThreadPool& thread_pool, const int min_N) {
+  own_thread_pool_.setNumThreads(1);
+  if (N_ >= min_N) {
+    thread_pool_ = &thread_pool;
+  }
+  else {
+    thread_pool_ = &own_thread_pool_;
+  }
+  thread_dx_mat_.resize(thread_pool_->num_threads(), dim_state_);
+  thread_hx_mat_.resize(thread_pool_->num_threads(), dim_state_);
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::computeStageTimes(
+    const double time, const double delta_tau) {
+  tau_vec_[0] = time;
+  double tau = time + delta_tau;
+  for (int i=1; i<=N_; ++i, tau+=delta_tau) {
+    tau_vec_[i] = tau;
+  }
+  tau = tau_vec_[N_];
+  for (int i=N_-1; i>=1; --i, tau-=delta_tau) {
+    backward_tau_vec_[i] = tau;
+  }
+}
+
+template <class Model, int FixedN>
+void MSOCPWithInputSaturation<Model, FixedN>::
+computeOptimalityResidualForStateAndLambdaOfStage(
+    const int stage, const double delta_tau, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+    double* dx_vec, AlignedMatrix& optimality_residual_for_state, 
+    AlignedMatrix& optimality_residual_for_lambda) {
+  const double* previous_state_vec 
+      = (stage == 0) ? state_vec : state_mat[stage-1];
+  const double* control_input_and_constraints_vec 
+      = &(control_input_and_constraints_seq[
+              stage*dim_control_input_and_constraints_]);
+  model_.stateFunc(tau_vec_[stage], previous_state_vec, 
+                   control_input_and_constraints_vec, dx_vec);
+  for (int j=0; j<dim_state_; ++j) {
+    optimality_residual_for_state[stage][j] = 
+        state_mat[stage][j] - previous_state_vec[j] - delta_tau * dx_vec[j];
+  }
+  if (stage > 0) {
+    model_.hxFunc(backward_tau_vec_[stage], previous_state_vec, 
+                  control_input_and_constraints_vec, lambda_mat[stage], dx_vec);
+    for (int j=0; j<dim_state_; ++j) {
+      optimality_residual_for_lambda[stage-1][j] = 
+          lambda_mat[stage-1][j] - lambda_mat[stage][j] 
+          - delta_tau * dx_vec[j];
+    }
+  }
+}
+
 } // namespace cgmres
 
 
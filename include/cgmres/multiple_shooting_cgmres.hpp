@@ -11,9 +11,15 @@
 #define MULTIPLE_SHOOTING_CGMRES_H
 
 #include "matrixfree_gmres.hpp"
+#include "matrixfree_bicgstab.hpp"
+#include "matrixfree_idrs.hpp"
+#include "matrixfree_gcrodr.hpp"
+#include "dense_lu_solver.hpp"
 #include "multiple_shooting_continuation.hpp"
 #include "cgmres_initializer.hpp"
 #include "linear_algebra.hpp"
+#include "aligned_matrix.hpp"
+#include "horizon_storage.hpp"
 
 
 namespace cgmres {
@@ -28,8 +34,25 @@ namespace cgmres {
 // For this initialization, you are required to set parameters by
 // setParametersForInitialization() method and initializeSolution() method. 
 // Without these initialization, all components of the solution is zero.
-class MultipleShootingCGMRES {
+// The matrix-free Krylov method of controlUpdate() is KrylovMethod, which 
+// has the same interface as MatrixFreeGMRES, e.g., MatrixFreeBiCGStab or 
+// MatrixFreeIDRs. MultipleShootingCGMRES is this solver with 
+// ControlUpdateKrylovMethod. 
+// Model is the model of NMPC, e.g., NMPCModel generated by AutoGenU in the 
+// namespace named after the model, so that the solvers of different models 
+// can share one binary. If FixedN is not kDynamicSize, the sequences and the 
+// matrices over the horizon are members of the solver sized by FixedN, which 
+// must be equal to N passed to the constructor, and no memory is allocated 
+// for them. The vectors and matrices of the block-Jacobi preconditioner and 
+// of the other solvers of the linear problem are allocated when they are 
+// enabled, and those of the initialization by the constructor.
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN = kDynamicSize>
+class BasicMultipleShootingCGMRES {
 public:
+  // The model of NMPC, which the simulator also integrates.
+  using NMPCModel = Model;
+
   // Constructs MultipleShootingCGMRES with setting parameters and allocates 
   // vectors and matrices used in the C/GMRES method. 
   // Arguments:
@@ -43,12 +66,10 @@ public:
   //  kmax: A parameter for the GMRES method. This parameter represents the
   //     dimension of the Krylov subspace and maximum iteration number of the
   //     GMRES method.
-  MultipleShootingCGMRES(const double T_f, const double alpha, const int N,
-           const double finite_difference_increment,
-           const double zeta, const int kmax);
-
-  // Free vectors and matrices.
-  ~MultipleShootingCGMRES();
+  BasicMultipleShootingCGMRES(const double T_f, const double alpha, 
+                              const int N, 
+                              const double finite_difference_increment, 
+                              const double zeta, const int kmax);
 
   // Updates the solution by solving the matrix-free GMRES. The optimal control
   // to be applied to the actual system is assigned in control_input_vec.
@@ -88,23 +109,475 @@ public:
   // and the current solution.
   double getErrorNorm(const double time, const double* state_vec);
 
+  // Sets the parameters of the models of the continuation problem and of the 
+  // initialization, which are used from the next controlUpdate() and 
+  // initializeSolution(), respectively. This can be called from any thread, 
+  // also during controlUpdate(), which never waits for it. See 
+  // Model::setParameters().
+  template <class Parameters>
+  void setParameters(const Parameters& parameters);
+
+  // Sets the tolerances of the residual of the GMRES method. The GMRES 
+  // iteration in controlUpdate() terminates as soon as the residual norm is 
+  // less than or equal to max(absolute_tolerance, 
+  // relative_tolerance*(the initial residual norm)). If both of the 
+  // tolerances are zero (default), kmax iterations are always performed.
+  void setGMRESTolerance(const double absolute_tolerance, 
+                         const double relative_tolerance);
+
+  // Sets the maximum number of the restarts of the GMRES method. The GMRES 
+  // method with the kmax-dimensional Krylov subspace is restarted at most 
+  // max_restarts times in controlUpdate() while the residual does not satisfy
+  // the tolerances set by setGMRESTolerance(). The default is zero.
+  void setMaxGMRESRestarts(const int max_restarts);
+
+  // Enables the block-Jacobi preconditioner of the GMRES method. The blocks, 
+  // i.e., the Jacobians of the optimality residual of each stage with respect 
+  // to the control input and the constraints of the stage, are recomputed 
+  // every update_period calls of controlUpdate(). If update_period is zero 
+  // (default), the preconditioner is not used.
+  void setBlockJacobiPreconditioner(const int update_period);
+
+  // Sets whether the Jacobian-vector products in the GMRES method of 
+  // controlUpdate() and of the initialization are computed exactly by the 
+  // forward-mode automatic differentiation, i.e., by the functions of 
+  // Model instantiated with the dual numbers, instead of the forward 
+  // difference approximation with finite_difference_increment. This removes 
+  // the truncation error of the products, which may reduce the GMRES 
+  // iterations needed for a given accuracy. The default is false.
+  void setExactJacobianVectorProduct(const bool exact_jacobian_vector_product);
+
+  // Sets whether the linear problem in controlUpdate() is solved by the LU 
+  // factorization of the explicitly assembled coefficient matrix, i.e., the 
+  // Jacobian of the condensed optimality residual, instead of the GMRES 
+  // method. The matrix is assembled by 
+  // N*(dim_control_input+dim_constraints) directional derivatives and is 
+  // reused for update_period calls of controlUpdate(), which then cost only 
+  // two triangular solves besides the right-hand side. If refresh_tolerance 
+  // is positive, the solution under the frozen matrix is improved by the 
+  // iterative refinement while its residual is larger than refresh_tolerance 
+  // relative to the right-hand side, and the matrix is reassembled if the 
+  // refinement stalls. See DenseLUSolver. Since each reassembly costs as much 
+  // as N*(dim_control_input+dim_constraints) GMRES iterations, this is slower 
+  // than the GMRES method unless the reassemblies are rare, e.g., on the 
+  // cartpole with N = 50; see getNumDenseJacobianFactorizations(). If 
+  // update_period is zero (default), the GMRES method is used. If the 
+  // matrix is singular, the GMRES method is used in that controlUpdate() and 
+  // the matrix is reassembled in the next one.
+  void setDenseJacobian(const int update_period, 
+                        const double refresh_tolerance);
+
+  // Sets whether the linear problem in controlUpdate() is solved directly by 
+  // the Riccati recursion instead of the GMRES method. The Riccati recursion 
+  // computes the Jacobians of the state equation and the partial derivatives 
+  // of the Hamiltonian of each stage exactly and solves the linear problem 
+  // in O(N) operations independently of kmax. See 
+  // MultipleShootingContinuation::solveLinearProblemByRiccatiRecursion(). 
+  // Since the Jacobians cost 2*dim_state+dim_control_input+dim_constraints 
+  // evaluations of the model in the dual numbers per stage, this is slower 
+  // than the GMRES method with a small kmax; see the benchmark 
+  // riccati_recursion. The vectors and matrices of the recursion 
+  // are allocated at the first controlUpdate() after this is enabled. The 
+  // settings of the GMRES method and the block-Jacobi preconditioner are 
+  // ignored while this is true, except that the GMRES method without the 
+  // preconditioner solves the linear problem of a controlUpdate() in which a 
+  // stage is singular. The default is false.
+  void setRiccatiRecursion(const bool use_riccati_recursion);
+
+  // Sets whether the linear problem in controlUpdate() is solved by the 
+  // matrix-free GCRO-DR method with the recycle_dim-dimensional recycled 
+  // subspace instead of KrylovMethod. The subspace is spanned by the harmonic 
+  // Ritz vectors of the linear problem of the previous controlUpdate(), and 
+  // the Krylov subspace is built in its orthogonal complement, so that each 
+  // update still costs kmax calls of AxFunc() at most. See MatrixFreeGCRODR. 
+  // The tolerances and the restarts of the GMRES method and the block-Jacobi 
+  // preconditioner are also applied to it. The vectors and matrices of the 
+  // method are allocated in this function. Since the image of the recycled 
+  // subspace costs recycle_dim calls of AxFunc() in every update, this is 
+  // slower than KrylovMethod on the sample models; see the benchmark 
+  // krylov_recycling. If recycle_dim is zero (default), KrylovMethod is 
+  // used. setRiccatiRecursion() and setDenseJacobian() take precedence over 
+  // this.
+  void setKrylovRecycling(const int recycle_dim);
+
+  // Sets the number of the threads that evaluate the stages of the horizon, 
+  // i.e., the state equation and the partial derivatives of the Hamiltonian 
+  // of each stage, in parallel in controlUpdate(). The threads are used only 
+  // if N is greater than or equal to min_N because their synchronization 
+  // does not pay for short horizons. The threads are created in this 
+  // function and persist until the destruction of the solver. The solution 
+  // is the same as that of the serial evaluation. The recursions of the state 
+  // and lambda of the condensing are always serial. num_threads is clamped to 
+  // the number of the hardware threads. The default is one thread.
+  void setNumThreads(const int num_threads, const int min_N);
+
+  // Sets the pool that evaluates the stages of the horizon instead of the 
+  // threads of setNumThreads(), so that the solvers of several models in one 
+  // process share the threads, e.g., 
+  //   cgmres::StageThreadPool thread_pool;
+  //   thread_pool.setNumThreads(4);
+  //   solver1.setThreadPool(thread_pool, 50);
+  //   solver2.setThreadPool(thread_pool, 50);
+  // The solvers sharing thread_pool must call controlUpdate() one after 
+  // another, and the number of the threads of thread_pool must not be changed 
+  // while it is shared. See MultipleShootingOCP::setThreadPool().
+  void setThreadPool(StageThreadPool& thread_pool, const int min_N);
+
+  // Returns the number of the GMRES iterations in the latest controlUpdate().
+  // If setDenseJacobian() is enabled, returns the number of the directional 
+  // derivatives of DenseLUSolver instead. If setKrylovRecycling() is 
+  // enabled, returns the number of the calls of AxFunc() of 
+  // MatrixFreeGCRODR, including those for the recycled subspace.
+  int getGMRESIterations() const;
+
+  // Returns the residual norm of the GMRES method in the latest 
+  // controlUpdate(). If setDenseJacobian() or setKrylovRecycling() is 
+  // enabled, returns that of DenseLUSolver or MatrixFreeGCRODR instead.
+  double getGMRESResidualNorm() const;
+
+  // Returns the number of the factorizations of the Jacobian by 
+  // setDenseJacobian() since the construction of the solver, i.e., how often 
+  // the frozen matrix is refreshed. Returns zero if it is not enabled.
+  int getNumDenseJacobianFactorizations() const;
+
   // Prohibits copy due to memory allocation.
-  MultipleShootingCGMRES(const MultipleShootingCGMRES&) = delete;
-  MultipleShootingCGMRES& operator=(const MultipleShootingCGMRES&) = delete;
+  BasicMultipleShootingCGMRES(const BasicMultipleShootingCGMRES&) = delete;
+  BasicMultipleShootingCGMRES& operator=(const BasicMultipleShootingCGMRES&) 
+      = delete;
 
 private:
-  MultipleShootingContinuation continuation_problem_;
-  MatrixFreeGMRES<MultipleShootingContinuation, const double, const double*, 
-                  const double*, double const* const*, double const* const*> 
-                  mfgmres_;
-  CGMRESInitializer solution_initializer_;
-  const int dim_state_, dim_control_input_, dim_constraints_, N_;
-  double *control_input_and_constraints_seq_, 
-    *control_input_and_constraints_update_seq_, 
-    *initial_control_input_and_constraints_vec_, *initial_lambda_vec_;
-  double **state_mat_, **lambda_mat_;
+  MultipleShootingContinuation<Model, FixedN> continuation_problem_;
+  KrylovMethod<MultipleShootingContinuation<Model, FixedN>, const double, 
+               const double*, const double*, const AlignedMatrix&, 
+               const AlignedMatrix&> mfgmres_;
+  CGMRESInitializer<Model> solution_initializer_;
+  const int dim_state_, dim_control_input_, dim_constraints_, N_, kmax_;
+  HorizonArray<double, HorizonSize(FixedN, Model::dim_control_input()
+                                               +Model::dim_constraints())> 
+      control_input_and_constraints_seq_, 
+      control_input_and_constraints_update_seq_;
+  double initial_control_input_and_constraints_vec_[
+      Model::dim_control_input()+Model::dim_constraints()];
+  double initial_lambda_vec_[Model::dim_state()];
+  HorizonMatrix<FixedN, Model::dim_state()> state_mat_, lambda_mat_;
+  BlockJacobiPreconditioner preconditioner_;
+  int preconditioner_update_period_, num_updates_from_preconditioning_;
+  RiccatiRecursion riccati_recursion_;
+  bool use_riccati_recursion_;
+  DenseLUSolver<MultipleShootingContinuation<Model, FixedN>, const double, 
+                const double*, const double*, const AlignedMatrix&, 
+                const AlignedMatrix&> dense_lu_solver_;
+  bool use_dense_jacobian_;
+  MatrixFreeGCRODR<MultipleShootingContinuation<Model, FixedN>, const double, 
+                   const double*, const double*, const AlignedMatrix&, 
+                   const AlignedMatrix&> recycling_gmres_;
+  bool use_krylov_recycling_;
 };
 
+// The solver with the GMRES method selected by ControlUpdateKrylovMethod, 
+// e.g., MultipleShootingCGMRES<NMPCModel> whose N and kmax are given to the 
+// constructor, or MultipleShootingCGMRES<NMPCModel, 50, 10> whose sequences 
+// over the horizon and the Krylov subspace are sized by N = 50 and kmax = 10 
+// at compile time. 
+template <class Model, int FixedN = kDynamicSize, 
+          int FixedKmax = kDynamicSize>
+using MultipleShootingCGMRES = BasicMultipleShootingCGMRES<
+    Model, 
+    ControlUpdateKrylovMethod<
+        FixedKmax, HorizonSize(FixedN, Model::dim_control_input()
+                                           +Model::dim_constraints())>::
+        template Method, 
+    FixedN>;
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::
+BasicMultipleShootingCGMRES(
+    const double T_f, const double alpha, const int N, 
+    const double finite_difference_increment, const double zeta, const int kmax)
+  : continuation_problem_(T_f, alpha, N, finite_difference_increment, zeta),
+    mfgmres_(continuation_problem_.dim_condensed_problem(), kmax),
+    solution_initializer_(finite_difference_increment, kmax),
+    dim_state_(continuation_problem_.dim_state()),
+    dim_control_input_(continuation_problem_.dim_control_input()),
+    dim_constraints_(continuation_problem_.dim_constraints()),
+    N_(N),
+    kmax_(kmax),
+    control_input_and_constraints_seq_(
+        N*(dim_control_input_+dim_constraints_)),
+    control_input_and_constraints_update_seq_(
+        N*(dim_control_input_+dim_constraints_)),
+    initial_control_input_and_constraints_vec_(),
+    initial_lambda_vec_(),
+    state_mat_(N, dim_state_),
+    lambda_mat_(N, dim_state_),
+    preconditioner_(N, dim_control_input_+dim_constraints_),
+    preconditioner_update_period_(0),
+    num_updates_from_preconditioning_(0),
+    riccati_recursion_(N, dim_state_, dim_control_input_+dim_constraints_),
+    use_riccati_recursion_(false),
+    dense_lu_solver_(continuation_problem_.dim_condensed_problem()),
+    use_dense_jacobian_(false),
+    recycling_gmres_(),
+    use_krylov_recycling_(false) {
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::controlUpdate(
+    const double time, const double* state_vec, const double sampling_period, 
+    double* control_input_vec) {
+  continuation_problem_.syncParameters();
+  if (use_riccati_recursion_) {
+    continuation_problem_.solveLinearProblemByRiccatiRecursion(
+        time, state_vec, control_input_and_constraints_seq_, state_mat_, 
+        lambda_mat_, riccati_recursion_, 
+        control_input_and_constraints_update_seq_);
+    // If a stage is singular, the GMRES method solves the problem of this 
+    // update.
+    if (riccati_recursion_.is_singular()) {
+      mfgmres_.solveLinearProblem(continuation_problem_, time, state_vec,
+                                  control_input_and_constraints_seq_,
+                                  state_mat_, lambda_mat_, 
+                                  control_input_and_constraints_update_seq_);
+    }
+  }
+  else if (use_dense_jacobian_) {
+    dense_lu_solver_.solveLinearProblem(
+        continuation_problem_, time, state_vec, 
+        control_input_and_constraints_seq_, state_mat_, lambda_mat_, 
+        control_input_and_constraints_update_seq_);
+    // If the matrix is singular, the GMRES method solves the problem of this 
+    // update and the matrix is reassembled in the next update.
+    if (dense_lu_solver_.is_singular()) {
+      mfgmres_.solveLinearProblem(continuation_problem_, time, state_vec,
+                                  control_input_and_constraints_seq_,
+                                  state_mat_, lambda_mat_, 
+                                  control_input_and_constraints_update_seq_);
+    }
+  }
+  else if (preconditioner_update_period_ > 0) {
+    if (num_updates_from_preconditioning_ == 0) {
+      continuation_problem_.computeBlockJacobiPreconditioner(
+          time, state_vec, control_input_and_constraints_seq_, state_mat_, 
+          lambda_mat_, preconditioner_);
+    }
+    num_updates_from_preconditioning_ = (num_updates_from_preconditioning_+1) 
+                                        % preconditioner_update_period_;
+    if (use_krylov_recycling_) {
+      recycling_gmres_.solveLinearProblem(
+          preconditioner_, continuation_problem_, time, state_vec, 
+          control_input_and_constraints_seq_, state_mat_, lambda_mat_, 
+          control_input_and_constraints_update_seq_);
+    }
+    else {
+      mfgmres_.solveLinearProblem(preconditioner_, continuation_problem_, 
+                                  time, state_vec, 
+                                  control_input_and_constraints_seq_,
+                                  state_mat_, lambda_mat_, 
+                                  control_input_and_constraints_update_seq_);
+    }
+  }
+  else if (use_krylov_recycling_) {
+    recycling_gmres_.solveLinearProblem(
+        continuation_problem_, time, state_vec, 
+        control_input_and_constraints_seq_, state_mat_, lambda_mat_, 
+        control_input_and_constraints_update_seq_);
+  }
+  else {
+    mfgmres_.solveLinearProblem(continuation_problem_, time, state_vec,
+                                control_input_and_constraints_seq_,
+                                state_mat_, lambda_mat_, 
+                                control_input_and_constraints_update_seq_);
+  }
+  continuation_problem_.integrateSolution(
+      control_input_and_constraints_seq_, state_mat_, lambda_mat_, 
+      control_input_and_constraints_update_seq_, sampling_period);
+  getControlInput(control_input_vec);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::getControlInput(
+    double* control_input_vec) const {
+  for (int i=0; i<dim_control_input_; ++i) {
+    control_input_vec[i] = control_input_and_constraints_seq_[i];
+  }
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::
+setParametersForInitialization(const double* initial_guess_solution, 
+                               const double newton_residual_tolerance, 
+                               const int max_newton_iteration) {
+  solution_initializer_.setInitialGuessSolution(initial_guess_solution);
+  solution_initializer_.setCriterionsOfNewtonTermination(
+      newton_residual_tolerance, max_newton_iteration);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::
+initializeSolution(const double initial_time, const double* initial_state_vec) {
+  continuation_problem_.syncParameters();
+  solution_initializer_.computeInitialSolution(
+      initial_time, initial_state_vec, 
+      initial_control_input_and_constraints_vec_);
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_control_input_+dim_constraints_; ++j) {
+      control_input_and_constraints_seq_[i*(dim_control_input_+dim_constraints_)+j] 
+          = initial_control_input_and_constraints_vec_[j];
+    }
+  }
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_state_; ++j) {
+      state_mat_[i][j] = initial_state_vec[j];
+    }
+  }
+  solution_initializer_.getInitialLambda(initial_time, initial_state_vec, 
+                                       initial_lambda_vec_);
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_state_; ++j) {
+      lambda_mat_[i][j] = initial_lambda_vec_[j];
+    }
+  }
+  continuation_problem_.resetHorizonLength(initial_time);
+  num_updates_from_preconditioning_ = 0;
+  dense_lu_solver_.resetFactorization();
+  recycling_gmres_.resetRecycledSubspace();
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+double BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::getErrorNorm(
+    const double time, const double* state_vec) {
+  return continuation_problem_.computeErrorNorm(
+      time, state_vec, control_input_and_constraints_seq_,state_mat_, 
+      lambda_mat_);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+template <class Parameters>
+void BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::setParameters(
+    const Parameters& parameters) {
+  continuation_problem_.setParameters(parameters);
+  solution_initializer_.setParameters(parameters);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::
+setGMRESTolerance(
+    const double absolute_tolerance, const double relative_tolerance) {
+  mfgmres_.setTolerance(absolute_tolerance, relative_tolerance);
+  recycling_gmres_.setTolerance(absolute_tolerance, relative_tolerance);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::
+setMaxGMRESRestarts(const int max_restarts) {
+  mfgmres_.setMaxRestarts(max_restarts);
+  recycling_gmres_.setMaxRestarts(max_restarts);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::
+setBlockJacobiPreconditioner(const int update_period) {
+  preconditioner_update_period_ = update_period;
+  num_updates_from_preconditioning_ = 0;
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::
+setExactJacobianVectorProduct(const bool exact_jacobian_vector_product) {
+  continuation_problem_.setExactJacobianVectorProduct(
+      exact_jacobian_vector_product);
+  solution_initializer_.setExactJacobianVectorProduct(
+      exact_jacobian_vector_product);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::
+setRiccatiRecursion(const bool use_riccati_recursion) {
+  use_riccati_recursion_ = use_riccati_recursion;
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::setNumThreads(
+    const int num_threads, const int min_N) {
+  continuation_problem_.setNumThreads(num_threads, min_N);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::setThreadPool(
+    StageThreadPool& thread_pool, const int min_N) {
+  continuation_problem_.setThreadPool(thread_pool, min_N);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::setDenseJacobian(
+    const int update_period, const double refresh_tolerance) {
+  use_dense_jacobian_ = (update_period > 0);
+  if (use_dense_jacobian_) {
+    dense_lu_solver_.setUpdatePolicy(update_period, refresh_tolerance);
+  }
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::
+setKrylovRecycling(const int recycle_dim) {
+  use_krylov_recycling_ = (recycle_dim > 0);
+  if (use_krylov_recycling_) {
+    recycling_gmres_.setParameters(
+        continuation_problem_.dim_condensed_problem(), kmax_, recycle_dim);
+  }
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+int BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::
+getGMRESIterations() const {
+  if (use_dense_jacobian_ && !dense_lu_solver_.is_singular()) {
+    return dense_lu_solver_.num_iterations();
+  }
+  if (use_krylov_recycling_ && !use_riccati_recursion_ 
+      && !use_dense_jacobian_) {
+    return recycling_gmres_.num_iterations();
+  }
+  return mfgmres_.num_iterations();
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+double BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::
+getGMRESResidualNorm() const {
+  if (use_dense_jacobian_ && !dense_lu_solver_.is_singular()) {
+    return dense_lu_solver_.residual_norm();
+  }
+  if (use_krylov_recycling_ && !use_riccati_recursion_ 
+      && !use_dense_jacobian_) {
+    return recycling_gmres_.residual_norm();
+  }
+  return mfgmres_.residual_norm();
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+int BasicMultipleShootingCGMRES<Model, KrylovMethod, FixedN>::
+getNumDenseJacobianFactorizations() const {
+  return dense_lu_solver_.num_factorizations();
+}
+
 } // namespace cgmres
 
 
@@ -7,7 +7,11 @@
 
 #include <cmath>
 #include "linear_algebra.hpp"
+#include "aligned_matrix.hpp"
+#include "horizon_storage.hpp"
 #include "multiple_shooting_ocp.hpp"
+#include "block_jacobi_preconditioner.hpp"
+#include "riccati_recursion.hpp"
 
 
 namespace cgmres {
@@ -15,6 +19,7 @@ namespace cgmres {
 // Linear problem of the continuation transformation for the multiple-shooting 
 // optimal control problem, which is solved in Matrix-free GMRES. This class 
 // is intended for use with MatrixfreeGMRES class. 
+template <class Model, int FixedN = kDynamicSize>
 class MultipleShootingContinuation {
 public:
   // Constructs MultipleShootingContinuation with setting parameters and 
@@ -50,13 +55,10 @@ public:
                                const double finite_difference_increment,
                                const double zeta);
 
-  // Free vectors and matrices.
-  ~MultipleShootingContinuation();
-
   // Integrates the solution for given optimal update vector of the solution 
   // and the integration length.
   void integrateSolution(double* control_input_and_constraints_seq, 
-                         double** state_mat, double** lambda_mat,
+                         AlignedMatrix& state_mat, AlignedMatrix& lambda_mat,
                          const double* control_input_and_constraints_update_seq, 
                          const double integration_length);
 
@@ -64,8 +66,8 @@ public:
   // the state_vec and the current solution.
   double computeErrorNorm(const double time, const double* state_vec, 
                           const double* control_input_and_constraints_seq,
-                          double const* const* state_mat, 
-                          double const* const* lambda_mat);
+                          const AlignedMatrix& state_mat, 
+                          const AlignedMatrix& lambda_mat);
 
   // Reset the length of the horizon by resetting parameters related to the 
   // horizon.
@@ -76,21 +78,74 @@ public:
   // horizon.
   void resetHorizonLength(const double initial_time);
 
+  // Copies the runtime parameters of the model into the optimal control 
+  // problem. See OptimalControlProblem::syncParameters().
+  void syncParameters();
+
+  // Sets the parameters of the model of the optimal control problem. See 
+  // OptimalControlProblem::setParameters().
+  template <class Parameters>
+  void setParameters(const Parameters& parameters);
+
   // Computes a vector correspongin to b in Ax=b. This function is called in
   // MatrixfreeGMRES.
   void bFunc(const double time, const double* state_vec, 
              const double* control_input_and_constraints_seq, 
-             double const* const* state_mat, double const* const* lambda_mat,
+             const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat,
              const double* current_control_input_and_constraints_update_seq, 
              double* b_vec);
 
   // Computes a vector correspongin to Ax in Ax=b. This function is called in
-  // MatrixfreeGMRES.
+  // MatrixfreeGMRES. Ax is approximated by the forward difference by default 
+  // and is computed exactly if setExactJacobianVectorProduct(true) is called.
   void AxFunc(const double time, const double* state_vec, 
               const double* control_input_and_constraints_seq, 
-              double const* const* state_mat, double const* const* lambda_mat,
+              const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat,
               const double* direction_vec, double* ax_vec);
 
+  // Computes the blocks of the block-Jacobi preconditioner, i.e., the 
+  // Jacobians of the optimality residual of each stage with respect to the 
+  // control input and the constraints of the stage, by the forward 
+  // difference with the state and lambda fixed, and factorizes them. 
+  void computeBlockJacobiPreconditioner(
+      const double time, const double* state_vec, 
+      const double* control_input_and_constraints_seq, 
+      const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+      BlockJacobiPreconditioner& preconditioner);
+
+  // Updates control_input_and_constraints_update_seq by solving the linear 
+  // problem, whose coefficient matrix and right-hand side are those given by 
+  // AxFunc() and bFunc(), directly by riccati_recursion instead of 
+  // MatrixfreeGMRES. The Jacobians of the stages are computed exactly at the 
+  // condensed trajectory of AxFunc() and the coefficient matrix is 
+  // factorized in every call, so that the linear problem is the same as that 
+  // of MatrixfreeGMRES with the exact Jacobian-vector products. If the 
+  // factorization is singular, control_input_and_constraints_update_seq is 
+  // not changed; see RiccatiRecursion::is_singular().
+  void solveLinearProblemByRiccatiRecursion(
+      const double time, const double* state_vec, 
+      const double* control_input_and_constraints_seq, 
+      const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+      RiccatiRecursion& riccati_recursion, 
+      double* control_input_and_constraints_update_seq);
+
+  // Sets whether AxFunc() computes the product of the Jacobian of the 
+  // condensed optimality residual and the direction exactly by the 
+  // forward-mode automatic differentiation instead of the forward difference 
+  // approximation with finite_difference_increment. The default is false. 
+  // bFunc() and integrateSolution() are not affected.
+  void setExactJacobianVectorProduct(const bool exact_jacobian_vector_product);
+
+  // Sets the number of the threads that evaluate the stages of the horizon 
+  // in parallel if N is greater than or equal to min_N. See 
+  // MultipleShootingOCP::setNumThreads(). The default is one thread.
+  void setNumThreads(const int num_threads, const int min_N);
+
+  // Sets the pool shared with other solvers that evaluates the stages of the 
+  // horizon instead of the threads of setNumThreads(). See 
+  // MultipleShootingOCP::setThreadPool().
+  void setThreadPool(StageThreadPool& thread_pool, const int min_N);
+
   // Returns the dimension of the state.
   int dim_state() const;
 
@@ -113,22 +168,401 @@ public:
       = delete;
 
 private:
-  MultipleShootingOCP ocp_;
+  // The dimension of the sequences of the control input and the constraints 
+  // over the horizon if FixedN is fixed, and kDynamicSize otherwise.
+  static constexpr int kDimSeq = HorizonSize(
+      FixedN, Model::dim_control_input()+Model::dim_constraints());
+
+  MultipleShootingOCP<Model, FixedN> ocp_;
   const int dim_state_, dim_control_input_, dim_constraints_, 
       dim_control_input_and_constraints_, dim_control_input_and_constraints_seq_, 
       N_;
   double finite_difference_increment_, zeta_, incremented_time_; 
-  double *incremented_state_vec_, 
-      *incremented_control_input_and_constraints_seq_, 
-      *control_input_and_constraints_residual_seq_, 
-      *control_input_and_constraints_residual_seq_1_, 
-      *control_input_and_constraints_residual_seq_2_, 
-      *control_input_and_constraints_residual_seq_3_;
-  double **incremented_state_mat_, **incremented_lambda_mat_, 
-      **state_residual_mat_, **state_residual_mat_1_, 
-      **lambda_residual_mat_, **lambda_residual_mat_1_;
+  bool exact_jacobian_vector_product_;
+  double incremented_state_vec_[Model::dim_state()];
+  HorizonArray<double, kDimSeq> incremented_control_input_and_constraints_seq_, 
+      control_input_and_constraints_residual_seq_, 
+      control_input_and_constraints_residual_seq_1_, 
+      control_input_and_constraints_residual_seq_2_, 
+      control_input_and_constraints_residual_seq_3_, b_vec_;
+  HorizonMatrix<FixedN, Model::dim_state()> incremented_state_mat_, 
+      incremented_lambda_mat_, state_residual_mat_, state_residual_mat_1_, 
+      lambda_residual_mat_, lambda_residual_mat_1_;
 };
 
+template <class Model, int FixedN>
+MultipleShootingContinuation<Model, FixedN>::MultipleShootingContinuation(
+    const double T_f, const double alpha, const int N,
+    const double finite_difference_increment, const double zeta)
+  : ocp_(T_f, alpha, N), 
+    dim_state_(ocp_.dim_state()),
+    dim_control_input_(ocp_.dim_control_input()),
+    dim_constraints_(ocp_.dim_constraints()),
+    dim_control_input_and_constraints_(
+        ocp_.dim_control_input()+ocp_.dim_constraints()), 
+    dim_control_input_and_constraints_seq_(
+        N*(ocp_.dim_control_input()+ocp_.dim_constraints())), 
+    N_(N),
+    finite_difference_increment_(finite_difference_increment),
+    zeta_(zeta),
+    incremented_time_(0),
+    exact_jacobian_vector_product_(false),
+    incremented_state_vec_(),
+    incremented_control_input_and_constraints_seq_(
+      dim_control_input_and_constraints_seq_),
+    control_input_and_constraints_residual_seq_(
+      dim_control_input_and_constraints_seq_),
+    control_input_and_constraints_residual_seq_1_(
+      dim_control_input_and_constraints_seq_),
+    control_input_and_constraints_residual_seq_2_(
+      dim_control_input_and_constraints_seq_),
+    control_input_and_constraints_residual_seq_3_(
+      dim_control_input_and_constraints_seq_),
+    b_vec_(dim_control_input_and_constraints_seq_),
+    incremented_state_mat_(N_, dim_state_),
+    incremented_lambda_mat_(N_, dim_state_),
+    state_residual_mat_(N_, dim_state_),
+    state_residual_mat_1_(N_, dim_state_),
+    lambda_residual_mat_(N_, dim_state_),
+    lambda_residual_mat_1_(N_, dim_state_) {
+}
+
+template <class Model, int FixedN>
+MultipleShootingContinuation<Model, FixedN>::MultipleShootingContinuation(
+    const double T_f, const double alpha, const int N,
+    const double initial_time,
+    const double finite_difference_increment, const double zeta)
+  : ocp_(T_f, alpha, N, initial_time), 
+    dim_state_(ocp_.dim_state()),
+    dim_control_input_(ocp_.dim_control_input()),
+    dim_constraints_(ocp_.dim_constraints()),
+    dim_control_input_and_constraints_(
+        ocp_.dim_control_input()+ocp_.dim_constraints()), 
+    dim_control_input_and_constraints_seq_(
+        N*(ocp_.dim_control_input()+ocp_.dim_constraints())), 
+    N_(N),
+    finite_difference_increment_(finite_difference_increment),
+    zeta_(zeta),
+    incremented_time_(0),
+    exact_jacobian_vector_product_(false),
+    incremented_state_vec_(),
+    incremented_control_input_and_constraints_seq_(
+      dim_control_input_and_constraints_seq_),
+    control_input_and_constraints_residual_seq_(
+      dim_control_input_and_constraints_seq_),
+    control_input_and_constraints_residual_seq_1_(
+      dim_control_input_and_constraints_seq_),
+    control_input_and_constraints_residual_seq_2_(
+      dim_control_input_and_constraints_seq_),
+    control_input_and_constraints_residual_seq_3_(
+      dim_control_input_and_constraints_seq_),
+    b_vec_(dim_control_input_and_constraints_seq_),
+    incremented_state_mat_(N_, dim_state_),
+    incremented_lambda_mat_(N_, dim_state_),
+    state_residual_mat_(N_, dim_state_),
+    state_residual_mat_1_(N_, dim_state_),
+    lambda_residual_mat_(N_, dim_state_),
+    lambda_residual_mat_1_(N_, dim_state_) {
+}
+
+template <class Model, int FixedN>
+void MultipleShootingContinuation<Model, FixedN>::integrateSolution(
+    double* control_input_and_constraints_seq, 
+    AlignedMatrix& state_mat, AlignedMatrix& lambda_mat,
+    const double* control_input_and_constraints_update_seq, 
+    const double integration_length) {
+  // Update state_mat_ and lamdba_mat_ by the difference approximation.
+  linearalgebra::ScaledSum(dim_control_input_and_constraints_seq_, 
+                           control_input_and_constraints_seq, 
+                           finite_difference_increment_, 
+                           control_input_and_constraints_update_seq, 
+                           incremented_control_input_and_constraints_seq_);
+  for (int i=0; i<state_residual_mat_1_.size(); ++i) {
+    state_residual_mat_1_.data()[i] = (1-finite_difference_increment_*zeta_) 
+                                      * state_residual_mat_.data()[i];
+  }
+  for (int i=0; i<lambda_residual_mat_1_.size(); ++i) {
+    lambda_residual_mat_1_.data()[i] = (1-finite_difference_increment_*zeta_) 
+                                       * lambda_residual_mat_.data()[i];
+  }
+  ocp_.computeStateAndLambdaFromOptimalityResidual(
+      incremented_time_, incremented_state_vec_, 
+      incremented_control_input_and_constraints_seq_, state_residual_mat_1_, 
+      lambda_residual_mat_1_, incremented_state_mat_, incremented_lambda_mat_);
+  // state_mat_ += 
+  //     (sampling_period/finite_difference_step_) 
+  //     * (incremented_state_mat_-state_mat_);
+  for (int i=0; i<state_mat.size(); ++i) {
+    state_mat.data()[i] 
+        += (integration_length/finite_difference_increment_) 
+            * (incremented_state_mat_.data()[i]-state_mat.data()[i]);
+  }
+  // lambda_mat_ += 
+  //     (sampling_period/finite_difference_step_) 
+  //     * (incremented_lambda_mat_-lambda_mat_);
+  for (int i=0; i<lambda_mat.size(); ++i) {
+    lambda_mat.data()[i] 
+        += (integration_length/finite_difference_increment_) 
+            * (incremented_lambda_mat_.data()[i]-lambda_mat.data()[i]);
+  }
+  // Update control_input_and_constraints_seq_
+  linearalgebra::AddScaledVector(dim_control_input_and_constraints_seq_, 
+                                 integration_length, 
+                                 control_input_and_constraints_update_seq, 
+                                 control_input_and_constraints_seq);
+}
+
+template <class Model, int FixedN>
+double MultipleShootingContinuation<Model, FixedN>::computeErrorNorm(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq,
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat) {
+  ocp_.computeOptimalityResidual(
+      time, state_vec, control_input_and_constraints_seq, 
+      state_mat, lambda_mat, control_input_and_constraints_residual_seq_, 
+      state_residual_mat_, lambda_residual_mat_);
+  double squared_error_norm 
+      = linearalgebra::SquaredNorm(
+            dim_control_input_and_constraints_seq_, 
+            control_input_and_constraints_residual_seq_);
+  for (int i=0; i<N_; ++i) {
+    squared_error_norm 
+        += linearalgebra::SquaredNorm(dim_state_, state_residual_mat_[i]);
+  }
+  for (int i=0; i<N_; ++i) {
+    squared_error_norm 
+        += linearalgebra::SquaredNorm(dim_state_, lambda_residual_mat_[i]);
+  }
+  return std::sqrt(squared_error_norm);
+}
+
+template <class Model, int FixedN>
+void MultipleShootingContinuation<Model, FixedN>::resetHorizonLength(
+    const double T_f, const double alpha, const double initial_time) {
+  ocp_.resetHorizonLength(T_f, alpha, initial_time);
+}
+
+template <class Model, int FixedN>
+void MultipleShootingContinuation<Model, FixedN>::resetHorizonLength(
+    const double initial_time) {
+  ocp_.resetHorizonLength(initial_time);
+}
+
+template <class Model, int FixedN>
+void MultipleShootingContinuation<Model, FixedN>::syncParameters() {
+  ocp_.syncParameters();
+}
+
+template <class Model, int FixedN>
+template <class Parameters>
+void MultipleShootingContinuation<Model, FixedN>::setParameters(
+    const Parameters& parameters) {
+  ocp_.setParameters(parameters);
+}
+
+template <class Model, int FixedN>
+void MultipleShootingContinuation<Model, FixedN>::bFunc(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq,
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat,
+    const double* current_control_input_and_constraints_update_seq, 
+    double* b_vec) {
+  incremented_time_ = time + finite_difference_increment_;
+  ocp_.predictStateFromSolution(time, state_vec, 
+                                control_input_and_constraints_seq,
+                                finite_difference_increment_, 
+                                incremented_state_vec_);
+  ocp_.computeOptimalityResidual(
+      time, state_vec, control_input_and_constraints_seq, state_mat, lambda_mat, 
+      control_input_and_constraints_residual_seq_, state_residual_mat_, 
+      lambda_residual_mat_);
+  for (int i=0; i<state_residual_mat_1_.size(); ++i) {
+    state_residual_mat_1_.data()[i] = (1-finite_difference_increment_*zeta_) 
+                                      * state_residual_mat_.data()[i];
+  }
+  for (int i=0; i<lambda_residual_mat_1_.size(); ++i) {
+    lambda_residual_mat_1_.data()[i] = (1-finite_difference_increment_*zeta_) 
+                                       * lambda_residual_mat_.data()[i];
+  }
+  ocp_.computeCondensedOptimalityResidual(
+    incremented_time_, incremented_state_vec_, 
+    control_input_and_constraints_seq, 
+    state_residual_mat_1_, lambda_residual_mat_1_, 
+    incremented_state_mat_, incremented_lambda_mat_, 
+    control_input_and_constraints_residual_seq_3_);
+  ocp_.computeOptimalityResidual(
+    incremented_time_, incremented_state_vec_, 
+    control_input_and_constraints_seq, 
+    state_mat, lambda_mat, control_input_and_constraints_residual_seq_1_, 
+    state_residual_mat_1_, lambda_residual_mat_1_);
+  linearalgebra::ScaledSum(dim_control_input_and_constraints_seq_, 
+                           control_input_and_constraints_seq, 
+                           finite_difference_increment_, 
+                           current_control_input_and_constraints_update_seq, 
+                           incremented_control_input_and_constraints_seq_);
+  ocp_.computeCondensedOptimalityResidual(
+    incremented_time_, incremented_state_vec_, 
+    incremented_control_input_and_constraints_seq_, state_residual_mat_1_, 
+    lambda_residual_mat_1_, incremented_state_mat_, incremented_lambda_mat_, 
+    control_input_and_constraints_residual_seq_2_);
+  for (int i=0; i<dim_control_input_and_constraints_seq_; ++i) {
+    b_vec[i] = 
+        (1/finite_difference_increment_-zeta_) 
+        * control_input_and_constraints_residual_seq_[i] 
+        - control_input_and_constraints_residual_seq_3_[i] 
+            / finite_difference_increment_ 
+        - (control_input_and_constraints_residual_seq_2_[i]
+           -control_input_and_constraints_residual_seq_1_[i])
+        / finite_difference_increment_;
+  }
+}
+
+template <class Model, int FixedN>
+void MultipleShootingContinuation<Model, FixedN>::AxFunc(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat,
+    const double* direction_vec, double* ax_vec) {
+  if (exact_jacobian_vector_product_) {
+    ocp_.computeCondensedOptimalityResidualDirectionalDerivative(
+        incremented_time_, incremented_state_vec_, 
+        control_input_and_constraints_seq, state_residual_mat_1_, 
+        lambda_residual_mat_1_, direction_vec, ax_vec);
+    return;
+  }
+  linearalgebra::ScaledSum(dim_control_input_and_constraints_seq_, 
+                           control_input_and_constraints_seq, 
+                           finite_difference_increment_, 
+                           direction_vec, 
+                           incremented_control_input_and_constraints_seq_);
+  ocp_.computeCondensedOptimalityResidual(
+      incremented_time_, incremented_state_vec_, 
+      incremented_control_input_and_constraints_seq_, state_residual_mat_1_, 
+      lambda_residual_mat_1_, incremented_state_mat_, incremented_lambda_mat_, 
+      control_input_and_constraints_residual_seq_2_);
+  for (int i=0; i<dim_control_input_and_constraints_seq_; ++i) {
+    ax_vec[i] = (control_input_and_constraints_residual_seq_2_[i]
+                    -control_input_and_constraints_residual_seq_1_[i]) 
+                    / finite_difference_increment_;
+  }
+}
+
+template <class Model, int FixedN>
+void MultipleShootingContinuation<Model, FixedN>::
+computeBlockJacobiPreconditioner(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+    BlockJacobiPreconditioner& preconditioner) {
+  ocp_.computeOptimalityResidualForControlInputAndConstraints(
+      time, state_vec, control_input_and_constraints_seq, state_mat, lambda_mat, 
+      control_input_and_constraints_residual_seq_);
+  // The residual of each stage depends only on the control input and the 
+  // constraints of the stage under the fixed state and lambda. Therefore, the 
+  // same column of all blocks is computed by perturbing all stages at once.
+  for (int j=0; j<dim_control_input_and_constraints_; ++j) {
+    for (int i=0; i<dim_control_input_and_constraints_seq_; ++i) {
+      incremented_control_input_and_constraints_seq_[i] 
+          = control_input_and_constraints_seq[i];
+    }
+    for (int i=0; i<N_; ++i) {
+      incremented_control_input_and_constraints_seq_[
+          i*dim_control_input_and_constraints_+j] 
+          += finite_difference_increment_;
+    }
+    ocp_.computeOptimalityResidualForControlInputAndConstraints(
+        time, state_vec, incremented_control_input_and_constraints_seq_, 
+        state_mat, lambda_mat, control_input_and_constraints_residual_seq_2_);
+    for (int i=0; i<dim_control_input_and_constraints_seq_; ++i) {
+      control_input_and_constraints_residual_seq_2_[i] 
+          = (control_input_and_constraints_residual_seq_2_[i]
+              -control_input_and_constraints_residual_seq_[i]) 
+            / finite_difference_increment_;
+    }
+    preconditioner.setColumnOfBlocks(
+        j, control_input_and_constraints_residual_seq_2_);
+  }
+  preconditioner.factorize();
+}
+
+template <class Model, int FixedN>
+void MultipleShootingContinuation<Model, FixedN>::
+solveLinearProblemByRiccatiRecursion(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+    RiccatiRecursion& riccati_recursion, 
+    double* control_input_and_constraints_update_seq) {
+  // b_vec_ is the residual of the linear problem under the current update as 
+  // the initial residual of MatrixfreeGMRES. 
+  bFunc(time, state_vec, control_input_and_constraints_seq, state_mat, 
+        lambda_mat, control_input_and_constraints_update_seq, b_vec_);
+  // The stages are linearized at the condensed trajectory at which AxFunc() 
+  // differentiates the condensed optimality residual, i.e., the state and 
+  // lambda under state_residual_mat_1_ and lambda_residual_mat_1_ from the 
+  // incremented time and state.
+  ocp_.computeStateAndLambdaFromOptimalityResidual(
+      incremented_time_, incremented_state_vec_, 
+      control_input_and_constraints_seq, state_residual_mat_1_, 
+      lambda_residual_mat_1_, incremented_state_mat_, incremented_lambda_mat_);
+  ocp_.computeStageJacobians(incremented_time_, incremented_state_vec_, 
+                             control_input_and_constraints_seq, 
+                             incremented_state_mat_, incremented_lambda_mat_, 
+                             riccati_recursion);
+  riccati_recursion.factorize();
+  if (riccati_recursion.is_singular()) {
+    return;
+  }
+  riccati_recursion.solve(b_vec_, 
+                          incremented_control_input_and_constraints_seq_);
+  linearalgebra::AddScaledVector(dim_control_input_and_constraints_seq_, 1, 
+                                 incremented_control_input_and_constraints_seq_, 
+                                 control_input_and_constraints_update_seq);
+}
+
+template <class Model, int FixedN>
+void MultipleShootingContinuation<Model, FixedN>::setExactJacobianVectorProduct(
+    const bool exact_jacobian_vector_product) {
+  exact_jacobian_vector_product_ = exact_jacobian_vector_product;
+}
+
+template <class Model, int FixedN>
+void MultipleShootingContinuation<Model, FixedN>::setNumThreads(
+    const int num_threads, const int min_N) {
+  ocp_.setNumThreads(num_threads, min_N);
+}
+
+template <class Model, int FixedN>
+void MultipleShootingContinuation<Model, FixedN>::setThreadPool(
+    StageThreadPool& thread_pool, const int min_N) {
+  ocp_.setThreadPool(thread_pool, min_N);
+}
+
+template <class Model, int FixedN>
+int MultipleShootingContinuation<Model, FixedN>::dim_state() const {
+  return dim_state_;
+}
+
+template <class Model, int FixedN>
+int MultipleShootingContinuation<Model, FixedN>::dim_control_input() const {
+  return dim_control_input_;
+}
+
+template <class Model, int FixedN>
+int MultipleShootingContinuation<Model, FixedN>::dim_constraints() const {
+  return dim_constraints_;
+}
+
+template <class Model, int FixedN>
+int MultipleShootingContinuation<Model, FixedN>::dim_condensed_problem() const {
+  return dim_control_input_and_constraints_seq_;
+}
+
+template <class Model, int FixedN>
+int MultipleShootingContinuation<Model, FixedN>::N() const {
+  return ocp_.N();
+}
+
 } // namespace cgmres
 
 
@@ -8,6 +8,11 @@
 #include "optimal_control_problem.hpp"
 #include "time_varying_smooth_horizon.hpp"
 #include "linear_algebra.hpp"
+#include "aligned_matrix.hpp"
+#include "horizon_storage.hpp"
+#include "dual_number.hpp"
+#include "stage_thread_pool.hpp"
+#include "riccati_recursion.hpp"
 
 
 namespace cgmres {
@@ -15,7 +20,8 @@ namespace cgmres {
 // This class provides multiple-shooting two-point boundary-value problem of 
 // the finite-horizon optimal control problem. Functions for condensing of the 
 // solution are also provided.
-class MultipleShootingOCP final : public OptimalControlProblem {
+template <class Model, int FixedN = kDynamicSize>
+class MultipleShootingOCP final : public OptimalControlProblem<Model> {
 public:
   // Constructs MultipleShootingOCP with setting parameters and allocates 
   // vectors and matrices.
@@ -35,9 +41,6 @@ public:
   MultipleShootingOCP(const double T_f, const double alpha, const int N,
                       const double initial_time);
 
-  // Free vectors and matrices.
-  ~MultipleShootingOCP();
-
   // Computes the optimaliy residual with respect to the control input and the 
   // equality constraints under time, state_vec, and solution_vec 
   // that represents the control input sequence. The result is stored in 
@@ -45,7 +48,7 @@ public:
   void computeOptimalityResidualForControlInputAndConstraints(
     const double time, const double* state_vec, 
     const double* control_input_and_constraints_seq, 
-    double const* const* state_mat, double const* const* lambda_mat, 
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
     double* optimality_redisual_for_control_input_and_constraints);
 
   // Computes the optimaliy residual with respect to the state and lambda,
@@ -56,9 +59,26 @@ public:
   void computeOptimalityResidualForStateAndLambda(
     const double time, const double* state_vec, 
     const double* control_input_and_constraints_seq, 
-    double const* const* state_mat, double const* const* lambda_mat, 
-    double** optimality_residual_for_state, 
-    double** optimality_residual_for_lambda);
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+    AlignedMatrix& optimality_residual_for_state, 
+    AlignedMatrix& optimality_residual_for_lambda);
+
+  // Computes the optimality residuals with respect to the control input and 
+  // the equality constraints, the state, and lambda at once. The results are 
+  // the same as those of 
+  // computeOptimalityResidualForControlInputAndConstraints() and 
+  // computeOptimalityResidualForStateAndLambda(), but the horizon is swept 
+  // only once forward and once backward. If Model provides 
+  // hamiltonianDerivativesFunc(), the state equation and the partial 
+  // derivatives of the Hamiltonian of each stage are computed by one call of 
+  // it in one sweep.
+  void computeOptimalityResidual(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+    double* optimality_residual_for_control_input_and_constraints, 
+    AlignedMatrix& optimality_residual_for_state, 
+    AlignedMatrix& optimality_residual_for_lambda);
 
   // Computes the state and lambda, the Lagrange multiplier with respect to 
   // the state equation from the optimality residual with respect to the state 
@@ -67,9 +87,56 @@ public:
   void computeStateAndLambdaFromOptimalityResidual(
     const double time, const double* state_vec, 
     const double* control_input_and_constraints_seq, 
-    double const* const* optimality_residual_for_state,
-    double const* const* optimality_residual_for_lambda,
-    double** state_mat, double** lambda_mat);
+    const AlignedMatrix& optimality_residual_for_state,
+    const AlignedMatrix& optimality_residual_for_lambda,
+    AlignedMatrix& state_mat, AlignedMatrix& lambda_mat);
+
+  // Computes the state and lambda from the optimality residuals with respect 
+  // to the state and lambda as computeStateAndLambdaFromOptimalityResidual() 
+  // and the optimality residual with respect to the control input and the 
+  // equality constraints under them as 
+  // computeOptimalityResidualForControlInputAndConstraints(). The latter 
+  // of each stage is computed in the backward sweep as soon as lambda of the 
+  // stage is obtained, so that the horizon is swept only once forward and 
+  // once backward. The results are the same as those of the separate 
+  // functions.
+  void computeCondensedOptimalityResidual(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& optimality_residual_for_state,
+    const AlignedMatrix& optimality_residual_for_lambda,
+    AlignedMatrix& state_mat, AlignedMatrix& lambda_mat, 
+    double* optimality_residual_for_control_input_and_constraints);
+
+  // Computes the directional derivative of the condensed optimality residual 
+  // with respect to the control input and the equality constraints along 
+  // direction_vec. The condensed optimality residual is the optimality 
+  // residual with respect to the control input and the constraints under the 
+  // state and lambda given by computeStateAndLambdaFromOptimalityResidual() 
+  // from control_input_and_constraints_seq, optimality_residual_for_state, 
+  // and optimality_residual_for_lambda. The derivative is computed exactly by 
+  // the forward-mode automatic differentiation, i.e., by computing the 
+  // condensed optimality residual with the dual numbers. The result is 
+  // stored in optimality_residual_derivative.
+  void computeCondensedOptimalityResidualDirectionalDerivative(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& optimality_residual_for_state,
+    const AlignedMatrix& optimality_residual_for_lambda,
+    const double* direction_vec, double* optimality_residual_derivative);
+
+  // Computes the Jacobians of the state equation and the partial derivatives 
+  // of the Hamiltonian of each stage with respect to the state, the control 
+  // input and the constraints, and lambda of the stage, and the Hessian of 
+  // the terminal cost, under time, state_vec, 
+  // control_input_and_constraints_seq, state_mat, and lambda_mat. They are 
+  // computed exactly by the forward-mode automatic differentiation and set 
+  // in riccati_recursion. 
+  void computeStageJacobians(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+    RiccatiRecursion& riccati_recursion);
 
   // Predicts the state in the finite future. Under time,state_vec, and 
   // solution_vec that represents the control input sequence., and 
@@ -80,6 +147,31 @@ public:
                                 const double prediction_length,
                                 double* predicted_state);
 
+  // Sets the number of the threads that evaluate the stages of the horizon 
+  // in parallel in computeOptimalityResidual(), 
+  // computeOptimalityResidualForControlInputAndConstraints(), 
+  // computeOptimalityResidualForStateAndLambda(), and 
+  // computeCondensedOptimalityResidual(). The threads are used only if N is 
+  // greater than or equal to min_N because the synchronization of the threads 
+  // does not pay for short horizons. The threads are created here and persist 
+  // until the next call or the destruction. The results are the same as 
+  // those of the serial evaluation. The recursions of the state and lambda 
+  // in computeStateAndLambdaFromOptimalityResidual() and 
+  // computeCondensedOptimalityResidualDirectionalDerivative() are always 
+  // serial. The default is one thread.
+  void setNumThreads(const int num_threads, const int min_N);
+
+  // Sets the pool whose threads evaluate the stages of the horizon as 
+  // setNumThreads() instead of the threads owned by this object, so that 
+  // the solvers of several models can share one pool. thread_pool is used 
+  // only if N is greater than or equal to min_N. Its number of the threads 
+  // must be set before this call and must not be changed while it is 
+  // shared. Since StageThreadPool::parallelFor() must not be called 
+  // concurrently, the solvers sharing thread_pool must be updated one after 
+  // another, e.g., in one control loop. thread_pool must outlive this 
+  // object or be replaced by the next call of setNumThreads().
+  void setThreadPool(StageThreadPool& thread_pool, const int min_N);
+
   // Reset the length of the horizon by resetting parameters related to the 
   // horizon.
   void resetHorizonLength(const double initial_time);
@@ -97,11 +189,718 @@ public:
   int N() const;
 
 private:
+  using OptimalControlProblem<Model>::model_;
+  using OptimalControlProblem<Model>::dim_state_;
+  using OptimalControlProblem<Model>::dim_control_input_;
+  using OptimalControlProblem<Model>::dim_constraints_;
+  using OptimalControlProblem<Model>::dim_control_input_and_constraints_;
+
   TimeVaryingSmoothHorizon horizon_;
   int dim_solution_, N_;
-  double *dx_vec_;
+  // The work vectors of a stage are sized by the compile-time dimensions of 
+  // Model.
+  double dx_vec_[dim_state_], hx_vec_[dim_state_];
+  // The sequences over the horizon are sized by FixedN if it is fixed.
+  HorizonArray<double, HorizonSize(FixedN, 1, 1)> tau_vec_;
+  HorizonArray<double, HorizonSize(FixedN, 1)> backward_tau_vec_;
+  HorizonArray<Dual, HorizonSize(FixedN, dim_control_input_and_constraints_)> 
+      dual_control_input_and_constraints_seq_;
+  Dual dual_state_vec_[dim_state_];
+  HorizonArray<Dual, HorizonSize(FixedN, dim_state_)> dual_state_mat_, 
+      dual_lambda_mat_;
+  Dual dual_dx_vec_[dim_state_], 
+      dual_hu_vec_[dim_control_input_and_constraints_];
+  StageThreadPool own_thread_pool_;
+  StageThreadPool* thread_pool_;
+  AlignedMatrix thread_dx_mat_, thread_hx_mat_, stage_jacobian_mat_, 
+      terminal_jacobian_mat_;
+
+  // Computes the times of the stages in the forward sweep, tau_vec_, and 
+  // those in the backward sweep, backward_tau_vec_. They are accumulated in 
+  // the same order as the serial sweeps so that the parallel evaluation gives 
+  // the same results. backward_tau_vec_[0] is not used by the residual but by 
+  // the rows of the stage Jacobian of the initial stage.
+  void computeStageTimes(const double time, const double delta_tau);
+
+  // Computes the optimality residual for the state of the stage-th stage and 
+  // that for lambda of the previous stage at the times given by 
+  // computeStageTimes(). dx_vec is the workspace of the calling thread.
+  void computeOptimalityResidualForStateAndLambdaOfStage(
+      const int stage, const double delta_tau, const double* state_vec, 
+      const double* control_input_and_constraints_seq, 
+      const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+      double* dx_vec, AlignedMatrix& optimality_residual_for_state, 
+      AlignedMatrix& optimality_residual_for_lambda);
 };
 
+template <class Model, int FixedN>
+MultipleShootingOCP<Model, FixedN>::MultipleShootingOCP(
+    const double T_f, const double alpha, const int N)
+  : OptimalControlProblem<Model>(),
+    horizon_(T_f, alpha),
+    dim_solution_(N*(model_.dim_control_input()+model_.dim_constraints())),
+    N_(N),
+    dx_vec_(),
+    hx_vec_(),
+    tau_vec_(N+1),
+    backward_tau_vec_(N),
+    dual_control_input_and_constraints_seq_(dim_solution_),
+    dual_state_vec_(),
+    dual_state_mat_(N*model_.dim_state()),
+    dual_lambda_mat_(N*model_.dim_state()),
+    dual_dx_vec_(),
+    dual_hu_vec_(),
+    own_thread_pool_(),
+    thread_pool_(&own_thread_pool_),
+    thread_dx_mat_(1, model_.dim_state()),
+    thread_hx_mat_(1, model_.dim_state()),
+    stage_jacobian_mat_(2*model_.dim_state()+dim_control_input_and_constraints_, 
+                        2*model_.dim_state()+dim_control_input_and_constraints_),
+    terminal_jacobian_mat_(model_.dim_state(), model_.dim_state()) {
+}
+
+template <class Model, int FixedN>
+MultipleShootingOCP<Model, FixedN>::MultipleShootingOCP(
+    const double T_f, const double alpha, const int N, 
+    const double initial_time)
+  : OptimalControlProblem<Model>(),
+    horizon_(T_f, alpha, initial_time),
+    dim_solution_(N*(model_.dim_control_input()+model_.dim_constraints())),
+    N_(N),
+    dx_vec_(),
+    hx_vec_(),
+    tau_vec_(N+1),
+    backward_tau_vec_(N),
+    dual_control_input_and_constraints_seq_(dim_solution_),
+    dual_state_vec_(),
+    dual_state_mat_(N*model_.dim_state()),
+    dual_lambda_mat_(N*model_.dim_state()),
+    dual_dx_vec_(),
+    dual_hu_vec_(),
+    own_thread_pool_(),
+    thread_pool_(&own_thread_pool_),
+    thread_dx_mat_(1, model_.dim_state()),
+    thread_hx_mat_(1, model_.dim_state()),
+    stage_jacobian_mat_(2*model_.dim_state()+dim_control_input_and_constraints_, 
+                        2*model_.dim_state()+dim_control_input_and_constraints_),
+    terminal_jacobian_mat_(model_.dim_state(), model_.dim_state()) {
+}
+
+template <class Model, int FixedN>
+void MultipleShootingOCP<Model, FixedN>::
+computeOptimalityResidualForControlInputAndConstraints(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+    double* optimality_redisual_for_control_input_and_constraints) {
+  // Set the length of the horizon and discretize the horizon.
+  double horizon_length = horizon_.getLength(time);
+  double delta_tau = horizon_length / N_;
+  if (thread_pool_->num_threads() > 1) {
+    computeStageTimes(time, delta_tau);
+    thread_pool_->parallelFor(0, N_, 
+        [&](const int /*thread_index*/, const int begin, const int end) {
+      for (int i=begin; i<end; ++i) {
+        int i_total = i * dim_control_input_and_constraints_;
+        model_.huFunc(
+            tau_vec_[i], (i == 0) ? state_vec : state_mat[i-1], 
+            &(control_input_and_constraints_seq[i_total]), lambda_mat[i], 
+            &(optimality_redisual_for_control_input_and_constraints[i_total]));
+      }
+    });
+    return;
+  }
+  // Compute optimality error for control input and constraints.
+  model_.huFunc(
+      time, state_vec, control_input_and_constraints_seq, 
+      lambda_mat[0], 
+      optimality_redisual_for_control_input_and_constraints);
+  double tau = time + delta_tau;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.huFunc(
+        tau, state_mat[i-1], &(control_input_and_constraints_seq[i_total]), 
+        lambda_mat[i], 
+        &(optimality_redisual_for_control_input_and_constraints[i_total]));
+  }
+}
+
+template <class Model, int FixedN>
+void MultipleShootingOCP<Model, FixedN>::
+computeOptimalityResidualForStateAndLambda(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+    AlignedMatrix& optimality_residual_for_state, 
+    AlignedMatrix& optimality_residual_for_lambda) {
+  // Set the length of the horizon and discretize the horizon.
+  double horizon_length = horizon_.getLength(time);
+  double delta_tau = horizon_length / N_;
+  if (thread_pool_->num_threads() > 1) {
+    computeStageTimes(time, delta_tau);
+    thread_pool_->parallelFor(0, N_, 
+        [&](const int thread_index, const int begin, const int end) {
+      for (int i=begin; i<end; ++i) {
+        computeOptimalityResidualForStateAndLambdaOfStage(
+            i, delta_tau, state_vec, control_input_and_constraints_seq, 
+            state_mat, lambda_mat, thread_dx_mat_[thread_index], 
+            optimality_residual_for_state, optimality_residual_for_lambda);
+      }
+    });
+    model_.phixFunc(tau_vec_[N_], state_mat[N_-1], dx_vec_);
+    for (int i=0; i<dim_state_; ++i) {
+      optimality_residual_for_lambda[N_-1][i] 
+          = lambda_mat[N_-1][i] - dx_vec_[i];
+    }
+    return;
+  }
+  // Compute optimality error for state.
+  model_.stateFunc(time, state_vec, control_input_and_constraints_seq, dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    optimality_residual_for_state[0][i] = 
+        state_mat[0][i] - state_vec[i] - delta_tau * dx_vec_[i];
+  }
+  double tau = time + delta_tau;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.stateFunc(tau, state_mat[i-1], 
+                     &(control_input_and_constraints_seq[i_total]), dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      optimality_residual_for_state[i][j] = 
+          state_mat[i][j] - state_mat[i-1][j] - delta_tau * dx_vec_[j];
+    }
+  }
+  // Compute optimality error for lambda.
+  model_.phixFunc(tau, state_mat[N_-1], dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    optimality_residual_for_lambda[N_-1][i] = lambda_mat[N_-1][i] - dx_vec_[i];
+  }
+  for (int i=N_-1; i>=1; --i, tau-=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.hxFunc(tau, state_mat[i-1], 
+                  &(control_input_and_constraints_seq[i_total]), 
+                  lambda_mat[i], dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      optimality_residual_for_lambda[i-1][j] = 
+          lambda_mat[i-1][j] - lambda_mat[i][j] - delta_tau * dx_vec_[j];
+    }
+  }
+}
+
+template <class Model, int FixedN>
+void MultipleShootingOCP<Model, FixedN>::computeOptimalityResidual(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+    double* optimality_residual_for_control_input_and_constraints, 
+    AlignedMatrix& optimality_residual_for_state, 
+    AlignedMatrix& optimality_residual_for_lambda) {
+  // Set the length of the horizon and discretize the horizon.
+  double horizon_length = horizon_.getLength(time);
+  double delta_tau = horizon_length / N_;
+  if (thread_pool_->num_threads() > 1) {
+    computeStageTimes(time, delta_tau);
+    thread_pool_->parallelFor(0, N_, 
+        [&](const int thread_index, const int begin, const int end) {
+      for (int i=begin; i<end; ++i) {
+        int i_total = i * dim_control_input_and_constraints_;
+        if (modeltraits::HasHamiltonianDerivativesFunc<Model>::value
+            && i > 0) {
+          double* dx_vec = thread_dx_mat_[thread_index];
+          double* hx_vec = thread_hx_mat_[thread_index];
+          modeltraits::HamiltonianDerivativesFunc(
+              model_, tau_vec_[i], backward_tau_vec_[i], state_mat[i-1], 
+              &(control_input_and_constraints_seq[i_total]), lambda_mat[i], 
+              dx_vec, hx_vec, 
+              &(optimality_residual_for_control_input_and_constraints[i_total]));
+          for (int j=0; j<dim_state_; ++j) {
+            optimality_residual_for_state[i][j] = 
+                state_mat[i][j] - state_mat[i-1][j] - delta_tau * dx_vec[j];
+          }
+          for (int j=0; j<dim_state_; ++j) {
+            optimality_residual_for_lambda[i-1][j] = 
+                lambda_mat[i-1][j] - lambda_mat[i][j] - delta_tau * hx_vec[j];
+          }
+          continue;
+        }
+        computeOptimalityResidualForStateAndLambdaOfStage(
+            i, delta_tau, state_vec, control_input_and_constraints_seq, 
+            state_mat, lambda_mat, thread_dx_mat_[thread_index], 
+            optimality_residual_for_state, optimality_residual_for_lambda);
+        model_.huFunc(
+            tau_vec_[i], (i == 0) ? state_vec : state_mat[i-1], 
+            &(control_input_and_constraints_seq[i_total]), lambda_mat[i], 
+            &(optimality_residual_for_control_input_and_constraints[i_total]));
+      }
+    });
+    model_.phixFunc(tau_vec_[N_], state_mat[N_-1], dx_vec_);
+    for (int i=0; i<dim_state_; ++i) {
+      optimality_residual_for_lambda[N_-1][i] 
+          = lambda_mat[N_-1][i] - dx_vec_[i];
+    }
+    return;
+  }
+  if (modeltraits::HasHamiltonianDerivativesFunc<Model>::value) {
+    // The first stage has no optimality residual for lambda.
+    model_.stateFunc(time, state_vec, control_input_and_constraints_seq, 
+                     dx_vec_);
+    for (int i=0; i<dim_state_; ++i) {
+      optimality_residual_for_state[0][i] = 
+          state_mat[0][i] - state_vec[i] - delta_tau * dx_vec_[i];
+    }
+    model_.huFunc(time, state_vec, control_input_and_constraints_seq, 
+                  lambda_mat[0], 
+                  optimality_residual_for_control_input_and_constraints);
+    // Compute the optimality residuals of the other stages with the state 
+    // equation and the partial derivatives of the Hamiltonian at once. The 
+    // partial derivative with respect to the state is evaluated at the time of 
+    // the backward sweep as in the separate evaluation.
+    computeStageTimes(time, delta_tau);
+    for (int i=1; i<N_; ++i) {
+      int i_total = i * dim_control_input_and_constraints_;
+      modeltraits::HamiltonianDerivativesFunc(
+          model_, tau_vec_[i], backward_tau_vec_[i], state_mat[i-1], 
+          &(control_input_and_constraints_seq[i_total]), lambda_mat[i], 
+          dx_vec_, hx_vec_, 
+          &(optimality_residual_for_control_input_and_constraints[i_total]));
+      for (int j=0; j<dim_state_; ++j) {
+        optimality_residual_for_state[i][j] = 
+            state_mat[i][j] - state_mat[i-1][j] - delta_tau * dx_vec_[j];
+      }
+      for (int j=0; j<dim_state_; ++j) {
+        optimality_residual_for_lambda[i-1][j] = 
+            lambda_mat[i-1][j] - lambda_mat[i][j] - delta_tau * hx_vec_[j];
+      }
+    }
+    model_.phixFunc(tau_vec_[N_], state_mat[N_-1], dx_vec_);
+    for (int i=0; i<dim_state_; ++i) {
+      optimality_residual_for_lambda[N_-1][i] 
+          = lambda_mat[N_-1][i] - dx_vec_[i];
+    }
+    return;
+  }
+  // Compute the optimality residuals for the state and for the control input 
+  // and constraints of each stage in the forward sweep.
+  model_.stateFunc(time, state_vec, control_input_and_constraints_seq, dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    optimality_residual_for_state[0][i] = 
+        state_mat[0][i] - state_vec[i] - delta_tau * dx_vec_[i];
+  }
+  model_.huFunc(time, state_vec, control_input_and_constraints_seq, 
+                lambda_mat[0], 
+                optimality_residual_for_control_input_and_constraints);
+  double tau = time + delta_tau;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.stateFunc(tau, state_mat[i-1], 
+                     &(control_input_and_constraints_seq[i_total]), dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      optimality_residual_for_state[i][j] = 
+          state_mat[i][j] - state_mat[i-1][j] - delta_tau * dx_vec_[j];
+    }
+    model_.huFunc(
+        tau, state_mat[i-1], &(control_input_and_constraints_seq[i_total]), 
+        lambda_mat[i], 
+        &(optimality_residual_for_control_input_and_constraints[i_total]));
+  }
+  // Compute the optimality residual for lambda in the backward sweep.
+  model_.phixFunc(tau, state_mat[N_-1], dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    optimality_residual_for_lambda[N_-1][i] = lambda_mat[N_-1][i] - dx_vec_[i];
+  }
+  for (int i=N_-1; i>=1; --i, tau-=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.hxFunc(tau, state_mat[i-1], 
+                  &(control_input_and_constraints_seq[i_total]), 
+                  lambda_mat[i], dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      optimality_residual_for_lambda[i-1][j] = 
+          lambda_mat[i-1][j] - lambda_mat[i][j] - delta_tau * dx_vec_[j];
+    }
+  }
+}
+
+template <class Model, int FixedN>
+void MultipleShootingOCP<Model, FixedN>::
+computeStateAndLambdaFromOptimalityResidual(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& optimality_residual_for_state,
+    const AlignedMatrix& optimality_residual_for_lambda,
+    AlignedMatrix& state_mat, AlignedMatrix& lambda_mat) {
+  // Set the length of the horizon and discretize the horizon.
+  double horizon_length = horizon_.getLength(time);
+  double delta_tau = horizon_length / N_;
+  // Compute the sequence of state under the error for state.
+  model_.stateFunc(time, state_vec, control_input_and_constraints_seq, dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    state_mat[0][i] = 
+        state_vec[i] 
+        + delta_tau * dx_vec_[i] + optimality_residual_for_state[0][i];
+  }
+  double tau = time + delta_tau;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.stateFunc(tau, state_mat[i-1], 
+                     &(control_input_and_constraints_seq[i_total]), dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      state_mat[i][j] = 
+          state_mat[i-1][j] 
+          + delta_tau * dx_vec_[j] + optimality_residual_for_state[i][j];
+    }
+  }
+  // Compute the sequence of lambda under the error for lambda.
+  model_.phixFunc(tau, state_mat[N_-1], dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    lambda_mat[N_-1][i] = dx_vec_[i] + optimality_residual_for_lambda[N_-1][i];
+  }
+  for (int i=N_-1; i>=1; --i, tau-=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.hxFunc(tau, state_mat[i-1], 
+                  &(control_input_and_constraints_seq[i_total]), 
+                  lambda_mat[i], dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      lambda_mat[i-1][j] = 
+          lambda_mat[i][j] 
+          + delta_tau * dx_vec_[j] + optimality_residual_for_lambda[i-1][j];
+    }
+  }
+}
+
+template <class Model, int FixedN>
+void MultipleShootingOCP<Model, FixedN>::computeCondensedOptimalityResidual(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& optimality_residual_for_state,
+    const AlignedMatrix& optimality_residual_for_lambda,
+    AlignedMatrix& state_mat, AlignedMatrix& lambda_mat, 
+    double* optimality_residual_for_control_input_and_constraints) {
+  // Set the length of the horizon and discretize the horizon.
+  double horizon_length = horizon_.getLength(time);
+  double delta_tau = horizon_length / N_;
+  if (thread_pool_->num_threads() > 1) {
+    computeStateAndLambdaFromOptimalityResidual(
+        time, state_vec, control_input_and_constraints_seq, 
+        optimality_residual_for_state, optimality_residual_for_lambda, 
+        state_mat, lambda_mat);
+    computeOptimalityResidualForControlInputAndConstraints(
+        time, state_vec, control_input_and_constraints_seq, state_mat, 
+        lambda_mat, optimality_residual_for_control_input_and_constraints);
+    return;
+  }
+  // Compute the sequence of state under the error for state. The time of each 
+  // stage is stored to compute the optimality residual for the control input 
+  // and constraints at the same time as the forward sweep.
+  model_.stateFunc(time, state_vec, control_input_and_constraints_seq, dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    state_mat[0][i] = 
+        state_vec[i] 
+        + delta_tau * dx_vec_[i] + optimality_residual_for_state[0][i];
+  }
+  double tau = time + delta_tau;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    tau_vec_[i] = tau;
+    model_.stateFunc(tau, state_mat[i-1], 
+                     &(control_input_and_constraints_seq[i_total]), dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      state_mat[i][j] = 
+          state_mat[i-1][j] 
+          + delta_tau * dx_vec_[j] + optimality_residual_for_state[i][j];
+    }
+  }
+  // Compute the sequence of lambda under the error for lambda and the 
+  // optimality residual for the control input and constraints of each stage 
+  // while the state and lambda of the stage are still in cache.
+  model_.phixFunc(tau, state_mat[N_-1], dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    lambda_mat[N_-1][i] = dx_vec_[i] + optimality_residual_for_lambda[N_-1][i];
+  }
+  for (int i=N_-1; i>=1; --i, tau-=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.huFunc(
+        tau_vec_[i], state_mat[i-1], 
+        &(control_input_and_constraints_seq[i_total]), lambda_mat[i], 
+        &(optimality_residual_for_control_input_and_constraints[i_total]));
+    model_.hxFunc(tau, state_mat[i-1], 
+                  &(control_input_and_constraints_seq[i_total]), 
+                  lambda_mat[i], dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      lambda_mat[i-1][j] = 
+          lambda_mat[i][j] 
+          + delta_tau * dx_vec_[j] + optimality_residual_for_lambda[i-1][j];
+    }
+  }
+  model_.huFunc(time, state_vec, control_input_and_constraints_seq, 
+                lambda_mat[0], 
+                optimality_residual_for_control_input_and_constraints);
+}
+
+template <class Model, int FixedN>
+void MultipleShootingOCP<Model, FixedN>::
+computeCondensedOptimalityResidualDirectionalDerivative(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& optimality_residual_for_state,
+    const AlignedMatrix& optimality_residual_for_lambda,
+    const double* direction_vec, double* optimality_residual_derivative) {
+  // Set the length of the horizon and discretize the horizon.
+  double horizon_length = horizon_.getLength(time);
+  double delta_tau = horizon_length / N_;
+  // The derivatives of the control input and the constraints are set by 
+  // direction_vec and those of the initial state are zero. The i-th rows of 
+  // the state and lambda are stored from dual_state_mat_[i*dim_state_] and 
+  // dual_lambda_mat_[i*dim_state_].
+  for (int i=0; i<dim_solution_; ++i) {
+    dual_control_input_and_constraints_seq_[i] 
+        = Dual(control_input_and_constraints_seq[i], direction_vec[i]);
+  }
+  for (int i=0; i<dim_state_; ++i) {
+    dual_state_vec_[i] = Dual(state_vec[i]);
+  }
+  // Compute the sequence of state under the error for state.
+  model_.stateFunc(time, dual_state_vec_, 
+                   dual_control_input_and_constraints_seq_.data(), 
+                   dual_dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    dual_state_mat_[i] = dual_state_vec_[i] + delta_tau * dual_dx_vec_[i] 
+                         + optimality_residual_for_state[0][i];
+  }
+  double tau = time + delta_tau;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.stateFunc(tau, &(dual_state_mat_[(i-1)*dim_state_]), 
+                     &(dual_control_input_and_constraints_seq_[i_total]), 
+                     dual_dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      dual_state_mat_[i*dim_state_+j] = 
+          dual_state_mat_[(i-1)*dim_state_+j] 
+          + delta_tau * dual_dx_vec_[j] + optimality_residual_for_state[i][j];
+    }
+  }
+  // Compute the sequence of lambda under the error for lambda.
+  model_.phixFunc(tau, &(dual_state_mat_[(N_-1)*dim_state_]), dual_dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    dual_lambda_mat_[(N_-1)*dim_state_+i] 
+        = dual_dx_vec_[i] + optimality_residual_for_lambda[N_-1][i];
+  }
+  for (int i=N_-1; i>=1; --i, tau-=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.hxFunc(tau, &(dual_state_mat_[(i-1)*dim_state_]), 
+                  &(dual_control_input_and_constraints_seq_[i_total]), 
+                  &(dual_lambda_mat_[i*dim_state_]), dual_dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      dual_lambda_mat_[(i-1)*dim_state_+j] = 
+          dual_lambda_mat_[i*dim_state_+j] 
+          + delta_tau * dual_dx_vec_[j] 
+          + optimality_residual_for_lambda[i-1][j];
+    }
+  }
+  // Compute the derivative of the optimality error for control input and 
+  // constraints.
+  model_.huFunc(time, dual_state_vec_, 
+                dual_control_input_and_constraints_seq_.data(), 
+                dual_lambda_mat_.data(), dual_hu_vec_);
+  for (int j=0; j<dim_control_input_and_constraints_; ++j) {
+    optimality_residual_derivative[j] = dual_hu_vec_[j].derivative();
+  }
+  tau = time + delta_tau;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    int i_total = i * dim_control_input_and_constraints_;
+    model_.huFunc(tau, &(dual_state_mat_[(i-1)*dim_state_]), 
+                  &(dual_control_input_and_constraints_seq_[i_total]), 
+                  &(dual_lambda_mat_[i*dim_state_]), dual_hu_vec_);
+    for (int j=0; j<dim_control_input_and_constraints_; ++j) {
+      optimality_residual_derivative[i_total+j] = dual_hu_vec_[j].derivative();
+    }
+  }
+}
+
+template <class Model, int FixedN>
+void MultipleShootingOCP<Model, FixedN>::computeStageJacobians(
+    const double time, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+    RiccatiRecursion& riccati_recursion) {
+  // Set the length of the horizon and discretize the horizon.
+  double horizon_length = horizon_.getLength(time);
+  double delta_tau = horizon_length / N_;
+  // The rows of the Jacobians are evaluated at the same times as the 
+  // optimality residual, i.e., the state equation and the partial derivative 
+  // of the Hamiltonian with respect to the control input at tau_vec_ and that 
+  // with respect to the state at backward_tau_vec_.
+  computeStageTimes(time, delta_tau);
+  // The columns of the Jacobians of each stage are computed by seeding the 
+  // derivatives of the state, the control input and the constraints, and 
+  // lambda one by one. The dual workspaces of 
+  // computeCondensedOptimalityResidualDirectionalDerivative() are reused: 
+  // the head of dual_lambda_mat_ holds lambda and that of dual_state_mat_ 
+  // the partial derivative of the Hamiltonian with respect to the state.
+  const int dim_stage = 2 * dim_state_ + dim_control_input_and_constraints_;
+  const int hu = dim_state_;
+  const int hx = dim_state_ + dim_control_input_and_constraints_;
+  for (int i=0; i<N_; ++i) {
+    const int i_total = i * dim_control_input_and_constraints_;
+    const double* x_vec = (i == 0) ? state_vec : state_mat[i-1];
+    const double* u_vec = &(control_input_and_constraints_seq[i_total]);
+    const double* lmd_vec = lambda_mat[i];
+    for (int k=0; k<dim_stage; ++k) {
+      for (int j=0; j<dim_state_; ++j) {
+        dual_state_vec_[j] = Dual(x_vec[j], (k == j) ? 1 : 0);
+      }
+      for (int j=0; j<dim_control_input_and_constraints_; ++j) {
+        dual_control_input_and_constraints_seq_[j] 
+            = Dual(u_vec[j], (k == hu+j) ? 1 : 0);
+      }
+      for (int j=0; j<dim_state_; ++j) {
+        dual_lambda_mat_[j] = Dual(lmd_vec[j], (k == hx+j) ? 1 : 0);
+      }
+      // The state equation does not depend on lambda.
+      if (k < hx) {
+        model_.stateFunc(tau_vec_[i], dual_state_vec_, 
+                         dual_control_input_and_constraints_seq_.data(), 
+                         dual_dx_vec_);
+        for (int j=0; j<dim_state_; ++j) {
+          stage_jacobian_mat_[j][k] = dual_dx_vec_[j].derivative();
+        }
+      }
+      else {
+        for (int j=0; j<dim_state_; ++j) {
+          stage_jacobian_mat_[j][k] = 0;
+        }
+      }
+      model_.huFunc(tau_vec_[i], dual_state_vec_, 
+                    dual_control_input_and_constraints_seq_.data(), 
+                    dual_lambda_mat_.data(), dual_hu_vec_);
+      for (int j=0; j<dim_control_input_and_constraints_; ++j) {
+        stage_jacobian_mat_[hu+j][k] = dual_hu_vec_[j].derivative();
+      }
+      model_.hxFunc(backward_tau_vec_[i], dual_state_vec_, 
+                    dual_control_input_and_constraints_seq_.data(), 
+                    dual_lambda_mat_.data(), dual_state_mat_.data());
+      for (int j=0; j<dim_state_; ++j) {
+        stage_jacobian_mat_[hx+j][k] = dual_state_mat_[j].derivative();
+      }
+    }
+    riccati_recursion.setStageJacobian(i, delta_tau, stage_jacobian_mat_);
+  }
+  for (int k=0; k<dim_state_; ++k) {
+    for (int j=0; j<dim_state_; ++j) {
+      dual_state_vec_[j] = Dual(state_mat[N_-1][j], (k == j) ? 1 : 0);
+    }
+    model_.phixFunc(tau_vec_[N_], dual_state_vec_, dual_dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      terminal_jacobian_mat_[j][k] = dual_dx_vec_[j].derivative();
+    }
+  }
+  riccati_recursion.setTerminalJacobian(terminal_jacobian_mat_);
+}
+
+template <class Model, int FixedN>
+void MultipleShootingOCP<Model, FixedN>::predictStateFromSolution(
+    const double current_time, const double* current_state,
+    const double* solution_vec, const double prediction_length,
+    double* predicted_state) {
+  model_.stateFunc(current_time, current_state, solution_vec, dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    predicted_state[i] =  current_state[i] + prediction_length * dx_vec_[i];
+  }
+}
+
+template <class Model, int FixedN>
+void MultipleShootingOCP<Model, FixedN>::resetHorizonLength(
+    const double T_f, const double alpha, const double initial_time) {
+  horizon_.resetLength(T_f, alpha, initial_time);
+}
+
+template <class Model, int FixedN>
+void MultipleShootingOCP<Model, FixedN>::resetHorizonLength(
+    const double initial_time) {
+  horizon_.resetLength(initial_time);
+}
+
+template <class Model, int FixedN>
+int MultipleShootingOCP<Model, FixedN>::dim_solution() const {
+  return dim_solution_;
+}
+
+template <class Model, int FixedN>
+int MultipleShootingOCP<Model, FixedN>::N() const {
+  return N_;
+}
+
+template <class Model, int FixedN>
+void MultipleShootingOCP<Model, FixedN>::setNumThreads(
+    const int num_threads, const int min_N) {
+  thread_pool_ = &own_thread_pool_;
+  if (N_ >= min_N) {
+    own_thread_pool_.setNumThreads(num_threads);
+  }
+  else {
+    own_thread_pool_.setNumThreads(1);
+  }
+  thread_dx_mat_.resize(thread_pool_->num_threads(), dim_state_);
+  thread_hx_mat_.resize(thread_pool_->num_threads(), dim_state_);
+}
+
+template <class Model, int FixedN>
+void MultipleShootingOCP<Model, FixedN>::setThreadPool(
+    StageThreadPool& thread_pool, const int min_N) {
+  own_thread_pool_.setNumThreads(1);
+  if (N_ >= min_N) {
+    thread_pool_ = &thread_pool;
+  }
+  else {
+    thread_pool_ = &own_thread_pool_;
+  }
+  thread_dx_mat_.resize(thread_pool_->num_threads(), dim_state_);
+  thread_hx_mat_.resize(thread_pool_->num_threads(), dim_state_);
+}
+
+template <class Model, int FixedN>
+void MultipleShootingOCP<Model, FixedN>::computeStageTimes(
+    const double time, const double delta_tau) {
+  tau_vec_[0] = time;
+  double tau = time + delta_tau;
+  for (int i=1; i<=N_; ++i, tau+=delta_tau) {
+    tau_vec_[i] = tau;
+  }
+  tau = tau_vec_[N_];
+  for (int i=N_-1; i>=0; --i, tau-=delta_tau) {
+    backward_tau_vec_[i] = tau;
+  }
+}
+
+template <class Model, int FixedN>
+void MultipleShootingOCP<Model, FixedN>::
+computeOptimalityResidualForStateAndLambdaOfStage(
+    const int stage, const double delta_tau, const double* state_vec, 
+    const double* control_input_and_constraints_seq, 
+    const AlignedMatrix& state_mat, const AlignedMatrix& lambda_mat, 
+    double* dx_vec, AlignedMatrix& optimality_residual_for_state, 
+    AlignedMatrix& optimality_residual_for_lambda) {
+  const double* previous_state_vec 
+      = (stage == 0) ? state_vec : state_mat[stage-1];
+  const double* control_input_and_constraints_vec 
+      = &(control_input_and_constraints_seq[
+              stage*dim_control_input_and_constraints_]);
+  model_.stateFunc(tau_vec_[stage], previous_state_vec, 
+                   control_input_and_constraints_vec, dx_vec);
+  for (int j=0; j<dim_state_; ++j) {
+    optimality_residual_for_state[stage][j] = 
+        state_mat[stage][j] - previous_state_vec[j] - delta_tau * dx_vec[j];
+  }
+  if (stage > 0) {
+    model_.hxFunc(backward_tau_vec_[stage], previous_state_vec, 
+                  control_input_and_constraints_vec, lambda_mat[stage], dx_vec);
+    for (int j=0; j<dim_state_; ++j) {
+      optimality_residual_for_lambda[stage-1][j] = 
+          lambda_mat[stage-1][j] - lambda_mat[stage][j] 
+          - delta_tau * dx_vec[j];
+    }
+  }
+}
+
 } // namespace cgmres
 
 
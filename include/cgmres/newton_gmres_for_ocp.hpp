@@ -31,6 +31,7 @@ public:
     : ocp_(ocp_constructor_args...), 
       dim_solution_(ocp_.dim_solution()),
       finite_difference_increment_(finite_difference_increment),
+      exact_jacobian_vector_product_(false),
       incremented_solution_vec_(linearalgebra::NewVector(dim_solution_)),
       optimality_residual_(linearalgebra::NewVector(dim_solution_)),
       optimality_residual_1_(linearalgebra::NewVector(dim_solution_)) {
@@ -58,10 +59,10 @@ public:
   void bFunc(const double time, const double* state_vec, 
              const double* current_solution_vec, 
              const double* current_solution_update_vec, double* b_vec) {
-    for (int i=0; i<dim_solution_; ++i) {
-      incremented_solution_vec_[i] = current_solution_vec[i] 
-          + finite_difference_increment_ * current_solution_update_vec[i];
-    }
+    linearalgebra::ScaledSum(dim_solution_, current_solution_vec, 
+                             finite_difference_increment_, 
+                             current_solution_update_vec, 
+                             incremented_solution_vec_);
     ocp_.computeOptimalityResidual(time, state_vec, current_solution_vec, 
                                   optimality_residual_);
     ocp_.computeOptimalityResidual(time, state_vec, incremented_solution_vec_, 
@@ -74,14 +75,19 @@ public:
   }
 
   // Computes a vector correspongin to Ax in Ax=b. This function is called in
-  // MatrixfreeGMRES.
+  // MatrixfreeGMRES. Ax is approximated by the forward difference by default 
+  // and is computed exactly if setExactJacobianVectorProduct(true) is called.
   void AxFunc(const double time, const double* state_vec, 
               const double* current_solution_vec, const double* direction_vec,
               double* ax_vec) {
-    for (int i=0; i<dim_solution_; ++i) { 
-      incremented_solution_vec_[i] = current_solution_vec[i] 
-          + finite_difference_increment_ * direction_vec[i];
+    if (exact_jacobian_vector_product_) {
+      ocp_.computeOptimalityResidualDirectionalDerivative(
+          time, state_vec, current_solution_vec, direction_vec, ax_vec);
+      return;
     }
+    linearalgebra::ScaledSum(dim_solution_, current_solution_vec, 
+                             finite_difference_increment_, direction_vec, 
+                             incremented_solution_vec_);
     ocp_.computeOptimalityResidual(time, state_vec, incremented_solution_vec_, 
                                   optimality_residual_1_);
     for (int i=0; i<dim_solution_; ++i) {
@@ -90,6 +96,29 @@ public:
     }
   }
 
+  // Sets whether AxFunc() computes the product of the Jacobian of the 
+  // optimality residual and the direction exactly by the forward-mode 
+  // automatic differentiation instead of the forward difference 
+  // approximation with finite_difference_increment. OCPType must provide 
+  // computeOptimalityResidualDirectionalDerivative(). The default is false.
+  void setExactJacobianVectorProduct(const bool exact_jacobian_vector_product) {
+    exact_jacobian_vector_product_ = exact_jacobian_vector_product;
+  }
+
+  // Copies the runtime parameters of the model into the optimal control 
+  // problem. See OptimalControlProblem::syncParameters().
+  void syncParameters() {
+    ocp_.syncParameters();
+  }
+
+  // Sets the parameters of the model of the optimal control problem. See 
+  // OptimalControlProblem::setParameters(). This is a template because this 
+  // class does not depend on NMPCModel.
+  template <class Parameters>
+  void setParameters(const Parameters& parameters) {
+    ocp_.setParameters(parameters);
+  }
+
   // Computes the partial derivative of the terminal cost with respect to
   // the state.
   void getTerminalCostDerivatives(const double time, 
@@ -123,6 +152,7 @@ private:
   OCPType ocp_;
   const int dim_solution_;
   double finite_difference_increment_; 
+  bool exact_jacobian_vector_product_;
   double *incremented_solution_vec_, *optimality_residual_, 
       *optimality_residual_1_;
 };
@@ -4,13 +4,15 @@
 #ifndef OPTIMAL_CONTROL_PROBLEM_H
 #define OPTIMAL_CONTROL_PROBLEM_H
 
-#include "nmpc_model.hpp"
+#include "model_traits.hpp"
 
 
 namespace cgmres {
 
 // Abstruct class for optimal control problems. This class loads model of NMPC
-// and define dimensions.
+// and define dimensions. Model is the model of NMPC, e.g., NMPCModel 
+// generated by AutoGenU.
+template <class Model>
 class OptimalControlProblem {
 public:
   // Loads model of NMPC and define dimensions.
@@ -33,12 +35,75 @@ public:
   // Returns dimension of the solution of the optimal control problem.
   virtual int dim_solution() const = 0;
 
+  // Copies the parameters set by Model::setParameters() into the model if 
+  // Model has the runtime parameters, and does nothing otherwise. The 
+  // solvers call this once at the beginning of each control update so that 
+  // the equations read the parameters as plain members of the model.
+  void syncParameters();
+
+  // Sets the parameters of the model, which the equations use after the 
+  // next syncParameters(). See Model::setParameters(). This can be called 
+  // only if Model has the runtime parameters.
+  template <class Parameters>
+  void setParameters(const Parameters& parameters);
+
 protected:
-  NMPCModel model_;
-  int dim_state_, dim_control_input_, dim_constraints_, 
-      dim_control_input_and_constraints_;
+  Model model_;
+  // The dimensions are the compile-time constants of Model, so that the 
+  // loops over the state and the control input of each stage in the derived 
+  // classes have constant trip counts and can be unrolled by the compiler, 
+  // and the work vectors of a stage are fixed-size arrays. The sequences and 
+  // matrices over the horizon are sized by the template parameter FixedN of 
+  // the derived classes if it is fixed, and are allocated at runtime 
+  // otherwise.
+  static constexpr int dim_state_ = Model::dim_state();
+  static constexpr int dim_control_input_ = Model::dim_control_input();
+  static constexpr int dim_constraints_ = Model::dim_constraints();
+  static constexpr int dim_control_input_and_constraints_ 
+      = Model::dim_control_input() + Model::dim_constraints();
 };
 
+template <class Model>
+constexpr int OptimalControlProblem<Model>::dim_state_;
+template <class Model>
+constexpr int OptimalControlProblem<Model>::dim_control_input_;
+template <class Model>
+constexpr int OptimalControlProblem<Model>::dim_constraints_;
+template <class Model>
+constexpr int OptimalControlProblem<Model>::dim_control_input_and_constraints_;
+
+template <class Model>
+OptimalControlProblem<Model>::OptimalControlProblem()
+  : model_() {
+}
+
+template <class Model>
+int OptimalControlProblem<Model>::dim_state() const {
+  return dim_state_;
+}
+
+template <class Model>
+int OptimalControlProblem<Model>::dim_control_input() const {
+  return dim_control_input_;
+}
+
+template <class Model>
+int OptimalControlProblem<Model>::dim_constraints() const {
+  return dim_constraints_;
+}
+
+template <class Model>
+void OptimalControlProblem<Model>::syncParameters() {
+  modeltraits::SyncParameters(model_);
+}
+
+template <class Model>
+template <class Parameters>
+void OptimalControlProblem<Model>::setParameters(
+    const Parameters& parameters) {
+  model_.setParameters(parameters);
+}
+
 } // namespace cgmres
 
 
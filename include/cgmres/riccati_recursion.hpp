@@ -0,0 +1,97 @@
+// Riccati recursion that solves the linear problem of the multiple-shooting 
+// continuation directly in O(N) operations instead of MatrixFreeGMRES.
+
+#ifndef RICCATI_RECURSION_H
+#define RICCATI_RECURSION_H
+
+#include "linear_algebra.hpp"
+#include "aligned_matrix.hpp"
+
+
+namespace cgmres {
+
+// Direct solver of the linear problem of MultipleShootingContinuation, i.e., 
+// of the Jacobian of the condensed optimality residual with respect to the 
+// control input and the constraints. The Jacobian is the Schur complement 
+// of the linearized multiple-shooting optimality residual, whose i-th stage 
+// is linearized at x_{i-1}, U_i, and lambda_i as 
+//   dx_i - (I+delta_tau*f_x) dx_{i-1} - delta_tau*f_u dU_i = 0, 
+//   H_ux dx_{i-1} + H_uu dU_i + H_ulambda dlambda_i = b_i, 
+//   dlambda_{i-1} - (I+delta_tau*H_xlambda) dlambda_i 
+//       - delta_tau*(H_xx dx_{i-1} + H_xu dU_i) = 0, 
+// with dx_{-1} = 0 and dlambda_{N-1} = phi_xx dx_{N-1}. factorize() computes 
+// the matrices P_i of dlambda_i = P_i dx_i + p_i and the feedback gains of 
+// dU_i by the backward Riccati recursion and solve() computes the solution 
+// for b by one backward and one forward sweep. The matrices H_uu and H_ux 
+// need not be symmetric, e.g., for the semi-smooth Fischer-Burmeister 
+// method. The matrix to be inverted at each stage is factorized by 
+// linearalgebra::LUFactorize(). If it is singular at any stage, the linear 
+// problem is regarded as singular and is not solved; see is_singular().
+class RiccatiRecursion {
+public:
+  // Constructs RiccatiRecursion for the horizon with N stages. The vectors 
+  // and matrices are allocated at the first call of setStageJacobian(), 
+  // setTerminalJacobian(), or factorize() so that an unused instance is 
+  // cheap.
+  RiccatiRecursion(const int N, const int dim_state, 
+                   const int dim_control_input_and_constraints);
+
+  // Free vectors and matrices.
+  ~RiccatiRecursion();
+
+  // Sets the Jacobians of the stage-th stage. The rows of stage_jacobian are 
+  // f, H_u, and H_x and its columns x, U, and lambda, i.e., its dimensions 
+  // are 2*dim_state+dim_control_input_and_constraints. 
+  void setStageJacobian(const int stage, const double delta_tau, 
+                        const AlignedMatrix& stage_jacobian);
+
+  // Sets the Hessian of the terminal cost phi_xx.
+  void setTerminalJacobian(const AlignedMatrix& terminal_jacobian);
+
+  // Computes the matrices of the Riccati recursion and the LU factorizations 
+  // of the stages from the Jacobians set by setStageJacobian() and 
+  // setTerminalJacobian(). The recursion stops at the first stage whose 
+  // matrix is singular, after which is_singular() returns true.
+  void factorize();
+
+  // Computes the solution of the linear problem, i.e., dU, for b_vec. Call 
+  // after factorize(). Must not be called if is_singular() is true.
+  void solve(const double* b_vec, double* solution_vec);
+
+  // Returns true if the latest factorize() found a singular stage or if 
+  // factorize() has not been called.
+  bool is_singular() const;
+
+  // Prohibits copy due to memory allocation.
+  RiccatiRecursion(const RiccatiRecursion&) = delete;
+  RiccatiRecursion& operator=(const RiccatiRecursion&) = delete;
+
+private:
+  int N_, dim_state_, dim_control_input_and_constraints_;
+  // The matrices of the i-th stage are stored in the rows from i*dim_state_ 
+  // or i*dim_control_input_and_constraints_. A_mat_ is I+delta_tau*f_x, 
+  // B_mat_ delta_tau*f_u, E_mat_ I+delta_tau*H_xlambda, Qxx_mat_ 
+  // delta_tau*H_xx, and Qxu_mat_ delta_tau*H_xu. G_mat_ is H_uu before 
+  // factorize() and the LU factorization of H_uu+H_ulambda*P*B after it.
+  AlignedMatrix A_mat_, B_mat_, E_mat_, Qxx_mat_, Qxu_mat_, Hux_mat_, 
+      Hulmd_mat_, G_mat_, K_mat_, W_mat_, P_mat_, PA_mat_, PB_mat_, 
+      terminal_mat_;
+  int *pivot_seq_;
+  bool is_singular_;
+  double *p_vec_, *p_vec_1_, *dx_vec_, *dx_vec_1_, *column_vec_;
+
+  // Allocates the vectors and matrices if they have not been allocated.
+  void allocateMatrices();
+
+  // Computes the LU factorization of the stage-th block of G_mat_ in place 
+  // by linearalgebra::LUFactorize(). Returns false if the block is singular.
+  bool factorizeBlock(const int stage);
+
+  // Solves the stage-th block of G_mat_ times vec = vec in place.
+  void solveBlock(const int stage, double* vec) const;
+};
+
+} // namespace cgmres
+
+
+#endif // RICCATI_RECURSION_H
\ No newline at end of file
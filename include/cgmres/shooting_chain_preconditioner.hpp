@@ -0,0 +1,55 @@
+// Preconditioner for MatrixFreeGMRES of the multiple-shooting optimal control 
+// problem without condensing whose preconditioning matrix is the chain of the 
+// state and lambda over the stages of the horizon.
+
+#ifndef SHOOTING_CHAIN_PRECONDITIONER_H
+#define SHOOTING_CHAIN_PRECONDITIONER_H
+
+#include "block_jacobi_preconditioner.hpp"
+
+namespace cgmres {
+
+// Right preconditioner of MatrixFreeGMRES for UncondensedMSContinuation. The 
+// optimality residual of the state of the i-th stage is 
+// x_i - x_{i-1} - delta_tau * f and that of lambda is 
+// lambda_i - lambda_{i+1} - delta_tau * H_x. The preconditioning matrix is 
+// the Jacobian of them without the terms multiplied by delta_tau, i.e., the 
+// lower block-bidiagonal matrix for the state and the upper one for lambda 
+// whose blocks are the identities, and the block-diagonal matrix of 
+// BlockJacobiPreconditioner for the control input and the constraints, whose 
+// blocks are the identities until they are set. Its inverse is applied by the prefix sums of the state 
+// and the suffix sums of lambda, which propagate the information through the 
+// horizon that the GMRES method would otherwise need about N iterations to 
+// propagate. The cost is O(N*dim_state) additions and no evaluation of the 
+// model.
+class ShootingChainPreconditioner {
+public:
+  // Constructs ShootingChainPreconditioner for the horizon with N stages.
+  ShootingChainPreconditioner(const int N, 
+                              const int dim_control_input_and_constraints, 
+                              const int dim_state);
+
+  // Computes preconditioned_vec = M^{-1} * vec, where vec is ordered as the 
+  // solution of UncondensedMSContinuation. This function is called in 
+  // MatrixFreeGMRES.
+  void apply(const double* vec, double* preconditioned_vec) const;
+
+  // Returns the block-Jacobi preconditioner for the control input and the 
+  // constraints, whose blocks are set by 
+  // UncondensedMSContinuation::computeBlockJacobiPreconditioner().
+  BlockJacobiPreconditioner& control_input_preconditioner();
+
+  // Prohibits copy due to memory allocation.
+  ShootingChainPreconditioner(const ShootingChainPreconditioner&) = delete;
+  ShootingChainPreconditioner& operator=(const ShootingChainPreconditioner&) 
+      = delete;
+
+private:
+  int N_, dim_control_input_and_constraints_seq_, dim_state_;
+  BlockJacobiPreconditioner control_input_preconditioner_;
+};
+
+} // namespace cgmres
+
+
+#endif // SHOOTING_CHAIN_PRECONDITIONER_H
\ No newline at end of file
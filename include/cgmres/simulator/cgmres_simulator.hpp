@@ -5,7 +5,6 @@
 #include <fstream>
 #include <string>
 #include <chrono>
-#include "nmpc_model.hpp"
 #include "numerical_integrator.hpp"
 #include "save_simulation_data.hpp"
 
@@ -15,14 +14,15 @@ namespace cgmres {
 // Simulates NMPC using the C/GMRES-based methods. Opens file streams and saves 
 // simulation data into them.
 // NMPCSolver: the solver class. Select from ContinuationGMRES, 
-//             MultipleShootingCGMRES, and MSCGMRESWithInputSaturation.
+//             MultipleShootingCGMRES, and MSCGMRESWithInputSaturation. The 
+//             model is simulated by NMPCSolver::NMPCModel.
 template <class NMPCSolver>
 void simulation(NMPCSolver& nmpc, const double* initial_state_vec, 
                 const double start_time, const double end_time, 
                 const double sampling_period, const std::string save_dir, 
                 const std::string savefile_name) {
-  NMPCModel model;
-  NumericalIntegrator integrator;
+  typename NMPCSolver::NMPCModel model;
+  NumericalIntegrator<typename NMPCSolver::NMPCModel> integrator;
   double current_state_vec[model.dim_state()], next_state_vec[model.dim_state()],
       control_input_vec[model.dim_control_input()];
   std::chrono::system_clock::time_point start_clock, end_clock;
@@ -1,13 +1,17 @@
 #ifndef NUMERICAL_INTEGRATOR_H
 #define NUMERICAL_INTEGRATOR_H
 
-#include "nmpc_model.hpp"
+#include <cmath>
+#include "model_traits.hpp"
 
 
 namespace cgmres {
 
 // Supports numerical integration of the state equation of the system described 
-// in nmpc_model.hpp for numerical simnulations.
+// by Model, e.g., NMPCModel in nmpc_model.hpp, for numerical simnulations. If 
+// Model has the runtime parameters, the parameters set by setParameters() are 
+// synchronized at the beginning of each step.
+template <class Model>
 class NumericalIntegrator {
 public:
   NumericalIntegrator();
@@ -24,10 +28,81 @@ public:
                       const double integration_length, 
                       double* integrated_state);
 
+  // Sets the parameters of the model. See Model::setParameters().
+  template <class Parameters>
+  void setParameters(const Parameters& parameters);
+
 private:
-  NMPCModel model_;
+  Model model_;
 };
 
+template <class Model>
+NumericalIntegrator<Model>::NumericalIntegrator() 
+  : model_() {
+}
+
+template <class Model>
+void NumericalIntegrator<Model>::euler(const double current_time, 
+                                       const double* current_state_vec, 
+                                       const double* control_input_vec, 
+                                       const double integration_length, 
+                                       double* integrated_state) {
+  modeltraits::SyncParameters(model_);
+  double dx_vec_[model_.dim_state()];
+  model_.stateFunc(current_time, current_state_vec, control_input_vec, dx_vec_);
+  for (int i=0; i<model_.dim_state(); i++) {
+    integrated_state[i] = current_state_vec[i] + integration_length*dx_vec_[i];
+  }
+}
+
+template <class Model>
+void NumericalIntegrator<Model>::rungeKuttaGill(
+    const double current_time, const double* current_state_vec, 
+    const double* control_input_vec, const double integration_length, 
+    double* integrated_state) {
+  modeltraits::SyncParameters(model_);
+  double k1_vec[model_.dim_state()],  k2_vec[model_.dim_state()], 
+      k3_vec[model_.dim_state()], k4_vec[model_.dim_state()], 
+      tmp_vec[model_.dim_state()];
+
+  model_.stateFunc(current_time, current_state_vec, control_input_vec, k1_vec);
+  for (int i=0; i<model_.dim_state(); i++) {
+      tmp_vec[i] = current_state_vec[i] + 0.5*integration_length*k1_vec[i];
+  }
+
+  model_.stateFunc(current_time+0.5*integration_length, tmp_vec, 
+                   control_input_vec, k2_vec);
+  for (int i=0; i<model_.dim_state(); i++) {
+    tmp_vec[i] = current_state_vec[i] 
+        + integration_length*0.5*(std::sqrt(2)-1)*k1_vec[i] 
+        + integration_length*(1-(1/std::sqrt(2)))*k2_vec[i];
+  }
+
+  model_.stateFunc(current_time+0.5*integration_length, tmp_vec, 
+                   control_input_vec, k3_vec);
+  for (int i=0; i<model_.dim_state(); i++) {
+    tmp_vec[i] = current_state_vec[i] 
+        - integration_length*0.5*std::sqrt(2)*k2_vec[i] 
+        + integration_length*(1+(1/std::sqrt(2)))*k3_vec[i];
+  }
+
+  model_.stateFunc(current_time+integration_length, tmp_vec, 
+                   control_input_vec, k4_vec);
+  for (int i=0; i<model_.dim_state(); i++) {
+    integrated_state[i] = current_state_vec[i] 
+        + (integration_length/6)
+        * (k1_vec[i]+(2-std::sqrt(2))*k2_vec[i]
+            +(2+std::sqrt(2))*k3_vec[i]+k4_vec[i]);
+  }
+}
+
+template <class Model>
+template <class Parameters>
+void NumericalIntegrator<Model>::setParameters(
+    const Parameters& parameters) {
+  model_.setParameters(parameters);
+}
+
 } // namespace cgmres
 
 
@@ -9,7 +9,9 @@
 
 #include <cmath>
 #include "linear_algebra.hpp"
+#include "horizon_storage.hpp"
 #include "single_shooting_ocp.hpp"
+#include "block_jacobi_preconditioner.hpp"
 
 
 namespace cgmres {
@@ -17,6 +19,7 @@ namespace cgmres {
 // Linear problem of the continuation transformation for the single-shooting 
 // optimal control problem, which is solved in Matrix-free GMRES. This class 
 // is intended for use with MatrixfreeGMRES class. 
+template <class Model, int FixedN = kDynamicSize>
 class SingleShootingContinuation {
 public:
   // Constructs SingleShootingContinuation with setting parameters and allocates 
@@ -50,9 +53,6 @@ public:
                              const double finite_difference_increment,
                              const double zeta);
 
-  // Free vectors and matrices.
-  ~SingleShootingContinuation();
-
   // Integrates the solution for given optimal update vector of the solution 
   // and the integration length.
   void integrateSolution(double* solution_vec, 
@@ -73,6 +73,15 @@ public:
   // horizon.
   void resetHorizonLength(const double initial_time);
 
+  // Copies the runtime parameters of the model into the optimal control 
+  // problem. See OptimalControlProblem::syncParameters().
+  void syncParameters();
+
+  // Sets the parameters of the model of the optimal control problem. See 
+  // OptimalControlProblem::setParameters().
+  template <class Parameters>
+  void setParameters(const Parameters& parameters);
+
   // Computes a vector correspongin to b in Ax=b. This function is called in
   // MatrixfreeGMRES.
   void bFunc(const double time, const double* state_vec, 
@@ -80,11 +89,29 @@ public:
              const double* current_solution_update_vec, double* b_vec);
 
   // Computes a vector correspongin to Ax in Ax=b. This function is called in
-  // MatrixfreeGMRES.
+  // MatrixfreeGMRES. Ax is approximated by the forward difference by default 
+  // and is computed exactly if setExactJacobianVectorProduct(true) is called.
   void AxFunc(const double time, const double* state_vec, 
               const double* current_solution_vec, const double* direction_vec,
               double* ax_vec);
 
+  // Computes the blocks of the block-Jacobi preconditioner, i.e., the 
+  // Jacobians of the optimality residual of each stage with respect to the 
+  // control input and the constraints of the stage, by the forward 
+  // difference with the state and lambda over the horizon fixed, and 
+  // factorizes them. 
+  void computeBlockJacobiPreconditioner(
+      const double time, const double* state_vec, 
+      const double* current_solution_vec, 
+      BlockJacobiPreconditioner& preconditioner);
+
+  // Sets whether AxFunc() computes the product of the Jacobian of the 
+  // optimality residual and the direction exactly by the forward-mode 
+  // automatic differentiation instead of the forward difference 
+  // approximation with finite_difference_increment. The default is false. 
+  // bFunc() is not affected.
+  void setExactJacobianVectorProduct(const bool exact_jacobian_vector_product);
+
   // Returns the dimension of the state.
   int dim_state() const;
 
@@ -102,13 +129,216 @@ public:
   int N() const;
 
 private:
-  SingleShootingOCP ocp_;
+  // The dimension of the solution if FixedN is fixed, and kDynamicSize 
+  // otherwise.
+  static constexpr int kDimSolution = HorizonSize(
+      FixedN, Model::dim_control_input()+Model::dim_constraints());
+
+  SingleShootingOCP<Model, FixedN> ocp_;
   const int dim_state_, dim_control_input_, dim_constraints_, dim_solution_;
   double finite_difference_increment_, zeta_, incremented_time_; 
-  double *incremented_state_vec_, *incremented_solution_vec_, 
-      *optimality_residual_, *optimality_residual_1_, *optimality_residual_2_;
+  bool exact_jacobian_vector_product_;
+  double incremented_state_vec_[Model::dim_state()];
+  HorizonArray<double, kDimSolution> incremented_solution_vec_, 
+      optimality_residual_, optimality_residual_1_, optimality_residual_2_;
 };
 
+template <class Model, int FixedN>
+SingleShootingContinuation<Model, FixedN>::SingleShootingContinuation(
+    const double T_f, const double alpha, const int N,
+    const double finite_difference_increment, const double zeta) 
+  : ocp_(T_f, alpha, N),
+    dim_state_(ocp_.dim_state()),
+    dim_control_input_(ocp_.dim_control_input()),
+    dim_constraints_(ocp_.dim_constraints()),
+    dim_solution_(N*(dim_control_input_+dim_constraints_)),
+    finite_difference_increment_(finite_difference_increment),
+    zeta_(zeta),
+    incremented_time_(0),
+    exact_jacobian_vector_product_(false),
+    incremented_state_vec_(),
+    incremented_solution_vec_(dim_solution_),
+    optimality_residual_(dim_solution_),
+    optimality_residual_1_(dim_solution_),
+    optimality_residual_2_(dim_solution_) {
+}
+
+template <class Model, int FixedN>
+SingleShootingContinuation<Model, FixedN>::SingleShootingContinuation(
+    const double T_f, const double alpha, const int N, 
+    const double initial_time,
+    const double finite_difference_increment, const double zeta) 
+  : ocp_(T_f, alpha, N, initial_time),
+    dim_state_(ocp_.dim_state()),
+    dim_control_input_(ocp_.dim_control_input()),
+    dim_constraints_(ocp_.dim_constraints()),
+    dim_solution_(N*(dim_control_input_+dim_constraints_)),
+    finite_difference_increment_(finite_difference_increment),
+    zeta_(zeta),
+    incremented_time_(0),
+    exact_jacobian_vector_product_(false),
+    incremented_state_vec_(),
+    incremented_solution_vec_(dim_solution_),
+    optimality_residual_(dim_solution_),
+    optimality_residual_1_(dim_solution_),
+    optimality_residual_2_(dim_solution_) {
+}
+
+template <class Model, int FixedN>
+void SingleShootingContinuation<Model, FixedN>::integrateSolution(
+    double* solution_vec, const double* solution_update_vec, 
+    const double integration_length) {
+  linearalgebra::AddScaledVector(dim_solution_, integration_length, 
+                                 solution_update_vec, solution_vec);
+}
+
+template <class Model, int FixedN>
+double SingleShootingContinuation<Model, FixedN>::computeErrorNorm(
+    const double time, const double* state_vec, const double* solution_vec) {
+  ocp_.computeOptimalityResidual(time, state_vec, solution_vec,
+                                 optimality_residual_);
+  return std::sqrt(
+        linearalgebra::SquaredNorm(dim_solution_, optimality_residual_));
+}
+
+template <class Model, int FixedN>
+void SingleShootingContinuation<Model, FixedN>::resetHorizonLength(
+    const double T_f, const double alpha, const double initial_time) {
+  ocp_.resetHorizonLength(T_f, alpha, initial_time);
+}
+
+template <class Model, int FixedN>
+void SingleShootingContinuation<Model, FixedN>::resetHorizonLength(
+    const double initial_time) {
+  ocp_.resetHorizonLength(initial_time);
+}
+
+template <class Model, int FixedN>
+void SingleShootingContinuation<Model, FixedN>::syncParameters() {
+  ocp_.syncParameters();
+}
+
+template <class Model, int FixedN>
+template <class Parameters>
+void SingleShootingContinuation<Model, FixedN>::setParameters(
+    const Parameters& parameters) {
+  ocp_.setParameters(parameters);
+}
+
+template <class Model, int FixedN>
+void SingleShootingContinuation<Model, FixedN>::bFunc(
+    const double time, const double* state_vec, 
+    const double* current_solution_vec, 
+    const double* current_solution_update_vec, double* b_vec) {
+  incremented_time_ = time + finite_difference_increment_;
+  ocp_.predictStateFromSolution(time, state_vec, current_solution_vec,
+                                finite_difference_increment_, 
+                                incremented_state_vec_);
+  linearalgebra::ScaledSum(dim_solution_, current_solution_vec, 
+                           finite_difference_increment_, 
+                           current_solution_update_vec, 
+                           incremented_solution_vec_);
+  ocp_.computeOptimalityResidual(time, state_vec, current_solution_vec, 
+                                 optimality_residual_);
+  ocp_.computeOptimalityResidual(incremented_time_, incremented_state_vec_, 
+                                 current_solution_vec, optimality_residual_1_);
+  ocp_.computeOptimalityResidual(incremented_time_, incremented_state_vec_, 
+                                 incremented_solution_vec_, 
+                                 optimality_residual_2_);
+  for (int i=0; i<dim_solution_; ++i) {
+    b_vec[i] = (1/finite_difference_increment_-zeta_) * optimality_residual_[i] 
+        - optimality_residual_2_[i] / finite_difference_increment_;
+  }
+}
+
+template <class Model, int FixedN>
+void SingleShootingContinuation<Model, FixedN>::AxFunc(
+    const double time, const double* state_vec, 
+    const double* current_solution_vec, const double* direction_vec, 
+    double* ax_vec) {
+  if (exact_jacobian_vector_product_) {
+    ocp_.computeOptimalityResidualDirectionalDerivative(
+        incremented_time_, incremented_state_vec_, current_solution_vec, 
+        direction_vec, ax_vec);
+    return;
+  }
+  linearalgebra::ScaledSum(dim_solution_, current_solution_vec, 
+                           finite_difference_increment_, direction_vec, 
+                           incremented_solution_vec_);
+  ocp_.computeOptimalityResidual(incremented_time_, incremented_state_vec_, 
+                                 incremented_solution_vec_, 
+                                 optimality_residual_2_);
+  for (int i=0; i<dim_solution_; ++i) {
+    ax_vec[i] = 
+        (optimality_residual_2_[i]-optimality_residual_1_[i]) 
+        / finite_difference_increment_;
+  }
+}
+
+template <class Model, int FixedN>
+void SingleShootingContinuation<Model, FixedN>::
+computeBlockJacobiPreconditioner(
+    const double time, const double* state_vec, 
+    const double* current_solution_vec, 
+    BlockJacobiPreconditioner& preconditioner) {
+  const int dim_control_input_and_constraints 
+      = dim_control_input_ + dim_constraints_;
+  ocp_.computeOptimalityResidual(time, state_vec, current_solution_vec, 
+                                 optimality_residual_);
+  // The residual of each stage depends only on the control input and the 
+  // constraints of the stage under the fixed state and lambda. Therefore, the 
+  // same column of all blocks is computed by perturbing all stages at once.
+  for (int j=0; j<dim_control_input_and_constraints; ++j) {
+    for (int i=0; i<dim_solution_; ++i) {
+      incremented_solution_vec_[i] = current_solution_vec[i];
+    }
+    for (int i=0; i<ocp_.N(); ++i) {
+      incremented_solution_vec_[i*dim_control_input_and_constraints+j] 
+          += finite_difference_increment_;
+    }
+    ocp_.computeOptimalityResidualUnderFixedStateAndLambda(
+        time, state_vec, incremented_solution_vec_, optimality_residual_2_);
+    for (int i=0; i<dim_solution_; ++i) {
+      optimality_residual_2_[i] 
+          = (optimality_residual_2_[i]-optimality_residual_[i]) 
+            / finite_difference_increment_;
+    }
+    preconditioner.setColumnOfBlocks(j, optimality_residual_2_);
+  }
+  preconditioner.factorize();
+}
+
+template <class Model, int FixedN>
+void SingleShootingContinuation<Model, FixedN>::setExactJacobianVectorProduct(
+    const bool exact_jacobian_vector_product) {
+  exact_jacobian_vector_product_ = exact_jacobian_vector_product;
+}
+
+template <class Model, int FixedN>
+int SingleShootingContinuation<Model, FixedN>::dim_state() const {
+  return dim_state_;
+}
+
+template <class Model, int FixedN>
+int SingleShootingContinuation<Model, FixedN>::dim_control_input() const {
+  return dim_control_input_;
+}
+
+template <class Model, int FixedN>
+int SingleShootingContinuation<Model, FixedN>::dim_constraints() const {
+  return dim_constraints_;
+}
+
+template <class Model, int FixedN>
+int SingleShootingContinuation<Model, FixedN>::dim_solution() const {
+  return dim_solution_;
+}
+
+template <class Model, int FixedN>
+int SingleShootingContinuation<Model, FixedN>::N() const {
+  return ocp_.N();
+}
+
 } // namespace cgmres
 
 
@@ -7,13 +7,17 @@
 #include "optimal_control_problem.hpp"
 #include "time_varying_smooth_horizon.hpp"
 #include "linear_algebra.hpp"
+#include "aligned_matrix.hpp"
+#include "horizon_storage.hpp"
+#include "dual_number.hpp"
 
 
 namespace cgmres {
 
 // Provides the single-shooting two-point boundary-value problem of the 
 // finite-horizon optimal control problem.
-class SingleShootingOCP final : public OptimalControlProblem {
+template <class Model, int FixedN = kDynamicSize>
+class SingleShootingOCP final : public OptimalControlProblem<Model> {
 public:
   // Constructs SingleShootingOCP with setting parameters and allocates 
   // vectors and matrices.
@@ -33,16 +37,34 @@ public:
   SingleShootingOCP(const double T_f, const double alpha, const int N,
                     const double initial_time);
 
-  // Free vectors and matrices.
-  ~SingleShootingOCP();
-
   // Computes the optimaliy residual under time, state_vec, and solution_vec 
   // that represents the control input sequence. The result is set in 
-  // optimality_residual.
+  // optimality_residual. If Model provides hamiltonianDerivativesFunc(), 
+  // hxFunc() and huFunc() of each stage are replaced by one call of it in the 
+  // backward sweep.
   void computeOptimalityResidual(const double time, const double* state_vec, 
                                  const double* solution_vec,
                                  double* optimality_residual);
 
+  // Computes the optimaliy residual under time, state_vec, and solution_vec 
+  // with the state and the Lagrange multiplier over the horizon that are 
+  // computed in the latest computeOptimalityResidual(). The result is set in 
+  // optimality_residual.
+  void computeOptimalityResidualUnderFixedStateAndLambda(
+      const double time, const double* state_vec, const double* solution_vec,
+      double* optimality_residual);
+
+  // Computes the directional derivative of the optimality residual with 
+  // respect to solution_vec along direction_vec under time, state_vec, and 
+  // solution_vec, i.e., the product of the Jacobian of the optimality 
+  // residual and direction_vec. The derivative is computed exactly by the 
+  // forward-mode automatic differentiation, i.e., by computing the optimality 
+  // residual with the dual numbers. The result is set in 
+  // optimality_residual_derivative.
+  void computeOptimalityResidualDirectionalDerivative(
+      const double time, const double* state_vec, const double* solution_vec,
+      const double* direction_vec, double* optimality_residual_derivative);
+
   // Predicts the state in the finite future. Under time,state_vec, and 
   // solution_vec that represents the control input sequence., and 
   // prediction_length The result is set in predicted_state.
@@ -69,11 +91,248 @@ public:
   int N() const;
 
 private:
+  using OptimalControlProblem<Model>::model_;
+  using OptimalControlProblem<Model>::dim_state_;
+  using OptimalControlProblem<Model>::dim_control_input_;
+  using OptimalControlProblem<Model>::dim_constraints_;
+  using OptimalControlProblem<Model>::dim_control_input_and_constraints_;
+
   TimeVaryingSmoothHorizon horizon_;
   int dim_solution_, N_;
-  double *dx_vec_, **state_mat_, **lambda_mat_;
+  // The work vectors of a stage are sized by the compile-time dimensions of 
+  // Model.
+  double dx_vec_[dim_state_], hx_vec_[dim_state_];
+  // The sequences over the horizon are sized by FixedN if it is fixed.
+  HorizonMatrix<HorizonSize(FixedN, 1, 1), dim_state_> state_mat_, 
+      lambda_mat_;
+  HorizonArray<Dual, HorizonSize(FixedN, dim_control_input_and_constraints_)> 
+      dual_solution_vec_;
+  HorizonArray<Dual, HorizonSize(FixedN, dim_state_, dim_state_)> 
+      dual_state_mat_, dual_lambda_mat_;
+  Dual dual_dx_vec_[dim_state_], 
+      dual_hu_vec_[dim_control_input_and_constraints_];
 };
 
+template <class Model, int FixedN>
+SingleShootingOCP<Model, FixedN>::SingleShootingOCP(
+    const double T_f, const double alpha, const int N)
+  : OptimalControlProblem<Model>(),
+    horizon_(T_f, alpha),
+    dim_solution_(N*(model_.dim_control_input()+model_.dim_constraints())),
+    N_(N),
+    dx_vec_(),
+    hx_vec_(),
+    state_mat_(N+1, model_.dim_state()),
+    lambda_mat_(N+1, model_.dim_state()),
+    dual_solution_vec_(dim_solution_),
+    dual_state_mat_((N+1)*model_.dim_state()),
+    dual_lambda_mat_((N+1)*model_.dim_state()),
+    dual_dx_vec_(),
+    dual_hu_vec_() {
+}
+
+template <class Model, int FixedN>
+SingleShootingOCP<Model, FixedN>::SingleShootingOCP(
+    const double T_f, const double alpha, const int N, 
+    const double initial_time)
+  : OptimalControlProblem<Model>(),
+    horizon_(T_f, alpha, initial_time),
+    dim_solution_(N*(model_.dim_control_input()+model_.dim_constraints())),
+    N_(N),
+    dx_vec_(),
+    hx_vec_(),
+    state_mat_(N+1, model_.dim_state()),
+    lambda_mat_(N+1, model_.dim_state()),
+    dual_solution_vec_(dim_solution_),
+    dual_state_mat_((N+1)*model_.dim_state()),
+    dual_lambda_mat_((N+1)*model_.dim_state()),
+    dual_dx_vec_(),
+    dual_hu_vec_() {
+}
+
+template <class Model, int FixedN>
+void SingleShootingOCP<Model, FixedN>::computeOptimalityResidual(
+    const double time, const double* state_vec, const double* solution_vec, 
+    double* optimality_residual) {
+  double horizon_length = horizon_.getLength(time);
+  double delta_tau = horizon_length / N_;
+  // Compute the state trajectory over the horizon on the basis of the 
+  // time, solution_vec and the state_vec.
+  model_.stateFunc(time, state_vec, solution_vec, dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    state_mat_[1][i] = state_vec[i] + delta_tau * dx_vec_[i];
+  }
+  double tau = time + delta_tau;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    model_.stateFunc(
+        tau, state_mat_[i], 
+        &(solution_vec[i*dim_control_input_and_constraints_]), dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      state_mat_[i+1][j] = state_mat_[i][j] + delta_tau * dx_vec_[j];
+    }
+  }
+  // Compute the Lagrange multiplier over the horizon on the basis of 
+  // time, solution_vec and the state_vec.
+  model_.phixFunc(tau, state_mat_[N_], lambda_mat_[N_]);
+  if (modeltraits::HasHamiltonianDerivativesFunc<Model>::value) {
+    // The optimality residual of each stage is computed together with the 
+    // partial derivative of the Hamiltonian with respect to the state because 
+    // both of them are evaluated at the same state, control input, and lambda. 
+    // The state equation computed at once is not used. As in the separate 
+    // evaluation, the partial derivative with respect to the control input of 
+    // the i-th stage is evaluated two grid points before that with respect to 
+    // the state.
+    for (int i=N_-1; i>=1; --i, tau-=delta_tau) {
+      modeltraits::HamiltonianDerivativesFunc(
+          model_, tau-2*delta_tau, tau, state_mat_[i], 
+          &(solution_vec[i*dim_control_input_and_constraints_]), 
+          lambda_mat_[i+1], dx_vec_, hx_vec_, 
+          &(optimality_residual[i*dim_control_input_and_constraints_]));
+      for (int j=0; j<dim_state_; ++j) {
+        lambda_mat_[i][j] = lambda_mat_[i+1][j] + delta_tau * hx_vec_[j];
+      }
+    }
+    model_.huFunc(time, state_vec, solution_vec, lambda_mat_[1], 
+                  optimality_residual);
+    return;
+  }
+  for (int i=N_-1; i>=1; --i, tau-=delta_tau) {
+    model_.hxFunc(
+        tau, state_mat_[i], 
+        &(solution_vec[i*dim_control_input_and_constraints_]), 
+        lambda_mat_[i+1], dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      lambda_mat_[i][j] = lambda_mat_[i+1][j] + delta_tau * dx_vec_[j];
+    }
+  }
+  // Compute the erros in optimality over the horizon on the basis of the 
+  // control_input_vec and the state_vec.
+  computeOptimalityResidualUnderFixedStateAndLambda(time, state_vec, 
+                                                    solution_vec, 
+                                                    optimality_residual);
+}
+
+template <class Model, int FixedN>
+void SingleShootingOCP<Model, FixedN>::
+computeOptimalityResidualUnderFixedStateAndLambda(const double time, 
+                                                  const double* state_vec, 
+                                                  const double* solution_vec, 
+                                                  double* optimality_residual) {
+  double horizon_length = horizon_.getLength(time);
+  double delta_tau = horizon_length / N_;
+  model_.huFunc(time, state_vec, solution_vec, lambda_mat_[1], 
+                optimality_residual);
+  double tau = time;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    model_.huFunc(
+        tau, state_mat_[i], 
+        &(solution_vec[i*dim_control_input_and_constraints_]), 
+        lambda_mat_[i+1], 
+        &(optimality_residual[i*dim_control_input_and_constraints_]));
+  }
+}
+
+template <class Model, int FixedN>
+void SingleShootingOCP<Model, FixedN>::
+computeOptimalityResidualDirectionalDerivative(
+    const double time, const double* state_vec, const double* solution_vec,
+    const double* direction_vec, double* optimality_residual_derivative) {
+  double horizon_length = horizon_.getLength(time);
+  double delta_tau = horizon_length / N_;
+  // The derivatives of the solution are set by direction_vec and those of 
+  // the initial state are zero. The state and the Lagrange multiplier over 
+  // the horizon are then computed by the same recursions as 
+  // computeOptimalityResidual() with the dual numbers, whose i-th row is 
+  // stored from dual_state_mat_[i*dim_state_] and 
+  // dual_lambda_mat_[i*dim_state_].
+  for (int i=0; i<dim_solution_; ++i) {
+    dual_solution_vec_[i] = Dual(solution_vec[i], direction_vec[i]);
+  }
+  for (int i=0; i<dim_state_; ++i) {
+    dual_state_mat_[i] = Dual(state_vec[i]);
+  }
+  model_.stateFunc(time, dual_state_mat_.data(), dual_solution_vec_.data(), 
+                   dual_dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    dual_state_mat_[dim_state_+i] 
+        = dual_state_mat_[i] + delta_tau * dual_dx_vec_[i];
+  }
+  double tau = time + delta_tau;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    model_.stateFunc(
+        tau, &(dual_state_mat_[i*dim_state_]), 
+        &(dual_solution_vec_[i*dim_control_input_and_constraints_]), 
+        dual_dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      dual_state_mat_[(i+1)*dim_state_+j] 
+          = dual_state_mat_[i*dim_state_+j] + delta_tau * dual_dx_vec_[j];
+    }
+  }
+  model_.phixFunc(tau, &(dual_state_mat_[N_*dim_state_]), 
+                  &(dual_lambda_mat_[N_*dim_state_]));
+  for (int i=N_-1; i>=1; --i, tau-=delta_tau) {
+    model_.hxFunc(
+        tau, &(dual_state_mat_[i*dim_state_]), 
+        &(dual_solution_vec_[i*dim_control_input_and_constraints_]), 
+        &(dual_lambda_mat_[(i+1)*dim_state_]), dual_dx_vec_);
+    for (int j=0; j<dim_state_; ++j) {
+      dual_lambda_mat_[i*dim_state_+j] 
+          = dual_lambda_mat_[(i+1)*dim_state_+j] 
+            + delta_tau * dual_dx_vec_[j];
+    }
+  }
+  // Extract the derivatives of the optimality residual of each stage.
+  model_.huFunc(time, dual_state_mat_.data(), dual_solution_vec_.data(), 
+                &(dual_lambda_mat_[dim_state_]), dual_hu_vec_);
+  for (int j=0; j<dim_control_input_and_constraints_; ++j) {
+    optimality_residual_derivative[j] = dual_hu_vec_[j].derivative();
+  }
+  tau = time;
+  for (int i=1; i<N_; ++i, tau+=delta_tau) {
+    model_.huFunc(
+        tau, &(dual_state_mat_[i*dim_state_]), 
+        &(dual_solution_vec_[i*dim_control_input_and_constraints_]), 
+        &(dual_lambda_mat_[(i+1)*dim_state_]), dual_hu_vec_);
+    for (int j=0; j<dim_control_input_and_constraints_; ++j) {
+      optimality_residual_derivative[i*dim_control_input_and_constraints_+j] 
+          = dual_hu_vec_[j].derivative();
+    }
+  }
+}
+
+template <class Model, int FixedN>
+void SingleShootingOCP<Model, FixedN>::predictStateFromSolution(
+    const double current_time, const double* current_state, 
+    const double* solution_vec, const double prediction_length, 
+    double* predicted_state) {
+  model_.stateFunc(current_time, current_state, solution_vec, dx_vec_);
+  for (int i=0; i<dim_state_; ++i) {
+    predicted_state[i] =  current_state[i] + prediction_length * dx_vec_[i];
+  }
+}
+
+template <class Model, int FixedN>
+void SingleShootingOCP<Model, FixedN>::resetHorizonLength(
+    const double T_f, const double alpha, const double initial_time) {
+  horizon_.resetLength(T_f, alpha, initial_time);
+}
+
+template <class Model, int FixedN>
+void SingleShootingOCP<Model, FixedN>::resetHorizonLength(
+    const double initial_time) {
+  horizon_.resetLength(initial_time);
+}
+
+template <class Model, int FixedN>
+int SingleShootingOCP<Model, FixedN>::dim_solution() const {
+  return dim_solution_;
+}
+
+template <class Model, int FixedN>
+int SingleShootingOCP<Model, FixedN>::N() const {
+  return N_;
+}
+
 } // namespace cgmres
 
 
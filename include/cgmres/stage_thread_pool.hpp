@@ -0,0 +1,98 @@
+// Thread pool that evaluates the stages of the horizon in parallel in the 
+// multiple-shooting optimal control problems.
+
+#ifndef STAGE_THREAD_POOL_H
+#define STAGE_THREAD_POOL_H
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <algorithm>
+
+
+namespace cgmres {
+
+// Pool of worker threads that are created once by setNumThreads() and persist 
+// until the destruction. parallelFor() splits a range of the stages into 
+// num_threads() contiguous chunks, one of which is processed by the calling 
+// thread. The workers spin for a while before they sleep, so that the 
+// consecutive calls of parallelFor() in one update of the solution do not 
+// pay the cost of waking up the threads. parallelFor() does not allocate 
+// memory and must not be called concurrently.
+class StageThreadPool {
+public:
+  // Constructs a pool without worker threads, i.e., parallelFor() runs in the 
+  // calling thread.
+  StageThreadPool();
+
+  // Joins the worker threads.
+  ~StageThreadPool();
+
+  // Sets the number of the threads including the calling thread. If 
+  // num_threads is less than or equal to one, the worker threads are joined 
+  // and parallelFor() runs in the calling thread. num_threads is clamped to 
+  // std::thread::hardware_concurrency() if it is known because the spinning 
+  // workers would otherwise take the cores from the calling thread.
+  void setNumThreads(const int num_threads);
+
+  // Returns the number of the threads including the calling thread.
+  int num_threads() const;
+
+  // Calls function(thread_index, chunk_begin, chunk_end) for the 
+  // num_threads() contiguous chunks of [begin, end) in parallel and returns 
+  // after all of the calls return. thread_index is in [0, num_threads()) and 
+  // is distinct among the concurrent calls, which is used to select the 
+  // workspace of each thread. 
+  template <typename Function>
+  void parallelFor(const int begin, const int end, const Function& function) {
+    if (num_threads_ <= 1) {
+      function(0, begin, end);
+      return;
+    }
+    run(begin, end, &invoke<Function>, &function);
+  }
+
+  // Prohibits copy due to the threads.
+  StageThreadPool(const StageThreadPool&) = delete;
+  StageThreadPool& operator=(const StageThreadPool&) = delete;
+
+private:
+  using Invoker = void (*)(const void*, const int, const int, const int);
+
+  template <typename Function>
+  static void invoke(const void* function, const int thread_index, 
+                     const int begin, const int end) {
+    (*static_cast<const Function*>(function))(thread_index, begin, end);
+  }
+
+  // Dispatches the chunks to the workers, processes the first chunk, and 
+  // waits for the workers.
+  void run(const int begin, const int end, const Invoker invoker, 
+           const void* function);
+
+  // Processes the thread_index-th chunk of the current range.
+  void runChunk(const int thread_index);
+
+  // Processes the chunks of the ranges dispatched after generation until the 
+  // pool is terminated.
+  void workerLoop(const int thread_index, unsigned generation);
+
+  void joinWorkers();
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::atomic<unsigned> generation_;
+  std::atomic<int> num_running_workers_;
+  std::atomic<bool> is_terminated_;
+  int num_threads_, begin_, end_;
+  Invoker invoker_;
+  const void* function_;
+};
+
+} // namespace cgmres
+
+
+#endif // STAGE_THREAD_POOL_H
\ No newline at end of file
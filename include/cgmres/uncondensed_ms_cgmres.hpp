@@ -0,0 +1,432 @@
+// The multiple shooting based continuation GMRES (C/GMRES) method without 
+// condensing, a fast algorithm of nonlinear model predictive control (NMPC). 
+// This program is witten with reference to "Y. Shimizu, T. Ohtsuka, M. Diehl, 
+// A real‐time algorithm for nonlinear receding horizon control using multiple 
+// shooting and continuation/Krylov method, International Journal of Robust 
+// and Nonlinear Control, Vol. 19, No. 8, pp. 919-936 (2008)".
+
+#ifndef UNCONDENSED_MS_CGMRES_H
+#define UNCONDENSED_MS_CGMRES_H
+
+#include "matrixfree_gmres.hpp"
+#include "matrixfree_bicgstab.hpp"
+#include "matrixfree_idrs.hpp"
+#include "uncondensed_ms_continuation.hpp"
+#include "shooting_chain_preconditioner.hpp"
+#include "block_tridiagonal_lu.hpp"
+#include "cgmres_initializer.hpp"
+#include "linear_algebra.hpp"
+#include "horizon_storage.hpp"
+
+
+namespace cgmres {
+
+// Solver of the nonlinear optimal control problem for NMPC using the 
+// multiple shooting-based C/GMRES method whose linear problem is not 
+// condensed, i.e., the GMRES method solves for the updates of the control 
+// input, the constraints, the state, and lambda of all stages at once. 
+// Compared with MultipleShootingCGMRES, the dimension of the linear problem 
+// is larger, but each directional derivative of the optimality residual has 
+// no sequential recursion over the stages and is evaluated in parallel by 
+// setNumThreads(). This may pay off for long horizons on multi-core CPUs. 
+// The GMRES method is preconditioned by ShootingChainPreconditioner so that 
+// its iterations do not grow with N. Even so, kmax must be larger than for 
+// MultipleShootingCGMRES: about 1.5*(dim_control_input+dim_constraints 
+// +2*dim_state) iterations are needed per update, e.g., 17 for the cartpole 
+// instead of 10, and on a single core this solver is slower than 
+// MultipleShootingCGMRES on all the sample models. 
+// The main method is controlUpdate() that updates the solution of NMPC. 
+// Before using controlUpdate() method, you have to initialize the solution.
+// For this initialization, you are required to set parameters by
+// setParametersForInitialization() method and initializeSolution() method. 
+// Without these initialization, all components of the solution is zero.
+// The matrix-free Krylov method of controlUpdate() is KrylovMethod, which 
+// has the same interface as MatrixFreeGMRES, e.g., MatrixFreeBiCGStab or 
+// MatrixFreeIDRs. UncondensedMSCGMRES is this solver with 
+// ControlUpdateKrylovMethod. 
+// Model is the model of NMPC, e.g., NMPCModel generated by AutoGenU in the 
+// namespace named after the model, so that the solvers of different models 
+// can share one binary. If FixedN is not kDynamicSize, the solution and the 
+// other sequences over the horizon are members of the solver sized by 
+// FixedN, which must be equal to N passed to the constructor, and no memory 
+// is allocated for them. ShootingChainPreconditioner, BlockTridiagonalLU, 
+// and the initialization still allocate theirs in the constructor.
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN = kDynamicSize>
+class BasicUncondensedMSCGMRES {
+public:
+  // The model of NMPC, which the simulator also integrates.
+  using NMPCModel = Model;
+
+  // Constructs UncondensedMSCGMRES with setting parameters and allocates 
+  // vectors and matrices used in the C/GMRES method. 
+  // Arguments:
+  //  T_f, alpha: Parameters for the length of the horizon. The length horizon
+  //    at time t is given by T_f * (1-exp(-alpha*t)).
+  //  N: The number of the discretization of the horizon.
+  //  finite_difference_increment: Step length of the finite difference 
+  //     approximation of the OCP for the initialization.
+  //  zeta: A parameter for stabilization of the C/GMRES method. It may work
+  //    well to set this parameters as the reciprocal of the sampling period.
+  //  kmax: A parameter for the GMRES method. This parameter represents the
+  //     dimension of the Krylov subspace and maximum iteration number of the
+  //     GMRES method.
+  BasicUncondensedMSCGMRES(const double T_f, const double alpha, const int N, 
+                           const double finite_difference_increment, 
+                           const double zeta, const int kmax);
+
+  // Updates the solution by solving the matrix-free GMRES. The optimal control
+  // to be applied to the actual system is assigned in control_input_vec.
+  void controlUpdate(const double time, const double* state_vec, 
+                     const double sampling_period, double* control_input_vec);
+
+  // Initial value of the current optimal control input is assigned 
+  // in control_input_vec.
+  void getControlInput(double* control_input_vec) const;
+
+  // Sets parameters for the initialization of the solution of the C/GMRES 
+  // method. Call before initializes the solutino by initializeSolution().
+  // This initializaiton is done by solving an optimal control problem (OCP) 
+  // with horizon whose length is zero using the Newton-GMRES method.
+  // Argments:
+  //   initial_guess_solution: An initial guess solution of the OCP vectors
+  //     are composed of a contorl input vector and a Lagrange multiplier for
+  //     equality constraints.
+  //   newton_residual_tolerance: A convergence criteria for the Newton iteration. 
+  //     Newton iteration terminates when the error is less than this value.
+  //   max_newton_iteration: Maximum number of the Newton iteration. Newton 
+  //     iteration for the initialization terminates when the number of the 
+  //     iteration is equal to this value.
+  void setParametersForInitialization(const double* initial_guess_solution, 
+                                      const double newton_residual_tolerance,
+                                      const int max_newton_iteration);
+
+  // Initializes the solution of the C/GMRES method by solving the optimal
+  // control problem with the horizon whose length is zero. The control input 
+  // and the constraints of all stages are set by the solution of this OCP, 
+  // the state of all stages by initial_state_vec, and lambda of all stages 
+  // by the corresponding terminal cost gradient.
+  void initializeSolution(const double initial_time,  
+                          const double* initial_state_vec);
+
+  // Returns the squared norm of the optimality residual under time, state_vec, 
+  // and the current solution.
+  double getErrorNorm(const double time, const double* state_vec);
+
+  // Sets the parameters of the models of the continuation problem and of the 
+  // initialization, which are used from the next controlUpdate() and 
+  // initializeSolution(), respectively. This can be called from any thread, 
+  // also during controlUpdate(), which never waits for it. See 
+  // Model::setParameters().
+  template <class Parameters>
+  void setParameters(const Parameters& parameters);
+
+  // Sets the tolerances of the residual of the GMRES method. See 
+  // MultipleShootingCGMRES::setGMRESTolerance().
+  void setGMRESTolerance(const double absolute_tolerance, 
+                         const double relative_tolerance);
+
+  // Sets the maximum number of the restarts of the GMRES method. See 
+  // MultipleShootingCGMRES::setMaxGMRESRestarts().
+  void setMaxGMRESRestarts(const int max_restarts);
+
+  // Sets the block-Jacobi preconditioner for the control input and the 
+  // constraints in ShootingChainPreconditioner. The blocks are recomputed 
+  // every update_period calls of controlUpdate(). The default update_period 
+  // is 5 since without the blocks the GMRES method diverges on the sample 
+  // models even with kmax = 30. If update_period is zero, the blocks are the 
+  // identities. See MultipleShootingCGMRES::setBlockJacobiPreconditioner().
+  void setBlockJacobiPreconditioner(const int update_period);
+
+  // Sets whether the linear problem in controlUpdate() is solved directly by 
+  // BlockTridiagonalLU instead of the GMRES method. The block-tridiagonal 
+  // Jacobian of the optimality residual is assembled by the forward 
+  // difference with 3*(dim_control_input+dim_constraints+2*dim_state) 
+  // evaluations of the optimality residual independently of N and is 
+  // factorized in O(N) operations every update_period calls of 
+  // controlUpdate(). Between them, the factorization is reused and each 
+  // update costs only the right-hand side and the block substitutions. See 
+  // UncondensedMSContinuation::solveLinearProblemByBlockTridiagonalLU(). If 
+  // the matrix is singular, the GMRES method solves the linear problem of the 
+  // update and the matrix is reassembled in the next update. If update_period 
+  // is zero (default), the GMRES method is used and the matrices of the 
+  // factorization are not allocated.
+  void setBlockTridiagonalLU(const int update_period);
+
+  // Sets the number of the threads that evaluate the stages of the horizon 
+  // in parallel in controlUpdate() if N is greater than or equal to min_N. 
+  // Since the linear problem is not condensed, all the evaluations of the 
+  // optimality residual are parallel. The solution is the same as that of 
+  // the serial evaluation. num_threads is clamped to the number of the 
+  // hardware threads. The default is one thread.
+  void setNumThreads(const int num_threads, const int min_N);
+
+  // Sets the pool that evaluates the stages of the horizon instead of the 
+  // threads of setNumThreads(), so that the solvers of several models in one 
+  // process share the threads, e.g., 
+  //   cgmres::StageThreadPool thread_pool;
+  //   thread_pool.setNumThreads(4);
+  //   solver1.setThreadPool(thread_pool, 50);
+  //   solver2.setThreadPool(thread_pool, 50);
+  // The solvers sharing thread_pool must call controlUpdate() one after 
+  // another, and the number of the threads of thread_pool must not be changed 
+  // while it is shared. See MultipleShootingOCP::setThreadPool().
+  void setThreadPool(StageThreadPool& thread_pool, const int min_N);
+
+  // Returns the number of the GMRES iterations in the latest controlUpdate().
+  // If setBlockTridiagonalLU() is enabled and the matrix is not singular, 
+  // returns the number of the directional derivatives to assemble the 
+  // Jacobian instead.
+  int getGMRESIterations() const;
+
+  // Returns the residual norm of the GMRES method in the latest 
+  // controlUpdate(). If setBlockTridiagonalLU() is enabled and the matrix is 
+  // not singular, returns zero.
+  double getGMRESResidualNorm() const;
+
+  // Prohibits copy due to memory allocation.
+  BasicUncondensedMSCGMRES(const BasicUncondensedMSCGMRES&) = delete;
+  BasicUncondensedMSCGMRES& operator=(const BasicUncondensedMSCGMRES&) 
+      = delete;
+
+private:
+  UncondensedMSContinuation<Model, FixedN> continuation_problem_;
+  KrylovMethod<UncondensedMSContinuation<Model, FixedN>, const double, 
+               const double*, const double*> mfgmres_;
+  CGMRESInitializer<Model> solution_initializer_;
+  const int dim_state_, dim_control_input_, dim_constraints_, N_;
+  HorizonArray<double, HorizonSize(FixedN, Model::dim_control_input()
+                                               +Model::dim_constraints()
+                                               +2*Model::dim_state())> 
+      solution_vec_, solution_update_vec_;
+  double initial_control_input_and_constraints_vec_[
+      Model::dim_control_input()+Model::dim_constraints()];
+  double initial_lambda_vec_[Model::dim_state()];
+  ShootingChainPreconditioner preconditioner_;
+  int preconditioner_update_period_, num_updates_from_preconditioning_;
+  BlockTridiagonalLU block_tridiagonal_lu_;
+  int block_tridiagonal_lu_update_period_, num_updates_from_factorization_, 
+      num_directional_derivatives_;
+};
+
+// The solver with the GMRES method selected by ControlUpdateKrylovMethod, 
+// e.g., UncondensedMSCGMRES<NMPCModel> whose N and kmax are given to the 
+// constructor, or UncondensedMSCGMRES<NMPCModel, 50, 20> whose sequences 
+// over the horizon and the Krylov subspace are sized by N = 50 and 
+// kmax = 20 at compile time. 
+template <class Model, int FixedN = kDynamicSize, 
+          int FixedKmax = kDynamicSize>
+using UncondensedMSCGMRES = BasicUncondensedMSCGMRES<
+    Model, 
+    ControlUpdateKrylovMethod<
+        FixedKmax, HorizonSize(FixedN, Model::dim_control_input()
+                                           +Model::dim_constraints()
+                                           +2*Model::dim_state())>::
+        template Method, 
+    FixedN>;
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+BasicUncondensedMSCGMRES<Model, KrylovMethod, FixedN>::BasicUncondensedMSCGMRES(
+    const double T_f, const double alpha, const int N, 
+    const double finite_difference_increment, const double zeta, const int kmax)
+  : continuation_problem_(T_f, alpha, N, finite_difference_increment, zeta),
+    mfgmres_(continuation_problem_.dim_solution(), kmax),
+    solution_initializer_(finite_difference_increment, kmax),
+    dim_state_(continuation_problem_.dim_state()),
+    dim_control_input_(continuation_problem_.dim_control_input()),
+    dim_constraints_(continuation_problem_.dim_constraints()),
+    N_(N),
+    solution_vec_(continuation_problem_.dim_solution()),
+    solution_update_vec_(continuation_problem_.dim_solution()),
+    initial_control_input_and_constraints_vec_(),
+    initial_lambda_vec_(),
+    preconditioner_(N, dim_control_input_+dim_constraints_, dim_state_),
+    preconditioner_update_period_(5),
+    num_updates_from_preconditioning_(0),
+    block_tridiagonal_lu_(N, continuation_problem_.dim_stage()),
+    block_tridiagonal_lu_update_period_(0),
+    num_updates_from_factorization_(0),
+    num_directional_derivatives_(0) {
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicUncondensedMSCGMRES<Model, KrylovMethod, FixedN>::controlUpdate(
+    const double time, const double* state_vec, const double sampling_period, 
+    double* control_input_vec) {
+  continuation_problem_.syncParameters();
+  if (block_tridiagonal_lu_update_period_ > 0) {
+    num_directional_derivatives_ 
+        = continuation_problem_.solveLinearProblemByBlockTridiagonalLU(
+            time, state_vec, solution_vec_, 
+            (num_updates_from_factorization_ == 0), block_tridiagonal_lu_, 
+            solution_update_vec_);
+    num_updates_from_factorization_ = (num_updates_from_factorization_+1) 
+                                      % block_tridiagonal_lu_update_period_;
+  }
+  // If the matrix is singular, the GMRES method solves the problem of this 
+  // update and the matrix is reassembled in the next update.
+  if (block_tridiagonal_lu_update_period_ == 0 
+      || block_tridiagonal_lu_.is_singular()) {
+    num_updates_from_factorization_ = 0;
+    if (preconditioner_update_period_ > 0) {
+      if (num_updates_from_preconditioning_ == 0) {
+        continuation_problem_.computeBlockJacobiPreconditioner(
+            time, state_vec, solution_vec_, preconditioner_);
+      }
+      num_updates_from_preconditioning_ 
+          = (num_updates_from_preconditioning_+1) 
+            % preconditioner_update_period_;
+    }
+    mfgmres_.solveLinearProblem(preconditioner_, continuation_problem_, time, 
+                                state_vec, solution_vec_, 
+                                solution_update_vec_);
+  }
+  continuation_problem_.integrateSolution(solution_vec_, solution_update_vec_, 
+                                          sampling_period);
+  getControlInput(control_input_vec);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicUncondensedMSCGMRES<Model, KrylovMethod, FixedN>::getControlInput(
+    double* control_input_vec) const {
+  for (int i=0; i<dim_control_input_; ++i) {
+    control_input_vec[i] = solution_vec_[i];
+  }
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicUncondensedMSCGMRES<Model, KrylovMethod, FixedN>::
+setParametersForInitialization(const double* initial_guess_solution, 
+                               const double newton_residual_tolerance, 
+                               const int max_newton_iteration) {
+  solution_initializer_.setInitialGuessSolution(initial_guess_solution);
+  solution_initializer_.setCriterionsOfNewtonTermination(
+      newton_residual_tolerance, max_newton_iteration);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicUncondensedMSCGMRES<Model, KrylovMethod, FixedN>::initializeSolution(
+    const double initial_time, const double* initial_state_vec) {
+  continuation_problem_.syncParameters();
+  const int dim_control_input_and_constraints 
+      = dim_control_input_ + dim_constraints_;
+  solution_initializer_.computeInitialSolution(
+      initial_time, initial_state_vec, 
+      initial_control_input_and_constraints_vec_);
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_control_input_and_constraints; ++j) {
+      solution_vec_[i*dim_control_input_and_constraints+j] 
+          = initial_control_input_and_constraints_vec_[j];
+    }
+  }
+  double* state_seq = &(solution_vec_[N_*dim_control_input_and_constraints]);
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_state_; ++j) {
+      state_seq[i*dim_state_+j] = initial_state_vec[j];
+    }
+  }
+  solution_initializer_.getInitialLambda(initial_time, initial_state_vec, 
+                                         initial_lambda_vec_);
+  double* lambda_seq = &(state_seq[N_*dim_state_]);
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_state_; ++j) {
+      lambda_seq[i*dim_state_+j] = initial_lambda_vec_[j];
+    }
+  }
+  continuation_problem_.resetHorizonLength(initial_time);
+  num_updates_from_preconditioning_ = 0;
+  num_updates_from_factorization_ = 0;
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+double BasicUncondensedMSCGMRES<Model, KrylovMethod, FixedN>::getErrorNorm(
+    const double time, const double* state_vec) {
+  return continuation_problem_.computeErrorNorm(time, state_vec, 
+                                                solution_vec_);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+template <class Parameters>
+void BasicUncondensedMSCGMRES<Model, KrylovMethod, FixedN>::setParameters(
+    const Parameters& parameters) {
+  continuation_problem_.setParameters(parameters);
+  solution_initializer_.setParameters(parameters);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicUncondensedMSCGMRES<Model, KrylovMethod, FixedN>::setGMRESTolerance(
+    const double absolute_tolerance, const double relative_tolerance) {
+  mfgmres_.setTolerance(absolute_tolerance, relative_tolerance);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicUncondensedMSCGMRES<Model, KrylovMethod, FixedN>::setMaxGMRESRestarts(
+    const int max_restarts) {
+  mfgmres_.setMaxRestarts(max_restarts);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicUncondensedMSCGMRES<Model, KrylovMethod, FixedN>::
+setBlockJacobiPreconditioner(const int update_period) {
+  preconditioner_update_period_ = update_period;
+  num_updates_from_preconditioning_ = 0;
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicUncondensedMSCGMRES<Model, KrylovMethod, FixedN>::
+setBlockTridiagonalLU(const int update_period) {
+  block_tridiagonal_lu_update_period_ = update_period;
+  num_updates_from_factorization_ = 0;
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicUncondensedMSCGMRES<Model, KrylovMethod, FixedN>::setNumThreads(
+    const int num_threads, const int min_N) {
+  continuation_problem_.setNumThreads(num_threads, min_N);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+void BasicUncondensedMSCGMRES<Model, KrylovMethod, FixedN>::setThreadPool(
+    StageThreadPool& thread_pool, const int min_N) {
+  continuation_problem_.setThreadPool(thread_pool, min_N);
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+int BasicUncondensedMSCGMRES<Model, KrylovMethod, FixedN>::
+getGMRESIterations() const {
+  if (block_tridiagonal_lu_update_period_ > 0 
+      && !block_tridiagonal_lu_.is_singular()) {
+    return num_directional_derivatives_;
+  }
+  return mfgmres_.num_iterations();
+}
+
+template <class Model, template <class, typename...> class KrylovMethod, 
+          int FixedN>
+double BasicUncondensedMSCGMRES<Model, KrylovMethod, FixedN>::
+getGMRESResidualNorm() const {
+  if (block_tridiagonal_lu_update_period_ > 0 
+      && !block_tridiagonal_lu_.is_singular()) {
+    return 0;
+  }
+  return mfgmres_.residual_norm();
+}
+
+} // namespace cgmres
+
+
+#endif // UNCONDENSED_MS_CGMRES_H
\ No newline at end of file
@@ -0,0 +1,602 @@
+// This class provides the linear problem of the continuation transformation 
+// for the multiple-shooting optimal control problem without condensing, which 
+// is solved in Matrix-free GMRES. 
+
+#ifndef UNCONDENSED_MS_CONTINUATION_H
+#define UNCONDENSED_MS_CONTINUATION_H
+
+#include <cmath>
+#include "linear_algebra.hpp"
+#include "aligned_matrix.hpp"
+#include "horizon_storage.hpp"
+#include "multiple_shooting_ocp.hpp"
+#include "shooting_chain_preconditioner.hpp"
+#include "block_tridiagonal_lu.hpp"
+
+
+namespace cgmres {
+
+// Linear problem of the continuation transformation for the multiple-shooting 
+// optimal control problem whose unknowns are the control input and the 
+// constraints, the state, and lambda of all stages, i.e., the state and 
+// lambda are not condensed. The solution is the vector 
+// (U_0, ..., U_{N-1}, x_1, ..., x_N, lambda_1, ..., lambda_N), where U_i is 
+// the control input and the Lagrange multiplier for the equality constraints 
+// of the i-th stage. Since the optimality residual of each stage depends only 
+// on the unknowns of the stage and its neighbors, AxFunc() does not need the 
+// sequential recursion of the state and lambda of MultipleShootingContinuation 
+// and its stages are evaluated in parallel by setNumThreads(), at the cost of 
+// the larger dimension of the linear problem. This class is intended for use 
+// with MatrixfreeGMRES class. 
+template <class Model, int FixedN = kDynamicSize>
+class UncondensedMSContinuation {
+public:
+  // Constructs UncondensedMSContinuation with setting parameters and 
+  // allocates vectors and matrices.
+  // Arguments:
+  //  T_f, alpha: Parameters for the length of the horizon. The length horizon
+  //    at time t is given by T_f * (1-exp(-alpha*t)).
+  //  N: The number of the discretization of the horizon.
+  //  finite_difference_increment: Step length of the finite difference 
+  //     approximation of the OCP for the initialization.
+  //  zeta: A parameter for stabilization of the C/GMRES method. It may work
+  //    well to set this parameters as the reciprocal of the sampling period.
+  UncondensedMSContinuation(const double T_f, const double alpha, const int N,
+                            const double finite_difference_increment,
+                            const double zeta);
+
+  // Constructs UncondensedMSContinuation with setting parameters and 
+  // allocates vectors and matrices.
+  // Arguments:
+  //  T_f, alpha: Parameters for the length of the horizon. The length horizon
+  //    at time t is given by T_f * (1-exp(-alpha*t)).
+  //  N: The number of the discretization of the horizon.
+  //  initial_time: Initial time for the length of the horizon.
+  //  finite_difference_increment: Step length of the finite difference 
+  //     approximation of the OCP for the initialization.
+  //  zeta: A parameter for stabilization of the C/GMRES method. It may work
+  //    well to set this parameters as the reciprocal of the sampling period.
+  UncondensedMSContinuation(const double T_f, const double alpha, const int N,
+                            const double initial_time, 
+                            const double finite_difference_increment,
+                            const double zeta);
+
+  // Integrates the solution for given optimal update vector of the solution 
+  // and the integration length.
+  void integrateSolution(double* solution_vec, 
+                         const double* solution_update_vec, 
+                         const double integration_length);
+
+  // Computes and returns the norm of the errors in optimality under the 
+  // state_vec and the current solution.
+  double computeErrorNorm(const double time, const double* state_vec, 
+                          const double* solution_vec);
+
+  // Reset the length of the horizon by resetting parameters related to the 
+  // horizon.
+  void resetHorizonLength(const double T_f, const double alpha, 
+                          const double initial_time);
+
+  // Reset the length of the horizon by resetting parameters related to the 
+  // horizon.
+  void resetHorizonLength(const double initial_time);
+
+  // Copies the runtime parameters of the model into the optimal control 
+  // problem. See OptimalControlProblem::syncParameters().
+  void syncParameters();
+
+  // Sets the parameters of the model of the optimal control problem. See 
+  // OptimalControlProblem::setParameters().
+  template <class Parameters>
+  void setParameters(const Parameters& parameters);
+
+  // Computes a vector correspongin to b in Ax=b. This function is called in
+  // MatrixfreeGMRES.
+  void bFunc(const double time, const double* state_vec, 
+             const double* current_solution_vec, 
+             const double* current_solution_update_vec, double* b_vec);
+
+  // Computes a vector correspongin to Ax in Ax=b by the forward difference 
+  // approximation. This function is called in MatrixfreeGMRES. 
+  void AxFunc(const double time, const double* state_vec, 
+              const double* current_solution_vec, const double* direction_vec, 
+              double* ax_vec);
+
+  // Computes the blocks of the block-Jacobi preconditioner for the control 
+  // input and the constraints of preconditioner, i.e., the Jacobians of the 
+  // optimality residual of each stage with respect to the control input and 
+  // the constraints of the stage, by the forward difference and factorizes 
+  // them. 
+  void computeBlockJacobiPreconditioner(
+      const double time, const double* state_vec, const double* solution_vec, 
+      ShootingChainPreconditioner& preconditioner);
+
+  // Solves the linear problem directly by block_tridiagonal_lu instead of 
+  // MatrixfreeGMRES and adds the solution to current_solution_update_vec. If 
+  // the unknowns are ordered stage by stage as (U_i, x_{i+1}, lambda_{i+1}), 
+  // the coefficient matrix is block-tridiagonal since the optimality residual 
+  // of each stage depends only on the unknowns of the stage and its 
+  // neighbors. If assemble_jacobian is true, the matrix is assembled by the 
+  // forward difference and factorized. Since the stages whose indices are 
+  // equal modulo 3 do not share any block row, they are perturbed at once 
+  // and the matrix is assembled by 3*(dim_control_input+dim_constraints 
+  // +2*dim_state) calls of AxFunc() independently of N. Otherwise, the 
+  // factorization of the previous call is reused. If the factorization is 
+  // singular, current_solution_update_vec is not changed; see 
+  // BlockTridiagonalLU::is_singular(). Returns the number of the calls of 
+  // AxFunc().
+  int solveLinearProblemByBlockTridiagonalLU(
+      const double time, const double* state_vec, 
+      const double* current_solution_vec, const bool assemble_jacobian, 
+      BlockTridiagonalLU& block_tridiagonal_lu, 
+      double* current_solution_update_vec);
+
+  // Sets the number of the threads that evaluate the stages of the horizon 
+  // in parallel if N is greater than or equal to min_N. See 
+  // MultipleShootingOCP::setNumThreads(). The default is one thread.
+  void setNumThreads(const int num_threads, const int min_N);
+
+  // Sets the pool shared with other solvers that evaluates the stages of the 
+  // horizon instead of the threads of setNumThreads(). See 
+  // MultipleShootingOCP::setThreadPool().
+  void setThreadPool(StageThreadPool& thread_pool, const int min_N);
+
+  // Returns the dimension of the state.
+  int dim_state() const;
+
+  // Returns the dimension of the control input.
+  int dim_control_input() const;
+
+  // Returns the dimension of the equality constraints.
+  int dim_constraints() const;
+
+  // Returns the dimension of the solution, which is equivalent to 
+  // N*(dim_control_input+dim_constraints+2*dim_state).
+  int dim_solution() const;
+
+  // Returns the grid number of the horizon.
+  int N() const;
+
+  // Returns the dimension of the unknowns of each stage, which is equivalent 
+  // to dim_control_input+dim_constraints+2*dim_state.
+  int dim_stage() const;
+
+  // Prohibits copy due to memory allocation.
+  UncondensedMSContinuation(const UncondensedMSContinuation&) = delete;
+  UncondensedMSContinuation& operator=(const UncondensedMSContinuation&) 
+      = delete;
+
+private:
+  // The dimensions of the sequences of the control input and the constraints 
+  // and of the solution over the horizon if FixedN is fixed, and kDynamicSize 
+  // otherwise.
+  static constexpr int kDimSeq = HorizonSize(
+      FixedN, Model::dim_control_input()+Model::dim_constraints());
+  static constexpr int kDimSolution = HorizonSize(
+      FixedN, 
+      Model::dim_control_input()+Model::dim_constraints()
+          +2*Model::dim_state());
+
+  MultipleShootingOCP<Model, FixedN> ocp_;
+  const int dim_state_, dim_control_input_, dim_constraints_, 
+      dim_control_input_and_constraints_seq_, dim_solution_, dim_stage_, N_;
+  double finite_difference_increment_, zeta_, incremented_time_; 
+  double incremented_state_vec_[Model::dim_state()];
+  HorizonArray<double, kDimSolution> incremented_solution_vec_, 
+      optimality_residual_, optimality_residual_1_, optimality_residual_2_;
+  HorizonArray<double, kDimSeq> incremented_control_input_and_constraints_seq_, 
+      control_input_and_constraints_residual_seq_, 
+      control_input_and_constraints_residual_seq_2_;
+  HorizonArray<double, kDimSolution> b_vec_, direction_vec_, ax_vec_, 
+      stage_order_vec_;
+  HorizonMatrix<FixedN, Model::dim_state()> state_mat_, lambda_mat_, 
+      state_residual_mat_, lambda_residual_mat_;
+
+  // Copies the state and lambda of solution_vec into state_mat_ and 
+  // lambda_mat_.
+  void unpackStateAndLambda(const double* solution_vec);
+
+  // Computes the optimality residual of the uncondensed problem under time, 
+  // state_vec, and solution_vec. The state and lambda of solution_vec are 
+  // copied into the workspaces of MultipleShootingOCP and the residuals for 
+  // them are copied back into optimality_residual.
+  void computeOptimalityResidual(const double time, const double* state_vec, 
+                                 const double* solution_vec, 
+                                 double* optimality_residual);
+
+  // Reorders vec, which is ordered as the solution, stage by stage into 
+  // stage_order_vec.
+  void convertToStageOrder(const double* vec, double* stage_order_vec) const;
+
+  // Reorders stage_order_vec, which is ordered stage by stage, as the 
+  // solution into vec.
+  void convertFromStageOrder(const double* stage_order_vec, 
+                             double* vec) const;
+};
+
+template <class Model, int FixedN>
+UncondensedMSContinuation<Model, FixedN>::UncondensedMSContinuation(
+    const double T_f, const double alpha, const int N,
+    const double finite_difference_increment, const double zeta)
+  : ocp_(T_f, alpha, N), 
+    dim_state_(ocp_.dim_state()),
+    dim_control_input_(ocp_.dim_control_input()),
+    dim_constraints_(ocp_.dim_constraints()),
+    dim_control_input_and_constraints_seq_(
+        N*(ocp_.dim_control_input()+ocp_.dim_constraints())), 
+    dim_solution_(
+        N*(ocp_.dim_control_input()+ocp_.dim_constraints()
+           +2*ocp_.dim_state())),
+    dim_stage_(
+        ocp_.dim_control_input()+ocp_.dim_constraints()+2*ocp_.dim_state()),
+    N_(N),
+    finite_difference_increment_(finite_difference_increment),
+    zeta_(zeta),
+    incremented_time_(0),
+    incremented_state_vec_(),
+    incremented_solution_vec_(dim_solution_),
+    optimality_residual_(dim_solution_),
+    optimality_residual_1_(dim_solution_),
+    optimality_residual_2_(dim_solution_),
+    incremented_control_input_and_constraints_seq_(
+        dim_control_input_and_constraints_seq_),
+    control_input_and_constraints_residual_seq_(
+        dim_control_input_and_constraints_seq_),
+    control_input_and_constraints_residual_seq_2_(
+        dim_control_input_and_constraints_seq_),
+    b_vec_(dim_solution_),
+    direction_vec_(dim_solution_),
+    ax_vec_(dim_solution_),
+    stage_order_vec_(dim_solution_),
+    state_mat_(N_, dim_state_),
+    lambda_mat_(N_, dim_state_),
+    state_residual_mat_(N_, dim_state_),
+    lambda_residual_mat_(N_, dim_state_) {
+}
+
+template <class Model, int FixedN>
+UncondensedMSContinuation<Model, FixedN>::UncondensedMSContinuation(
+    const double T_f, const double alpha, const int N,
+    const double initial_time,
+    const double finite_difference_increment, const double zeta)
+  : ocp_(T_f, alpha, N, initial_time), 
+    dim_state_(ocp_.dim_state()),
+    dim_control_input_(ocp_.dim_control_input()),
+    dim_constraints_(ocp_.dim_constraints()),
+    dim_control_input_and_constraints_seq_(
+        N*(ocp_.dim_control_input()+ocp_.dim_constraints())), 
+    dim_solution_(
+        N*(ocp_.dim_control_input()+ocp_.dim_constraints()
+           +2*ocp_.dim_state())),
+    dim_stage_(
+        ocp_.dim_control_input()+ocp_.dim_constraints()+2*ocp_.dim_state()),
+    N_(N),
+    finite_difference_increment_(finite_difference_increment),
+    zeta_(zeta),
+    incremented_time_(0),
+    incremented_state_vec_(),
+    incremented_solution_vec_(dim_solution_),
+    optimality_residual_(dim_solution_),
+    optimality_residual_1_(dim_solution_),
+    optimality_residual_2_(dim_solution_),
+    incremented_control_input_and_constraints_seq_(
+        dim_control_input_and_constraints_seq_),
+    control_input_and_constraints_residual_seq_(
+        dim_control_input_and_constraints_seq_),
+    control_input_and_constraints_residual_seq_2_(
+        dim_control_input_and_constraints_seq_),
+    b_vec_(dim_solution_),
+    direction_vec_(dim_solution_),
+    ax_vec_(dim_solution_),
+    stage_order_vec_(dim_solution_),
+    state_mat_(N_, dim_state_),
+    lambda_mat_(N_, dim_state_),
+    state_residual_mat_(N_, dim_state_),
+    lambda_residual_mat_(N_, dim_state_) {
+}
+
+template <class Model, int FixedN>
+void UncondensedMSContinuation<Model, FixedN>::integrateSolution(
+    double* solution_vec, const double* solution_update_vec, 
+    const double integration_length) {
+  linearalgebra::AddScaledVector(dim_solution_, integration_length, 
+                                 solution_update_vec, solution_vec);
+}
+
+template <class Model, int FixedN>
+double UncondensedMSContinuation<Model, FixedN>::computeErrorNorm(
+    const double time, const double* state_vec, const double* solution_vec) {
+  computeOptimalityResidual(time, state_vec, solution_vec, 
+                            optimality_residual_);
+  return std::sqrt(
+      linearalgebra::SquaredNorm(dim_solution_, optimality_residual_));
+}
+
+template <class Model, int FixedN>
+void UncondensedMSContinuation<Model, FixedN>::resetHorizonLength(
+    const double T_f, const double alpha, const double initial_time) {
+  ocp_.resetHorizonLength(T_f, alpha, initial_time);
+}
+
+template <class Model, int FixedN>
+void UncondensedMSContinuation<Model, FixedN>::resetHorizonLength(
+    const double initial_time) {
+  ocp_.resetHorizonLength(initial_time);
+}
+
+template <class Model, int FixedN>
+void UncondensedMSContinuation<Model, FixedN>::syncParameters() {
+  ocp_.syncParameters();
+}
+
+template <class Model, int FixedN>
+template <class Parameters>
+void UncondensedMSContinuation<Model, FixedN>::setParameters(
+    const Parameters& parameters) {
+  ocp_.setParameters(parameters);
+}
+
+template <class Model, int FixedN>
+void UncondensedMSContinuation<Model, FixedN>::bFunc(
+    const double time, const double* state_vec, 
+    const double* current_solution_vec, 
+    const double* current_solution_update_vec, double* b_vec) {
+  incremented_time_ = time + finite_difference_increment_;
+  ocp_.predictStateFromSolution(time, state_vec, current_solution_vec,
+                                finite_difference_increment_, 
+                                incremented_state_vec_);
+  linearalgebra::ScaledSum(dim_solution_, current_solution_vec, 
+                           finite_difference_increment_, 
+                           current_solution_update_vec, 
+                           incremented_solution_vec_);
+  computeOptimalityResidual(time, state_vec, current_solution_vec, 
+                            optimality_residual_);
+  computeOptimalityResidual(incremented_time_, incremented_state_vec_, 
+                            current_solution_vec, optimality_residual_1_);
+  computeOptimalityResidual(incremented_time_, incremented_state_vec_, 
+                            incremented_solution_vec_, optimality_residual_2_);
+  for (int i=0; i<dim_solution_; ++i) {
+    b_vec[i] = (1/finite_difference_increment_-zeta_) * optimality_residual_[i] 
+        - optimality_residual_2_[i] / finite_difference_increment_;
+  }
+}
+
+template <class Model, int FixedN>
+void UncondensedMSContinuation<Model, FixedN>::AxFunc(
+    const double time, const double* state_vec, 
+    const double* current_solution_vec, const double* direction_vec, 
+    double* ax_vec) {
+  linearalgebra::ScaledSum(dim_solution_, current_solution_vec, 
+                           finite_difference_increment_, direction_vec, 
+                           incremented_solution_vec_);
+  computeOptimalityResidual(incremented_time_, incremented_state_vec_, 
+                            incremented_solution_vec_, optimality_residual_2_);
+  for (int i=0; i<dim_solution_; ++i) {
+    ax_vec[i] = 
+        (optimality_residual_2_[i]-optimality_residual_1_[i]) 
+        / finite_difference_increment_;
+  }
+}
+
+template <class Model, int FixedN>
+void UncondensedMSContinuation<Model, FixedN>::computeBlockJacobiPreconditioner(
+    const double time, const double* state_vec, const double* solution_vec, 
+    ShootingChainPreconditioner& preconditioner) {
+  const int dim_control_input_and_constraints 
+      = dim_control_input_ + dim_constraints_;
+  unpackStateAndLambda(solution_vec);
+  ocp_.computeOptimalityResidualForControlInputAndConstraints(
+      time, state_vec, solution_vec, state_mat_, lambda_mat_, 
+      control_input_and_constraints_residual_seq_);
+  // The same column of all blocks is computed by perturbing all stages at 
+  // once as MultipleShootingContinuation::computeBlockJacobiPreconditioner().
+  for (int j=0; j<dim_control_input_and_constraints; ++j) {
+    for (int i=0; i<dim_control_input_and_constraints_seq_; ++i) {
+      incremented_control_input_and_constraints_seq_[i] = solution_vec[i];
+    }
+    for (int i=0; i<N_; ++i) {
+      incremented_control_input_and_constraints_seq_[
+          i*dim_control_input_and_constraints+j] 
+          += finite_difference_increment_;
+    }
+    ocp_.computeOptimalityResidualForControlInputAndConstraints(
+        time, state_vec, incremented_control_input_and_constraints_seq_, 
+        state_mat_, lambda_mat_, control_input_and_constraints_residual_seq_2_);
+    for (int i=0; i<dim_control_input_and_constraints_seq_; ++i) {
+      control_input_and_constraints_residual_seq_2_[i] 
+          = (control_input_and_constraints_residual_seq_2_[i]
+              -control_input_and_constraints_residual_seq_[i]) 
+            / finite_difference_increment_;
+    }
+    preconditioner.control_input_preconditioner().setColumnOfBlocks(
+        j, control_input_and_constraints_residual_seq_2_);
+  }
+  preconditioner.control_input_preconditioner().factorize();
+}
+
+template <class Model, int FixedN>
+int UncondensedMSContinuation<Model, FixedN>::
+solveLinearProblemByBlockTridiagonalLU(
+    const double time, const double* state_vec, 
+    const double* current_solution_vec, const bool assemble_jacobian, 
+    BlockTridiagonalLU& block_tridiagonal_lu, 
+    double* current_solution_update_vec) {
+  // b_vec_ is the residual of the linear problem under the current update as 
+  // the initial residual of MatrixfreeGMRES. 
+  bFunc(time, state_vec, current_solution_vec, current_solution_update_vec, 
+        b_vec_);
+  int num_directional_derivatives = 0;
+  if (assemble_jacobian) {
+    // The stages of the same color, i.e., the same index modulo 3, are 
+    // perturbed at once. The rows of the i-th stage then contain the column 
+    // of the block coupled with the unique stage of the color among the 
+    // (i-1)-th, i-th, and (i+1)-th stages.
+    for (int color=0; color<3 && color<N_; ++color) {
+      for (int j=0; j<dim_stage_; ++j) {
+        for (int i=0; i<dim_solution_; ++i) {
+          stage_order_vec_[i] = 0;
+        }
+        for (int i=color; i<N_; i+=3) {
+          stage_order_vec_[i*dim_stage_+j] = 1;
+        }
+        convertFromStageOrder(stage_order_vec_, direction_vec_);
+        AxFunc(time, state_vec, current_solution_vec, direction_vec_, ax_vec_);
+        ++num_directional_derivatives;
+        convertToStageOrder(ax_vec_, stage_order_vec_);
+        for (int i=0; i<N_; ++i) {
+          // The perturbed stage among the neighbors is i, i+1, or i-1 if 
+          // (color-i) modulo 3 is 0, 1, or 2, respectively.
+          const int perturbed_stage = i + (color-i%3+4)%3 - 1;
+          if (perturbed_stage >= 0 && perturbed_stage < N_) {
+            block_tridiagonal_lu.setColumnOfBlock(
+                i, perturbed_stage, j, &(stage_order_vec_[i*dim_stage_]));
+          }
+        }
+      }
+    }
+    block_tridiagonal_lu.factorize();
+  }
+  if (block_tridiagonal_lu.is_singular()) {
+    return num_directional_derivatives;
+  }
+  convertToStageOrder(b_vec_, ax_vec_);
+  block_tridiagonal_lu.solve(ax_vec_, stage_order_vec_);
+  convertFromStageOrder(stage_order_vec_, direction_vec_);
+  linearalgebra::AddScaledVector(dim_solution_, 1, direction_vec_, 
+                                 current_solution_update_vec);
+  return num_directional_derivatives;
+}
+
+template <class Model, int FixedN>
+void UncondensedMSContinuation<Model, FixedN>::setNumThreads(
+    const int num_threads, const int min_N) {
+  ocp_.setNumThreads(num_threads, min_N);
+}
+
+template <class Model, int FixedN>
+void UncondensedMSContinuation<Model, FixedN>::setThreadPool(
+    StageThreadPool& thread_pool, const int min_N) {
+  ocp_.setThreadPool(thread_pool, min_N);
+}
+
+template <class Model, int FixedN>
+int UncondensedMSContinuation<Model, FixedN>::dim_state() const {
+  return dim_state_;
+}
+
+template <class Model, int FixedN>
+int UncondensedMSContinuation<Model, FixedN>::dim_control_input() const {
+  return dim_control_input_;
+}
+
+template <class Model, int FixedN>
+int UncondensedMSContinuation<Model, FixedN>::dim_constraints() const {
+  return dim_constraints_;
+}
+
+template <class Model, int FixedN>
+int UncondensedMSContinuation<Model, FixedN>::dim_solution() const {
+  return dim_solution_;
+}
+
+template <class Model, int FixedN>
+int UncondensedMSContinuation<Model, FixedN>::N() const {
+  return N_;
+}
+
+template <class Model, int FixedN>
+int UncondensedMSContinuation<Model, FixedN>::dim_stage() const {
+  return dim_stage_;
+}
+
+template <class Model, int FixedN>
+void UncondensedMSContinuation<Model, FixedN>::unpackStateAndLambda(
+    const double* solution_vec) {
+  const double* state_seq 
+      = &(solution_vec[dim_control_input_and_constraints_seq_]);
+  const double* lambda_seq = &(state_seq[N_*dim_state_]);
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_state_; ++j) {
+      state_mat_[i][j] = state_seq[i*dim_state_+j];
+    }
+  }
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_state_; ++j) {
+      lambda_mat_[i][j] = lambda_seq[i*dim_state_+j];
+    }
+  }
+}
+
+template <class Model, int FixedN>
+void UncondensedMSContinuation<Model, FixedN>::computeOptimalityResidual(
+    const double time, const double* state_vec, const double* solution_vec, 
+    double* optimality_residual) {
+  unpackStateAndLambda(solution_vec);
+  ocp_.computeOptimalityResidual(time, state_vec, solution_vec, state_mat_, 
+                                 lambda_mat_, optimality_residual, 
+                                 state_residual_mat_, lambda_residual_mat_);
+  double* state_residual_seq 
+      = &(optimality_residual[dim_control_input_and_constraints_seq_]);
+  double* lambda_residual_seq = &(state_residual_seq[N_*dim_state_]);
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_state_; ++j) {
+      state_residual_seq[i*dim_state_+j] = state_residual_mat_[i][j];
+    }
+  }
+  for (int i=0; i<N_; ++i) {
+    for (int j=0; j<dim_state_; ++j) {
+      lambda_residual_seq[i*dim_state_+j] = lambda_residual_mat_[i][j];
+    }
+  }
+}
+
+template <class Model, int FixedN>
+void UncondensedMSContinuation<Model, FixedN>::convertToStageOrder(
+    const double* vec, double* stage_order_vec) const {
+  const int dim_control_input_and_constraints 
+      = dim_control_input_ + dim_constraints_;
+  const double* state_seq = &(vec[dim_control_input_and_constraints_seq_]);
+  const double* lambda_seq = &(state_seq[N_*dim_state_]);
+  for (int i=0; i<N_; ++i) {
+    double* stage_vec = &(stage_order_vec[i*dim_stage_]);
+    for (int j=0; j<dim_control_input_and_constraints; ++j) {
+      stage_vec[j] = vec[i*dim_control_input_and_constraints+j];
+    }
+    stage_vec = &(stage_vec[dim_control_input_and_constraints]);
+    for (int j=0; j<dim_state_; ++j) {
+      stage_vec[j] = state_seq[i*dim_state_+j];
+    }
+    stage_vec = &(stage_vec[dim_state_]);
+    for (int j=0; j<dim_state_; ++j) {
+      stage_vec[j] = lambda_seq[i*dim_state_+j];
+    }
+  }
+}
+
+template <class Model, int FixedN>
+void UncondensedMSContinuation<Model, FixedN>::convertFromStageOrder(
+    const double* stage_order_vec, double* vec) const {
+  const int dim_control_input_and_constraints 
+      = dim_control_input_ + dim_constraints_;
+  double* state_seq = &(vec[dim_control_input_and_constraints_seq_]);
+  double* lambda_seq = &(state_seq[N_*dim_state_]);
+  for (int i=0; i<N_; ++i) {
+    const double* stage_vec = &(stage_order_vec[i*dim_stage_]);
+    for (int j=0; j<dim_control_input_and_constraints; ++j) {
+      vec[i*dim_control_input_and_constraints+j] = stage_vec[j];
+    }
+    stage_vec = &(stage_vec[dim_control_input_and_constraints]);
+    for (int j=0; j<dim_state_; ++j) {
+      state_seq[i*dim_state_+j] = stage_vec[j];
+    }
+    stage_vec = &(stage_vec[dim_state_]);
+    for (int j=0; j<dim_state_; ++j) {
+      lambda_seq[i*dim_state_+j] = stage_vec[j];
+    }
+  }
+}
+
+} // namespace cgmres
+
+
+#endif // UNCONDENSED_MS_CONTINUATION_H
\ No newline at end of file
@@ -8,13 +8,16 @@
 #include "input_saturation_functions.hpp"
 #include "optimal_control_problem.hpp"
 #include "linear_algebra.hpp"
+#include "dual_number.hpp"
 
 
 namespace cgmres {
 
 // Privides the optimal control problem (OCP) with horizon whose length is zero.
 // The OCP also consider the constrains provided by InputSaturationSet.
-class ZeroHorizonOCPWithInputSaturation final : public OptimalControlProblem {
+template <class Model>
+class ZeroHorizonOCPWithInputSaturation final 
+    : public OptimalControlProblem<Model> {
 public:
   // Allocates a vector.
   ZeroHorizonOCPWithInputSaturation(
@@ -30,6 +33,16 @@ public:
                                  const double* solution_vec,
                                  double* optimality_residual);
 
+  // Computes the directional derivative of the optimality residual with 
+  // respect to solution_vec along direction_vec under time, state_vec, and 
+  // solution_vec, i.e., the product of the Jacobian of the optimality 
+  // residual and direction_vec. The derivative is computed exactly by the 
+  // forward-mode automatic differentiation. The result is set in 
+  // optimality_residual_derivative.
+  void computeOptimalityResidualDirectionalDerivative(
+      const double time, const double* state_vec, const double* solution_vec,
+      const double* direction_vec, double* optimality_residual_derivative);
+
   // Computes the partial derivative of the terminal cost with respect to
   // the state.
   void computeTerminalCostDerivative(const double time, const double* state_vec,
@@ -44,11 +57,117 @@ public:
   int dim_solution() const override;
 
 private:
+  using OptimalControlProblem<Model>::model_;
+  using OptimalControlProblem<Model>::dim_state_;
+  using OptimalControlProblem<Model>::dim_control_input_;
+  using OptimalControlProblem<Model>::dim_constraints_;
+  using OptimalControlProblem<Model>::dim_control_input_and_constraints_;
+
   InputSaturationSet input_saturation_set_;
   int dim_solution_, dim_saturation_;
-  double *lambda_vec_;
+  // The work vectors of a stage are sized by the compile-time dimensions of 
+  // Model.
+  double lambda_vec_[dim_state_];
+  Dual dual_state_vec_[dim_state_];
+  Dual *dual_solution_vec_;
+  Dual dual_lambda_vec_[dim_state_];
+  Dual *dual_optimality_residual_;
 };
 
+template <class Model>
+ZeroHorizonOCPWithInputSaturation<Model>::ZeroHorizonOCPWithInputSaturation(
+    const InputSaturationSet& input_saturation_set)
+  : OptimalControlProblem<Model>(),
+    input_saturation_set_(input_saturation_set),
+    dim_solution_(model_.dim_control_input()+model_.dim_constraints()
+                  +2*input_saturation_set.dim_saturation()),
+    dim_saturation_(input_saturation_set.dim_saturation()),
+    lambda_vec_(),
+    dual_state_vec_(),
+    dual_solution_vec_(new Dual[dim_solution_]),
+    dual_lambda_vec_(),
+    dual_optimality_residual_(new Dual[dim_solution_]) {
+}
+
+template <class Model>
+ZeroHorizonOCPWithInputSaturation<Model>::~ZeroHorizonOCPWithInputSaturation() {
+  delete[] dual_solution_vec_;
+  delete[] dual_optimality_residual_;
+}
+
+template <class Model>
+void ZeroHorizonOCPWithInputSaturation<Model>::computeOptimalityResidual(
+    const double time, const double* state_vec,
+    const double* solution_vec, double* optimality_residual) {
+  model_.phixFunc(time, state_vec, lambda_vec_);
+  model_.huFunc(time, state_vec, solution_vec, lambda_vec_, 
+                optimality_residual);
+  inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
+      input_saturation_set_, solution_vec, 
+      &(solution_vec[dim_control_input_and_constraints_+dim_saturation_]),
+      optimality_residual);
+  inputsaturationfunctions::computeOptimalityResidualForDummyInput(
+      input_saturation_set_, 
+      &(solution_vec[dim_control_input_and_constraints_]),
+      &(solution_vec[dim_control_input_and_constraints_+dim_saturation_]),
+      &(optimality_residual[dim_control_input_and_constraints_]));
+  inputsaturationfunctions::computeOptimalityResidualForInputSaturation(
+      input_saturation_set_, solution_vec,
+      &(solution_vec[dim_control_input_and_constraints_]),
+      &(optimality_residual[dim_control_input_and_constraints_+dim_saturation_]));
+}
+
+template <class Model>
+void ZeroHorizonOCPWithInputSaturation<Model>::
+computeOptimalityResidualDirectionalDerivative(
+    const double time, const double* state_vec, const double* solution_vec,
+    const double* direction_vec, double* optimality_residual_derivative) {
+  for (int i=0; i<dim_state_; ++i) {
+    dual_state_vec_[i] = Dual(state_vec[i]);
+  }
+  for (int i=0; i<dim_solution_; ++i) {
+    dual_solution_vec_[i] = Dual(solution_vec[i], direction_vec[i]);
+  }
+  model_.phixFunc(time, dual_state_vec_, dual_lambda_vec_);
+  model_.huFunc(time, dual_state_vec_, dual_solution_vec_, dual_lambda_vec_, 
+                dual_optimality_residual_);
+  inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
+      input_saturation_set_, dual_solution_vec_, 
+      &(dual_solution_vec_[dim_control_input_and_constraints_+dim_saturation_]),
+      dual_optimality_residual_);
+  inputsaturationfunctions::computeOptimalityResidualForDummyInput(
+      input_saturation_set_, 
+      &(dual_solution_vec_[dim_control_input_and_constraints_]),
+      &(dual_solution_vec_[dim_control_input_and_constraints_+dim_saturation_]),
+      &(dual_optimality_residual_[dim_control_input_and_constraints_]));
+  inputsaturationfunctions::computeOptimalityResidualForInputSaturation(
+      input_saturation_set_, dual_solution_vec_,
+      &(dual_solution_vec_[dim_control_input_and_constraints_]),
+      &(dual_optimality_residual_[dim_control_input_and_constraints_
+                                  +dim_saturation_]));
+  for (int i=0; i<dim_solution_; ++i) {
+    optimality_residual_derivative[i] 
+        = dual_optimality_residual_[i].derivative();
+  }
+}
+
+template <class Model>
+void ZeroHorizonOCPWithInputSaturation<Model>::computeTerminalCostDerivative(
+    const double time, const double* state_vec,
+    double* terminal_cost_derivative_vec) {
+  model_.phixFunc(time, state_vec, terminal_cost_derivative_vec);
+}
+
+template <class Model>
+int ZeroHorizonOCPWithInputSaturation<Model>::dim_saturation() const {
+  return dim_saturation_;
+}
+
+template <class Model>
+int ZeroHorizonOCPWithInputSaturation<Model>::dim_solution() const {
+  return dim_solution_;
+}
+
 } // namespace cgmres
 
 
@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/aligned_matrix.cpp" "CMakeFiles/cgmres.dir/root/repo/src/aligned_matrix.cpp.o" "gcc" "CMakeFiles/cgmres.dir/root/repo/src/aligned_matrix.cpp.o.d"
+  "/root/repo/src/block_jacobi_preconditioner.cpp" "CMakeFiles/cgmres.dir/root/repo/src/block_jacobi_preconditioner.cpp.o" "gcc" "CMakeFiles/cgmres.dir/root/repo/src/block_jacobi_preconditioner.cpp.o.d"
+  "/root/repo/src/linear_algebra.cpp" "CMakeFiles/cgmres.dir/root/repo/src/linear_algebra.cpp.o" "gcc" "CMakeFiles/cgmres.dir/root/repo/src/linear_algebra.cpp.o.d"
+  "/root/repo/src/minimal_residual_smoothing.cpp" "CMakeFiles/cgmres.dir/root/repo/src/minimal_residual_smoothing.cpp.o" "gcc" "CMakeFiles/cgmres.dir/root/repo/src/minimal_residual_smoothing.cpp.o.d"
+  "/root/repo/src/time_varying_smooth_horizon.cpp" "CMakeFiles/cgmres.dir/root/repo/src/time_varying_smooth_horizon.cpp.o" "gcc" "CMakeFiles/cgmres.dir/root/repo/src/time_varying_smooth_horizon.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
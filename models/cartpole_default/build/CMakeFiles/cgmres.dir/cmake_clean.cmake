@@ -0,0 +1,19 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/cgmres.dir/root/repo/src/aligned_matrix.cpp.o"
+  "CMakeFiles/cgmres.dir/root/repo/src/aligned_matrix.cpp.o.d"
+  "CMakeFiles/cgmres.dir/root/repo/src/block_jacobi_preconditioner.cpp.o"
+  "CMakeFiles/cgmres.dir/root/repo/src/block_jacobi_preconditioner.cpp.o.d"
+  "CMakeFiles/cgmres.dir/root/repo/src/linear_algebra.cpp.o"
+  "CMakeFiles/cgmres.dir/root/repo/src/linear_algebra.cpp.o.d"
+  "CMakeFiles/cgmres.dir/root/repo/src/minimal_residual_smoothing.cpp.o"
+  "CMakeFiles/cgmres.dir/root/repo/src/minimal_residual_smoothing.cpp.o.d"
+  "CMakeFiles/cgmres.dir/root/repo/src/time_varying_smooth_horizon.cpp.o"
+  "CMakeFiles/cgmres.dir/root/repo/src/time_varying_smooth_horizon.cpp.o.d"
+  "libcgmres.a"
+  "libcgmres.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/cgmres.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,28 @@
+#include "nmpc_model.hpp"
+#include "continuation_gmres.hpp"
+#include "cgmres_simulator.hpp"
+#include <string>
+
+int main() {
+  // Define the model in NMPC.
+  cgmres::cartpole_default::NMPCModel nmpc_model;
+
+  // Define the solver.
+  cgmres::ContinuationGMRES<cgmres::cartpole_default::NMPCModel> nmpc_solver(2.0, 1.0, 100, 1e-08, 1000, 10);
+
+
+  // Set the initial state.
+  double initial_state[4] = {0, 0, 0, 0};
+
+  // Set the initial guess of the solution.
+  double solution_initial_guess[3] = {0.01, 10, 0.01};
+
+  // Initialize the solution of the C/GMRES method.
+  nmpc_solver.setParametersForInitialization(solution_initial_guess, 1e-06, 50);
+
+  std::string save_dir_name("../simulation_result");
+  // Perform a numerical simulation.
+  cgmres::simulation(nmpc_solver, initial_state, 0, 10, 0.001, save_dir_name, "cartpole_default");
+
+  return 0;
+}
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/a.out.dir/main.cpp.o"
+  "CMakeFiles/a.out.dir/main.cpp.o.d"
+  "CMakeFiles/a.out.dir/root/repo/src/simulator/save_simulation_data.cpp.o"
+  "CMakeFiles/a.out.dir/root/repo/src/simulator/save_simulation_data.cpp.o.d"
+  "a.out"
+  "a.out.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/a.out.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
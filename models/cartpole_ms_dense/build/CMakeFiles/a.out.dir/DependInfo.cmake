@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/models/cartpole_ms_dense/main.cpp" "CMakeFiles/a.out.dir/main.cpp.o" "gcc" "CMakeFiles/a.out.dir/main.cpp.o.d"
+  "/root/repo/src/simulator/save_simulation_data.cpp" "CMakeFiles/a.out.dir/root/repo/src/simulator/save_simulation_data.cpp.o" "gcc" "CMakeFiles/a.out.dir/root/repo/src/simulator/save_simulation_data.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/models/cartpole_ms_dense/build/CMakeFiles/multiple_shooting_cgmres.dir/DependInfo.cmake"
+  "/root/repo/models/cartpole_ms_dense/build/CMakeFiles/nmpcmodel.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
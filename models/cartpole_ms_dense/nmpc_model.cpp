@@ -0,0 +1,94 @@
+ 
+#include "nmpc_model.hpp"
+#include "dual_number.hpp"
+
+
+namespace cgmres {
+namespace cartpole_ms_dense {
+
+template <typename Scalar>
+void NMPCModel::stateFunc(const double t, const Scalar* x, const Scalar* u, 
+                          Scalar* dx) const {
+  Scalar x0 = sin(x[1]);
+  Scalar x1 = 1.0/(m_c + m_p*pow(x0, 2));
+  Scalar x2 = cos(x[1]);
+  Scalar x3 = l*pow(x[1], 2);
+  Scalar x4 = m_p*x0;
+  dx[0] = x[2];
+  dx[1] = x[3];
+  dx[2] = x1*(u[0] + x4*(g*x2 + x3));
+  dx[3] = x1*(-g*x0*(m_c + m_p) - u[0]*x2 - x2*x3*x4)/l;
+ 
+}
+
+template <typename Scalar>
+void NMPCModel::phixFunc(const double t, const Scalar* x, Scalar* phix) const {
+  phix[0] = (1.0/2.0)*q_terminal[0]*(2*x[0] - 2*x_ref[0]);
+  phix[1] = (1.0/2.0)*q_terminal[1]*(2*x[1] - 2*x_ref[1]);
+  phix[2] = (1.0/2.0)*q_terminal[2]*(2*x[2] - 2*x_ref[2]);
+  phix[3] = (1.0/2.0)*q_terminal[3]*(2*x[3] - 2*x_ref[3]);
+ 
+}
+
+template <typename Scalar>
+void NMPCModel::hxFunc(const double t, const Scalar* x, const Scalar* u, 
+                       const Scalar* lmd, Scalar* hx) const {
+  Scalar x0 = 2*x[1];
+  Scalar x1 = sin(x[1]);
+  Scalar x2 = cos(x[1]);
+  Scalar x3 = g*x2;
+  Scalar x4 = pow(x[1], 2);
+  Scalar x5 = l*x4;
+  Scalar x6 = m_p*(x3 + x5);
+  Scalar x7 = pow(x1, 2);
+  Scalar x8 = m_c + m_p*x7;
+  Scalar x9 = m_p*x1;
+  Scalar x10 = x2*x9;
+  Scalar x11 = 2*x10/pow(x8, 2);
+  Scalar x12 = 1.0/x8;
+  Scalar x13 = g*x1;
+  Scalar x14 = m_c + m_p;
+  Scalar x15 = lmd[3]/l;
+  hx[0] = (1.0/2.0)*q[0]*(2*x[0] - 2*x_ref[0]);
+  hx[1] = -lmd[2]*x11*(u[0] + x1*x6) + lmd[2]*x12*(x2*x6 + x9*(2*l*x[1] - x13)) + (1.0/2.0)*q[1]*(x0 - 2*x_ref[1]) - x11*x15*(-u[0]*x2 - x10*x5 - x13*x14) + x12*x15*(l*m_p*x4*x7 - l*x0*x10 - m_p*pow(x2, 2)*x5 + u[0]*x1 - x14*x3);
+  hx[2] = lmd[0] + (1.0/2.0)*q[2]*(2*x[2] - 2*x_ref[2]);
+  hx[3] = lmd[1] + (1.0/2.0)*q[3]*(2*x[3] - 2*x_ref[3]);
+ 
+}
+
+template <typename Scalar>
+void NMPCModel::huFunc(const double t, const Scalar* x, const Scalar* u, 
+                       const Scalar* lmd, Scalar* hu) const {
+  Scalar x0 = 1.0/(m_c + m_p*pow(sin(x[1]), 2));
+  hu[0] = lmd[2]*x0 + r[0]*u[0] + 2*u[0]*u[2] - lmd[3]*x0*cos(x[1])/l;
+  hu[1] = -dummy_weight + 2*u[1]*u[2];
+  hu[2] = pow(u[0], 2) + pow(u[1], 2) - 1.0/4.0*pow(u_max - u_min, 2);
+
+}
+
+template void NMPCModel::stateFunc<double>(const double t, const double* x, 
+                                           const double* u, 
+                                           double* dx) const;
+template void NMPCModel::phixFunc<double>(const double t, const double* x, 
+                                          double* phix) const;
+template void NMPCModel::hxFunc<double>(const double t, const double* x, 
+                                        const double* u, const double* lmd, 
+                                        double* hx) const;
+template void NMPCModel::huFunc<double>(const double t, const double* x, 
+                                        const double* u, const double* lmd, 
+                                        double* hu) const;
+
+template void NMPCModel::stateFunc<Dual>(const double t, const Dual* x, 
+                                         const Dual* u, Dual* dx) const;
+template void NMPCModel::phixFunc<Dual>(const double t, const Dual* x, 
+                                        Dual* phix) const;
+template void NMPCModel::hxFunc<Dual>(const double t, const Dual* x, 
+                                      const Dual* u, const Dual* lmd, 
+                                      Dual* hx) const;
+template void NMPCModel::huFunc<Dual>(const double t, const Dual* x, 
+                                      const Dual* u, const Dual* lmd, 
+                                      Dual* hu) const;
+
+} // namespace cartpole_ms_dense
+} // namespace cgmres
+
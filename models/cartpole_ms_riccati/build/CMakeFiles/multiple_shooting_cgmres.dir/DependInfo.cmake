@@ -0,0 +1,25 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/aligned_matrix.cpp" "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/aligned_matrix.cpp.o" "gcc" "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/aligned_matrix.cpp.o.d"
+  "/root/repo/src/block_jacobi_preconditioner.cpp" "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/block_jacobi_preconditioner.cpp.o" "gcc" "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/block_jacobi_preconditioner.cpp.o.d"
+  "/root/repo/src/linear_algebra.cpp" "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/linear_algebra.cpp.o" "gcc" "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/linear_algebra.cpp.o.d"
+  "/root/repo/src/minimal_residual_smoothing.cpp" "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/minimal_residual_smoothing.cpp.o" "gcc" "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/minimal_residual_smoothing.cpp.o.d"
+  "/root/repo/src/riccati_recursion.cpp" "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/riccati_recursion.cpp.o" "gcc" "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/riccati_recursion.cpp.o.d"
+  "/root/repo/src/stage_thread_pool.cpp" "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/stage_thread_pool.cpp.o" "gcc" "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/stage_thread_pool.cpp.o.d"
+  "/root/repo/src/time_varying_smooth_horizon.cpp" "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/time_varying_smooth_horizon.cpp.o" "gcc" "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/time_varying_smooth_horizon.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,23 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/aligned_matrix.cpp.o"
+  "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/aligned_matrix.cpp.o.d"
+  "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/block_jacobi_preconditioner.cpp.o"
+  "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/block_jacobi_preconditioner.cpp.o.d"
+  "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/linear_algebra.cpp.o"
+  "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/linear_algebra.cpp.o.d"
+  "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/minimal_residual_smoothing.cpp.o"
+  "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/minimal_residual_smoothing.cpp.o.d"
+  "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/riccati_recursion.cpp.o"
+  "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/riccati_recursion.cpp.o.d"
+  "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/stage_thread_pool.cpp.o"
+  "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/stage_thread_pool.cpp.o.d"
+  "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/time_varying_smooth_horizon.cpp.o"
+  "CMakeFiles/multiple_shooting_cgmres.dir/root/repo/src/time_varying_smooth_horizon.cpp.o.d"
+  "libmultiple_shooting_cgmres.a"
+  "libmultiple_shooting_cgmres.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/multiple_shooting_cgmres.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
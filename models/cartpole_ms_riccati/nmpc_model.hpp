@@ -0,0 +1,108 @@
+ 
+#ifndef NMPC_MODEL_CARTPOLE_MS_RICCATI_H
+#define NMPC_MODEL_CARTPOLE_MS_RICCATI_H
+
+#define _USE_MATH_DEFINES
+
+#include <cmath>
+
+
+// NMPCModel is declared in the namespace named after the model, 
+// cgmres::cartpole_ms_riccati, and the solvers are templates on it, e.g., 
+// cgmres::MultipleShootingCGMRES<cgmres::cartpole_ms_riccati::NMPCModel>, so that 
+// the solvers of different models can share one binary. 
+namespace cgmres {
+
+namespace cartpole_ms_riccati {
+
+// This class stores parameters of NMPC and equations of NMPC. The equations 
+// are templates with respect to the scalar type of the state, the control 
+// input, and the Lagrange multiplier. They are instantiated for double and 
+// Dual in nmpc_model.cpp. The instantiation for Dual computes the 
+// directional derivatives of the equations for the exact Jacobian-vector 
+// products of the solvers.
+class NMPCModel {
+private:
+  static constexpr int dim_state_ = 4;
+  static constexpr int dim_control_input_ = 2;
+  static constexpr int dim_constraints_ = 1;
+
+  static constexpr double m_c = 2;
+  static constexpr double m_p = 0.2;
+  static constexpr double l = 0.5;
+  static constexpr double g = 9.80665;
+  static constexpr double u_min = -15;
+  static constexpr double u_max = 15;
+  static constexpr double dummy_weight = 0.1;
+
+  double q[4] = {2.5, 10, 0.01, 0.01};
+  double q_terminal[4] = {2.5, 10, 0.01, 0.01};
+  double x_ref[4] = {0, M_PI, 0, 0};
+  double r[2] = {1, 0.01};
+
+
+public:
+
+  // Computes the state equation f(t, x, u).
+  // t : time parameter
+  // x : state vector
+  // u : control input vector
+  // f : the value of f(t, x, u)
+  template <typename Scalar>
+  void stateFunc(const double t, const Scalar* x, const Scalar* u, 
+                 Scalar* dx) const;
+
+  // Computes the partial derivative of terminal cost with respect to state, 
+  // i.e., dphi/dx(t, x).
+  // t    : time parameter
+  // x    : state vector
+  // phix : the value of dphi/dx(t, x)
+  template <typename Scalar>
+  void phixFunc(const double t, const Scalar* x, Scalar* phix) const;
+
+  // Computes the partial derivative of the Hamiltonian with respect to state, 
+  // i.e., dH/dx(t, x, u, lmd).
+  // t   : time parameter
+  // x   : state vector
+  // u   : control input vector
+  // lmd : the Lagrange multiplier for the state equation
+  // hx  : the value of dH/dx(t, x, u, lmd)
+  template <typename Scalar>
+  void hxFunc(const double t, const Scalar* x, const Scalar* u, 
+              const Scalar* lmd, Scalar* hx) const;
+
+  // Computes the partial derivative of the Hamiltonian with respect to control 
+  // input and the constraints, dH/du(t, x, u, lmd).
+  // t   : time parameter
+  // x   : state vector
+  // u   : control input vector
+  // lmd : the Lagrange multiplier for the state equation
+  // hu  : the value of dH/du(t, x, u, lmd)
+  template <typename Scalar>
+  void huFunc(const double t, const Scalar* x, const Scalar* u, 
+              const Scalar* lmd, Scalar* hu) const;
+
+  // Returns the dimension of the state. The dimensions are compile-time 
+  // constants so that the solvers compiled with this model can size the 
+  // loops and the work vectors of a stage statically.
+  static constexpr int dim_state() {
+    return dim_state_;
+  }
+
+  // Returns the dimension of the contorl input.
+  static constexpr int dim_control_input() {
+    return dim_control_input_;
+  }
+
+  // Returns the dimension of the constraints.
+  static constexpr int dim_constraints() {
+    return dim_constraints_;
+  }
+};
+
+} // namespace cartpole_ms_riccati
+
+} // namespace cgmres
+
+
+#endif // NMPC_MODEL_CARTPOLE_MS_RICCATI_H
@@ -0,0 +1,27 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/aligned_matrix.cpp.o"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/aligned_matrix.cpp.o.d"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/block_jacobi_preconditioner.cpp.o"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/block_jacobi_preconditioner.cpp.o.d"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/block_tridiagonal_lu.cpp.o"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/block_tridiagonal_lu.cpp.o.d"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/linear_algebra.cpp.o"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/linear_algebra.cpp.o.d"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/minimal_residual_smoothing.cpp.o"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/minimal_residual_smoothing.cpp.o.d"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/riccati_recursion.cpp.o"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/riccati_recursion.cpp.o.d"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/shooting_chain_preconditioner.cpp.o"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/shooting_chain_preconditioner.cpp.o.d"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/stage_thread_pool.cpp.o"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/stage_thread_pool.cpp.o.d"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/time_varying_smooth_horizon.cpp.o"
+  "CMakeFiles/uncondensed_ms_cgmres.dir/root/repo/src/time_varying_smooth_horizon.cpp.o.d"
+  "libuncondensed_ms_cgmres.a"
+  "libuncondensed_ms_cgmres.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/uncondensed_ms_cgmres.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
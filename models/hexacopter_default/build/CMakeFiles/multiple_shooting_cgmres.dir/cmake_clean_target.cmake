@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libmultiple_shooting_cgmres.a"
+)
@@ -0,0 +1,31 @@
+#include "nmpc_model.hpp"
+#include "multiple_shooting_cgmres.hpp"
+#include "cgmres_simulator.hpp"
+#include <string>
+
+int main() {
+  // Define the model in NMPC.
+  cgmres::hexacopter_riccati::NMPCModel nmpc_model;
+
+  // Define the solver.
+  cgmres::MultipleShootingCGMRES<cgmres::hexacopter_riccati::NMPCModel> nmpc_solver(1.0, 1.0, 50, 1e-08, 1000, 10);
+
+
+  // Set the initial state.
+  double initial_state[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+  // Set the initial guess of the solution.
+  double solution_initial_guess[6] = {1, 1, 1, 1, 1, 1};
+
+  // Initialize the solution of the C/GMRES method.
+  nmpc_solver.setParametersForInitialization(solution_initial_guess, 1e-06, 50);
+
+  // Solve the linear problem by the Riccati recursion.
+  nmpc_solver.setRiccatiRecursion(true);
+
+  std::string save_dir_name("../simulation_result");
+  // Perform a numerical simulation.
+  cgmres::simulation(nmpc_solver, initial_state, 0, 10, 0.001, save_dir_name, "hexacopter_riccati");
+
+  return 0;
+}
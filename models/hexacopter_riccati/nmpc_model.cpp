@@ -0,0 +1,158 @@
+ 
+#include "nmpc_model.hpp"
+#include "dual_number.hpp"
+
+
+namespace cgmres {
+namespace hexacopter_riccati {
+
+template <typename Scalar>
+void NMPCModel::stateFunc(const double t, const Scalar* x, const Scalar* u, 
+                          Scalar* dx) const {
+  Scalar x0 = sin(x[3]);
+  Scalar x1 = sin(x[5]);
+  Scalar x2 = cos(x[5]);
+  Scalar x3 = cos(x[3]);
+  Scalar x4 = sin(x[4]);
+  Scalar x5 = 1.0/m;
+  Scalar x6 = u[0] + u[2] + u[4];
+  Scalar x7 = u[1] + u[3] + u[5] + x6;
+  Scalar x8 = x5*x7;
+  Scalar x9 = 1.0/Ixx;
+  Scalar x10 = -Izz;
+  Scalar x11 = (1.0/2.0)*u[0];
+  Scalar x12 = 1.0/Iyy;
+  Scalar x13 = sqrt(3);
+  Scalar x14 = 1.0/Izz;
+  dx[0] = x[6];
+  dx[1] = x[7];
+  dx[2] = x[8];
+  dx[3] = x[9];
+  dx[4] = x[10];
+  dx[5] = x[11];
+  dx[6] = x8*(x0*x1 + x2*x3*x4);
+  dx[7] = x8*(-x0*x2 + x1*x3*x4);
+  dx[8] = -g + x3*x5*x7*cos(x[4]);
+  dx[9] = l*x9*(-u[1] - 1.0/2.0*u[2] + (1.0/2.0)*u[3] + u[4] + (1.0/2.0)*u[5] - x11) + x9*x[10]*x[11]*(Iyy + x10);
+  dx[10] = l*x12*((1.0/2.0)*u[2]*x13 + (1.0/2.0)*u[3]*x13 - 1.0/2.0*u[5]*x13 - x11*x13) + x12*x[11]*x[9]*(-Ixx - x10);
+  dx[11] = x14*x[10]*x[9]*(Ixx - Iyy) + x14*(-gamma*x[11] + k*(u[1] + u[3] + u[5] - x6));
+ 
+}
+
+template <typename Scalar>
+void NMPCModel::phixFunc(const double t, const Scalar* x, Scalar* phix) const {
+  Scalar x0 = 2*t;
+  Scalar x1 = sin(x0);
+  Scalar x2 = cos(x0);
+  phix[0] = (1.0/2.0)*q_terminal[0]*(-2*x1 + 2*x[0]);
+  phix[1] = (1.0/2.0)*q_terminal[1]*(2*x2 + 2*x[1] - 2);
+  phix[2] = (1.0/2.0)*q_terminal[2]*(2*x[2] - 2*z_ref - 4*sin(t));
+  phix[3] = q_terminal[3]*x[3];
+  phix[4] = q_terminal[4]*x[4];
+  phix[5] = q_terminal[5]*x[5];
+  phix[6] = (1.0/2.0)*q_terminal[6]*(-4*x2 + 2*x[6]);
+  phix[7] = (1.0/2.0)*q_terminal[7]*(-4*x1 + 2*x[7]);
+  phix[8] = (1.0/2.0)*q_terminal[8]*(2*x[8] - 4*cos(t));
+  phix[9] = q_terminal[9]*x[9];
+  phix[10] = q_terminal[10]*x[10];
+  phix[11] = q_terminal[11]*x[11];
+ 
+}
+
+template <typename Scalar>
+void NMPCModel::hxFunc(const double t, const Scalar* x, const Scalar* u, 
+                       const Scalar* lmd, Scalar* hx) const {
+  Scalar x0 = 2*t;
+  Scalar x1 = sin(x0);
+  Scalar x2 = cos(x0);
+  Scalar x3 = sin(x[3]);
+  Scalar x4 = cos(x[4]);
+  Scalar x5 = (u[0] + u[1] + u[2] + u[3] + u[4] + u[5])/m;
+  Scalar x6 = lmd[8]*x5;
+  Scalar x7 = sin(x[5]);
+  Scalar x8 = cos(x[3]);
+  Scalar x9 = sin(x[4]);
+  Scalar x10 = cos(x[5]);
+  Scalar x11 = x10*x3;
+  Scalar x12 = lmd[6]*x5;
+  Scalar x13 = x10*x8;
+  Scalar x14 = x3*x7;
+  Scalar x15 = lmd[7]*x5;
+  Scalar x16 = x7*x8;
+  Scalar x17 = -Izz;
+  Scalar x18 = lmd[10]*(-Ixx - x17)/Iyy;
+  Scalar x19 = lmd[11]/Izz;
+  Scalar x20 = x19*(Ixx - Iyy);
+  Scalar x21 = lmd[9]*(Iyy + x17)/Ixx;
+  hx[0] = (1.0/2.0)*q[0]*(-2*x1 + 2*x[0]);
+  hx[1] = (1.0/2.0)*q[1]*(2*x2 + 2*x[1] - 2);
+  hx[2] = (1.0/2.0)*q[2]*(2*x[2] - 2*z_ref - 4*sin(t));
+  hx[3] = q[3]*x[3] + x12*(-x11*x9 + x7*x8) + x15*(-x13 - x14*x9) - x3*x4*x6;
+  hx[4] = q[4]*x[4] + x12*x13*x4 + x15*x16*x4 - x6*x8*x9;
+  hx[5] = q[5]*x[5] + x12*(x11 - x16*x9) + x15*(x13*x9 + x14);
+  hx[6] = lmd[0] + (1.0/2.0)*q[6]*(-4*x2 + 2*x[6]);
+  hx[7] = lmd[1] + (1.0/2.0)*q[7]*(-4*x1 + 2*x[7]);
+  hx[8] = lmd[2] + (1.0/2.0)*q[8]*(2*x[8] - 4*cos(t));
+  hx[9] = lmd[3] + q[9]*x[9] + x18*x[11] + x20*x[10];
+  hx[10] = lmd[4] + q[10]*x[10] + x20*x[9] + x21*x[11];
+  hx[11] = -gamma*x19 + lmd[5] + q[11]*x[11] + x18*x[9] + x21*x[10];
+ 
+}
+
+template <typename Scalar>
+void NMPCModel::huFunc(const double t, const Scalar* x, const Scalar* u, 
+                       const Scalar* lmd, Scalar* hu) const {
+  Scalar x0 = -u_min;
+  Scalar x1 = -u_max;
+  Scalar x2 = (1.0/3.0)*g*m;
+  Scalar x3 = (1.0/2.0)*sqrt(3)*l*lmd[10]/Iyy;
+  Scalar x4 = -x3;
+  Scalar x5 = l*lmd[9]/Ixx;
+  Scalar x6 = (1.0/2.0)*x5;
+  Scalar x7 = k*lmd[11]/Izz;
+  Scalar x8 = 1.0/m;
+  Scalar x9 = sin(x[3]);
+  Scalar x10 = sin(x[5]);
+  Scalar x11 = cos(x[5]);
+  Scalar x12 = cos(x[3]);
+  Scalar x13 = sin(x[4]);
+  Scalar x14 = lmd[6]*x8*(x10*x9 + x11*x12*x13) + lmd[7]*x8*(x10*x12*x13 - x11*x9) + lmd[8]*x12*x8*cos(x[4]);
+  Scalar x15 = x14 - x7;
+  Scalar x16 = x15 - x6;
+  Scalar x17 = x14 + x7;
+  Scalar x18 = x17 + x6;
+  hu[0] = epsilon*(-1/(u[0] + x0) + 1.0/(-u[0] - x1)) + (1.0/2.0)*r[0]*(2*u[0] - x2) + x16 + x4;
+  hu[1] = epsilon*(-1/(u[1] + x0) + 1.0/(-u[1] - x1)) + (1.0/2.0)*r[1]*(2*u[1] - x2) + x17 - x5;
+  hu[2] = epsilon*(-1/(u[2] + x0) + 1.0/(-u[2] - x1)) + (1.0/2.0)*r[2]*(2*u[2] - x2) + x16 + x3;
+  hu[3] = epsilon*(-1/(u[3] + x0) + 1.0/(-u[3] - x1)) + (1.0/2.0)*r[3]*(2*u[3] - x2) + x18 + x3;
+  hu[4] = epsilon*(-1/(u[4] + x0) + 1.0/(-u[4] - x1)) + (1.0/2.0)*r[4]*(2*u[4] - x2) + x15 + x5;
+  hu[5] = epsilon*(-1/(u[5] + x0) + 1.0/(-u[5] - x1)) + (1.0/2.0)*r[5]*(2*u[5] - x2) + x18 + x4;
+
+}
+
+template void NMPCModel::stateFunc<double>(const double t, const double* x, 
+                                           const double* u, 
+                                           double* dx) const;
+template void NMPCModel::phixFunc<double>(const double t, const double* x, 
+                                          double* phix) const;
+template void NMPCModel::hxFunc<double>(const double t, const double* x, 
+                                        const double* u, const double* lmd, 
+                                        double* hx) const;
+template void NMPCModel::huFunc<double>(const double t, const double* x, 
+                                        const double* u, const double* lmd, 
+                                        double* hu) const;
+
+template void NMPCModel::stateFunc<Dual>(const double t, const Dual* x, 
+                                         const Dual* u, Dual* dx) const;
+template void NMPCModel::phixFunc<Dual>(const double t, const Dual* x, 
+                                        Dual* phix) const;
+template void NMPCModel::hxFunc<Dual>(const double t, const Dual* x, 
+                                      const Dual* u, const Dual* lmd, 
+                                      Dual* hx) const;
+template void NMPCModel::huFunc<Dual>(const double t, const Dual* x, 
+                                      const Dual* u, const Dual* lmd, 
+                                      Dual* hu) const;
+
+} // namespace hexacopter_riccati
+} // namespace cgmres
+
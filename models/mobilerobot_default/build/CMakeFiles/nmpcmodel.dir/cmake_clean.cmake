@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/nmpcmodel.dir/nmpc_model.cpp.o"
+  "CMakeFiles/nmpcmodel.dir/nmpc_model.cpp.o.d"
+  "libnmpcmodel.a"
+  "libnmpcmodel.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/nmpcmodel.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,87 @@
+ 
+#include "nmpc_model.hpp"
+#include "dual_number.hpp"
+
+
+namespace cgmres {
+namespace mobilerobot_riccati {
+
+template <typename Scalar>
+void NMPCModel::stateFunc(const double t, const Scalar* x, const Scalar* u, 
+                          Scalar* dx) const {
+  dx[0] = u[0]*cos(x[2]);
+  dx[1] = u[0]*sin(x[2]);
+  dx[2] = u[1];
+ 
+}
+
+template <typename Scalar>
+void NMPCModel::phixFunc(const double t, const Scalar* x, Scalar* phix) const {
+  phix[0] = (1.0/2.0)*q[0]*(-2*t*vx_ref + 2*x[0]);
+  phix[1] = q[1]*x[1];
+  phix[2] = q[2]*x[2];
+ 
+}
+
+template <typename Scalar>
+void NMPCModel::hxFunc(const double t, const Scalar* x, const Scalar* u, 
+                       const Scalar* lmd, Scalar* hx) const {
+  Scalar x0 = -2*x[0];
+  Scalar x1 = -2*x[1];
+  Scalar x2 = u[0]*sin(x[2]);
+  Scalar x3 = cos(x[2]);
+  hx[0] = (1.0/2.0)*q[0]*(-2*t*vx_ref - x0) + u[2]*(2*X_1 + x0) + u[3]*(2*X_2 + x0);
+  hx[1] = q[1]*x[1] + u[2]*(2*Y_1 + x1) + u[3]*(2*Y_2 + x1);
+  hx[2] = -lmd[0]*x2 + lmd[1]*u[0]*x3 + q[2]*x[2] - r[0]*x2*(u[0]*x3 - vx_ref);
+ 
+}
+
+template <typename Scalar>
+void NMPCModel::huFunc(const double t, const Scalar* x, const Scalar* u, 
+                       const Scalar* lmd, Scalar* hu) const {
+  Scalar x0 = cos(x[2]);
+  Scalar x1 = -x[0];
+  Scalar x2 = -x[1];
+  Scalar x3 = -pow(R_1, 2) + pow(-X_1 - x1, 2) + pow(-Y_1 - x2, 2);
+  Scalar x4 = -pow(R_2, 2) + pow(-X_2 - x1, 2) + pow(-Y_2 - x2, 2);
+  Scalar x5 = u[0] - v_min;
+  Scalar x6 = u[0] - v_max;
+  Scalar x7 = u[1] - w_min;
+  Scalar x8 = u[1] - w_max;
+  hu[0] = lmd[0]*x0 + lmd[1]*sin(x[2]) + r[0]*x0*(u[0]*x0 - vx_ref) - u[4] + u[5];
+  hu[1] = lmd[2] + r[1]*u[1] - u[6] + u[7];
+  hu[2] = -u[2] - x3 + sqrt(fb_eps[0] + pow(u[2], 2) + pow(x3, 2));
+  hu[3] = -u[3] - x4 + sqrt(fb_eps[1] + pow(u[3], 2) + pow(x4, 2));
+  hu[4] = -u[4] - x5 + sqrt(fb_eps[2] + pow(u[4], 2) + pow(x5, 2));
+  hu[5] = -u[5] + x6 + sqrt(fb_eps[3] + pow(u[5], 2) + pow(x6, 2));
+  hu[6] = -u[6] - x7 + sqrt(fb_eps[4] + pow(u[6], 2) + pow(x7, 2));
+  hu[7] = -u[7] + x8 + sqrt(fb_eps[5] + pow(u[7], 2) + pow(x8, 2));
+
+}
+
+template void NMPCModel::stateFunc<double>(const double t, const double* x, 
+                                           const double* u, 
+                                           double* dx) const;
+template void NMPCModel::phixFunc<double>(const double t, const double* x, 
+                                          double* phix) const;
+template void NMPCModel::hxFunc<double>(const double t, const double* x, 
+                                        const double* u, const double* lmd, 
+                                        double* hx) const;
+template void NMPCModel::huFunc<double>(const double t, const double* x, 
+                                        const double* u, const double* lmd, 
+                                        double* hu) const;
+
+template void NMPCModel::stateFunc<Dual>(const double t, const Dual* x, 
+                                         const Dual* u, Dual* dx) const;
+template void NMPCModel::phixFunc<Dual>(const double t, const Dual* x, 
+                                        Dual* phix) const;
+template void NMPCModel::hxFunc<Dual>(const double t, const Dual* x, 
+                                      const Dual* u, const Dual* lmd, 
+                                      Dual* hx) const;
+template void NMPCModel::huFunc<Dual>(const double t, const Dual* x, 
+                                      const Dual* u, const Dual* lmd, 
+                                      Dual* hu) const;
+
+} // namespace mobilerobot_riccati
+} // namespace cgmres
+
@@ -0,0 +1,112 @@
+ 
+#ifndef NMPC_MODEL_MOBILEROBOT_RICCATI_H
+#define NMPC_MODEL_MOBILEROBOT_RICCATI_H
+
+#define _USE_MATH_DEFINES
+
+#include <cmath>
+
+
+// NMPCModel is declared in the namespace named after the model, 
+// cgmres::mobilerobot_riccati, and the solvers are templates on it, e.g., 
+// cgmres::MultipleShootingCGMRES<cgmres::mobilerobot_riccati::NMPCModel>, so that 
+// the solvers of different models can share one binary. 
+namespace cgmres {
+
+namespace mobilerobot_riccati {
+
+// This class stores parameters of NMPC and equations of NMPC. The equations 
+// are templates with respect to the scalar type of the state, the control 
+// input, and the Lagrange multiplier. They are instantiated for double and 
+// Dual in nmpc_model.cpp. The instantiation for Dual computes the 
+// directional derivatives of the equations for the exact Jacobian-vector 
+// products of the solvers.
+class NMPCModel {
+private:
+  static constexpr int dim_state_ = 3;
+  static constexpr int dim_control_input_ = 2;
+  static constexpr int dim_constraints_ = 6;
+
+  static constexpr double vx_ref = 0.4;
+  static constexpr double v_min = -0.5;
+  static constexpr double v_max = 0.5;
+  static constexpr double w_min = -0.75;
+  static constexpr double w_max = 0.75;
+  static constexpr double X_1 = 1;
+  static constexpr double Y_1 = 0.25;
+  static constexpr double R_1 = 0.5;
+  static constexpr double X_2 = 2;
+  static constexpr double Y_2 = -0.25;
+  static constexpr double R_2 = 0.5;
+
+  double q[3] = {10, 1, 0.01};
+  double r[2] = {0.1, 0.1};
+  double x_ref[3] = {0, 0, 0};
+  double fb_eps[6] = {0.01, 0.01, 0.0001, 0.0001, 0.0001, 0.0001};
+
+
+public:
+
+  // Computes the state equation f(t, x, u).
+  // t : time parameter
+  // x : state vector
+  // u : control input vector
+  // f : the value of f(t, x, u)
+  template <typename Scalar>
+  void stateFunc(const double t, const Scalar* x, const Scalar* u, 
+                 Scalar* dx) const;
+
+  // Computes the partial derivative of terminal cost with respect to state, 
+  // i.e., dphi/dx(t, x).
+  // t    : time parameter
+  // x    : state vector
+  // phix : the value of dphi/dx(t, x)
+  template <typename Scalar>
+  void phixFunc(const double t, const Scalar* x, Scalar* phix) const;
+
+  // Computes the partial derivative of the Hamiltonian with respect to state, 
+  // i.e., dH/dx(t, x, u, lmd).
+  // t   : time parameter
+  // x   : state vector
+  // u   : control input vector
+  // lmd : the Lagrange multiplier for the state equation
+  // hx  : the value of dH/dx(t, x, u, lmd)
+  template <typename Scalar>
+  void hxFunc(const double t, const Scalar* x, const Scalar* u, 
+              const Scalar* lmd, Scalar* hx) const;
+
+  // Computes the partial derivative of the Hamiltonian with respect to control 
+  // input and the constraints, dH/du(t, x, u, lmd).
+  // t   : time parameter
+  // x   : state vector
+  // u   : control input vector
+  // lmd : the Lagrange multiplier for the state equation
+  // hu  : the value of dH/du(t, x, u, lmd)
+  template <typename Scalar>
+  void huFunc(const double t, const Scalar* x, const Scalar* u, 
+              const Scalar* lmd, Scalar* hu) const;
+
+  // Returns the dimension of the state. The dimensions are compile-time 
+  // constants so that the solvers compiled with this model can size the 
+  // loops and the work vectors of a stage statically.
+  static constexpr int dim_state() {
+    return dim_state_;
+  }
+
+  // Returns the dimension of the contorl input.
+  static constexpr int dim_control_input() {
+    return dim_control_input_;
+  }
+
+  // Returns the dimension of the constraints.
+  static constexpr int dim_constraints() {
+    return dim_constraints_;
+  }
+};
+
+} // namespace mobilerobot_riccati
+
+} // namespace cgmres
+
+
+#endif // NMPC_MODEL_MOBILEROBOT_RICCATI_H
@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libuncondensed_ms_cgmres.a"
+)
@@ -0,0 +1,31 @@
+#include "nmpc_model.hpp"
+#include "uncondensed_ms_cgmres.hpp"
+#include "cgmres_simulator.hpp"
+#include <string>
+
+int main() {
+  // Define the model in NMPC.
+  cgmres::mobilerobot_uncondensed_lu_default::NMPCModel nmpc_model;
+
+  // Define the solver.
+  cgmres::UncondensedMSCGMRES<cgmres::mobilerobot_uncondensed_lu_default::NMPCModel> nmpc_solver(1.5, 1.0, 50, 1e-08, 1000, 15);
+
+
+  // Set the initial state.
+  double initial_state[3] = {0, 0, 0};
+
+  // Set the initial guess of the solution.
+  double solution_initial_guess[8] = {0.1, 0.1, 0.01, 0.01, 0.01, 0.01, 0.01, 0.01};
+
+  // Initialize the solution of the C/GMRES method.
+  nmpc_solver.setParametersForInitialization(solution_initial_guess, 1e-06, 50);
+
+  // Solve the linear problem by the block-tridiagonal LU factorization.
+  nmpc_solver.setBlockTridiagonalLU(5);
+
+  std::string save_dir_name("../simulation_result");
+  // Perform a numerical simulation.
+  cgmres::simulation(nmpc_solver, initial_state, 0, 10, 0.001, save_dir_name, "mobilerobot_uncondensed_lu_default");
+
+  return 0;
+}
@@ -0,0 +1,27 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/aligned_matrix.cpp" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/aligned_matrix.cpp.o" "gcc" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/aligned_matrix.cpp.o.d"
+  "/root/repo/src/block_jacobi_preconditioner.cpp" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/block_jacobi_preconditioner.cpp.o" "gcc" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/block_jacobi_preconditioner.cpp.o.d"
+  "/root/repo/src/input_saturation.cpp" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/input_saturation.cpp.o" "gcc" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/input_saturation.cpp.o.d"
+  "/root/repo/src/input_saturation_functions.cpp" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/input_saturation_functions.cpp.o" "gcc" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/input_saturation_functions.cpp.o.d"
+  "/root/repo/src/input_saturation_set.cpp" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/input_saturation_set.cpp.o" "gcc" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/input_saturation_set.cpp.o.d"
+  "/root/repo/src/linear_algebra.cpp" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/linear_algebra.cpp.o" "gcc" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/linear_algebra.cpp.o.d"
+  "/root/repo/src/minimal_residual_smoothing.cpp" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/minimal_residual_smoothing.cpp.o" "gcc" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/minimal_residual_smoothing.cpp.o.d"
+  "/root/repo/src/stage_thread_pool.cpp" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/stage_thread_pool.cpp.o" "gcc" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/stage_thread_pool.cpp.o.d"
+  "/root/repo/src/time_varying_smooth_horizon.cpp" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/time_varying_smooth_horizon.cpp.o" "gcc" "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/time_varying_smooth_horizon.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
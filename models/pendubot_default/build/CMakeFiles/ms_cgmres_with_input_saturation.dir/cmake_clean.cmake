@@ -0,0 +1,27 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/aligned_matrix.cpp.o"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/aligned_matrix.cpp.o.d"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/block_jacobi_preconditioner.cpp.o"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/block_jacobi_preconditioner.cpp.o.d"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/input_saturation.cpp.o"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/input_saturation.cpp.o.d"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/input_saturation_functions.cpp.o"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/input_saturation_functions.cpp.o.d"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/input_saturation_set.cpp.o"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/input_saturation_set.cpp.o.d"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/linear_algebra.cpp.o"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/linear_algebra.cpp.o.d"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/minimal_residual_smoothing.cpp.o"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/minimal_residual_smoothing.cpp.o.d"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/stage_thread_pool.cpp.o"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/stage_thread_pool.cpp.o.d"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/time_varying_smooth_horizon.cpp.o"
+  "CMakeFiles/ms_cgmres_with_input_saturation.dir/root/repo/src/time_varying_smooth_horizon.cpp.o.d"
+  "libms_cgmres_with_input_saturation.a"
+  "libms_cgmres_with_input_saturation.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ms_cgmres_with_input_saturation.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
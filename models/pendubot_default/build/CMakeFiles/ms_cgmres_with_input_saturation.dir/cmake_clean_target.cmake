@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libms_cgmres_with_input_saturation.a"
+)
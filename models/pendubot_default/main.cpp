@@ -0,0 +1,35 @@
+#include "nmpc_model.hpp"
+#include "input_saturation_set.hpp"
+#include "ms_cgmres_with_input_saturation.hpp"
+#include "cgmres_simulator.hpp"
+#include <string>
+
+int main() {
+  // Define the model in NMPC.
+  cgmres::pendubot_default::NMPCModel nmpc_model;
+
+  // Define the solver.
+  cgmres::InputSaturationSet input_saturation_set;
+  input_saturation_set.appendInputSaturation(0, -5, 5, 0.1, 0);
+  cgmres::MSCGMRESWithInputSaturation<cgmres::pendubot_default::NMPCModel> nmpc_solver(input_saturation_set, 1.0, 1.0, 50, 1e-08, 1000, 3);
+
+
+  // Set the initial state.
+  double initial_state[4] = {0, 0, 0, 0};
+
+  // Set the initial guess of the solution.
+  double solution_initial_guess[1] = {0.01};
+
+  // Initialize the solution of the C/GMRES method.
+  nmpc_solver.setParametersForInitialization(solution_initial_guess, 1e-06, 50);
+
+  // Set the initial guess of the lagrange multiplier for the condensed constraints with respect to the saturation on the function of the control input .
+  double initial_guess_lagrange_multiplier[1] = {0.01};
+
+  nmpc_solver.setInitialInputSaturationMultiplier(initial_guess_lagrange_multiplier);
+  std::string save_dir_name("../simulation_result");
+  // Perform a numerical simulation.
+  cgmres::simulation(nmpc_solver, initial_state, 0, 10, 0.001, save_dir_name, "pendubot_default");
+
+  return 0;
+}
@@ -0,0 +1,145 @@
+ 
+#include "nmpc_model.hpp"
+#include "dual_number.hpp"
+
+
+namespace cgmres {
+namespace pendubot_default {
+
+template <typename Scalar>
+void NMPCModel::stateFunc(const double t, const Scalar* x, const Scalar* u, 
+                          Scalar* dx) const {
+  Scalar x0 = pow(l1, 2);
+  Scalar x1 = m2*x0;
+  Scalar x2 = l1*m2;
+  Scalar x3 = d2*x2;
+  Scalar x4 = x3*cos(x[1]);
+  Scalar x5 = pow(d2, 2);
+  Scalar x6 = J2 + m2*x5;
+  Scalar x7 = J1 + pow(d1, 2)*m1;
+  Scalar x8 = 1.0/(x1 + 2*x4 + x6 + x7);
+  Scalar x9 = d2*g*m2*sin(x[0] + x[1]);
+  Scalar x10 = d1*m1;
+  Scalar x11 = x10 + x2;
+  Scalar x12 = sin(x[0]);
+  Scalar x13 = sin(x[1]);
+  Scalar x14 = 2*x[1];
+  Scalar x15 = (1.0/2.0)*l1;
+  Scalar x16 = pow(m2, 2)*x5;
+  Scalar x17 = x15*x16;
+  Scalar x18 = pow(x[2], 2);
+  Scalar x19 = x[2]*x[3];
+  Scalar x20 = pow(x[3], 2);
+  dx[0] = x[2];
+  dx[1] = x[3];
+  dx[2] = x8*(2*d2*l1*m2*x13*x[3]*(x[2] + (1.0/2.0)*x[3]) - g*x11*x12 + u[0] - x9);
+  dx[3] = x8*((1.0/2.0)*d2*g*l1*m2*x11*sin(x[0] - x[1]) + g*x12*(J2*x10 + m2*(J2*l1 + x10*x5) + x17) - g*x17*sin(x14 + x[0]) - u[0]*(x4 + x6) - x0*x16*(x18 + x19 + (1.0/2.0)*x20)*sin(x14) - x13*x3*(2*J2*x19 + J2*x20 + m2*(x0*x18 + x5*pow(x[2] + x[3], 2)) + x18*(J2 + x7)) - x9*((1.0/2.0)*x1 - x10*x15 + x7))/x6;
+ 
+}
+
+template <typename Scalar>
+void NMPCModel::phixFunc(const double t, const Scalar* x, Scalar* phix) const {
+  phix[0] = (1.0/2.0)*q_terminal[0]*(2*x[0] - 2*x_ref[0]);
+  phix[1] = (1.0/2.0)*q_terminal[1]*(2*x[1] - 2*x_ref[1]);
+  phix[2] = (1.0/2.0)*q_terminal[2]*(2*x[2] - 2*x_ref[2]);
+  phix[3] = (1.0/2.0)*q_terminal[3]*(2*x[3] - 2*x_ref[3]);
+ 
+}
+
+template <typename Scalar>
+void NMPCModel::hxFunc(const double t, const Scalar* x, const Scalar* u, 
+                       const Scalar* lmd, Scalar* hx) const {
+  Scalar x0 = x[0] + x[1];
+  Scalar x1 = d2*g;
+  Scalar x2 = m2*x1;
+  Scalar x3 = x2*cos(x0);
+  Scalar x4 = d1*m1;
+  Scalar x5 = l1*m2;
+  Scalar x6 = x4 + x5;
+  Scalar x7 = cos(x[0]);
+  Scalar x8 = pow(l1, 2);
+  Scalar x9 = m2*x8;
+  Scalar x10 = cos(x[1]);
+  Scalar x11 = d2*x5;
+  Scalar x12 = x10*x11;
+  Scalar x13 = pow(d2, 2);
+  Scalar x14 = m2*x13;
+  Scalar x15 = J2 + x14;
+  Scalar x16 = J1 + pow(d1, 2)*m1;
+  Scalar x17 = 2*x12 + x15 + x16 + x9;
+  Scalar x18 = 1.0/x17;
+  Scalar x19 = lmd[2]*x18;
+  Scalar x20 = (1.0/2.0)*l1;
+  Scalar x21 = pow(m2, 2)*x13;
+  Scalar x22 = x20*x21;
+  Scalar x23 = 2*x[1];
+  Scalar x24 = x23 + x[0];
+  Scalar x25 = g*cos(x24);
+  Scalar x26 = x[0] - x[1];
+  Scalar x27 = (1.0/2.0)*x1*x5*x6*cos(x26);
+  Scalar x28 = x16 - x20*x4 + (1.0/2.0)*x9;
+  Scalar x29 = x28*x3;
+  Scalar x30 = J2*x4 + m2*(J2*l1 + x13*x4) + x22;
+  Scalar x31 = lmd[3]/x15;
+  Scalar x32 = x18*x31;
+  Scalar x33 = x[2] + (1.0/2.0)*x[3];
+  Scalar x34 = x2*sin(x0);
+  Scalar x35 = sin(x[0]);
+  Scalar x36 = sin(x[1]);
+  Scalar x37 = x11*x36;
+  Scalar x38 = 2*x37/pow(x17, 2);
+  Scalar x39 = pow(x[2], 2);
+  Scalar x40 = x[2]*x[3];
+  Scalar x41 = pow(x[3], 2);
+  Scalar x42 = x39 + x40 + (1.0/2.0)*x41;
+  Scalar x43 = J2 + x16;
+  Scalar x44 = x[2] + x[3];
+  Scalar x45 = 2*J2*x40 + J2*x41 + m2*(x13*pow(x44, 2) + x39*x8) + x39*x43;
+  Scalar x46 = x21*x8*sin(x23);
+  Scalar x47 = 2*x[2];
+  Scalar x48 = 2*x[3];
+  Scalar x49 = J2*x48;
+  Scalar x50 = x47 + x48;
+  hx[0] = (1.0/2.0)*q[0]*(2*x[0] - 2*x_ref[0]) + x19*(-g*x6*x7 - x3) + x32*(g*x30*x7 - x22*x25 + x27 - x29);
+  hx[1] = lmd[2]*x38*(2*d2*l1*m2*x33*x36*x[3] - g*x35*x6 + u[0] - x34) + (1.0/2.0)*q[1]*(x23 - 2*x_ref[1]) + x19*(2*d2*l1*m2*x10*x33*x[3] - x3) + x31*x38*((1.0/2.0)*d2*g*l1*m2*x6*sin(x26) - g*x22*sin(x24) + g*x30*x35 - u[0]*(x12 + x15) - x28*x34 - x37*x45 - x42*x46) + x32*(d2*l1*m2*u[0]*x36 - l1*x21*x25 - x12*x45 - 2*x21*x42*x8*cos(x23) - x27 - x29);
+  hx[2] = lmd[0] + (1.0/2.0)*q[2]*(x47 - 2*x_ref[2]) + x19*x37*x48 + x32*(-x37*(m2*(x13*x50 + x47*x8) + x43*x47 + x49) - x46*(x47 + x[3]));
+  hx[3] = lmd[1] + (1.0/2.0)*q[3]*(x48 - 2*x_ref[3]) + x19*(2*x33*x37 + x37*x[3]) + x32*(-x37*(J2*x47 + x14*x50 + x49) - x44*x46);
+ 
+}
+
+template <typename Scalar>
+void NMPCModel::huFunc(const double t, const Scalar* x, const Scalar* u, 
+                       const Scalar* lmd, Scalar* hu) const {
+  Scalar x0 = d2*l1*m2*cos(x[1]);
+  Scalar x1 = J2 + pow(d2, 2)*m2;
+  Scalar x2 = 1.0/(J1 + pow(d1, 2)*m1 + pow(l1, 2)*m2 + 2*x0 + x1);
+  hu[0] = lmd[2]*x2 + lmd[3]*x2*(-x0 - x1)/x1 + r[0]*u[0];
+
+}
+
+template void NMPCModel::stateFunc<double>(const double t, const double* x, 
+                                           const double* u, 
+                                           double* dx) const;
+template void NMPCModel::phixFunc<double>(const double t, const double* x, 
+                                          double* phix) const;
+template void NMPCModel::hxFunc<double>(const double t, const double* x, 
+                                        const double* u, const double* lmd, 
+                                        double* hx) const;
+template void NMPCModel::huFunc<double>(const double t, const double* x, 
+                                        const double* u, const double* lmd, 
+                                        double* hu) const;
+
+template void NMPCModel::stateFunc<Dual>(const double t, const Dual* x, 
+                                         const Dual* u, Dual* dx) const;
+template void NMPCModel::phixFunc<Dual>(const double t, const Dual* x, 
+                                        Dual* phix) const;
+template void NMPCModel::hxFunc<Dual>(const double t, const Dual* x, 
+                                      const Dual* u, const Dual* lmd, 
+                                      Dual* hx) const;
+template void NMPCModel::huFunc<Dual>(const double t, const Dual* x, 
+                                      const Dual* u, const Dual* lmd, 
+                                      Dual* hu) const;
+
+} // namespace pendubot_default
+} // namespace cgmres
+
@@ -0,0 +1,52 @@
+#include "aligned_matrix.hpp"
+
+
+namespace cgmres {
+
+AlignedMatrix::AlignedMatrix()
+  : dim_row_(0),
+    dim_column_(0),
+    stride_(0),
+    data_(nullptr),
+    owns_data_(true) {
+}
+
+AlignedMatrix::AlignedMatrix(const int dim_row, const int dim_column)
+  : dim_row_(dim_row),
+    dim_column_(dim_column),
+    stride_(linearalgebra::PaddedDimension(dim_column)),
+    data_(linearalgebra::NewAlignedVector(dim_row*stride_)),
+    owns_data_(true) {
+}
+
+AlignedMatrix::AlignedMatrix(double* data, const int dim_row, 
+                             const int dim_column)
+  : dim_row_(dim_row),
+    dim_column_(dim_column),
+    stride_(linearalgebra::PaddedDimension(dim_column)),
+    data_(data),
+    owns_data_(false) {
+}
+
+AlignedMatrix::~AlignedMatrix() {
+  if (owns_data_) {
+    linearalgebra::DeleteAlignedVector(data_);
+  }
+}
+
+void AlignedMatrix::resize(const int dim_row, const int dim_column) {
+  // The new array is allocated first so that the matrix is unchanged if the 
+  // allocation throws.
+  const int stride = linearalgebra::PaddedDimension(dim_column);
+  double* data = linearalgebra::NewAlignedVector(dim_row*stride);
+  if (owns_data_) {
+    linearalgebra::DeleteAlignedVector(data_);
+  }
+  dim_row_ = dim_row;
+  dim_column_ = dim_column;
+  stride_ = stride;
+  data_ = data;
+  owns_data_ = true;
+}
+
+} // namespace cgmres
\ No newline at end of file
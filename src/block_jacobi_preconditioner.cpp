@@ -0,0 +1,75 @@
+#include "block_jacobi_preconditioner.hpp"
+
+
+namespace cgmres {
+
+BlockJacobiPreconditioner::BlockJacobiPreconditioner(const int num_blocks, 
+                                                     const int dim_block)
+  : num_blocks_(num_blocks),
+    dim_block_(dim_block),
+    block_mat_(),
+    pivot_seq_(nullptr),
+    is_singular_seq_(nullptr) {
+}
+
+BlockJacobiPreconditioner::~BlockJacobiPreconditioner() {
+  delete[] pivot_seq_;
+  delete[] is_singular_seq_;
+}
+
+void BlockJacobiPreconditioner::setColumnOfBlocks(const int column, 
+                                                  const double* column_seq) {
+  allocateBlocks();
+  for (int i=0; i<num_blocks_*dim_block_; ++i) {
+    block_mat_[i][column] = column_seq[i];
+  }
+}
+
+void BlockJacobiPreconditioner::factorize() {
+  allocateBlocks();
+  for (int i=0; i<num_blocks_; ++i) {
+    const int i_head = i * dim_block_;
+    is_singular_seq_[i] = !linearalgebra::LUFactorize(
+        dim_block_, block_mat_.stride(), block_mat_[i_head], 
+        &(pivot_seq_[i_head]));
+  }
+}
+
+void BlockJacobiPreconditioner::apply(const double* vec, 
+                                      double* preconditioned_vec) const {
+  for (int i=0; i<num_blocks_; ++i) {
+    const int i_head = i * dim_block_;
+    const double* block_vec = &(vec[i_head]);
+    double* result_vec = &(preconditioned_vec[i_head]);
+    for (int j=0; j<dim_block_; ++j) {
+      result_vec[j] = block_vec[j];
+    }
+    if (is_singular_seq_ == nullptr || is_singular_seq_[i]) {
+      continue;
+    }
+    linearalgebra::LUSolve(dim_block_, block_mat_.stride(), block_mat_[i_head], 
+                           &(pivot_seq_[i_head]), result_vec);
+  }
+}
+
+int BlockJacobiPreconditioner::num_blocks() const {
+  return num_blocks_;
+}
+
+int BlockJacobiPreconditioner::dim_block() const {
+  return dim_block_;
+}
+
+void BlockJacobiPreconditioner::allocateBlocks() {
+  if (pivot_seq_ != nullptr) {
+    return;
+  }
+  block_mat_.resize(num_blocks_*dim_block_, dim_block_);
+  pivot_seq_ = new int[num_blocks_*dim_block_];
+  is_singular_seq_ = new bool[num_blocks_];
+  for (int i=0; i<num_blocks_; ++i) {
+    is_singular_seq_[i] = true;
+  }
+}
+
+} // namespace cgmres
\ No newline at end of file
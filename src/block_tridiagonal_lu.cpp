@@ -0,0 +1,146 @@
+#include "block_tridiagonal_lu.hpp"
+
+
+namespace cgmres {
+
+BlockTridiagonalLU::BlockTridiagonalLU(const int num_blocks, 
+                                       const int dim_block)
+  : num_blocks_(num_blocks),
+    dim_block_(dim_block),
+    lower_mat_(),
+    diagonal_mat_(),
+    upper_mat_(),
+    pivot_seq_(nullptr),
+    is_singular_(true),
+    column_vec_(nullptr) {
+}
+
+BlockTridiagonalLU::~BlockTridiagonalLU() {
+  delete[] pivot_seq_;
+  linearalgebra::DeleteVector(column_vec_);
+}
+
+void BlockTridiagonalLU::setColumnOfBlock(const int block_row, 
+                                          const int block_column, 
+                                          const int column, 
+                                          const double* column_vec) {
+  allocateMatrices();
+  AlignedMatrix* block_mat;
+  if (block_column < block_row) {
+    block_mat = &lower_mat_;
+  }
+  else if (block_column == block_row) {
+    block_mat = &diagonal_mat_;
+  }
+  else {
+    block_mat = &upper_mat_;
+  }
+  const int i_head = block_row * dim_block_;
+  for (int i=0; i<dim_block_; ++i) {
+    (*block_mat)[i_head+i][column] = column_vec[i];
+  }
+}
+
+void BlockTridiagonalLU::factorize() {
+  allocateMatrices();
+  is_singular_ = false;
+  for (int i=0; i<num_blocks_; ++i) {
+    const int i_head = i * dim_block_;
+    if (i > 0) {
+      // D'_i = D_i - L_i * (D'_{i-1}^{-1} * U_{i-1}).
+      const int i_head_prev = i_head - dim_block_;
+      for (int j=0; j<dim_block_; ++j) {
+        for (int k=0; k<dim_block_; ++k) {
+          linearalgebra::AddScaledVector(dim_block_, 
+                                         -lower_mat_[i_head+j][k], 
+                                         upper_mat_[i_head_prev+k], 
+                                         diagonal_mat_[i_head+j]);
+        }
+      }
+    }
+    if (!factorizeBlock(i)) {
+      is_singular_ = true;
+      return;
+    }
+    if (i < num_blocks_-1) {
+      // U_i is overwritten by D'_i^{-1} * U_i column by column.
+      for (int j=0; j<dim_block_; ++j) {
+        for (int k=0; k<dim_block_; ++k) {
+          column_vec_[k] = upper_mat_[i_head+k][j];
+        }
+        solveBlock(i, column_vec_);
+        for (int k=0; k<dim_block_; ++k) {
+          upper_mat_[i_head+k][j] = column_vec_[k];
+        }
+      }
+    }
+  }
+}
+
+void BlockTridiagonalLU::solve(const double* vec, double* solution_vec) const {
+  // Forward substitution: y_i = D'_i^{-1} * (b_i - L_i * y_{i-1}).
+  for (int i=0; i<num_blocks_; ++i) {
+    const int i_head = i * dim_block_;
+    double* y_vec = &(solution_vec[i_head]);
+    for (int j=0; j<dim_block_; ++j) {
+      y_vec[j] = vec[i_head+j];
+    }
+    if (i > 0) {
+      const double* y_vec_prev = &(solution_vec[i_head-dim_block_]);
+      for (int j=0; j<dim_block_; ++j) {
+        y_vec[j] -= linearalgebra::InnerProduct(dim_block_, 
+                                                lower_mat_[i_head+j], 
+                                                y_vec_prev);
+      }
+    }
+    solveBlock(i, y_vec);
+  }
+  // Backward substitution: x_i = y_i - D'_i^{-1} * U_i * x_{i+1}.
+  for (int i=num_blocks_-2; i>=0; --i) {
+    const int i_head = i * dim_block_;
+    const double* x_vec_next = &(solution_vec[i_head+dim_block_]);
+    for (int j=0; j<dim_block_; ++j) {
+      solution_vec[i_head+j] 
+          -= linearalgebra::InnerProduct(dim_block_, upper_mat_[i_head+j], 
+                                         x_vec_next);
+    }
+  }
+}
+
+bool BlockTridiagonalLU::is_singular() const {
+  return is_singular_;
+}
+
+int BlockTridiagonalLU::num_blocks() const {
+  return num_blocks_;
+}
+
+int BlockTridiagonalLU::dim_block() const {
+  return dim_block_;
+}
+
+void BlockTridiagonalLU::allocateMatrices() {
+  if (pivot_seq_ != nullptr) {
+    return;
+  }
+  lower_mat_.resize(num_blocks_*dim_block_, dim_block_);
+  diagonal_mat_.resize(num_blocks_*dim_block_, dim_block_);
+  upper_mat_.resize(num_blocks_*dim_block_, dim_block_);
+  column_vec_ = linearalgebra::NewVector(dim_block_);
+  pivot_seq_ = new int[num_blocks_*dim_block_];
+}
+
+bool BlockTridiagonalLU::factorizeBlock(const int i) {
+  const int i_head = i * dim_block_;
+  return linearalgebra::LUFactorize(dim_block_, diagonal_mat_.stride(), 
+                                    diagonal_mat_[i_head], 
+                                    &(pivot_seq_[i_head]));
+}
+
+void BlockTridiagonalLU::solveBlock(const int i, double* vec) const {
+  const int i_head = i * dim_block_;
+  linearalgebra::LUSolve(dim_block_, diagonal_mat_.stride(), 
+                         diagonal_mat_[i_head], &(pivot_seq_[i_head]), vec);
+}
+
+} // namespace cgmres
\ No newline at end of file
@@ -1,13 +1,15 @@
 #include "input_saturation_functions.hpp"
+#include "dual_number.hpp"
 
 
 namespace cgmres {
 
+template <typename Scalar>
 void inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
     InputSaturationSet& input_saturation_set,
-    const double* control_input_and_constraints_vec, 
-    const double* input_saturation_multiplier_vec, 
-    double* optimality_residual_for_control_input_and_constraints_vec) {
+    const Scalar* control_input_and_constraints_vec, 
+    const Scalar* input_saturation_multiplier_vec, 
+    Scalar* optimality_residual_for_control_input_and_constraints_vec) {
   for (int i=0; i<input_saturation_set.dim_saturation(); ++i) {
     int index_i = input_saturation_set.index(i);
     optimality_residual_for_control_input_and_constraints_vec[index_i] +=
@@ -17,11 +19,12 @@ void inputsaturationfunctions::addHamiltonianDerivativeWithSaturatedInput(
   }
 }
 
+template <typename Scalar>
 void inputsaturationfunctions::computeOptimalityResidualForDummyInput(
     InputSaturationSet& input_saturation_set,
-    const double* dummy_input_vec, 
-    const double* input_saturation_multiplier_vec, 
-    double* optimality_residual_for_dummy_input) {
+    const Scalar* dummy_input_vec, 
+    const Scalar* input_saturation_multiplier_vec, 
+    Scalar* optimality_residual_for_dummy_input) {
  for (int i=0; i<input_saturation_set.dim_saturation(); ++i) {
     optimality_residual_for_dummy_input[i] 
         = 2 * (input_saturation_set.quadratic_weight(i)
@@ -30,10 +33,11 @@ void inputsaturationfunctions::computeOptimalityResidualForDummyInput(
   }
 }
 
+template <typename Scalar>
 void inputsaturationfunctions::computeOptimalityResidualForInputSaturation(
     InputSaturationSet& input_saturation_set,
-    const double* control_input_and_constraint_vec, 
-    const double* dummy_input_vec, double* optimality_residual_for_saturation) {
+    const Scalar* control_input_and_constraint_vec, 
+    const Scalar* dummy_input_vec, Scalar* optimality_residual_for_saturation) {
   for (int i=0; i<input_saturation_set.dim_saturation(); ++i) {
     int index_i = input_saturation_set.index(i);
     double min_i = input_saturation_set.min(i);
@@ -45,4 +49,44 @@ void inputsaturationfunctions::computeOptimalityResidualForInputSaturation(
   }
 }
 
+template void inputsaturationfunctions::
+addHamiltonianDerivativeWithSaturatedInput<double>(
+    InputSaturationSet& input_saturation_set,
+    const double* control_input_and_constraints_vec, 
+    const double* input_saturation_multiplier_vec, 
+    double* optimality_residual_for_control_input_and_constraints_vec);
+
+template void inputsaturationfunctions::
+computeOptimalityResidualForDummyInput<double>(
+    InputSaturationSet& input_saturation_set,
+    const double* dummy_input_vec, 
+    const double* input_saturation_multiplier_vec, 
+    double* optimality_residual_for_dummy_input);
+
+template void inputsaturationfunctions::
+computeOptimalityResidualForInputSaturation<double>(
+    InputSaturationSet& input_saturation_set,
+    const double* control_input_and_constraint_vec, 
+    const double* dummy_input_vec, double* optimality_residual_for_saturation);
+
+template void inputsaturationfunctions::
+addHamiltonianDerivativeWithSaturatedInput<Dual>(
+    InputSaturationSet& input_saturation_set,
+    const Dual* control_input_and_constraints_vec, 
+    const Dual* input_saturation_multiplier_vec, 
+    Dual* optimality_residual_for_control_input_and_constraints_vec);
+
+template void inputsaturationfunctions::
+computeOptimalityResidualForDummyInput<Dual>(
+    InputSaturationSet& input_saturation_set,
+    const Dual* dummy_input_vec, 
+    const Dual* input_saturation_multiplier_vec, 
+    Dual* optimality_residual_for_dummy_input);
+
+template void inputsaturationfunctions::
+computeOptimalityResidualForInputSaturation<Dual>(
+    InputSaturationSet& input_saturation_set,
+    const Dual* control_input_and_constraint_vec, 
+    const Dual* dummy_input_vec, Dual* optimality_residual_for_saturation);
+
 } // namespace cgmres
\ No newline at end of file
@@ -1,8 +1,342 @@
 #include "linear_algebra.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+#if !defined(CGMRES_DISABLE_SIMD) && defined(__GNUC__) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define CGMRES_VECTOR_KERNEL_DISPATCH
+#include <immintrin.h>
+#endif
+
 
 namespace cgmres {
 
+namespace {
+
+// Allocates size bytes aligned to alignment bytes, which must be a power of 
+// two. Over-allocates the memory and stores the original pointer just before 
+// the aligned address so that FreeAligned() can free it. Throws 
+// std::bad_alloc if the allocation fails.
+void* AllocateAligned(const std::size_t size, const std::size_t alignment) {
+  void* raw = std::malloc(size+alignment+sizeof(void*));
+  if (raw == nullptr) {
+    throw std::bad_alloc();
+  }
+  const std::uintptr_t address 
+      = (reinterpret_cast<std::uintptr_t>(raw)+sizeof(void*)+alignment-1) 
+          & ~static_cast<std::uintptr_t>(alignment-1);
+  void* ptr = reinterpret_cast<void*>(address);
+  static_cast<void**>(ptr)[-1] = raw;
+  return ptr;
+}
+
+// Frees the memory allocated by AllocateAligned(). Does nothing if ptr is 
+// nullptr.
+void FreeAligned(void* ptr) {
+  if (ptr != nullptr) {
+    std::free(static_cast<void**>(ptr)[-1]);
+  }
+}
+
+// The portable variants of the kernels of the GMRES method. Several 
+// accumulators are used in the inner products as in 
+// linearalgebra::InnerProduct().
+
+template <typename Scalar>
+inline double InnerProductPortable(const int dim, const double* vec, 
+                                   const Scalar* row) {
+  double ans0 = 0, ans1 = 0, ans2 = 0, ans3 = 0;
+  int i = 0;
+  for (; i+4<=dim; i+=4) {
+    ans0 += vec[i] * static_cast<double>(row[i]);
+    ans1 += vec[i+1] * static_cast<double>(row[i+1]);
+    ans2 += vec[i+2] * static_cast<double>(row[i+2]);
+    ans3 += vec[i+3] * static_cast<double>(row[i+3]);
+  }
+  double ans = (ans0+ans1) + (ans2+ans3);
+  for (; i<dim; ++i) {
+    ans += vec[i] * static_cast<double>(row[i]);
+  }
+  return ans;
+}
+
+template <typename Scalar>
+double OrthogonalizeAgainstRowsPortable(const int dim, const int num_rows, 
+                                        const Scalar* mat, const int stride, 
+                                        double* vec, double* coeff_vec) {
+  for (int r=0; r<num_rows; ++r) {
+    const Scalar* row = mat + r*stride;
+    const double scale = - InnerProductPortable(dim, vec, row);
+    for (int i=0; i<dim; ++i) {
+      vec[i] += scale * static_cast<double>(row[i]);
+    }
+    coeff_vec[r] = - scale;
+  }
+  return std::sqrt(InnerProductPortable(dim, vec, vec));
+}
+
+template <typename Scalar>
+void AddLinearCombinationPortable(const int dim, const int num_rows, 
+                                  const Scalar* mat, const int stride, 
+                                  const double* coeff_vec, double* vec) {
+  for (int i=0; i<dim; ++i) {
+    double sum = vec[i];
+    for (int r=0; r<num_rows; ++r) {
+      sum += coeff_vec[r] * static_cast<double>(mat[r*stride+i]);
+    }
+    vec[i] = sum;
+  }
+}
+
+#if defined(CGMRES_VECTOR_KERNEL_DISPATCH)
+// The variants for AVX2 with FMA and for AVX-512. The target attribute 
+// enables the instruction sets only in these functions, which are called 
+// only if the CPU supports them. The helpers have the same target so that 
+// they are inlined into the kernels.
+#define CGMRES_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define CGMRES_TARGET_AVX512 __attribute__((target("avx512f")))
+
+CGMRES_TARGET_AVX2 
+inline __m256d LoadAVX2(const double* vec) {
+  return _mm256_loadu_pd(vec);
+}
+
+CGMRES_TARGET_AVX2 
+inline __m256d LoadAVX2(const float* vec) {
+  return _mm256_cvtps_pd(_mm_loadu_ps(vec));
+}
+
+// Returns the sum of the four components of vec.
+CGMRES_TARGET_AVX2 
+inline double HorizontalSumAVX2(const __m256d vec) {
+  __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(vec), 
+                           _mm256_extractf128_pd(vec, 1));
+  sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+  return _mm_cvtsd_f64(sum);
+}
+
+template <typename Scalar>
+CGMRES_TARGET_AVX2 
+inline double InnerProductAVX2(const int dim, const double* vec, 
+                               const Scalar* row) {
+  __m256d sum0 = _mm256_setzero_pd();
+  __m256d sum1 = _mm256_setzero_pd();
+  int i = 0;
+  for (; i+8<=dim; i+=8) {
+    sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(vec+i), LoadAVX2(row+i), sum0);
+    sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(vec+i+4), LoadAVX2(row+i+4), 
+                           sum1);
+  }
+  for (; i+4<=dim; i+=4) {
+    sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(vec+i), LoadAVX2(row+i), sum0);
+  }
+  double ans = HorizontalSumAVX2(_mm256_add_pd(sum0, sum1));
+  for (; i<dim; ++i) {
+    ans += vec[i] * static_cast<double>(row[i]);
+  }
+  return ans;
+}
+
+template <typename Scalar>
+CGMRES_TARGET_AVX2 
+double OrthogonalizeAgainstRowsAVX2(const int dim, const int num_rows, 
+                                    const Scalar* mat, const int stride, 
+                                    double* vec, double* coeff_vec) {
+  for (int r=0; r<num_rows; ++r) {
+    const Scalar* row = mat + r*stride;
+    const double scale = - InnerProductAVX2(dim, vec, row);
+    const __m256d scale_pd = _mm256_set1_pd(scale);
+    int i = 0;
+    for (; i+4<=dim; i+=4) {
+      _mm256_storeu_pd(vec+i, _mm256_fmadd_pd(scale_pd, LoadAVX2(row+i), 
+                                              _mm256_loadu_pd(vec+i)));
+    }
+    for (; i<dim; ++i) {
+      vec[i] += scale * static_cast<double>(row[i]);
+    }
+    coeff_vec[r] = - scale;
+  }
+  return std::sqrt(InnerProductAVX2(dim, vec, vec));
+}
+
+template <typename Scalar>
+CGMRES_TARGET_AVX2 
+void AddLinearCombinationAVX2(const int dim, const int num_rows, 
+                              const Scalar* mat, const int stride, 
+                              const double* coeff_vec, double* vec) {
+  // Four independent chains of the FMAs hide their latency.
+  int i = 0;
+  for (; i+16<=dim; i+=16) {
+    __m256d sum0 = _mm256_loadu_pd(vec+i);
+    __m256d sum1 = _mm256_loadu_pd(vec+i+4);
+    __m256d sum2 = _mm256_loadu_pd(vec+i+8);
+    __m256d sum3 = _mm256_loadu_pd(vec+i+12);
+    for (int r=0; r<num_rows; ++r) {
+      const Scalar* row = mat + r*stride + i;
+      const __m256d coeff = _mm256_set1_pd(coeff_vec[r]);
+      sum0 = _mm256_fmadd_pd(coeff, LoadAVX2(row), sum0);
+      sum1 = _mm256_fmadd_pd(coeff, LoadAVX2(row+4), sum1);
+      sum2 = _mm256_fmadd_pd(coeff, LoadAVX2(row+8), sum2);
+      sum3 = _mm256_fmadd_pd(coeff, LoadAVX2(row+12), sum3);
+    }
+    _mm256_storeu_pd(vec+i, sum0);
+    _mm256_storeu_pd(vec+i+4, sum1);
+    _mm256_storeu_pd(vec+i+8, sum2);
+    _mm256_storeu_pd(vec+i+12, sum3);
+  }
+  for (; i+4<=dim; i+=4) {
+    __m256d sum = _mm256_loadu_pd(vec+i);
+    for (int r=0; r<num_rows; ++r) {
+      sum = _mm256_fmadd_pd(_mm256_set1_pd(coeff_vec[r]), 
+                            LoadAVX2(mat+r*stride+i), sum);
+    }
+    _mm256_storeu_pd(vec+i, sum);
+  }
+  for (; i<dim; ++i) {
+    double sum = vec[i];
+    for (int r=0; r<num_rows; ++r) {
+      sum += coeff_vec[r] * static_cast<double>(mat[r*stride+i]);
+    }
+    vec[i] = sum;
+  }
+}
+
+CGMRES_TARGET_AVX512 
+inline __m512d LoadAVX512(const double* vec) {
+  return _mm512_loadu_pd(vec);
+}
+
+// _mm512_cvtps_pd() is not used because it passes an undefined vector to the 
+// builtin of GCC 12, which causes -Wmaybe-uninitialized with -Wall. The 
+// zero-masking conversion with the full mask compiles to the same vcvtps2pd. 
+CGMRES_TARGET_AVX512 
+inline __m512d LoadAVX512(const float* vec) {
+  return _mm512_maskz_cvtps_pd(0xFF, _mm256_loadu_ps(vec));
+}
+
+// Returns the sum of the eight components of vec. _mm512_reduce_add_pd(), 
+// _mm512_extractf64x4_pd(), and _mm512_castpd512_pd256() are not used for 
+// the same reason as _mm512_cvtps_pd() in LoadAVX512(). 
+CGMRES_TARGET_AVX512 
+inline double HorizontalSumAVX512(const __m512d vec) {
+  const __m256d lower = _mm512_maskz_extractf64x4_pd(0x0F, vec, 0);
+  const __m256d upper = _mm512_maskz_extractf64x4_pd(0x0F, vec, 1);
+  const __m256d sum256 = _mm256_add_pd(lower, upper);
+  __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(sum256), 
+                           _mm256_extractf128_pd(sum256, 1));
+  sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+  return _mm_cvtsd_f64(sum);
+}
+
+template <typename Scalar>
+CGMRES_TARGET_AVX512 
+inline double InnerProductAVX512(const int dim, const double* vec, 
+                                 const Scalar* row) {
+  __m512d sum0 = _mm512_setzero_pd();
+  __m512d sum1 = _mm512_setzero_pd();
+  int i = 0;
+  for (; i+16<=dim; i+=16) {
+    sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(vec+i), LoadAVX512(row+i), sum0);
+    sum1 = _mm512_fmadd_pd(_mm512_loadu_pd(vec+i+8), LoadAVX512(row+i+8), 
+                           sum1);
+  }
+  for (; i+8<=dim; i+=8) {
+    sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(vec+i), LoadAVX512(row+i), sum0);
+  }
+  double ans = HorizontalSumAVX512(_mm512_add_pd(sum0, sum1));
+  for (; i<dim; ++i) {
+    ans += vec[i] * static_cast<double>(row[i]);
+  }
+  return ans;
+}
+
+template <typename Scalar>
+CGMRES_TARGET_AVX512 
+double OrthogonalizeAgainstRowsAVX512(const int dim, const int num_rows, 
+                                      const Scalar* mat, const int stride, 
+                                      double* vec, double* coeff_vec) {
+  for (int r=0; r<num_rows; ++r) {
+    const Scalar* row = mat + r*stride;
+    const double scale = - InnerProductAVX512(dim, vec, row);
+    const __m512d scale_pd = _mm512_set1_pd(scale);
+    int i = 0;
+    for (; i+8<=dim; i+=8) {
+      _mm512_storeu_pd(vec+i, _mm512_fmadd_pd(scale_pd, LoadAVX512(row+i), 
+                                              _mm512_loadu_pd(vec+i)));
+    }
+    for (; i<dim; ++i) {
+      vec[i] += scale * static_cast<double>(row[i]);
+    }
+    coeff_vec[r] = - scale;
+  }
+  return std::sqrt(InnerProductAVX512(dim, vec, vec));
+}
+
+template <typename Scalar>
+CGMRES_TARGET_AVX512 
+void AddLinearCombinationAVX512(const int dim, const int num_rows, 
+                                const Scalar* mat, const int stride, 
+                                const double* coeff_vec, double* vec) {
+  int i = 0;
+  for (; i+16<=dim; i+=16) {
+    __m512d sum0 = _mm512_loadu_pd(vec+i);
+    __m512d sum1 = _mm512_loadu_pd(vec+i+8);
+    for (int r=0; r<num_rows; ++r) {
+      const Scalar* row = mat + r*stride + i;
+      const __m512d coeff = _mm512_set1_pd(coeff_vec[r]);
+      sum0 = _mm512_fmadd_pd(coeff, LoadAVX512(row), sum0);
+      sum1 = _mm512_fmadd_pd(coeff, LoadAVX512(row+8), sum1);
+    }
+    _mm512_storeu_pd(vec+i, sum0);
+    _mm512_storeu_pd(vec+i+8, sum1);
+  }
+  for (; i+8<=dim; i+=8) {
+    __m512d sum = _mm512_loadu_pd(vec+i);
+    for (int r=0; r<num_rows; ++r) {
+      sum = _mm512_fmadd_pd(_mm512_set1_pd(coeff_vec[r]), 
+                            LoadAVX512(mat+r*stride+i), sum);
+    }
+    _mm512_storeu_pd(vec+i, sum);
+  }
+  for (; i<dim; ++i) {
+    double sum = vec[i];
+    for (int r=0; r<num_rows; ++r) {
+      sum += coeff_vec[r] * static_cast<double>(mat[r*stride+i]);
+    }
+    vec[i] = sum;
+  }
+}
+
+// Returns the variant of a kernel for the instruction sets supported by the 
+// CPU.
+template <typename Kernel>
+Kernel SelectKernel(const Kernel avx512, const Kernel avx2, 
+                    const Kernel portable) {
+  // __builtin_cpu_init() is needed if this is called before the 
+  // constructors of the static objects, e.g., by one of them.
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return avx512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return avx2;
+  }
+  return portable;
+}
+#endif // CGMRES_VECTOR_KERNEL_DISPATCH
+
+} // namespace
+
+int linearalgebra::PaddedDimension(const int dim) {
+  constexpr int kPaddingUnit = kAlignment / sizeof(double);
+  return ((dim+kPaddingUnit-1)/kPaddingUnit) * kPaddingUnit;
+}
+
 double* linearalgebra::NewVector(const int dim) {
   double* vec = new double[dim];
   for (int i=0; i<dim; ++i) {
@@ -15,6 +349,34 @@ void linearalgebra::DeleteVector(double* vec) {
   delete[] vec;
 }
 
+double* linearalgebra::NewAlignedVector(const int dim) {
+  const int padded_dim = PaddedDimension(dim);
+  double* vec = static_cast<double*>(
+      AllocateAligned(padded_dim*sizeof(double), kAlignment));
+  for (int i=0; i<padded_dim; ++i) {
+    vec[i] = 0;
+  }
+  return vec;
+}
+
+void linearalgebra::DeleteAlignedVector(double* vec) {
+  FreeAligned(vec);
+}
+
+float* linearalgebra::NewAlignedFloatVector(const int dim) {
+  const int padded_dim = PaddedDimension(dim);
+  float* vec = static_cast<float*>(
+      AllocateAligned(padded_dim*sizeof(float), kAlignment));
+  for (int i=0; i<padded_dim; ++i) {
+    vec[i] = 0;
+  }
+  return vec;
+}
+
+void linearalgebra::DeleteAlignedVector(float* vec) {
+  FreeAligned(vec);
+}
+
 double** linearalgebra::NewMatrix(const int dim_row, const int dim_column) {
   double** mat = new double*[dim_row];
   mat[0] = new double[dim_row*dim_column];
@@ -32,21 +394,347 @@ void linearalgebra::DeleteMatrix(double** mat) {
   delete[] mat;
 }
 
-double linearalgebra::InnerProduct(const int dim, const double *vec1, 
-                                   const double *vec2) {
-  double ans = 0;
+bool linearalgebra::LUFactorize(const int dim, const int stride, double* mat, 
+                                int* pivot_seq) {
+  double max_abs_entry = 0;
   for (int i=0; i<dim; ++i) {
-    ans += vec1[i] * vec2[i];
+    for (int j=0; j<dim; ++j) {
+      max_abs_entry = std::max(max_abs_entry, std::abs(mat[i*stride+j]));
+    }
   }
-  return ans;
+  const double pivot_tolerance = kLUPivotTolerance * max_abs_entry;
+  for (int k=0; k<dim; ++k) {
+    double* row_k = mat + k*stride;
+    // Partial pivoting.
+    int k_max = k;
+    for (int i=k+1; i<dim; ++i) {
+      if (std::abs(mat[i*stride+k]) > std::abs(mat[k_max*stride+k])) {
+        k_max = i;
+      }
+    }
+    pivot_seq[k] = k_max;
+    // The negated comparison also rejects NaN.
+    if (!(std::abs(mat[k_max*stride+k]) > pivot_tolerance)) {
+      return false;
+    }
+    if (k_max != k) {
+      double* row_k_max = mat + k_max*stride;
+      for (int j=0; j<dim; ++j) {
+        const double tmp = row_k[j];
+        row_k[j] = row_k_max[j];
+        row_k_max[j] = tmp;
+      }
+    }
+    // Elimination. The rows below the pivot are updated by the vector kernel 
+    // because they are contiguous.
+    const double inverse_pivot = 1.0 / row_k[k];
+    for (int i=k+1; i<dim; ++i) {
+      double* row_i = mat + i*stride;
+      const double l = row_i[k] * inverse_pivot;
+      row_i[k] = l;
+      AddScaledVector(dim-k-1, -l, &(row_k[k+1]), &(row_i[k+1]));
+    }
+  }
+  return true;
 }
 
-double linearalgebra::SquaredNorm(const int dim, const double *vec) {
-  double ans = 0;
-  for (int i=0; i<dim; ++i) {
-    ans += vec[i] * vec[i];
+void linearalgebra::LUSolve(const int dim, const int stride, 
+                            const double* lu_mat, const int* pivot_seq, 
+                            double* vec) {
+  // Solves L * U * vec = P * vec.
+  for (int k=0; k<dim; ++k) {
+    if (pivot_seq[k] != k) {
+      const double tmp = vec[k];
+      vec[k] = vec[pivot_seq[k]];
+      vec[pivot_seq[k]] = tmp;
+    }
   }
-  return ans;
+  for (int k=1; k<dim; ++k) {
+    vec[k] -= InnerProduct(k, lu_mat+k*stride, vec);
+  }
+  for (int k=dim-1; k>=0; --k) {
+    const double* row_k = lu_mat + k*stride;
+    vec[k] -= InnerProduct(dim-k-1, &(row_k[k+1]), &(vec[k+1]));
+    vec[k] /= row_k[k];
+  }
+}
+
+bool linearalgebra::ComputeEigenvalues(const int dim, const int stride, 
+                                       double* mat, double* real_vec, 
+                                       double* imag_vec) {
+  // The indices of a() are one-based as in the reference.
+  auto a = [mat, stride](const int i, const int j) -> double& {
+    return mat[(i-1)*stride+(j-1)];
+  };
+  const int n = dim;
+  // Reduction to the Hessenberg form by the elimination with pivoting.
+  for (int m=2; m<n; ++m) {
+    double x = 0;
+    int i = m;
+    for (int j=m; j<=n; ++j) {
+      if (std::abs(a(j, m-1)) > std::abs(x)) {
+        x = a(j, m-1);
+        i = j;
+      }
+    }
+    if (i != m) {
+      for (int j=m-1; j<=n; ++j) {
+        std::swap(a(i, j), a(m, j));
+      }
+      for (int j=1; j<=n; ++j) {
+        std::swap(a(j, i), a(j, m));
+      }
+    }
+    if (x != 0) {
+      for (i=m+1; i<=n; ++i) {
+        double y = a(i, m-1);
+        if (y != 0) {
+          y /= x;
+          a(i, m-1) = y;
+          for (int j=m; j<=n; ++j) {
+            a(i, j) -= y * a(m, j);
+          }
+          for (int j=1; j<=n; ++j) {
+            a(j, m) += y * a(j, i);
+          }
+        }
+      }
+    }
+  }
+  for (int i=3; i<=n; ++i) {
+    for (int j=1; j<i-1; ++j) {
+      a(i, j) = 0;
+    }
+  }
+  // The shifted QR algorithm on the Hessenberg matrix.
+  double anorm = 0;
+  for (int i=1; i<=n; ++i) {
+    for (int j=std::max(i-1, 1); j<=n; ++j) {
+      anorm += std::abs(a(i, j));
+    }
+  }
+  int nn = n;
+  double t = 0;
+  while (nn >= 1) {
+    int its = 0;
+    int l;
+    do {
+      // Looks for a small subdiagonal element.
+      for (l=nn; l>=2; --l) {
+        double s = std::abs(a(l-1, l-1)) + std::abs(a(l, l));
+        if (s == 0) {
+          s = anorm;
+        }
+        if (std::abs(a(l, l-1)) + s == s) {
+          a(l, l-1) = 0;
+          break;
+        }
+      }
+      double x = a(nn, nn);
+      if (l == nn) {
+        // One root found.
+        real_vec[nn-1] = x + t;
+        imag_vec[nn-1] = 0;
+        --nn;
+      } 
+      else {
+        double y = a(nn-1, nn-1);
+        double w = a(nn, nn-1) * a(nn-1, nn);
+        if (l == nn-1) {
+          // Two roots found.
+          const double p = 0.5 * (y-x);
+          const double q = p*p + w;
+          double z = std::sqrt(std::abs(q));
+          x += t;
+          if (q >= 0) {
+            z = p + ((p >= 0) ? z : -z);
+            real_vec[nn-2] = real_vec[nn-1] = x + z;
+            if (z != 0) {
+              real_vec[nn-1] = x - w/z;
+            }
+            imag_vec[nn-2] = imag_vec[nn-1] = 0;
+          } 
+          else {
+            real_vec[nn-2] = real_vec[nn-1] = x + p;
+            imag_vec[nn-2] = z;
+            imag_vec[nn-1] = -z;
+          }
+          nn -= 2;
+        } 
+        else {
+          // The negated comparison also rejects NaN.
+          if (its == 30 || !(anorm < std::numeric_limits<double>::infinity())) {
+            return false;
+          }
+          if (its == 10 || its == 20) {
+            // Exceptional shift.
+            t += x;
+            for (int i=1; i<=nn; ++i) {
+              a(i, i) -= x;
+            }
+            const double s = std::abs(a(nn, nn-1)) + std::abs(a(nn-1, nn-2));
+            y = x = 0.75 * s;
+            w = -0.4375 * s * s;
+          }
+          ++its;
+          // Forms the shift and looks for two consecutive small subdiagonal 
+          // elements.
+          int m;
+          double p = 0, q = 0, r = 0, z = 0;
+          for (m=nn-2; m>=l; --m) {
+            z = a(m, m);
+            r = x - z;
+            double s = y - z;
+            p = (r*s-w) / a(m+1, m) + a(m, m+1);
+            q = a(m+1, m+1) - z - r - s;
+            r = a(m+2, m+1);
+            s = std::abs(p) + std::abs(q) + std::abs(r);
+            p /= s;
+            q /= s;
+            r /= s;
+            if (m == l) {
+              break;
+            }
+            const double u = std::abs(a(m, m-1)) * (std::abs(q)+std::abs(r));
+            const double v = std::abs(p) * (std::abs(a(m-1, m-1)) + std::abs(z) 
+                                            + std::abs(a(m+1, m+1)));
+            if (u + v == v) {
+              break;
+            }
+          }
+          for (int i=m+2; i<=nn; ++i) {
+            a(i, i-2) = 0;
+            if (i != m+2) {
+              a(i, i-3) = 0;
+            }
+          }
+          // The double QR step on the rows l to nn and the columns m to nn.
+          for (int k=m; k<=nn-1; ++k) {
+            if (k != m) {
+              p = a(k, k-1);
+              q = a(k+1, k-1);
+              r = 0;
+              if (k != nn-1) {
+                r = a(k+2, k-1);
+              }
+              x = std::abs(p) + std::abs(q) + std::abs(r);
+              if (x != 0) {
+                p /= x;
+                q /= x;
+                r /= x;
+              }
+            }
+            double s = std::sqrt(p*p+q*q+r*r);
+            if (p < 0) {
+              s = -s;
+            }
+            if (s != 0) {
+              if (k == m) {
+                if (l != m) {
+                  a(k, k-1) = -a(k, k-1);
+                }
+              } 
+              else {
+                a(k, k-1) = -s * x;
+              }
+              p += s;
+              x = p / s;
+              y = q / s;
+              z = r / s;
+              q /= p;
+              r /= p;
+              for (int j=k; j<=nn; ++j) {
+                p = a(k, j) + q * a(k+1, j);
+                if (k != nn-1) {
+                  p += r * a(k+2, j);
+                  a(k+2, j) -= p * z;
+                }
+                a(k+1, j) -= p * y;
+                a(k, j) -= p * x;
+              }
+              const int mmin = (nn < k+3) ? nn : k+3;
+              for (int i=l; i<=mmin; ++i) {
+                p = x * a(i, k) + y * a(i, k+1);
+                if (k != nn-1) {
+                  p += z * a(i, k+2);
+                  a(i, k+2) -= p * r;
+                }
+                a(i, k+1) -= p * q;
+                a(i, k) -= p;
+              }
+            }
+          }
+        }
+      }
+    } while (l < nn-1);
+  }
+  return true;
+}
+
+double linearalgebra::OrthogonalizeAgainstRows(const int dim, 
+                                               const int num_rows, 
+                                               const double* mat, 
+                                               const int stride, double* vec, 
+                                               double* coeff_vec) {
+#if defined(CGMRES_VECTOR_KERNEL_DISPATCH)
+  // The variant is selected once and the function-local static makes the 
+  // selection thread-safe.
+  static const auto kernel 
+      = SelectKernel(&OrthogonalizeAgainstRowsAVX512<double>, 
+                     &OrthogonalizeAgainstRowsAVX2<double>, 
+                     &OrthogonalizeAgainstRowsPortable<double>);
+  return kernel(dim, num_rows, mat, stride, vec, coeff_vec);
+#else
+  return OrthogonalizeAgainstRowsPortable(dim, num_rows, mat, stride, vec, 
+                                          coeff_vec);
+#endif
+}
+
+double linearalgebra::OrthogonalizeAgainstRows(const int dim, 
+                                               const int num_rows, 
+                                               const float* mat, 
+                                               const int stride, double* vec, 
+                                               double* coeff_vec) {
+#if defined(CGMRES_VECTOR_KERNEL_DISPATCH)
+  static const auto kernel 
+      = SelectKernel(&OrthogonalizeAgainstRowsAVX512<float>, 
+                     &OrthogonalizeAgainstRowsAVX2<float>, 
+                     &OrthogonalizeAgainstRowsPortable<float>);
+  return kernel(dim, num_rows, mat, stride, vec, coeff_vec);
+#else
+  return OrthogonalizeAgainstRowsPortable(dim, num_rows, mat, stride, vec, 
+                                          coeff_vec);
+#endif
+}
+
+void linearalgebra::AddLinearCombination(const int dim, const int num_rows, 
+                                         const double* mat, const int stride, 
+                                         const double* coeff_vec, 
+                                         double* vec) {
+#if defined(CGMRES_VECTOR_KERNEL_DISPATCH)
+  static const auto kernel 
+      = SelectKernel(&AddLinearCombinationAVX512<double>, 
+                     &AddLinearCombinationAVX2<double>, 
+                     &AddLinearCombinationPortable<double>);
+  kernel(dim, num_rows, mat, stride, coeff_vec, vec);
+#else
+  AddLinearCombinationPortable(dim, num_rows, mat, stride, coeff_vec, vec);
+#endif
+}
+
+void linearalgebra::AddLinearCombination(const int dim, const int num_rows, 
+                                         const float* mat, const int stride, 
+                                         const double* coeff_vec, 
+                                         double* vec) {
+#if defined(CGMRES_VECTOR_KERNEL_DISPATCH)
+  static const auto kernel 
+      = SelectKernel(&AddLinearCombinationAVX512<float>, 
+                     &AddLinearCombinationAVX2<float>, 
+                     &AddLinearCombinationPortable<float>);
+  kernel(dim, num_rows, mat, stride, coeff_vec, vec);
+#else
+  AddLinearCombinationPortable(dim, num_rows, mat, stride, coeff_vec, vec);
+#endif
 }
 
 } // namespace cgmres
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "minimal_residual_smoothing.hpp"
+
+
+namespace cgmres {
+
+MinimalResidualSmoothing::MinimalResidualSmoothing()
+  : dim_(0),
+    smoothed_residual_norm_(0),
+    smoothed_solution_vec_(nullptr),
+    smoothed_residual_vec_(nullptr) {
+}
+
+MinimalResidualSmoothing::MinimalResidualSmoothing(const int dim)
+  : dim_(dim),
+    smoothed_residual_norm_(0),
+    smoothed_solution_vec_(linearalgebra::NewVector(dim)),
+    smoothed_residual_vec_(linearalgebra::NewVector(dim)) {
+}
+
+MinimalResidualSmoothing::~MinimalResidualSmoothing() {
+  linearalgebra::DeleteVector(smoothed_solution_vec_);
+  linearalgebra::DeleteVector(smoothed_residual_vec_);
+}
+
+void MinimalResidualSmoothing::resize(const int dim) {
+  linearalgebra::DeleteVector(smoothed_solution_vec_);
+  linearalgebra::DeleteVector(smoothed_residual_vec_);
+  dim_ = dim;
+  smoothed_solution_vec_ = linearalgebra::NewVector(dim);
+  smoothed_residual_vec_ = linearalgebra::NewVector(dim);
+}
+
+double MinimalResidualSmoothing::initialize(const double* solution_vec, 
+                                            const double* residual_vec) {
+  for (int i=0; i<dim_; ++i) {
+    smoothed_solution_vec_[i] = solution_vec[i];
+    smoothed_residual_vec_[i] = residual_vec[i];
+  }
+  smoothed_residual_norm_ = std::sqrt(linearalgebra::SquaredNorm(
+      dim_, smoothed_residual_vec_));
+  return smoothed_residual_norm_;
+}
+
+double MinimalResidualSmoothing::update(const double* solution_vec, 
+                                        const double* residual_vec) {
+  // eta = - (s, r-s) / ||r-s||^2, which is computed from the inner products 
+  // to avoid an additional vector.
+  const double ss = smoothed_residual_norm_ * smoothed_residual_norm_;
+  const double sr = linearalgebra::InnerProduct(dim_, smoothed_residual_vec_, 
+                                                residual_vec);
+  const double rr = linearalgebra::SquaredNorm(dim_, residual_vec);
+  const double squared_difference_norm = rr - 2*sr + ss;
+  if (!(squared_difference_norm > 0) || !std::isfinite(rr)) {
+    return smoothed_residual_norm_;
+  }
+  const double eta = (ss-sr) / squared_difference_norm;
+  linearalgebra::ScaleVector(dim_, 1-eta, smoothed_solution_vec_);
+  linearalgebra::AddScaledVector(dim_, eta, solution_vec, 
+                                 smoothed_solution_vec_);
+  linearalgebra::ScaleVector(dim_, 1-eta, smoothed_residual_vec_);
+  linearalgebra::AddScaledVector(dim_, eta, residual_vec, 
+                                 smoothed_residual_vec_);
+  smoothed_residual_norm_ = std::sqrt(linearalgebra::SquaredNorm(
+      dim_, smoothed_residual_vec_));
+  return smoothed_residual_norm_;
+}
+
+const double* MinimalResidualSmoothing::smoothed_solution_vec() const {
+  return smoothed_solution_vec_;
+}
+
+const double* MinimalResidualSmoothing::smoothed_residual_vec() const {
+  return smoothed_residual_vec_;
+}
+
+} // namespace cgmres
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "model_plugin.hpp"
+#include "model_plugin_abi.hpp"
+
+#include <stdexcept>
+#if defined(_WIN32)
+  #include <windows.h>
+#else
+  #include <dlfcn.h>
+#endif
+
+
+namespace cgmres {
+namespace modelplugin {
+
+namespace {
+
+void* OpenLibrary(const std::string& path) {
+#if defined(_WIN32)
+  return reinterpret_cast<void*>(LoadLibraryA(path.c_str()));
+#else
+  return dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+#endif
+}
+
+void CloseLibrary(void* handle) {
+#if defined(_WIN32)
+  FreeLibrary(reinterpret_cast<HMODULE>(handle));
+#else
+  dlclose(handle);
+#endif
+}
+
+void* FindSymbol(void* handle, const char* name) {
+#if defined(_WIN32)
+  return reinterpret_cast<void*>(
+      GetProcAddress(reinterpret_cast<HMODULE>(handle), name));
+#else
+  return dlsym(handle, name);
+#endif
+}
+
+std::string LastError() {
+#if defined(_WIN32)
+  return "error code " + std::to_string(GetLastError());
+#else
+  const char* error = dlerror();
+  return (error != nullptr) ? std::string(error) : std::string();
+#endif
+}
+
+// Resolves the function name of the plugin into function. Returns false if 
+// it is not found.
+template <typename Function>
+bool ResolveFunction(void* handle, const char* name, Function& function) {
+  function = reinterpret_cast<Function>(FindSymbol(handle, name));
+  return (function != nullptr);
+}
+
+} // namespace
+
+void* Open(const std::string& path, const int dim_state, 
+           const int dim_control_input, const int dim_constraints, 
+           Functions& functions) {
+  void* handle = OpenLibrary(path);
+  if (handle == nullptr) {
+    throw std::runtime_error("Failed to load the model plugin " + path + ": " 
+                             + LastError());
+  }
+  int (*abi_version)();
+  int (*plugin_dim_state)();
+  int (*plugin_dim_control_input)();
+  int (*plugin_dim_constraints)();
+  if (!ResolveFunction(handle, "cgmres_model_plugin_abi_version", abi_version)
+      || !ResolveFunction(handle, "cgmres_model_dim_state", plugin_dim_state)
+      || !ResolveFunction(handle, "cgmres_model_dim_control_input", 
+                          plugin_dim_control_input)
+      || !ResolveFunction(handle, "cgmres_model_dim_constraints", 
+                          plugin_dim_constraints)
+      || !ResolveFunction(handle, "cgmres_model_state_func", 
+                          functions.state_func)
+      || !ResolveFunction(handle, "cgmres_model_phix_func", 
+                          functions.phix_func)
+      || !ResolveFunction(handle, "cgmres_model_hx_func", functions.hx_func)
+      || !ResolveFunction(handle, "cgmres_model_hu_func", functions.hu_func)
+      || !ResolveFunction(handle, "cgmres_model_state_func_jvp", 
+                          functions.state_func_jvp)
+      || !ResolveFunction(handle, "cgmres_model_phix_func_jvp", 
+                          functions.phix_func_jvp)
+      || !ResolveFunction(handle, "cgmres_model_hx_func_jvp", 
+                          functions.hx_func_jvp)
+      || !ResolveFunction(handle, "cgmres_model_hu_func_jvp", 
+                          functions.hu_func_jvp)) {
+    const std::string error = LastError();
+    CloseLibrary(handle);
+    throw std::runtime_error("The model plugin " + path 
+                             + " does not provide the ABI: " + error);
+  }
+  if (abi_version() != CGMRES_MODEL_PLUGIN_ABI_VERSION) {
+    CloseLibrary(handle);
+    throw std::runtime_error("The ABI version of the model plugin " + path 
+                             + " does not match.");
+  }
+  if (plugin_dim_state() != dim_state 
+      || plugin_dim_control_input() != dim_control_input
+      || plugin_dim_constraints() != dim_constraints) {
+    CloseLibrary(handle);
+    throw std::runtime_error("The dimensions of the model plugin " + path 
+                             + " do not match those of the model.");
+  }
+  return handle;
+}
+
+void Close(void* handle) {
+  CloseLibrary(handle);
+}
+
+} // namespace modelplugin
+} // namespace cgmres
\ No newline at end of file
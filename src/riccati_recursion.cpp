@@ -0,0 +1,274 @@
+#include "riccati_recursion.hpp"
+
+
+namespace cgmres {
+
+RiccatiRecursion::RiccatiRecursion(const int N, const int dim_state, 
+                                   const int dim_control_input_and_constraints)
+  : N_(N),
+    dim_state_(dim_state),
+    dim_control_input_and_constraints_(dim_control_input_and_constraints),
+    A_mat_(),
+    B_mat_(),
+    E_mat_(),
+    Qxx_mat_(),
+    Qxu_mat_(),
+    Hux_mat_(),
+    Hulmd_mat_(),
+    G_mat_(),
+    K_mat_(),
+    W_mat_(),
+    P_mat_(),
+    PA_mat_(),
+    PB_mat_(),
+    terminal_mat_(),
+    pivot_seq_(nullptr),
+    is_singular_(true),
+    p_vec_(nullptr),
+    p_vec_1_(nullptr),
+    dx_vec_(nullptr),
+    dx_vec_1_(nullptr),
+    column_vec_(nullptr) {
+}
+
+RiccatiRecursion::~RiccatiRecursion() {
+  delete[] pivot_seq_;
+  linearalgebra::DeleteVector(p_vec_);
+  linearalgebra::DeleteVector(p_vec_1_);
+  linearalgebra::DeleteVector(dx_vec_);
+  linearalgebra::DeleteVector(dx_vec_1_);
+  linearalgebra::DeleteVector(column_vec_);
+}
+
+void RiccatiRecursion::setStageJacobian(const int stage, 
+                                        const double delta_tau, 
+                                        const AlignedMatrix& stage_jacobian) {
+  allocateMatrices();
+  const int x_head = stage * dim_state_;
+  const int u_head = stage * dim_control_input_and_constraints_;
+  // The heads of the rows and the columns of f, H_u, and H_x, and of x, U, 
+  // and lambda in stage_jacobian.
+  const int f = 0;
+  const int hu = dim_state_;
+  const int hx = dim_state_ + dim_control_input_and_constraints_;
+  const int x = 0;
+  const int u = dim_state_;
+  const int lmd = dim_state_ + dim_control_input_and_constraints_;
+  for (int i=0; i<dim_state_; ++i) {
+    for (int j=0; j<dim_state_; ++j) {
+      A_mat_[x_head+i][j] = delta_tau * stage_jacobian[f+i][x+j];
+      E_mat_[x_head+i][j] = delta_tau * stage_jacobian[hx+i][lmd+j];
+      Qxx_mat_[x_head+i][j] = delta_tau * stage_jacobian[hx+i][x+j];
+    }
+    A_mat_[x_head+i][i] += 1;
+    E_mat_[x_head+i][i] += 1;
+    for (int j=0; j<dim_control_input_and_constraints_; ++j) {
+      B_mat_[x_head+i][j] = delta_tau * stage_jacobian[f+i][u+j];
+      Qxu_mat_[x_head+i][j] = delta_tau * stage_jacobian[hx+i][u+j];
+    }
+  }
+  for (int i=0; i<dim_control_input_and_constraints_; ++i) {
+    for (int j=0; j<dim_state_; ++j) {
+      Hux_mat_[u_head+i][j] = stage_jacobian[hu+i][x+j];
+      Hulmd_mat_[u_head+i][j] = stage_jacobian[hu+i][lmd+j];
+    }
+    for (int j=0; j<dim_control_input_and_constraints_; ++j) {
+      G_mat_[u_head+i][j] = stage_jacobian[hu+i][u+j];
+    }
+  }
+}
+
+void RiccatiRecursion::setTerminalJacobian(
+    const AlignedMatrix& terminal_jacobian) {
+  allocateMatrices();
+  for (int i=0; i<dim_state_; ++i) {
+    for (int j=0; j<dim_state_; ++j) {
+      terminal_mat_[i][j] = terminal_jacobian[i][j];
+    }
+  }
+}
+
+void RiccatiRecursion::factorize() {
+  allocateMatrices();
+  is_singular_ = false;
+  for (int i=0; i<dim_state_; ++i) {
+    for (int j=0; j<dim_state_; ++j) {
+      P_mat_[i][j] = terminal_mat_[i][j];
+    }
+  }
+  for (int stage=N_-1; stage>=0; --stage) {
+    const int x_head = stage * dim_state_;
+    const int u_head = stage * dim_control_input_and_constraints_;
+    // PA = P * A and PB = P * B.
+    for (int i=0; i<dim_state_; ++i) {
+      for (int j=0; j<dim_state_; ++j) {
+        double sum = 0;
+        for (int k=0; k<dim_state_; ++k) {
+          sum += P_mat_[i][k] * A_mat_[x_head+k][j];
+        }
+        PA_mat_[i][j] = sum;
+      }
+      for (int j=0; j<dim_control_input_and_constraints_; ++j) {
+        double sum = 0;
+        for (int k=0; k<dim_state_; ++k) {
+          sum += P_mat_[i][k] * B_mat_[x_head+k][j];
+        }
+        PB_mat_[i][j] = sum;
+      }
+    }
+    // G = H_uu + H_ulambda * PB and K = - G^{-1} (H_ux + H_ulambda * PA).
+    for (int i=0; i<dim_control_input_and_constraints_; ++i) {
+      for (int j=0; j<dim_control_input_and_constraints_; ++j) {
+        double sum = 0;
+        for (int k=0; k<dim_state_; ++k) {
+          sum += Hulmd_mat_[u_head+i][k] * PB_mat_[k][j];
+        }
+        G_mat_[u_head+i][j] += sum;
+      }
+      for (int j=0; j<dim_state_; ++j) {
+        double sum = Hux_mat_[u_head+i][j];
+        for (int k=0; k<dim_state_; ++k) {
+          sum += Hulmd_mat_[u_head+i][k] * PA_mat_[k][j];
+        }
+        K_mat_[u_head+i][j] = - sum;
+      }
+    }
+    if (!factorizeBlock(stage)) {
+      is_singular_ = true;
+      return;
+    }
+    for (int j=0; j<dim_state_; ++j) {
+      for (int i=0; i<dim_control_input_and_constraints_; ++i) {
+        column_vec_[i] = K_mat_[u_head+i][j];
+      }
+      solveBlock(stage, column_vec_);
+      for (int i=0; i<dim_control_input_and_constraints_; ++i) {
+        K_mat_[u_head+i][j] = column_vec_[i];
+      }
+    }
+    if (stage == 0) {
+      break;
+    }
+    // W = E * PB + delta_tau * H_xu and 
+    // P = E * PA + delta_tau * H_xx + W * K.
+    for (int i=0; i<dim_state_; ++i) {
+      for (int j=0; j<dim_control_input_and_constraints_; ++j) {
+        double sum = Qxu_mat_[x_head+i][j];
+        for (int k=0; k<dim_state_; ++k) {
+          sum += E_mat_[x_head+i][k] * PB_mat_[k][j];
+        }
+        W_mat_[x_head+i][j] = sum;
+      }
+    }
+    for (int i=0; i<dim_state_; ++i) {
+      for (int j=0; j<dim_state_; ++j) {
+        double sum = Qxx_mat_[x_head+i][j];
+        for (int k=0; k<dim_state_; ++k) {
+          sum += E_mat_[x_head+i][k] * PA_mat_[k][j];
+        }
+        for (int k=0; k<dim_control_input_and_constraints_; ++k) {
+          sum += W_mat_[x_head+i][k] * K_mat_[u_head+k][j];
+        }
+        P_mat_[i][j] = sum;
+      }
+    }
+  }
+}
+
+void RiccatiRecursion::solve(const double* b_vec, double* solution_vec) {
+  // Backward sweep: the feedforward terms of dU are stored in solution_vec.
+  for (int i=0; i<dim_state_; ++i) {
+    p_vec_[i] = 0;
+  }
+  for (int stage=N_-1; stage>=0; --stage) {
+    const int x_head = stage * dim_state_;
+    const int u_head = stage * dim_control_input_and_constraints_;
+    double* k_vec = &(solution_vec[u_head]);
+    for (int i=0; i<dim_control_input_and_constraints_; ++i) {
+      k_vec[i] = b_vec[u_head+i] 
+                 - linearalgebra::InnerProduct(dim_state_, 
+                                               Hulmd_mat_[u_head+i], p_vec_);
+    }
+    solveBlock(stage, k_vec);
+    if (stage == 0) {
+      break;
+    }
+    for (int i=0; i<dim_state_; ++i) {
+      p_vec_1_[i] 
+          = linearalgebra::InnerProduct(dim_state_, E_mat_[x_head+i], p_vec_) 
+            + linearalgebra::InnerProduct(dim_control_input_and_constraints_, 
+                                          W_mat_[x_head+i], k_vec);
+    }
+    double* tmp = p_vec_;
+    p_vec_ = p_vec_1_;
+    p_vec_1_ = tmp;
+  }
+  // Forward sweep: dU is computed with the feedback of dx.
+  for (int i=0; i<dim_state_; ++i) {
+    dx_vec_[i] = 0;
+  }
+  for (int stage=0; stage<N_; ++stage) {
+    const int x_head = stage * dim_state_;
+    const int u_head = stage * dim_control_input_and_constraints_;
+    double* u_vec = &(solution_vec[u_head]);
+    for (int i=0; i<dim_control_input_and_constraints_; ++i) {
+      u_vec[i] += linearalgebra::InnerProduct(dim_state_, K_mat_[u_head+i], 
+                                              dx_vec_);
+    }
+    for (int i=0; i<dim_state_; ++i) {
+      dx_vec_1_[i] 
+          = linearalgebra::InnerProduct(dim_state_, A_mat_[x_head+i], dx_vec_) 
+            + linearalgebra::InnerProduct(dim_control_input_and_constraints_, 
+                                          B_mat_[x_head+i], u_vec);
+    }
+    double* tmp = dx_vec_;
+    dx_vec_ = dx_vec_1_;
+    dx_vec_1_ = tmp;
+  }
+}
+
+bool RiccatiRecursion::is_singular() const {
+  return is_singular_;
+}
+
+void RiccatiRecursion::allocateMatrices() {
+  if (pivot_seq_ != nullptr) {
+    return;
+  }
+  A_mat_.resize(N_*dim_state_, dim_state_);
+  B_mat_.resize(N_*dim_state_, dim_control_input_and_constraints_);
+  E_mat_.resize(N_*dim_state_, dim_state_);
+  Qxx_mat_.resize(N_*dim_state_, dim_state_);
+  Qxu_mat_.resize(N_*dim_state_, dim_control_input_and_constraints_);
+  Hux_mat_.resize(N_*dim_control_input_and_constraints_, dim_state_);
+  Hulmd_mat_.resize(N_*dim_control_input_and_constraints_, dim_state_);
+  G_mat_.resize(N_*dim_control_input_and_constraints_, 
+                dim_control_input_and_constraints_);
+  K_mat_.resize(N_*dim_control_input_and_constraints_, dim_state_);
+  W_mat_.resize(N_*dim_state_, dim_control_input_and_constraints_);
+  P_mat_.resize(dim_state_, dim_state_);
+  PA_mat_.resize(dim_state_, dim_state_);
+  PB_mat_.resize(dim_state_, dim_control_input_and_constraints_);
+  terminal_mat_.resize(dim_state_, dim_state_);
+  p_vec_ = linearalgebra::NewVector(dim_state_);
+  p_vec_1_ = linearalgebra::NewVector(dim_state_);
+  dx_vec_ = linearalgebra::NewVector(dim_state_);
+  dx_vec_1_ = linearalgebra::NewVector(dim_state_);
+  column_vec_ = linearalgebra::NewVector(dim_control_input_and_constraints_);
+  pivot_seq_ = new int[N_*dim_control_input_and_constraints_];
+}
+
+bool RiccatiRecursion::factorizeBlock(const int stage) {
+  const int i_head = stage * dim_control_input_and_constraints_;
+  return linearalgebra::LUFactorize(dim_control_input_and_constraints_, 
+                                    G_mat_.stride(), G_mat_[i_head], 
+                                    &(pivot_seq_[i_head]));
+}
+
+void RiccatiRecursion::solveBlock(const int stage, double* vec) const {
+  const int i_head = stage * dim_control_input_and_constraints_;
+  linearalgebra::LUSolve(dim_control_input_and_constraints_, G_mat_.stride(), 
+                         G_mat_[i_head], &(pivot_seq_[i_head]), vec);
+}
+
+} // namespace cgmres
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "shooting_chain_preconditioner.hpp"
+
+
+namespace cgmres {
+
+ShootingChainPreconditioner::ShootingChainPreconditioner(
+    const int N, const int dim_control_input_and_constraints, 
+    const int dim_state)
+  : N_(N),
+    dim_control_input_and_constraints_seq_(
+        N*dim_control_input_and_constraints),
+    dim_state_(dim_state),
+    control_input_preconditioner_(N, dim_control_input_and_constraints) {
+}
+
+void ShootingChainPreconditioner::apply(const double* vec, 
+                                        double* preconditioned_vec) const {
+  control_input_preconditioner_.apply(vec, preconditioned_vec);
+  // The state of each stage is the sum of the residuals of the previous ones.
+  const double* state_seq = &(vec[dim_control_input_and_constraints_seq_]);
+  double* preconditioned_state_seq 
+      = &(preconditioned_vec[dim_control_input_and_constraints_seq_]);
+  for (int j=0; j<dim_state_; ++j) {
+    preconditioned_state_seq[j] = state_seq[j];
+  }
+  for (int i=1; i<N_; ++i) {
+    for (int j=0; j<dim_state_; ++j) {
+      preconditioned_state_seq[i*dim_state_+j] 
+          = preconditioned_state_seq[(i-1)*dim_state_+j] 
+            + state_seq[i*dim_state_+j];
+    }
+  }
+  // Lambda of each stage is the sum of the residuals of the subsequent ones.
+  const double* lambda_seq = &(state_seq[N_*dim_state_]);
+  double* preconditioned_lambda_seq 
+      = &(preconditioned_state_seq[N_*dim_state_]);
+  for (int j=0; j<dim_state_; ++j) {
+    preconditioned_lambda_seq[(N_-1)*dim_state_+j] 
+        = lambda_seq[(N_-1)*dim_state_+j];
+  }
+  for (int i=N_-2; i>=0; --i) {
+    for (int j=0; j<dim_state_; ++j) {
+      preconditioned_lambda_seq[i*dim_state_+j] 
+          = preconditioned_lambda_seq[(i+1)*dim_state_+j] 
+            + lambda_seq[i*dim_state_+j];
+    }
+  }
+}
+
+BlockJacobiPreconditioner& 
+ShootingChainPreconditioner::control_input_preconditioner() {
+  return control_input_preconditioner_;
+}
+
+} // namespace cgmres
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "stage_thread_pool.hpp"
+
+
+namespace cgmres {
+
+namespace {
+// Number of the checks of the generation by a worker before it sleeps.
+constexpr int kMaxSpins = 1 << 14;
+} // namespace
+
+StageThreadPool::StageThreadPool()
+  : workers_(),
+    mutex_(),
+    condition_(),
+    generation_(0),
+    num_running_workers_(0),
+    is_terminated_(false),
+    num_threads_(1),
+    begin_(0),
+    end_(0),
+    invoker_(nullptr),
+    function_(nullptr) {
+}
+
+StageThreadPool::~StageThreadPool() {
+  joinWorkers();
+}
+
+void StageThreadPool::setNumThreads(const int num_threads) {
+  joinWorkers();
+  num_threads_ = std::max(num_threads, 1);
+  const int num_hardware_threads 
+      = static_cast<int>(std::thread::hardware_concurrency());
+  if (num_hardware_threads > 0) {
+    num_threads_ = std::min(num_threads_, num_hardware_threads);
+  }
+  is_terminated_.store(false);
+  // The generation is passed to the workers because run() may be called 
+  // before they start.
+  const unsigned generation = generation_.load();
+  for (int i=1; i<num_threads_; ++i) {
+    workers_.emplace_back(&StageThreadPool::workerLoop, this, i, generation);
+  }
+}
+
+int StageThreadPool::num_threads() const {
+  return num_threads_;
+}
+
+void StageThreadPool::run(const int begin, const int end, 
+                          const Invoker invoker, const void* function) {
+  begin_ = begin;
+  end_ = end;
+  invoker_ = invoker;
+  function_ = function;
+  num_running_workers_.store(num_threads_-1, std::memory_order_relaxed);
+  // The generation is incremented under the lock so that a worker that is 
+  // about to sleep does not miss the notification.
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation_.fetch_add(1, std::memory_order_release);
+  }
+  condition_.notify_all();
+  runChunk(0);
+  while (num_running_workers_.load(std::memory_order_acquire) > 0) {
+    std::this_thread::yield();
+  }
+}
+
+void StageThreadPool::runChunk(const int thread_index) {
+  const long long length = end_ - begin_;
+  const int chunk_begin = begin_ + (length*thread_index) / num_threads_;
+  const int chunk_end = begin_ + (length*(thread_index+1)) / num_threads_;
+  if (chunk_begin < chunk_end) {
+    invoker_(function_, thread_index, chunk_begin, chunk_end);
+  }
+}
+
+void StageThreadPool::workerLoop(const int thread_index, 
+                                 unsigned generation) {
+  while (true) {
+    int num_spins = 0;
+    while (generation_.load(std::memory_order_acquire) == generation) {
+      if (++num_spins < kMaxSpins) {
+        std::this_thread::yield();
+      }
+      else {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this, generation]() { 
+            return generation_.load(std::memory_order_acquire) != generation; 
+        });
+      }
+    }
+    generation = generation_.load(std::memory_order_acquire);
+    if (is_terminated_.load(std::memory_order_acquire)) {
+      return;
+    }
+    runChunk(thread_index);
+    num_running_workers_.fetch_sub(1, std::memory_order_release);
+  }
+}
+
+void StageThreadPool::joinWorkers() {
+  if (workers_.empty()) {
+    return;
+  }
+  is_terminated_.store(true, std::memory_order_release);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation_.fetch_add(1, std::memory_order_release);
+  }
+  condition_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  num_threads_ = 1;
+}
+
+} // namespace cgmres
\ No newline at end of file